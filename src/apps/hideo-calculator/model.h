@@ -33,7 +33,7 @@ enum struct Operator {
     RESIPROCAL,
 };
 
-inline Str toFmt(Operator op) {
+inline Io::Fmt<isize> toFmt(Operator op) {
     switch (op) {
     case Operator::NONE:
         return "{}";
@@ -43,14 +43,12 @@ Ui::Child sidebar(State const &s) {
 }
 
 Ui::Child pageContent(State const &state) {
-    auto url = state.currentUrl();
-    auto dir = Sys::Dir::open(url);
-    auto listing = dir
-                       ? directoryListing(state, dir.unwrap()) | Ui::grow()
+    auto listing = state.listing
+                       ? directoryListing(state) | Ui::grow()
                        : alert(
                              state,
                              "Can't access this location"s,
-                             Io::toStr(dir.none()).unwrap()
+                             Io::toStr(state.listing.none()).unwrap()
                          );
 
     return listing | Ui::grow();
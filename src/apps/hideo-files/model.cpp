@@ -5,22 +5,51 @@
 
 namespace Hideo::Files {
 
+void State::refresh() {
+    auto dir = Sys::Dir::open(currentUrl());
+    if (not dir) {
+        listing = dir.none();
+        return;
+    }
+
+    auto entries = makeRc<Vec<Sys::DirEntry>>();
+    for (auto const &entry : dir.unwrap().entries()) {
+        if (entry.hidden() and not showHidden)
+            continue;
+        entries->pushBack(entry);
+    }
+    listing = Ok(entries);
+}
+
+static void _goTo(State &s, Mime::Url url) {
+    if (s.currentUrl() == url)
+        return;
+
+    s.history.trunc(s.currentIndex + 1);
+    s.history.pushBack(url);
+    s.currentIndex++;
+    s.refresh();
+}
+
 Ui::Task<Action> reduce(State &s, Action a) {
     a.visit(Visitor{
         [&](GoRoot) {
-            reduce(s, GoTo{"file:/"_url}).unwrap();
+            _goTo(s, "file:/"_url);
         },
         [&](GoBack) {
-            if (s.canGoBack())
+            if (s.canGoBack()) {
                 s.currentIndex--;
+                s.refresh();
+            }
         },
         [&](GoForward) {
-            if (s.canGoForward())
+            if (s.canGoForward()) {
                 s.currentIndex++;
+                s.refresh();
+            }
         },
         [&](GoParent p) {
-            auto parent = s.currentUrl().parent(p.index);
-            reduce(s, GoTo{parent}).unwrap();
+            _goTo(s, s.currentUrl().parent(p.index));
         },
         [&](Navigate navigate) {
             auto dest = s.currentUrl();
@@ -33,23 +62,20 @@ Ui::Task<Action> reduce(State &s, Action a) {
                     .objects = {dest},
                 });
             } else {
-                reduce(s, GoTo{dest}).unwrap();
+                _goTo(s, dest);
             }
         },
         [&](GoTo gotTo) {
-            if (s.currentUrl() == gotTo.url)
-                return;
-
-            s.history.trunc(s.currentIndex + 1);
-            s.history.pushBack(gotTo.url);
-            s.currentIndex++;
+            _goTo(s, gotTo.url);
         },
         [&](Refresh) {
+            s.refresh();
         },
         [&](AddBookmark) {
         },
         [&](ToggleHidden) {
             s.showHidden = not s.showHidden;
+            s.refresh();
         },
     });
 
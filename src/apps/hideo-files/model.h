@@ -1,6 +1,7 @@
 #pragma once
 
 #include <karm-mime/url.h>
+#include <karm-sys/dir.h>
 #include <karm-ui/reducer.h>
 
 namespace Hideo::Files {
@@ -10,8 +11,16 @@ struct State {
     usize currentIndex = 0;
     bool showHidden = false;
 
+    // The entries of the current location, read when navigating instead
+    // of on every build.
+    Res<Rc<Vec<Sys::DirEntry>>> listing = Error::notFound("not listed");
+
     State(Mime::Url path)
-        : history({path}) {}
+        : history({path}) {
+        refresh();
+    }
+
+    void refresh();
 
     Mime::Url currentUrl() const {
         return history[currentIndex];
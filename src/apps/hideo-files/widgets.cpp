@@ -98,6 +98,8 @@ Ui::Child directoryContextMenu() {
     });
 }
 
+static constexpr isize ENTRY_HEIGHT = 36;
+
 Ui::Child directorEntry(Sys::DirEntry const &entry, bool odd) {
     return Ui::button(
                Model::bind<Navigate>(entry.name),
@@ -110,22 +112,15 @@ Ui::Child directorEntry(Sys::DirEntry const &entry, bool odd) {
            Kr::contextMenu(slot$(directoryContextMenu()));
 }
 
-Ui::Child directoryListing(State const &s, Sys::Dir const &dir) {
-    if (dir.entries().len() == 0)
+Ui::Child directoryListing(State const &s) {
+    auto entries = s.listing.unwrap();
+    if (entries->len() == 0)
         return Ui::bodyMedium(Ui::GRAY500, "This directory is empty.") | Ui::center();
 
-    Ui::Children children;
-    bool odd = true;
-    for (auto const &entry : dir.entries()) {
-        if (entry.hidden() and not s.showHidden)
-            continue;
-        children.pushBack(directorEntry(entry, odd));
-        odd = !odd;
-    }
-
-    return Ui::vflow(children) |
-           Ui::align(Math::Align::TOP | Math::Align::HFILL) |
-           Ui::vscroll() | Ui::key(s.currentIndex);
+    return Ui::vlist(entries->len(), ENTRY_HEIGHT, [entries](usize i) {
+               return directorEntry((*entries)[i], i % 2 == 0);
+           }) |
+           Ui::key(s.currentIndex);
 }
 
 Ui::Child breadcrumbItem(Str text, isize index) {
@@ -291,17 +286,15 @@ Ui::Child openFileDialog() {
     return Ui::reducer<Model>(
         {"file:/"_url},
         [](auto const &d) {
-            auto maybeDir = Sys::Dir::open(d.currentUrl());
-
             return Kr::dialogContent({
                 Kr::dialogTitleBar("Open file…"s),
                 toolbar(d),
-                (maybeDir
-                     ? directoryListing(d, maybeDir.unwrap())
+                (d.listing
+                     ? directoryListing(d)
                      : alert(
                            d,
                            "Can't access this location"s,
-                           Io::toStr(maybeDir.none()).unwrap()
+                           Io::toStr(d.listing.none()).unwrap()
                        )
                 ) | Ui::pinSize({400, 260}),
                 Ui::separator(),
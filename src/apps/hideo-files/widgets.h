@@ -9,7 +9,7 @@ namespace Hideo::Files {
 
 // MARK: Common Widgets --------------------------------------------------------
 
-Ui::Child directoryListing(State const &s, Sys::Dir const &);
+Ui::Child directoryListing(State const &s);
 
 Ui::Child breadcrumb(State const &s);
 
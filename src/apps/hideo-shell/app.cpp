@@ -133,6 +133,7 @@ Ui::Child taskbar(State const &state) {
 Ui::Child background(State const &state) {
     return Ui::image(state.background) |
            Ui::cover() |
+           Ui::layer() |
            Ui::grow();
 }
 
@@ -8,6 +8,7 @@
 #include <karm-sys/_embed.h>
 #include <karm-sys/file.h>
 #include <karm-sys/launch.h>
+#include <karm-sys/thread.h>
 
 namespace Karm::Sys::_Embed {
 
@@ -324,7 +325,15 @@ Res<Rc<Fd>> openFile(Mime::Url const &url) {
     return Ok(makeRc<FileProto>(file));
 }
 
-Res<Vec<DirEntry>> readDir(Mime::Url const &) {
+Res<Vec<DirEntry>> readDir(Mime::Url const &, bool) {
+    return Error::notImplemented();
+}
+
+Res<Rc<Sys::Fd>> watchDir(Mime::Url const &) {
+    return Error::notImplemented();
+}
+
+Res<Vec<Sys::DirChange>> decodeDirChanges(Bytes) {
     return Error::notImplemented();
 }
 
@@ -462,6 +471,27 @@ Res<> exit(i32) {
         ;
 }
 
+// MARK: Threads ---------------------------------------------------------------
+
+Res<Rc<Sys::Thread>> spawnThread(Func<void()>) {
+    return Error::notImplemented();
+}
+
+usize concurrency() {
+    return 1;
+}
+
+// NOTE: There is only one thread, nothing else could change the condition
+//       a thread would be parked on.
+
+void parkLock() {}
+
+void parkUnlock() {}
+
+void park() {}
+
+void unparkAll() {}
+
 // MARK: Sandboxing ------------------------------------------------------------
 
 void hardenSandbox() {
@@ -9,11 +9,13 @@ void relaxe() {
 }
 
 void enterCritical() {
-    // NOTE: We don't do any thread so we don't need to do anything here.
+    // NOTE: Threads can be preempted anytime in userspace, the spinlock alone
+    //       has to be enough.
 }
 
 void leaveCritical() {
-    // NOTE: We don't do any thread so we don't need to do anything here.
+    // NOTE: Threads can be preempted anytime in userspace, the spinlock alone
+    //       has to be enough.
 }
 
 } // namespace Karm::_Embed
@@ -3,6 +3,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <netinet/in.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/socket.h>
@@ -14,12 +15,18 @@
 #include <time.h>
 #include <unistd.h>
 
+#ifdef __ck_sys_linux__
+#    include <sys/inotify.h>
+#    include <sys/syscall.h>
+#endif
+
 //
 #include <karm-io/funcs.h>
 #include <karm-logger/logger.h>
 #include <karm-sys/_embed.h>
 #include <karm-sys/launch.h>
 #include <karm-sys/proc.h>
+#include <karm-sys/thread.h>
 
 #include "fd.h"
 #include "utils.h"
@@ -153,36 +160,181 @@ Res<Rc<Fd>> createErr() {
     return Ok(fd);
 }
 
-Res<Vec<DirEntry>> readDir(Mime::Url const& url) {
+static void _pushDirEntry(Vec<DirEntry>& entries, int dirfd, char const* name, unsigned char type, bool withStat) {
+    if (strcmp(name, ".") == 0 or
+        strcmp(name, "..") == 0) {
+        return;
+    }
+
+    DirEntry entry{
+        Str::fromNullterminated(name),
+        type == DT_DIR ? Sys::Type::DIR : Sys::Type::FILE,
+    };
+
+    // NOTE: Some filesystems don't report the type of their entries,
+    //       it has to be looked up. Symlinks are reported as themselves,
+    //       like getdents64() does, so walking them can't loop.
+    if (withStat or type == DT_UNKNOWN) {
+        struct stat buf;
+
+        // NOTE: An entry that can't be looked up, because it was removed
+        //       in the meantime or for any other reason, is left out
+        //       rather than failing the whole listing.
+        if (::fstatat(dirfd, name, &buf, AT_SYMLINK_NOFOLLOW) < 0)
+            return;
+
+        entry.type = Posix::fromStat(buf).type;
+
+        // NOTE: The stat of a symlink is the one of the file it points to,
+        //       like stat() gives, a dangling one keeps its own.
+        if (withStat) {
+            struct stat target;
+            if (S_ISLNK(buf.st_mode) and ::fstatat(dirfd, name, &target, 0) == 0)
+                buf = target;
+            entry.stat = Posix::fromStat(buf);
+        }
+    }
+
+    entries.pushBack(std::move(entry));
+}
+
+#ifdef __ck_sys_linux__
+
+// Layout of the records returned by getdents64(2).
+struct _LinuxDirent64 {
+    u64 ino;
+    i64 off;
+    u16 reclen;
+    u8 type;
+    char name[256];
+};
+
+static constexpr usize DIRENTS_BUF_SIZE = 64 * 1024;
+
+// Reads the directory a whole buffer of entries at a time, instead of
+// going through readdir() once per entry.
+Res<Vec<DirEntry>> readDir(Mime::Url const& url, bool withStat) {
+    String str = try$(resolve(url)).str();
+
+    int fd = ::open(str.buf(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return Posix::fromLastErrno();
+    Defer defer{[&] {
+        ::close(fd);
+    }};
+
+    auto buf = Buf<u8>::init(DIRENTS_BUF_SIZE);
+    Vec<DirEntry> entries;
+    while (true) {
+        auto len = ::syscall(SYS_getdents64, fd, buf.buf(), buf.len());
+        if (len < 0)
+            return Posix::fromLastErrno();
+        if (len == 0)
+            break;
+
+        for (isize off = 0; off < len;) {
+            auto const* dirent = reinterpret_cast<_LinuxDirent64 const*>(buf.buf() + off);
+            _pushDirEntry(entries, fd, dirent->name, dirent->type, withStat);
+            off += dirent->reclen;
+        }
+    }
+
+    return Ok(entries);
+}
+
+#else
+
+Res<Vec<DirEntry>> readDir(Mime::Url const& url, bool withStat) {
     String str = try$(resolve(url)).str();
 
     DIR* dir = ::opendir(str.buf());
     if (not dir)
         return Posix::fromLastErrno();
+    Defer defer{[&] {
+        ::closedir(dir);
+    }};
 
     Vec<DirEntry> entries;
     struct dirent* entry;
     errno = 0;
     while ((entry = ::readdir(dir))) {
         try$(Posix::consumeErrno());
+        _pushDirEntry(entries, ::dirfd(dir), entry->d_name, entry->d_type, withStat);
+    }
+    try$(Posix::consumeErrno());
+
+    return Ok(entries);
+}
+
+#endif
+
+#ifdef __ck_sys_linux__
+
+Res<Rc<Sys::Fd>> watchDir(Mime::Url const& url) {
+    String str = try$(resolve(url)).str();
+
+    int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return Posix::fromLastErrno();
+    auto watch = makeRc<Posix::Fd>(fd);
+
+    u32 mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+               IN_MODIFY | IN_ATTRIB | IN_ONLYDIR;
+    if (::inotify_add_watch(fd, str.buf(), mask) < 0)
+        return Posix::fromLastErrno();
 
-        if (strcmp(entry->d_name, ".") == 0 or
-            strcmp(entry->d_name, "..") == 0) {
+    return Ok(watch);
+}
+
+Res<Vec<DirChange>> decodeDirChanges(Bytes bytes) {
+    Vec<DirChange> changes;
+    for (usize off = 0; off + sizeof(struct inotify_event) <= bytes.len();) {
+        struct inotify_event event;
+        memcpy(&event, bytes.buf() + off, sizeof(event));
+
+        // NOTE: A record cut short by the end of the buffer is dropped
+        //       rather than read past it.
+        if (off + sizeof(event) + event.len > bytes.len())
+            break;
+
+        auto const* name = reinterpret_cast<char const*>(bytes.buf() + off + sizeof(event));
+        off += sizeof(event) + event.len;
+
+        // NOTE: The kernel dropped events, the listing can't be kept
+        //       up to date from here, it has to be read again.
+        if (event.mask & IN_Q_OVERFLOW) {
+            changes.pushBack({DirChange::RESCAN, ""s});
             continue;
         }
 
-        entries.pushBack(DirEntry{
-            Str::fromNullterminated(entry->d_name),
-            entry->d_type == DT_DIR ? Sys::Type::DIR : Sys::Type::FILE,
-        });
+        if (event.len == 0)
+            continue;
+
+        DirChange::Type type = DirChange::MODIFIED;
+        if (event.mask & (IN_CREATE | IN_MOVED_TO))
+            type = DirChange::CREATED;
+        else if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+            type = DirChange::DELETED;
+
+        // NOTE: The name is padded with zeros up to event.len, which
+        //       bounds it when there is no room left for the terminator.
+        changes.pushBack({type, Str{name, strnlen(name, event.len)}});
     }
+    return Ok(changes);
+}
 
-    if (::closedir(dir) < 0)
-        return Posix::fromLastErrno();
+#else
 
-    return Ok(entries);
+Res<Rc<Sys::Fd>> watchDir(Mime::Url const&) {
+    return Error::notImplemented();
+}
+
+Res<Vec<DirChange>> decodeDirChanges(Bytes) {
+    return Error::notImplemented();
 }
 
+#endif
+
 Res<Stat> stat(Mime::Url const& url) {
     String str = try$(resolve(url)).str();
     struct stat buf;
@@ -442,6 +594,78 @@ Res<> exit(i32 res) {
     return Ok();
 }
 
+// MARK: Threads ---------------------------------------------------------------
+
+struct PosixThread : public Sys::Thread {
+    pthread_t _thread;
+    bool _joined = false;
+
+    PosixThread(pthread_t thread)
+        : _thread(thread) {}
+
+    ~PosixThread() override {
+        if (not _joined)
+            pthread_detach(_thread);
+    }
+
+    Res<> join() override {
+        if (_joined)
+            return Ok();
+        _joined = true;
+
+        if (auto err = pthread_join(_thread, nullptr); err != 0)
+            return Posix::fromErrno(err);
+        return Ok();
+    }
+};
+
+Res<Rc<Sys::Thread>> spawnThread(Func<void()> fn) {
+    auto* arg = new Func<void()>(std::move(fn));
+    auto entry = [](void* arg) -> void* {
+        auto* fn = static_cast<Func<void()>*>(arg);
+        (*fn)();
+        delete fn;
+        return nullptr;
+    };
+
+    pthread_t thread;
+    if (auto err = pthread_create(&thread, nullptr, entry, arg); err != 0) {
+        delete arg;
+        return Posix::fromErrno(err);
+    }
+
+    return Ok(makeRc<PosixThread>(thread));
+}
+
+usize concurrency() {
+    auto n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? n : 1;
+}
+
+// NOTE: Every parked thread waits on the same condition variable, waking
+//       up threads waiting for something else is harmless, they go back
+//       to sleep.
+static pthread_mutex_t _parkMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _parkCond = PTHREAD_COND_INITIALIZER;
+
+void parkLock() {
+    pthread_mutex_lock(&_parkMutex);
+}
+
+void parkUnlock() {
+    pthread_mutex_unlock(&_parkMutex);
+}
+
+void park() {
+    pthread_cond_wait(&_parkCond, &_parkMutex);
+}
+
+void unparkAll() {
+    pthread_mutex_lock(&_parkMutex);
+    pthread_cond_broadcast(&_parkCond);
+    pthread_mutex_unlock(&_parkMutex);
+}
+
 // MARK: Sandboxing ------------------------------------------------------------
 
 void hardenSandbox() {
@@ -69,11 +69,18 @@ struct UringSched : public Sys::Sched {
         io_uring_submit(&_ring);
     }
 
+    // The result is stored inline in the job, so the task holds on to the
+    // job until it has been received.
+    template <typename J>
+    static Async::_Task<typename decltype(Meta::declval<J&>()._slot.wait())::Inner> _waitAsync(Rc<J> job) {
+        co_return co_await job->_slot.wait();
+    }
+
     Async::Task<usize> readAsync(Rc<Fd> fd, MutBytes buf) override {
         struct Job : public _Job {
             Rc<Fd> _fd;
             MutBytes _buf;
-            Async::Promise<usize> _promise;
+            Async::Slot<usize> _slot;
 
             Job(Rc<Fd> fd, MutBytes buf)
                 : _fd(fd), _buf(buf) {}
@@ -85,26 +92,22 @@ struct UringSched : public Sys::Sched {
             void complete(io_uring_cqe* cqe) override {
                 auto res = cqe->res;
                 if (res < 0)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else
-                    _promise.resolve(Ok(cqe->res));
-            }
-
-            auto future() {
-                return _promise.future();
+                    _slot.resolve(Ok(cqe->res));
             }
         };
 
         auto job = makeRc<Job>(fd, buf);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Async::Task<usize> writeAsync(Rc<Fd> fd, Bytes buf) override {
         struct Job : public _Job {
             Rc<Fd> _fd;
             Bytes _buf;
-            Async::Promise<usize> _promise;
+            Async::Slot<usize> _slot;
 
             Job(Rc<Fd> fd, Bytes buf)
                 : _fd(fd), _buf(buf) {}
@@ -116,25 +119,21 @@ struct UringSched : public Sys::Sched {
             void complete(io_uring_cqe* cqe) override {
                 auto res = cqe->res;
                 if (res < 0)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else
-                    _promise.resolve(Ok(cqe->res));
-            }
-
-            auto future() {
-                return _promise.future();
+                    _slot.resolve(Ok(cqe->res));
             }
         };
 
         auto job = makeRc<Job>(fd, buf);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Async::Task<usize> flushAsync(Rc<Fd> fd) override {
         struct Job : public _Job {
             Rc<Fd> _fd;
-            Async::Promise<usize> _promise;
+            Async::Slot<usize> _slot;
 
             Job(Rc<Fd> fd)
                 : _fd(fd) {}
@@ -146,19 +145,15 @@ struct UringSched : public Sys::Sched {
             void complete(io_uring_cqe* cqe) override {
                 auto res = cqe->res;
                 if (res < 0)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else
-                    _promise.resolve(Ok(cqe->res));
-            }
-
-            auto future() {
-                return _promise.future();
+                    _slot.resolve(Ok(cqe->res));
             }
         };
 
         auto job = makeRc<Job>(fd);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Async::Task<_Accepted> acceptAsync(Rc<Fd> fd) override {
@@ -166,7 +161,7 @@ struct UringSched : public Sys::Sched {
             Rc<Fd> _fd;
             sockaddr_in _addr{};
             unsigned _addrLen = sizeof(sockaddr_in);
-            Async::Promise<_Accepted> _promise;
+            Async::Slot<_Accepted> _slot;
 
             Job(Rc<Fd> fd)
                 : _fd(fd) {}
@@ -178,21 +173,17 @@ struct UringSched : public Sys::Sched {
             void complete(io_uring_cqe* cqe) override {
                 auto res = cqe->res;
                 if (res < 0)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else {
                     _Accepted accepted = {makeRc<Posix::Fd>(res), Posix::fromSockAddr(_addr)};
-                    _promise.resolve(Ok(accepted));
+                    _slot.resolve(Ok(accepted));
                 }
             }
-
-            auto future() {
-                return _promise.future();
-            }
         };
 
         auto job = makeRc<Job>(fd);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Async::Task<_Sent> sendAsync(Rc<Fd> fd, Bytes buf, Slice<Handle> handles, SocketAddr addr) override {
@@ -205,7 +196,7 @@ struct UringSched : public Sys::Sched {
             iovec _iov;
             msghdr _msg;
             sockaddr_in _addr;
-            Async::Promise<_Sent> _promise;
+            Async::Slot<_Sent> _slot;
 
             Job(Rc<Fd> fd, Bytes buf, SocketAddr addr)
                 : _fd(fd), _buf(buf), _addr(Posix::toSockAddr(addr)) {}
@@ -224,19 +215,15 @@ struct UringSched : public Sys::Sched {
 
             void complete(io_uring_cqe* cqe) override {
                 if (cqe->res < 0)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else
-                    _promise.resolve(Ok<_Sent>(cqe->res, 0));
-            }
-
-            auto future() {
-                return _promise.future();
+                    _slot.resolve(Ok<_Sent>(cqe->res, 0));
             }
         };
 
         auto job = makeRc<Job>(fd, buf, addr);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Async::Task<_Received> recvAsync(Rc<Fd> fd, MutBytes buf, MutSlice<Handle>) override {
@@ -246,7 +233,7 @@ struct UringSched : public Sys::Sched {
             iovec _iov;
             msghdr _msg;
             sockaddr_in _addr;
-            Async::Promise<_Received> _promise;
+            Async::Slot<_Received> _slot;
 
             Job(Rc<Fd> fd, MutBytes buf)
                 : _fd(fd), _buf(buf) {}
@@ -265,27 +252,23 @@ struct UringSched : public Sys::Sched {
 
             void complete(io_uring_cqe* cqe) override {
                 if (cqe->res < 0)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else {
                     _Received received = {(usize)cqe->res, 0, Posix::fromSockAddr(_addr)};
-                    _promise.resolve(Ok(received));
+                    _slot.resolve(Ok(received));
                 }
             }
-
-            auto future() {
-                return _promise.future();
-            }
         };
 
         auto job = makeRc<Job>(fd, buf);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Async::Task<> sleepAsync(Instant until) override {
         struct Job : public _Job {
             Instant _until;
-            Async::Promise<> _promise;
+            Async::Slot<> _slot;
 
             struct __kernel_timespec _ts{};
 
@@ -299,19 +282,15 @@ struct UringSched : public Sys::Sched {
 
             void complete(io_uring_cqe* cqe) override {
                 if (cqe->res < 0 and cqe->res != -ETIME)
-                    _promise.resolve(Posix::fromErrno(-cqe->res));
+                    _slot.resolve(Posix::fromErrno(-cqe->res));
                 else
-                    _promise.resolve(Ok());
-            }
-
-            auto future() {
-                return _promise.future();
+                    _slot.resolve(Ok());
             }
         };
 
         auto job = makeRc<Job>(until);
         submit(job);
-        return Async::makeTask(job->future());
+        return _waitAsync(job);
     }
 
     Res<> wait(Instant until) override {
@@ -3,6 +3,7 @@
 #include <karm-logger/logger.h>
 #include <karm-sys/_embed.h>
 #include <karm-sys/launch.h>
+#include <karm-sys/thread.h>
 
 #include "fd.h"
 
@@ -49,7 +50,15 @@ Res<Rc<Sys::Fd>> createErr() {
     return Ok(makeRc<Sys::NullFd>());
 }
 
-Res<Vec<Sys::DirEntry>> readDir(Mime::Url const &) {
+Res<Vec<Sys::DirEntry>> readDir(Mime::Url const &, bool) {
+    notImplemented();
+}
+
+Res<Rc<Sys::Fd>> watchDir(Mime::Url const &) {
+    notImplemented();
+}
+
+Res<Vec<Sys::DirChange>> decodeDirChanges(Bytes) {
     notImplemented();
 }
 
@@ -169,6 +178,27 @@ Res<> exit(i32) {
     notImplemented();
 }
 
+// MARK: Threads ---------------------------------------------------------------
+
+Res<Rc<Sys::Thread>> spawnThread(Func<void()>) {
+    return Error::notImplemented();
+}
+
+usize concurrency() {
+    return 1;
+}
+
+// NOTE: There is only one thread, nothing else could change the condition
+//       a thread would be parked on.
+
+void parkLock() {}
+
+void parkUnlock() {}
+
+void park() {}
+
+void unparkAll() {}
+
 // MARK: Sandboxing ------------------------------------------------------------
 
 void hardenSandbox() {
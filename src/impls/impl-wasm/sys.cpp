@@ -3,6 +3,7 @@
 #include <karm-base/time.h>
 #include <karm-logger/logger.h>
 #include <karm-sys/_embed.h>
+#include <karm-sys/thread.h>
 
 #include "externs.h"
 
@@ -93,10 +94,18 @@ Res<Rc<Sys::Fd>> unpackFd(Io::PackScan&) {
     notImplemented();
 }
 
-Res<Vec<DirEntry>> readDir(Mime::Url const&) {
+Res<Vec<DirEntry>> readDir(Mime::Url const&, bool) {
     return Error::notImplemented("directory listing not supported");
 }
 
+Res<Rc<Sys::Fd>> watchDir(Mime::Url const&) {
+    return Error::notImplemented("directory watching not supported");
+}
+
+Res<Vec<DirChange>> decodeDirChanges(Bytes) {
+    return Error::notImplemented("directory watching not supported");
+}
+
 Res<Stat> stat(Mime::Url const&) {
     return Error::notImplemented("directory listing not supported");
 }
@@ -171,6 +180,27 @@ Res<> populate(Vec<Sys::UserInfo>&) {
     return Ok();
 }
 
+// MARK: Threads ---------------------------------------------------------------
+
+Res<Rc<Sys::Thread>> spawnThread(Func<void()>) {
+    return Error::notImplemented();
+}
+
+usize concurrency() {
+    return 1;
+}
+
+// NOTE: There is only one thread, nothing else could change the condition
+//       a thread would be parked on.
+
+void parkLock() {}
+
+void parkUnlock() {}
+
+void park() {}
+
+void unparkAll() {}
+
 // MARK: Sandboxing ------------------------------------------------------------
 
 void hardenSandbox() {
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <hal/mem.h>
+#include <hal/raw.h>
+
+#include "asm.h"
+
+namespace x86_64 {
+
+struct Lapic {
+    Hal::RawDmaIo _io;
+
+    // Registers
+    static constexpr usize ID = 0x20;
+    static constexpr usize VERSION = 0x30;
+    static constexpr usize TPR = 0x80;
+    static constexpr usize EOI = 0xb0;
+    static constexpr usize SVR = 0xf0;
+    static constexpr usize ICR_LOW = 0x300;
+    static constexpr usize ICR_HIGH = 0x310;
+    static constexpr usize LVT_TIMER = 0x320;
+    static constexpr usize TIMER_INIT = 0x380;
+    static constexpr usize TIMER_CURR = 0x390;
+    static constexpr usize TIMER_DIV = 0x3e0;
+
+    // Flags
+    static constexpr u32 SVR_ENABLE = 1 << 8;
+    static constexpr u32 TIMER_PERIODIC = 1 << 17;
+    static constexpr u32 TIMER_MASKED = 1 << 16;
+    static constexpr u32 TIMER_DIV16 = 0x3;
+
+    static constexpr u32 ICR_INIT = 0b101 << 8;
+    static constexpr u32 ICR_STARTUP = 0b110 << 8;
+    static constexpr u32 ICR_PENDING = 1 << 12;
+    static constexpr u32 ICR_ASSERT = 1 << 14;
+    static constexpr u32 ICR_LEVEL = 1 << 15;
+    static constexpr u32 ICR_ALL_BUT_SELF = 0b11 << 18;
+
+    static constexpr usize APIC_BASE_MASK = ~(usize)0xfff;
+
+    static usize base() {
+        return rdmsr(Msrs::APIC) & APIC_BASE_MASK;
+    }
+
+    static Lapic lapic(usize vbase) {
+        return {Hal::RawDmaIo({vbase, Hal::PAGE_SIZE})};
+    }
+
+    u32 read(usize reg) {
+        return _io.in32(reg).unwrap("lapic read failed");
+    }
+
+    void write(usize reg, u32 value) {
+        _io.out32(reg, value).unwrap("lapic write failed");
+    }
+
+    void enable(u8 spurious) {
+        write(TPR, 0);
+        write(SVR, SVR_ENABLE | spurious);
+    }
+
+    u8 id() {
+        return read(ID) >> 24;
+    }
+
+    void eoi() {
+        write(EOI, 0);
+    }
+
+    void _waitIcr() {
+        while (read(ICR_LOW) & ICR_PENDING)
+            pause();
+    }
+
+    void sendIpi(u8 dest, u8 vector) {
+        _waitIcr();
+        write(ICR_HIGH, (u32)dest << 24);
+        write(ICR_LOW, vector);
+    }
+
+    void broadcastIpi(u8 vector) {
+        _waitIcr();
+        write(ICR_LOW, ICR_ALL_BUT_SELF | vector);
+    }
+
+    void sendInit(u8 dest) {
+        _waitIcr();
+        write(ICR_HIGH, (u32)dest << 24);
+        write(ICR_LOW, ICR_INIT | ICR_LEVEL | ICR_ASSERT);
+        _waitIcr();
+    }
+
+    void sendStartup(u8 dest, usize trampoline) {
+        _waitIcr();
+        write(ICR_HIGH, (u32)dest << 24);
+        write(ICR_LOW, ICR_STARTUP | (u32)(trampoline / Hal::PAGE_SIZE));
+        _waitIcr();
+    }
+
+    // MARK: Timer -------------------------------------------------------------
+
+    void startTimer(u32 count) {
+        write(TIMER_DIV, TIMER_DIV16);
+        write(LVT_TIMER, TIMER_MASKED);
+        write(TIMER_INIT, count);
+    }
+
+    u32 elapsedTimer() {
+        return read(TIMER_INIT) - read(TIMER_CURR);
+    }
+
+    void stopTimer() {
+        write(TIMER_INIT, 0);
+    }
+
+    void periodicTimer(u8 vector, u32 count) {
+        write(TIMER_DIV, TIMER_DIV16);
+        write(LVT_TIMER, TIMER_PERIODIC | vector);
+        write(TIMER_INIT, count);
+    }
+};
+
+} // namespace x86_64
@@ -36,6 +36,11 @@ struct Pic {
         return Ok();
     }
 
+    Res<> mask(u8 irq) {
+        try$(_io.out8(DATA, try$(_io.in8(DATA)) | (1 << irq)));
+        return Ok();
+    }
+
     static void wait() {
         asm volatile("jmp 1f; 1: jmp 1f; 1:");
     }
@@ -89,6 +94,12 @@ struct DualPic {
         return Ok();
     };
 
+    Res<> mask(u8 irq) {
+        if (irq >= 8)
+            return _pic2.mask(irq - 8);
+        return _pic1.mask(irq);
+    }
+
     Res<> disable() {
         try$(_pic1.disable());
         try$(_pic2.disable());
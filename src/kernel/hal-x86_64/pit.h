@@ -18,7 +18,9 @@ struct Pit {
     static constexpr auto CMD = 3;
 
     static constexpr auto CHANNEL1 = 1 << 5;
+    static constexpr auto CHANNEL2 = 1 << 7;
     static constexpr auto LOWBYTE = 1 << 4;
+    static constexpr auto HIGHBYTE = 1 << 5;
     static constexpr auto SQUARE_WAVE = 6;
 
     static Pit pit() {
@@ -35,6 +37,24 @@ struct Pit {
         return Ok();
     }
 
+    // Busy-wait using channel 2, which is gated through the keyboard
+    // controller port and never raises an interrupt, so it can be used to
+    // calibrate other timers before interrupts are enabled.
+    Res<> wait(usize ms) {
+        Hal::RawPortIo gate{{0x61, 1}};
+        u16 latch = (FREQ / 1000) * ms;
+
+        try$(gate.out8(0, (try$(gate.in8(0)) & ~0x02) | 0x01));
+        try$(_io.out8(CMD, CHANNEL2 | LOWBYTE | HIGHBYTE));
+        try$(_io.out8(PORT2, latch & 0xFF));
+        try$(_io.out8(PORT2, (latch >> 8) & 0xFF));
+
+        while ((try$(gate.in8(0)) & 0x20) == 0)
+            asm volatile("pause");
+
+        return Ok();
+    }
+
     Res<u32> readCount() {
         try$(_io.out8(CMD, 0x00));
         u32 low = try$(_io.in8(PORT0));
@@ -120,22 +120,41 @@ using Arg = usize;
 
 using Args = Array<Arg, 6>;
 
+// Each level of a cap addresses a slot of a domain and carries the
+// generation of that slot, so stale caps are caught once the slot is reused.
+// Caps into nested domains are built by stacking levels.
 struct Cap {
     Arg _raw = 0;
 
-    static constexpr usize SHIFT = 11;
-    static constexpr usize LEN = 1 << 11;
-    static constexpr usize MASK = LEN - 1;
+    static constexpr usize INDEX_BITS = 11;
+    static constexpr usize GEN_BITS = 5;
+    static constexpr usize SHIFT = INDEX_BITS + GEN_BITS;
+    static constexpr usize LEN = 1 << INDEX_BITS;
+    static constexpr usize MASK = (1 << SHIFT) - 1;
+    static constexpr usize INDEX_MASK = LEN - 1;
+    static constexpr usize GEN_MASK = (1 << GEN_BITS) - 1;
 
     constexpr Cap() = default;
 
     constexpr explicit Cap(Arg raw)
         : _raw(raw) {}
 
+    static constexpr Cap make(usize index, usize gen) {
+        return Cap{(index & INDEX_MASK) | ((gen & GEN_MASK) << INDEX_BITS)};
+    }
+
     constexpr Arg raw() const {
         return _raw;
     }
 
+    constexpr usize index() const {
+        return _raw & INDEX_MASK;
+    }
+
+    constexpr usize gen() const {
+        return (_raw >> INDEX_BITS) & GEN_MASK;
+    }
+
     constexpr bool isRoot() const {
         return _raw == 0;
     }
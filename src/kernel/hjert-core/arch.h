@@ -34,6 +34,10 @@ Res<Arc<Hal::Vmm>> createVmm();
 
 Res<> init(Handover::Payload &);
 
+Res<> initSmp(Handover::Payload &, Opt<Hal::PmmRange> trampoline);
+
+void shootdown(Hal::VmmRange vrange);
+
 [[noreturn]] void stop();
 
 void yield();
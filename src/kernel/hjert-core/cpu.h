@@ -14,10 +14,17 @@
 
 namespace Hjert::Core {
 
+static constexpr usize MAX_CPUS = 64;
+
 struct Cpu {
+    usize _id = 0;
     bool _retainEnabled = false;
     isize _depth = 0;
 
+    usize id() const {
+        return _id;
+    }
+
     void beginInterrupt() {
         _retainEnabled = false;
     }
@@ -57,4 +64,8 @@ struct Cpu {
     virtual void relaxe() = 0;
 };
 
+// Called by the platform layer on each application processor once it is
+// ready to take interrupts.
+[[noreturn]] void enterCpu();
+
 } // namespace Hjert::Core
@@ -6,6 +6,32 @@ Res<Arc<Domain>> Domain::create() {
     return Ok(makeArc<Domain>());
 }
 
+Res<usize> Domain::_lookupUnlock(Hj::Cap cap) {
+    auto index = cap.index();
+
+    if (index == 0 or index >= _slots.len() or not _slots[index].obj)
+        return Error::invalidHandle("slot is empty");
+
+    if (_slots[index].gen != cap.gen())
+        return Error::invalidHandle("stale handle");
+
+    return Ok(index);
+}
+
+Res<usize> Domain::_allocUnlock() {
+    if (_free) {
+        auto index = _free;
+        _free = _slots[index].next;
+        return Ok(index);
+    }
+
+    if (_slots.len() >= Hj::Cap::LEN)
+        return Error::invalidHandle("no free slots");
+
+    _slots.pushBack(Slot{});
+    return Ok(_slots.len() - 1);
+}
+
 Res<Hj::Cap> Domain::_addUnlock(Hj::Cap dest, Arc<Object> obj) {
     auto c = dest.raw();
 
@@ -15,14 +41,11 @@ Res<Hj::Cap> Domain::_addUnlock(Hj::Cap dest, Arc<Object> obj) {
         return Ok(Hj::Cap{newCap._raw | (c & ~Hj::Cap::MASK)});
     }
 
-    for (c = 1; c < _slots.len(); c++) {
-        if (not _slots[c]) {
-            _slots[c] = obj;
-            return Ok(Hj::Cap{c});
-        }
-    }
-
-    return Error::invalidHandle("no free slots");
+    auto index = try$(_allocUnlock());
+    auto &slot = _slots[index];
+    slot.obj = obj;
+    _used++;
+    return Ok(Hj::Cap::make(index, slot.gen));
 }
 
 Res<Hj::Cap> Domain::add(Hj::Cap dest, Arc<Object> obj) {
@@ -38,10 +61,8 @@ Res<Arc<Object>> Domain::_getUnlock(Hj::Cap cap) {
         return subDomain->get(Hj::Cap{c >> Hj::Cap::SHIFT});
     }
 
-    if (not _slots[c])
-        return Error::invalidHandle("slot is empty");
-
-    return Ok(*_slots[c]);
+    auto index = try$(_lookupUnlock(cap));
+    return Ok(*_slots[index].obj);
 }
 
 Res<Arc<Object>> Domain::get(Hj::Cap cap) {
@@ -59,22 +80,19 @@ Res<> Domain::drop(Hj::Cap cap) {
         return subDomain->drop(Hj::Cap{c >> Hj::Cap::SHIFT});
     }
 
-    if (not _slots[c])
-        return Error::invalidHandle("slot is empty");
-
-    _slots[c] = NONE;
+    auto index = try$(_lookupUnlock(cap));
+    auto &slot = _slots[index];
+    slot.obj = NONE;
+    slot.gen = (slot.gen + 1) & Hj::Cap::GEN_MASK;
+    slot.next = _free;
+    _free = index;
+    _used--;
     return Ok();
 }
 
 usize Domain::_availableUnlocked() const {
-    usize count = 0;
-
-    for (usize i = 1; i < _slots.len(); i++) {
-        if (_slots[i])
-            count++;
-    }
-
-    return count;
+    // NOTE: Slot 0 is reserved for the root cap
+    return Hj::Cap::LEN - 1 - _used;
 }
 
 } // namespace Hjert::Core
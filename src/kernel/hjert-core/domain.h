@@ -1,16 +1,30 @@
 #pragma once
 
+#include <karm-base/vec.h>
+
 #include "object.h"
 
 namespace Hjert::Core {
 
 struct Domain : public BaseObject<Domain, Hj::Type::DOMAIN> {
-    using Slot = Opt<Arc<Object>>;
-
-    Array<Slot, Hj::Cap::LEN> _slots;
+    struct Slot {
+        Opt<Arc<Object>> obj = NONE;
+        usize gen = 0;
+        usize next = 0;
+    };
+
+    // NOTE: Slot 0 is never handed out, it stands for the root
+    //       cap and terminates the free list.
+    Vec<Slot> _slots = {Slot{}};
+    usize _free = 0;
+    usize _used = 0;
 
     static Res<Arc<Domain>> create();
 
+    Res<usize> _lookupUnlock(Hj::Cap cap);
+
+    Res<usize> _allocUnlock();
+
     Res<Hj::Cap> _addUnlock(Hj::Cap dest, Arc<Object> obj);
 
     Res<Hj::Cap> add(Hj::Cap dest, Arc<Object> obj);
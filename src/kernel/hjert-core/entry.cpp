@@ -124,6 +124,7 @@ Res<> init(u64 magic, Handover::Payload &payload) {
     try$(validateAndDump(magic, payload));
     try$(initMem(payload));
     try$(initSched(payload));
+    try$(Arch::initSmp(payload, lowPage()));
 
     logInfo("entry: everything is ready, enabling interrupts...");
     Arch::globalCpu().retainEnable();
@@ -139,6 +140,15 @@ Res<> init(u64 magic, Handover::Payload &payload) {
         Arch::globalCpu().relaxe();
 }
 
+void enterCpu() {
+    Arch::globalCpu().retainEnable();
+    Arch::globalCpu().enableInterrupts();
+
+    Task::self().enter(Mode::IDLE);
+    while (true)
+        Arch::globalCpu().relaxe();
+}
+
 } // namespace Hjert::Core
 
 // MARK: Handover Entry Point ------ -------------------------------------------
@@ -146,7 +156,8 @@ Res<> init(u64 magic, Handover::Payload &payload) {
 HandoverRequests$(
     Handover::requestStack(),
     Handover::requestFb(),
-    Handover::requestFiles()
+    Handover::requestFiles(),
+    Handover::requestRsdp()
 );
 
 void __panicHandler(PanicKind kind, char const *buf) {
@@ -115,8 +115,11 @@ struct Kmm : public Hal::Kmm {
     }
 };
 
+static constexpr usize LOW_MEMORY = mib(1);
+
 static Opt<Pmm> _pmm = NONE;
 static Opt<Kmm> _kmm = NONE;
+static Opt<Hal::PmmRange> _lowPage = NONE;
 
 Hal::PmmRange _findBitmapSpace(Handover::Payload &payload, usize bitmapSize) {
     for (auto &record : payload) {
@@ -181,6 +184,17 @@ Res<> initMem(Handover::Payload &payload) {
 
     try$(pmm().used({pmmBits.start, pmmBits.size}, Hal::PmmFlags::NONE));
 
+    // NOTE: Nothing has been allocated yet, so the lowest free page is the
+    //       best chance of finding one in the first megabyte.
+    auto lowPage = try$(pmm().allocRange(Hal::PAGE_SIZE, Hal::PmmFlags::LOWER));
+    if (lowPage.end() <= LOW_MEMORY) {
+        logInfo("mem: reserving low page at {p}...", lowPage.start);
+        _lowPage = lowPage;
+    } else {
+        logWarn("mem: no free page below 1MiB");
+        try$(pmm().free(lowPage));
+    }
+
     _pmm->dump();
 
     logInfo("mem: mapping kernel...");
@@ -220,6 +234,10 @@ Hal::Pmm &pmm() {
     return *_pmm;
 }
 
+Opt<Hal::PmmRange> lowPage() {
+    return _lowPage;
+}
+
 Hal::Kmm &kmm() {
     if (not _kmm)
         logFatal("mem: heap not initialized yet");
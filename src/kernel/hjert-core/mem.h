@@ -13,4 +13,8 @@ Hal::Kmm &kmm();
 
 Hal::Pmm &pmm();
 
+// A page of the first megabyte reserved by initMem(), for the code that
+// has to run in real mode, NONE if there wasn't any left.
+Opt<Hal::PmmRange> lowPage();
+
 } // namespace Hjert::Core
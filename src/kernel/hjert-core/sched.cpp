@@ -1,3 +1,4 @@
+#include <karm-base/limits.h>
 #include <karm-logger/logger.h>
 
 #include "arch.h"
@@ -9,55 +10,151 @@ namespace Hjert::Core {
 
 static Opt<Sched> _sched;
 
+static Res<Arc<Task>> _createIdle() {
+    auto idleTask = try$(Task::create(Mode::SUPER, try$(Space::create())));
+    try$(idleTask->ready(0, 0, {}));
+    return Ok(idleTask);
+}
+
 Res<> initSched(Handover::Payload &) {
     logInfo("sched: initializing...");
-    auto bootTask = try$(Task::create(Mode::SUPER, try$(Space::create())));
+    auto bootTask = try$(_createIdle());
     bootTask->label("entry");
-    try$(bootTask->ready(0, 0, {}));
     _sched.emplace(std::move(bootTask));
     return Ok();
 }
 
+Res<> initSchedCpu() {
+    auto cpu = Arch::globalCpu().id();
+    logInfo("sched: attaching cpu{}...", cpu);
+    auto idleTask = try$(_createIdle());
+    idleTask->label("idle");
+    try$(globalSched().attach(cpu, std::move(idleTask)));
+    return Ok();
+}
+
 Sched &globalSched() {
     return *_sched;
 }
 
-Sched::Sched(Arc<Task> boot)
-    : _tasks{boot},
-      _prev(boot),
-      _curr(boot),
-      _idle(boot) {
+Sched::Queue::Queue(Arc<Task> idle)
+    : _prev(idle),
+      _curr(idle),
+      _idle(idle) {
+}
+
+Sched::Sched(Arc<Task> boot) {
+    attach(0, std::move(boot)).unwrap("failed to attach boot cpu");
+}
+
+Res<> Sched::attach(usize cpu, Arc<Task> idle) {
+    // NOTE: Processors are brought up one after the other, so queues
+    //       are always published in order.
+    if (cpu != _len.load() or cpu >= MAX_CPUS)
+        return Error::invalidInput("cpu attached out of order");
+
+    _queues[cpu] = makeBox<Queue>(std::move(idle));
+    _len.store(cpu + 1);
+    return Ok();
+}
+
+Sched::Queue &Sched::local() {
+    return **_queues[Arch::globalCpu().id()];
 }
 
 Res<> Sched::enqueue(Arc<Task> task) {
-    LockScope scope(_lock);
-    _tasks.pushBack(std::move(task));
+    // NOTE: New tasks go to the least loaded processor, idle processors
+    //       will steal from the others if this goes out of balance.
+    auto len = _len.load();
+    usize best = 0;
+    usize bestLoad = Limits<usize>::MAX;
+    for (usize i = 0; i < len; i++) {
+        usize load = 0;
+        {
+            auto &queue = **_queues[i];
+            LockScope scope(queue._lock);
+            load = queue._tasks.len();
+        }
+
+        if (load < bestLoad) {
+            best = i;
+            bestLoad = load;
+        }
+    }
+
+    auto &queue = **_queues[best];
+    LockScope scope(queue._lock);
+    queue._tasks.pushBack(std::move(task));
     return Ok();
 }
 
+Opt<Arc<Task>> Sched::_steal(usize cpu) {
+    auto len = _len.load();
+    for (usize off = 1; off < len; off++) {
+        auto &victim = **_queues[(cpu + off) % len];
+
+        // NOTE: We are already holding our own queue lock, never wait
+        //       on another one or two stealing processors would deadlock.
+        if (not victim._lock.tryAcquire())
+            continue;
+
+        Opt<Arc<Task>> stolen = NONE;
+        for (usize i = 0; i < victim._tasks.len(); ++i) {
+            auto &t = victim._tasks[i];
+            if (&*t == &*victim._curr)
+                continue;
+
+            if (t->eval(stamp()) == State::RUNNABLE) {
+                stolen = victim._tasks.removeAt(i);
+                break;
+            }
+        }
+
+        victim._lock.release();
+
+        if (stolen)
+            return stolen;
+    }
+
+    return NONE;
+}
+
 void Sched::schedule(Duration span) {
-    LockScope scope(_lock);
+    auto cpu = Arch::globalCpu().id();
+    auto &queue = local();
+    LockScope scope(queue._lock);
+
+    if (cpu == 0)
+        _stamp.fetchAdd(span.val(), RELEASE);
 
-    _stamp += span;
-    _prev = _curr;
-    _curr->_sliceEnd = _stamp;
+    auto stamp = this->stamp();
 
-    auto next = _idle;
+    queue._prev = queue._curr;
+    queue._curr->_sliceEnd = stamp;
+
+    auto next = queue._idle;
     // NOTE: to make sure the idle task is always scheduled last
-    _idle->_sliceEnd = _stamp + 1;
+    queue._idle->_sliceEnd = stamp + 1;
 
-    for (usize i = 0; i < _tasks.len(); ++i) {
-        auto &t = _tasks[i];
-        auto state = t->eval(_stamp);
+    for (usize i = 0; i < queue._tasks.len(); ++i) {
+        auto &t = queue._tasks[i];
+        auto state = t->eval(stamp);
         if (state == State::EXITED) {
             logInfo("{}: exited", *t);
-            _tasks.removeAt(i--);
+            queue._tasks.removeAt(i--);
         } else if (state == State::RUNNABLE and t->_sliceEnd <= next->_sliceEnd) {
             next = t;
         }
     }
 
-    _curr = next;
+    if (&*next == &*queue._idle) {
+        if (auto stolen = _steal(cpu)) {
+            next = *stolen;
+            queue._tasks.pushBack(stolen.take());
+        }
+    }
+
+    queue._curr = next;
 }
 
 } // namespace Hjert::Core
@@ -1,33 +1,61 @@
 #pragma once
 
 #include <handover/spec.h>
+#include <karm-base/atomic.h>
+#include <karm-base/box.h>
 #include <karm-base/rc.h>
 #include <karm-base/res.h>
 #include <karm-base/time.h>
 #include <karm-base/vec.h>
 
+#include "cpu.h"
+
 namespace Hjert::Core {
 
 struct Task;
 
 struct Sched {
-    Instant _stamp{};
-    Lock _lock{};
+    // Each processor owns a run queue, an idle processor steals runnable
+    // tasks from the others.
+    struct Queue {
+        Lock _lock{};
+
+        Vec<Arc<Task>> _tasks;
+        Arc<Task> _prev;
+        Arc<Task> _curr;
+        Arc<Task> _idle;
+
+        Queue(Arc<Task> idle);
+    };
 
-    Vec<Arc<Task>> _tasks;
-    Arc<Task> _prev;
-    Arc<Task> _curr;
-    Arc<Task> _idle;
+    // NOTE: Only the bootstrap processor advances the clock, other
+    //       processors tick on their own timer but only read it.
+    Atomic<_TimeVal> _stamp{};
+
+    Array<Opt<Box<Queue>>, MAX_CPUS> _queues{};
+    Atomic<usize> _len{};
 
     Sched(Arc<Task> boot);
 
+    Res<> attach(usize cpu, Arc<Task> idle);
+
+    Instant stamp() {
+        return _stamp.load(ACQUIRE);
+    }
+
+    Queue &local();
+
     Res<> enqueue(Arc<Task> task);
 
+    Opt<Arc<Task>> _steal(usize cpu);
+
     void schedule(Duration span);
 };
 
 Res<> initSched(Handover::Payload &payload);
 
+Res<> initSchedCpu();
+
 Sched &globalSched();
 
 } // namespace Hjert::Core
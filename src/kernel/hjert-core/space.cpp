@@ -91,10 +91,20 @@ Res<Hal::VmmRange> Space::map(Hal::VmmRange vrange, Arc<Vmo> vmo, usize off, Hj:
 }
 
 Res<> Space::unmap(Hal::VmmRange vrange) {
-    ObjectLockScope scope(*this);
-
     try$(vrange.ensureAligned(Hal::PAGE_SIZE));
 
+    // NOTE: The mapping is kept alive until the other processors dropped
+    //       their stale translations, so the vmo can't be reused under them.
+    auto map = try$(_unmap(vrange));
+    Arch::shootdown(map.vrange);
+    return Ok();
+}
+
+Res<Space::Map> Space::_unmap(Hal::VmmRange vrange) {
+    // NOTE: The shootdown must happen outside of the lock, a processor
+    //       spinning on it with interrupts disabled would never ack it.
+    ObjectLockScope scope(*this);
+
     auto id = try$(_lookup(vrange));
     auto &map = _maps[id];
 
@@ -102,8 +112,7 @@ Res<> Space::unmap(Hal::VmmRange vrange) {
     try$(_vmm->flush(map.vrange));
 
     _ranges.add(map.vrange);
-    _maps.removeAt(id);
-    return Ok();
+    return Ok(_maps.removeAt(id));
 }
 
 void Space::activate() {
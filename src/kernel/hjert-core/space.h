@@ -36,6 +36,8 @@ struct Space : public BaseObject<Space, Hj::Type::SPACE> {
 
     Res<Hal::VmmRange> map(Hal::VmmRange vrange, Arc<Vmo> vmo, usize off, Hj::MapFlags flags);
 
+    Res<Map> _unmap(Hal::VmmRange vrange);
+
     Res<> unmap(Hal::VmmRange vrange);
 
     void activate();
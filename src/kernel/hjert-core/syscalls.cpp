@@ -18,7 +18,7 @@ namespace Hjert::Core {
 static constexpr bool DEBUG_SYSCALLS = false;
 
 Res<> doNow(Task &self, User<Instant> ts) {
-    return ts.store(self.space(), globalSched()._stamp);
+    return ts.store(self.space(), globalSched().stamp());
 }
 
 Res<> doLog(Task &self, UserSlice<Str> msg) {
@@ -18,7 +18,7 @@ Res<Arc<Task>> Task::create(
 }
 
 Task &Task::self() {
-    return *globalSched()._curr;
+    return *globalSched().local()._curr;
 }
 
 Task::Task(
@@ -58,7 +58,7 @@ Res<> Task::ready(usize ip, usize sp, Hj::Args args) {
 
 Res<> Task::block(Blocker blocker) {
     // NOTE: If the blocker is already expired, don't block.
-    if (blocker() <= globalSched()._stamp)
+    if (blocker() <= globalSched().stamp())
         return Ok();
 
     // NOTE: Can't use ObjectLockScope here because
@@ -1,6 +1,8 @@
+#include <acpi/spec.h>
 #include <hal-x86_64/com.h>
 #include <hal-x86_64/gdt.h>
 #include <hal-x86_64/idt.h>
+#include <hal-x86_64/lapic.h>
 #include <hal-x86_64/pic.h>
 #include <hal-x86_64/pit.h>
 #include <hal-x86_64/simd.h>
@@ -14,6 +16,7 @@
 #include <hjert-core/space.h>
 #include <hjert-core/syscalls.h>
 #include <hjert-core/task.h>
+#include <karm-base/defer.h>
 #include <karm-base/witty.h>
 
 #include "ints.h"
@@ -26,27 +29,66 @@ static x86_64::DualPic _pic = x86_64::DualPic::dualPic();
 static x86_64::Pit _pit = x86_64::Pit::pit();
 
 static Array<Byte, Hal::PAGE_SIZE * 16> _kstack{};
-static x86_64::Tss _tss{};
-
-static x86_64::Gdt _gdt{_tss};
-static x86_64::GdtDesc _gdtDesc{_gdt};
 
 static x86_64::Idt _idt{};
 static x86_64::IdtDesc _idtDesc{_idt};
 
+// MARK: Cpu -------------------------------------------------------------------
+
+struct Cpu : public Core::Cpu {
+    x86_64::Tss _tss{};
+    x86_64::Gdt _gdt{_tss};
+    x86_64::GdtDesc _gdtDesc{_gdt};
+
+    Atomic<bool> _online{};
+    Atomic<bool> _shootdown{};
+
+    void load(usize kstack) {
+        _gdtDesc.load();
+        _tss = {};
+        _tss.rsp[0] = kstack;
+        x86_64::_tssUpdate();
+        _idtDesc.load();
+    }
+
+    void enableInterrupts() override {
+        x86_64::sti();
+    }
+
+    void disableInterrupts() override {
+        x86_64::cli();
+    }
+
+    void relaxe() override {
+        x86_64::hlt();
+    }
+};
+
+static Array<Cpu, Core::MAX_CPUS> _cpus{};
+static Array<u8, 256> _lapicToCpu{};
+static usize _cpuCount = 1;  // Processors online
+static usize _slotCount = 1; // Slots of _cpus handed out, retired ones included
+static Opt<x86_64::Lapic> _lapic = NONE;
+
+static Cpu &_localCpu() {
+    if (not _lapic)
+        return _cpus[0];
+    return _cpus[_lapicToCpu[_lapic->id()]];
+}
+
+Core::Cpu &globalCpu() {
+    return _localCpu();
+}
+
 Res<> init(Handover::Payload &) {
     try$(_com1.init());
 
-    _gdtDesc.load();
-    _tss = {};
-    _tss.rsp[0] = (u64)_kstack.bytes().end();
-    x86_64::_tssUpdate();
-
     for (usize i = 0; i < x86_64::Idt::LEN; i++) {
         _idt.entries[i] = x86_64::IdtEntry{_intVec[i], 0, x86_64::IdtEntry::GATE};
     }
 
-    _idtDesc.load();
+    _cpus[0].load((u64)_kstack.bytes().end());
+    _cpus[0]._online.store(true);
 
     try$(_pic.init());
     try$(_pit.init(1000));
@@ -68,26 +110,281 @@ void stop() {
     }
 }
 
-// MARK: Cpu -------------------------------------------------------------------
+// MARK: Smp -------------------------------------------------------------------
 
-struct Cpu : public Core::Cpu {
-    void enableInterrupts() override {
-        x86_64::sti();
+extern "C" ExternSym _smpTrampolineStart, _smpTrampolineEnd, _smpBoot;
+
+static constexpr u32 NO_CPU = ~0u;
+
+struct SmpBoot {
+    u64 cr3;
+    u64 stack;
+    u64 entry;
+
+    // The slot of the processor being started, swapped with NO_CPU by the
+    // first processor to run the trampoline, the others stop right there.
+    Atomic<u32> cpu;
+    u32 _pad;
+};
+
+static constexpr u8 INT_TIMER = 48;
+static constexpr u8 INT_SHOOTDOWN = 49;
+static constexpr u8 INT_SPURIOUS = 0xff;
+
+// NOTE: Past this many pages reloading cr3 is cheaper than invlpg
+static constexpr usize SHOOTDOWN_MAX_PAGES = 64;
+
+static u32 _timerTicks = 0;
+
+struct Shootdown {
+    Lock _lock;
+    Hal::VmmRange _range;
+    Atomic<usize> _pending;
+};
+
+static Shootdown _shootdown{};
+
+static void _flush(Hal::VmmRange vrange) {
+    if (vrange.size / Hal::PAGE_SIZE > SHOOTDOWN_MAX_PAGES) {
+        x86_64::wrcr3(x86_64::rdcr3());
+        return;
     }
 
-    void disableInterrupts() override {
-        x86_64::cli();
+    for (usize i = 0; i < vrange.size; i += Hal::PAGE_SIZE)
+        x86_64::invlpg(vrange.start + i);
+}
+
+static void _shootdownPoll() {
+    if (not _localCpu()._shootdown.xchg(false))
+        return;
+
+    _flush(_shootdown._range);
+    _shootdown._pending.dec();
+}
+
+void shootdown(Hal::VmmRange vrange) {
+    if (_cpuCount <= 1)
+        return;
+
+    // NOTE: Keep serving requests while waiting for the lock, the
+    //       processor holding it might be waiting on us.
+    while (not _shootdown._lock.tryAcquire()) {
+        _shootdownPoll();
+        x86_64::pause();
     }
 
-    void relaxe() override {
-        x86_64::hlt();
+    auto &self = _localCpu();
+    usize pending = 0;
+    for (usize i = 0; i < _slotCount; i++) {
+        auto &cpu = _cpus[i];
+        if (&cpu == &self or not cpu._online.load())
+            continue;
+        cpu._shootdown.store(true);
+        pending++;
     }
-};
 
-static Cpu _cpu{};
+    _shootdown._range = vrange;
+    _shootdown._pending.store(pending);
+    _lapic->broadcastIpi(INT_SHOOTDOWN);
 
-Core::Cpu &globalCpu() {
-    return _cpu;
+    while (_shootdown._pending.load())
+        x86_64::pause();
+
+    _shootdown._lock.release();
+}
+
+static Res<> _calibrateTimer() {
+    _lapic->startTimer(0xffffffff);
+    try$(_pit.wait(10));
+    _timerTicks = _lapic->elapsedTimer() / 10;
+    _lapic->stopTimer();
+
+    logInfo("smp: lapic timer: {} ticks/ms", _timerTicks);
+    return Ok();
+}
+
+static Acpi::Madt const *_findMadt(Handover::Payload &payload) {
+    auto const *record = payload.findTag(Handover::Tag::RSDP);
+    if (not record)
+        return nullptr;
+
+    auto const *rsdp = (Acpi::Rsdp const *)(Hal::UPPER_HALF + record->start);
+    auto const *rsdt = (Acpi::Rsdt const *)(Hal::UPPER_HALF + rsdp->rsdt);
+    usize len = (rsdt->len - sizeof(Acpi::Sdth)) / sizeof(u32);
+
+    for (usize i = 0; i < len; i++) {
+        auto const *sdth = (Acpi::Sdth const *)(Hal::UPPER_HALF + rsdt->children[i]);
+        if (Str{sdth->signature.buf(), sdth->signature.len()} == "APIC"s)
+            return (Acpi::Madt const *)sdth;
+    }
+
+    return nullptr;
+}
+
+extern "C" [[noreturn]] void _smpEntry(usize slot) {
+    auto &cpu = _cpus[slot];
+    _lapicToCpu[_lapic->id()] = slot;
+    cpu.load(cpu._tss.rsp[0]);
+
+    x86_64::simdInit();
+    x86_64::sysInit(_sysHandler);
+
+    _lapic->enable(INT_SPURIOUS);
+    _lapic->periodicTimer(INT_TIMER, _timerTicks);
+
+    Core::initSchedCpu()
+        .unwrap("failed to initialize cpu");
+    cpu._online.store(true);
+
+    Core::enterCpu();
+}
+
+static Res<bool> _waitOnline(Cpu &cpu, usize ms) {
+    for (usize i = 0; i < ms; i++) {
+        if (cpu._online.load())
+            return Ok(true);
+        try$(_pit.wait(1));
+    }
+    return Ok(cpu._online.load());
+}
+
+static Res<bool> _sendStartup(Cpu &cpu, u8 lapicId, usize ptrampoline) {
+    _lapic->sendInit(lapicId);
+    try$(_pit.wait(10));
+
+    for (usize attempt = 0; attempt < 2; attempt++) {
+        _lapic->sendStartup(lapicId, ptrampoline);
+        if (try$(_waitOnline(cpu, 100)))
+            return Ok(true);
+    }
+
+    return Ok(false);
+}
+
+// Starts a processor in the next free slot. Returns false if it didn't
+// start, its slot is then retired for good, so that it can't be shared
+// with the next one if the processor shows up after all.
+static Res<bool> _startCpu(SmpBoot &boot, usize ptrampoline, u8 lapicId) {
+    usize slot = _slotCount++;
+    auto &cpu = _cpus[slot];
+    cpu._id = _cpuCount;
+
+    auto kstack = try$(Core::kmm().allocRange(Hal::PAGE_SIZE * 16));
+    ArmedDefer freeKstack{[&] {
+        (void)Core::kmm().free(kstack);
+    }};
+
+    auto bootStack = try$(Core::kmm().allocRange(Hal::PAGE_SIZE * 16));
+    ArmedDefer freeBootStack{[&] {
+        (void)Core::kmm().free(bootStack);
+    }};
+
+    // NOTE: Cpu::load() picks it up once the processor is running
+    cpu._tss.rsp[0] = kstack.end();
+
+    boot.cr3 = globalVmm().root();
+    boot.stack = bootStack.end();
+    boot.entry = (usize)_smpEntry;
+    boot.cpu.store(slot);
+
+    auto started = _sendStartup(cpu, lapicId, ptrampoline);
+
+    // NOTE: Nobody claimed the slot, no processor can ever use it or its
+    //       stacks from now on.
+    if (boot.cpu.xchg(NO_CPU) != NO_CPU) {
+        try$(started);
+        return Ok(false);
+    }
+
+    // NOTE: A processor claimed the slot and is running on its stacks,
+    //       give it some more time to come online.
+    freeKstack.disarm();
+    freeBootStack.disarm();
+
+    if (started and started.unwrap())
+        return Ok(true);
+
+    if (try$(_waitOnline(cpu, 1000)))
+        return Ok(true);
+
+    // NOTE: It would attach to the scheduler with the same id as the next
+    //       processor if it came online later.
+    return Error::timedOut("cpu hung while starting");
+}
+
+static Res<> _startAps(Acpi::Madt const *madt, u8 bspId, Hal::PmmRange ptrampoline) {
+    // NOTE: The processors start in real mode from the trampoline and need
+    //       it identity mapped while they switch to long mode. It's left
+    //       mapped, as one that was given up on might still run from it.
+    auto trampoline = try$(Core::kmm().pmm2Kmm(ptrampoline));
+    copy(
+        Bytes{_smpTrampolineStart, (usize)(_smpTrampolineEnd - _smpTrampolineStart)},
+        trampoline.mutBytes()
+    );
+
+    auto identity = Hal::identityMapped(ptrampoline);
+    try$(globalVmm().mapRange(identity, ptrampoline, Hal::Vmm::READ | Hal::Vmm::WRITE | Hal::Vmm::EXEC));
+
+    usize bootOff = (usize)_smpBoot - (usize)_smpTrampolineStart;
+    auto &boot = *(SmpBoot *)(trampoline.start + bootOff);
+    boot.cpu.store(NO_CPU);
+
+    auto const *end = (u8 const *)madt + madt->len;
+    auto const *rec = (u8 const *)madt->records;
+    while (rec < end) {
+        auto const &record = *(Acpi::Madt::Record const *)rec;
+        rec += record.len;
+
+        if (record.type != (u8)Acpi::Madt::Type::LAPIC)
+            continue;
+
+        auto const &lapic = (Acpi::Madt::LapicRecord const &)record;
+        if (lapic.id == bspId or not(lapic.flags & 1))
+            continue;
+
+        if (_slotCount >= Core::MAX_CPUS) {
+            logWarn("smp: too many cpus, ignoring the others");
+            break;
+        }
+
+        logInfo("smp: starting cpu{} (lapic {})...", _cpuCount, lapic.id);
+        if (not try$(_startCpu(boot, ptrampoline.start, lapic.id))) {
+            logError("smp: cpu{} (lapic {}) did not start", _cpuCount, lapic.id);
+            continue;
+        }
+
+        _cpuCount++;
+    }
+
+    return Ok();
+}
+
+Res<> initSmp(Handover::Payload &payload, Opt<Hal::PmmRange> trampoline) {
+    _lapic = x86_64::Lapic::lapic(Hal::UPPER_HALF + x86_64::Lapic::base());
+    _lapic->enable(INT_SPURIOUS);
+    auto bspId = _lapic->id();
+    _lapicToCpu[bspId] = 0;
+
+    try$(_calibrateTimer());
+
+    auto const *madt = _findMadt(payload);
+    if (not madt) {
+        logWarn("smp: no madt found, running on a single cpu");
+    } else if (not trampoline) {
+        logWarn("smp: no low memory for the trampoline, running on a single cpu");
+    } else if (auto res = _startAps(madt, bspId, *trampoline); not res) {
+        // NOTE: The processors that did start keep running, losing the
+        //       others is not a reason to fail the boot.
+        logWarn("smp: could not start the other cpus: {}", res.none().msg());
+    }
+
+    logInfo("smp: {} cpu(s) online", _cpuCount);
+
+    // NOTE: Every processor now ticks on its own lapic timer.
+    _lapic->periodicTimer(INT_TIMER, _timerTicks);
+    try$(_pic.mask(0));
+
+    return Ok();
 }
 
 // MARK: Interrupts ------------------------------------------------------------
@@ -192,6 +489,14 @@ extern "C" void _intDispatch(usize sp) {
             kPanic(frame);
     } else if (frame.intNo == 100) {
         switchTask(0_ms, frame);
+    } else if (frame.intNo == INT_TIMER) {
+        _lapic->eoi();
+        switchTask(1_ms, frame);
+    } else if (frame.intNo == INT_SHOOTDOWN) {
+        _shootdownPoll();
+        _lapic->eoi();
+    } else if (frame.intNo == INT_SPURIOUS) {
+        // NOTE: Spurious interrupts must not be acknowledged
     } else {
         isize irq = frame.intNo - 32;
 
@@ -0,0 +1,107 @@
+; Application processor trampoline, copied into a page of low memory by the
+; bootstrap processor before it sends the startup IPI. The processor starts
+; in real mode with cs pointing at that page, so everything before the switch
+; to long mode is addressed relative to cs.
+
+%define OFF(x) (x - _smpTrampolineStart)
+
+section .text
+
+global _smpTrampolineStart
+global _smpTrampolineEnd
+global _smpBoot
+
+bits 16
+_smpTrampolineStart:
+    cli
+    cld
+
+    mov ax, cs
+    mov ds, ax
+
+    ; claim the boot block, a processor that was given up on and starts late
+    ; finds it already taken and parks, before touching the shared stack
+    mov esi, 0xffffffff
+    xchg dword [OFF(_smpBoot.cpu)], esi
+    cmp esi, 0xffffffff
+    je .park
+
+    mov ss, ax
+    mov sp, 0x1000 ; top of the trampoline page
+
+    ; linear address of the trampoline
+    xor ebx, ebx
+    mov bx, cs
+    shl ebx, 4
+
+    lea eax, [ebx + OFF(_smpGdt)]
+    mov dword [OFF(_smpGdtDesc) + 2], eax
+
+    mov eax, cr4
+    or eax, (1 << 5) | (1 << 7) ; PAE | PGE
+    mov cr4, eax
+
+    mov eax, dword [OFF(_smpBoot.cr3)] ; the kernel pml4 lives below 4GiB
+    mov cr3, eax
+
+    mov ecx, 0xc0000080 ; EFER
+    rdmsr
+    or eax, (1 << 8)    ; LME
+    wrmsr
+
+    mov eax, cr0
+    or eax, (1 << 31) | (1 << 0) ; PG | PE
+    mov cr0, eax
+
+    lgdt [OFF(_smpGdtDesc)]
+
+    lea eax, [ebx + OFF(_smpLongMode)]
+    push dword 0x08
+    push eax
+    o32 retf
+
+.park:
+    cli
+    hlt
+    jmp .park
+
+bits 64
+_smpLongMode:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov ss, ax
+
+    mov rsp, qword [rel _smpBoot.stack]
+    mov edi, esi ; the slot claimed in real mode
+    mov rax, qword [rel _smpBoot.entry]
+    call rax
+
+.halt:
+    cli
+    hlt
+    jmp .halt
+
+align 16
+_smpGdt:
+    dq 0
+    dq 0x00af9a000000ffff ; kernel code
+    dq 0x00cf92000000ffff ; kernel data
+
+_smpGdtDesc:
+    dw _smpGdtDesc - _smpGdt - 1
+    dd 0
+
+align 8
+_smpBoot:
+.cr3:
+    dq 0
+.stack:
+    dq 0
+.entry:
+    dq 0
+.cpu:
+    dd 0
+    dd 0 ; padding
+
+_smpTrampolineEnd:
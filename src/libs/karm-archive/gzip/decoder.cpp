@@ -0,0 +1,125 @@
+#include <karm-io/impls.h>
+
+#include "decoder.h"
+
+namespace Gzip {
+
+Res<> Decoder::_readHeader() {
+    Crypto::Crc32 crc;
+
+    Array<u8, HEADER_LEN> hdr;
+    try$(_inflate.readRaw(hdr));
+    crc.update(hdr);
+
+    if (hdr[0] != ID1 or hdr[1] != ID2)
+        return Error::invalidData("invalid signature");
+
+    if (hdr[2] != CM_DEFLATE)
+        return Error::invalidData("unsupported compression method");
+
+    u8 flg = hdr[3];
+    if (flg & FLG_RESERVED)
+        return Error::invalidData("reserved flags set");
+
+    if (flg & FLG_FEXTRA) {
+        Array<u8, 2> xlen;
+        try$(_inflate.readRaw(xlen));
+        crc.update(xlen);
+
+        Array<u8, 256> skip;
+        usize left = xlen[0] | (xlen[1] << 8);
+        while (left) {
+            auto chunk = mutSub(skip, 0, min(left, skip.len()));
+            try$(_inflate.readRaw(chunk));
+            crc.update(chunk);
+            left -= chunk.len();
+        }
+    }
+
+    // The file name and comment are zero terminated
+    for (u8 flag : {FLG_FNAME, FLG_FCOMMENT}) {
+        if (not(flg & flag))
+            continue;
+
+        Array<u8, 1> c = {0xff};
+        while (c[0] != 0) {
+            try$(_inflate.readRaw(c));
+            crc.update(c[0]);
+        }
+    }
+
+    if (flg & FLG_FHCRC) {
+        Array<u8, 2> hcrc;
+        try$(_inflate.readRaw(hcrc));
+        if ((hcrc[0] | (hcrc[1] << 8)) != (crc.digest() & 0xffff))
+            return Error::invalidData("header crc mismatch");
+    }
+
+    _header = true;
+    return Ok();
+}
+
+Res<> Decoder::_readTrailer() {
+    Array<u8, TRAILER_LEN> trailer;
+    try$(_inflate.readRaw(trailer));
+
+    u32 crc = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (trailer[3] << 24);
+    u32 isize = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | (trailer[7] << 24);
+
+    if (crc != _crc.digest())
+        return Error::invalidData("crc32 mismatch");
+
+    if (isize != (u32)_size)
+        return Error::invalidData("size mismatch");
+
+    _trailer = true;
+    return Ok();
+}
+
+void Decoder::_update(Bytes bytes) {
+    _crc.update(bytes);
+    _size += bytes.len();
+}
+
+Res<Bytes> Decoder::next() {
+    if (not _header)
+        try$(_readHeader());
+
+    auto chunk = try$(_inflate.next());
+    _update(chunk);
+
+    if (isEmpty(chunk) and not _trailer)
+        try$(_readTrailer());
+
+    return Ok(chunk);
+}
+
+Res<usize> Decoder::read(MutBytes bytes) {
+    if (not _header)
+        try$(_readHeader());
+
+    usize n = try$(_inflate.read(bytes));
+    _update(sub(bytes, 0, n));
+
+    if (n == 0 and not _trailer)
+        try$(_readTrailer());
+
+    return Ok(n);
+}
+
+Res<Buf<u8>> decode(Bytes bytes) {
+    Io::BufReader reader{bytes};
+    Decoder decoder{reader};
+    Buf<u8> res;
+
+    while (true) {
+        auto chunk = try$(decoder.next());
+        if (isEmpty(chunk))
+            break;
+        res.insert(COPY, res.len(), chunk.buf(), chunk.len());
+    }
+
+    return Ok(std::move(res));
+}
+
+} // namespace Gzip
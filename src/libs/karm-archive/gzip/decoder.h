@@ -0,0 +1,34 @@
+#pragma once
+
+#include <karm-crypto/crc32.h>
+
+#include "../inflate/decoder.h"
+#include "spec.h"
+
+namespace Gzip {
+
+// Streaming decoder for a gzip member, the CRC-32 and size stored in the
+// trailer are checked once the compressed data ended.
+struct Decoder : public Io::Reader {
+    Inflate::Decoder _inflate;
+    bool _header = false;
+    bool _trailer = false;
+    Crypto::Crc32 _crc;
+    usize _size = 0;
+
+    Decoder(Io::Reader& reader) : _inflate(reader) {}
+
+    Res<usize> read(MutBytes bytes) override;
+
+    Res<Bytes> next();
+
+    Res<> _readHeader();
+
+    Res<> _readTrailer();
+
+    void _update(Bytes bytes);
+};
+
+Res<Buf<u8>> decode(Bytes bytes);
+
+} // namespace Gzip
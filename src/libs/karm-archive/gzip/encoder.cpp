@@ -0,0 +1,33 @@
+#include <karm-crypto/crc32.h>
+
+#include "encoder.h"
+
+namespace Gzip {
+
+Res<> encode(Bytes bytes, Io::Writer& writer, usize level) {
+    u8 xfl = level >= Inflate::BEST_LEVEL ? XFL_BEST : level <= Inflate::FAST_LEVEL ? XFL_FAST : 0;
+
+    // NOTE: No file name and no modification time, like `gzip -n`
+    Array<u8, HEADER_LEN> hdr = {ID1, ID2, CM_DEFLATE, 0, 0, 0, 0, 0, xfl, OS_UNKNOWN};
+    try$(writer.write(hdr));
+
+    try$(Inflate::encode(bytes, writer, level));
+
+    u32 crc = Crypto::crc32(bytes);
+    u32 isize = bytes.len();
+    Array<u8, TRAILER_LEN> trailer = {
+        (u8)crc,
+        (u8)(crc >> 8),
+        (u8)(crc >> 16),
+        (u8)(crc >> 24),
+        (u8)isize,
+        (u8)(isize >> 8),
+        (u8)(isize >> 16),
+        (u8)(isize >> 24),
+    };
+    try$(writer.write(trailer));
+
+    return Ok();
+}
+
+} // namespace Gzip
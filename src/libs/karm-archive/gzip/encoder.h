@@ -0,0 +1,10 @@
+#pragma once
+
+#include "../inflate/encoder.h"
+#include "spec.h"
+
+namespace Gzip {
+
+Res<> encode(Bytes bytes, Io::Writer& writer, usize level = Inflate::DEFAULT_LEVEL);
+
+} // namespace Gzip
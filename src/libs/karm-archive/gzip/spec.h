@@ -1,5 +1,28 @@
 #pragma once
 
+// https://www.rfc-editor.org/rfc/rfc1952
+
+#include <karm-base/base.h>
+
 namespace Gzip {
 
+static constexpr u8 ID1 = 0x1f;
+static constexpr u8 ID2 = 0x8b;
+static constexpr u8 CM_DEFLATE = 8;
+
+static constexpr u8 FLG_FTEXT = 1 << 0;
+static constexpr u8 FLG_FHCRC = 1 << 1;
+static constexpr u8 FLG_FEXTRA = 1 << 2;
+static constexpr u8 FLG_FNAME = 1 << 3;
+static constexpr u8 FLG_FCOMMENT = 1 << 4;
+static constexpr u8 FLG_RESERVED = 0xe0;
+
+static constexpr u8 XFL_BEST = 2;
+static constexpr u8 XFL_FAST = 4;
+
+static constexpr u8 OS_UNKNOWN = 255;
+
+static constexpr usize HEADER_LEN = 10;
+static constexpr usize TRAILER_LEN = 8;
+
 } // namespace Gzip
@@ -0,0 +1,513 @@
+#include <karm-io/impls.h>
+
+#include "decoder.h"
+
+namespace Inflate {
+
+// MARK: Huffman ---------------------------------------------------------------
+
+static constexpr u32 _reverseBits(u32 code, usize len) {
+    u32 res = 0;
+    for (usize i = 0; i < len; i++) {
+        res = (res << 1) | (code & 1);
+        code >>= 1;
+    }
+    return res;
+}
+
+template <usize ROOT, usize SIZE>
+Res<> Huffman<ROOT, SIZE>::build(Slice<u8> lens, auto encode) {
+    Array<u16, MAX_BITS + 1> count{};
+    for (auto l : lens)
+        count[l]++;
+    count[0] = 0;
+
+    isize left = 1;
+    for (usize l = 1; l <= MAX_BITS; l++) {
+        left = (left << 1) - count[l];
+        if (left < 0)
+            return Error::invalidData("over-subscribed huffman code");
+    }
+
+    // NOTE: Incomplete codes are allowed, unused entries are left invalid
+    //       and only trip if the stream actually uses them.
+    for (usize i = 0; i <= MASK; i++)
+        _entries[i] = entry(INVALID, 0);
+
+    Array<u32, MAX_BITS + 1> next{};
+    u32 code = 0;
+    for (usize l = 1; l <= MAX_BITS; l++) {
+        code = (code + count[l - 1]) << 1;
+        next[l] = code;
+    }
+
+    // First pass, short codes go straight into the root table and we find
+    // out how deep the second level table behind each prefix must be.
+    Array<u8, 1 << ROOT> depth{};
+    Array<u16, NUM_LITLEN> codes{};
+
+    for (usize sym = 0; sym < lens.len(); sym++) {
+        usize l = lens[sym];
+        if (not l)
+            continue;
+
+        u32 rev = _reverseBits(next[l]++, l);
+        codes[sym] = rev;
+
+        if (l <= ROOT) {
+            u32 e = encode(sym) | l;
+            for (u32 i = rev; i <= MASK; i += 1 << l)
+                _entries[i] = e;
+        } else {
+            auto& d = depth[rev & MASK];
+            d = max(d, (u8)(l - ROOT));
+        }
+    }
+
+    // Second pass, lay out the second level tables after the root table.
+    usize offset = MASK + 1;
+    Array<u16, 1 << ROOT> tables{};
+
+    for (usize prefix = 0; prefix <= MASK; prefix++) {
+        if (not depth[prefix])
+            continue;
+
+        usize size = 1 << depth[prefix];
+        if (offset + size > SIZE)
+            return Error::invalidData("huffman table overflow");
+
+        tables[prefix] = offset;
+        _entries[prefix] = entry(SUBTABLE, offset, depth[prefix], ROOT);
+        for (usize i = 0; i < size; i++)
+            _entries[offset + i] = entry(INVALID, 0);
+        offset += size;
+    }
+
+    for (usize sym = 0; sym < lens.len(); sym++) {
+        usize l = lens[sym];
+        if (l <= ROOT)
+            continue;
+
+        u32 rev = codes[sym];
+        usize prefix = rev & MASK;
+        usize size = 1 << depth[prefix];
+        u32 e = encode(sym) | (l - ROOT);
+        for (usize i = rev >> ROOT; i < size; i += 1 << (l - ROOT))
+            _entries[tables[prefix] + i] = e;
+    }
+
+    return Ok();
+}
+
+template <usize ROOT, usize SIZE>
+void Huffman<ROOT, SIZE>::pairLiterals() {
+    Array<u32, 1 << ROOT> single;
+    for (usize i = 0; i <= MASK; i++)
+        single[i] = _entries[i];
+
+    for (usize i = 0; i <= MASK; i++) {
+        u32 first = single[i];
+        if (kind(first) != LITERAL or len(first) >= ROOT)
+            continue;
+
+        // NOTE: The high bits of the index are unknown, the second code
+        //       only counts if it fits in the bits we actually have.
+        u32 second = single[i >> len(first)];
+        if (kind(second) != LITERAL or len(first) + len(second) > ROOT)
+            continue;
+
+        _entries[i] = entry(
+            LITERAL2,
+            value(first) | (value(second) << 8),
+            0,
+            len(first) + len(second)
+        );
+    }
+}
+
+static u32 _litlenEntry(usize sym) {
+    if (sym < 256)
+        return LitlenTable::entry(LitlenTable::LITERAL, sym);
+    if (sym == END_OF_BLOCK)
+        return LitlenTable::entry(LitlenTable::END, 0);
+    if (sym - 257 < LENGTH_BASE.len())
+        return LitlenTable::entry(LitlenTable::LENGTH, LENGTH_BASE[sym - 257], LENGTH_EXTRA[sym - 257]);
+    return LitlenTable::entry(LitlenTable::INVALID, 0);
+}
+
+static u32 _distEntry(usize sym) {
+    if (sym < DIST_BASE.len())
+        return DistTable::entry(DistTable::SYMBOL, DIST_BASE[sym], DIST_EXTRA[sym]);
+    return DistTable::entry(DistTable::INVALID, 0);
+}
+
+static u32 _codelenEntry(usize sym) {
+    return CodelenTable::entry(CodelenTable::SYMBOL, sym);
+}
+
+// MARK: Bits ------------------------------------------------------------------
+
+Res<bool> Decoder::_fill() {
+    usize rem = _inLen - _inPos;
+    memmove(_in.buf(), _in.buf() + _inPos, rem);
+    _inPos = 0;
+    _inLen = rem;
+
+    usize n = try$(_reader.read(mutNext(_in, rem)));
+    _inLen += n;
+    return Ok(n != 0);
+}
+
+Res<> Decoder::_refillSlow() {
+    while (_nbits <= 56) {
+        if (_inPos == _inLen and not try$(_fill())) {
+            // NOTE: Past the end of the input, pad with zeros so the
+            //       decoder can look ahead, _take() checks that they are
+            //       never actually consumed.
+            if (_overrun > 16)
+                return Error::invalidData("unexpected end of data");
+            _overrun++;
+            _nbits += 8;
+            continue;
+        }
+
+        if (_inLen - _inPos >= 8)
+            return _refill();
+
+        _bits |= (u64)_in[_inPos++] << _nbits;
+        _nbits += 8;
+    }
+    return Ok();
+}
+
+Res<u32> Decoder::_take(usize n) {
+    if (_nbits < n)
+        try$(_refill());
+
+    if (_nbits - n < _overrun * 8)
+        return Error::invalidData("unexpected end of data");
+
+    u32 v = _bits & ((1ull << n) - 1);
+    _bits >>= n;
+    _nbits -= n;
+    return Ok(v);
+}
+
+void Decoder::_align() {
+    usize n = _nbits % 8;
+    _bits >>= n;
+    _nbits -= n;
+}
+
+Res<> Decoder::readRaw(MutBytes bytes) {
+    _align();
+
+    auto [buf, len] = bytes;
+
+    // Whole bytes that were already pulled into the bit buffer come first.
+    while (len and _nbits > _overrun * 8) {
+        *buf++ = _bits;
+        _bits >>= 8;
+        _nbits -= 8;
+        len--;
+    }
+
+    if (_nbits == 0) {
+        // NOTE: Whatever is left above _nbits mirrors bytes that are about
+        //       to be read here, so it must not be merged back in later.
+        _bits = 0;
+    }
+
+    while (len) {
+        if (_inPos == _inLen and not try$(_fill()))
+            return Error::invalidData("unexpected end of data");
+
+        usize n = min(len, _inLen - _inPos);
+        memcpy(buf, _in.buf() + _inPos, n);
+        _inPos += n;
+        buf += n;
+        len -= n;
+    }
+
+    return Ok();
+}
+
+// MARK: Blocks ----------------------------------------------------------------
+
+Res<> Decoder::_header() {
+    if (_final) {
+        if (_nbits < _overrun * 8)
+            return Error::invalidData("unexpected end of data");
+        _state = _State::DONE;
+        return Ok();
+    }
+
+    _final = try$(_take(1));
+    auto type = (BlockType)try$(_take(2));
+
+    if (type == BlockType::STORED) {
+        Array<u8, 4> hdr;
+        try$(readRaw(mutBytes(hdr)));
+        u16 len = hdr[0] | (hdr[1] << 8);
+        u16 nlen = hdr[2] | (hdr[3] << 8);
+        if (len != (u16)~nlen)
+            return Error::invalidData("invalid stored block length");
+        _storedLeft = len;
+        _state = _State::STORED;
+    } else if (type == BlockType::FIXED) {
+        static constexpr auto LITLEN = fixedLitlenLengths();
+        static constexpr auto DIST = fixedDistLengths();
+        try$(_litlen.build(LITLEN, _litlenEntry));
+        _litlen.pairLiterals();
+        try$(_dist.build(DIST, _distEntry));
+        _state = _State::HUFFMAN;
+    } else if (type == BlockType::DYNAMIC) {
+        try$(_dynamicTables());
+        _state = _State::HUFFMAN;
+    } else {
+        return Error::invalidData("invalid block type");
+    }
+
+    return Ok();
+}
+
+Res<> Decoder::_dynamicTables() {
+    usize hlit = try$(_take(5)) + 257;
+    usize hdist = try$(_take(5)) + 1;
+    usize hclen = try$(_take(4)) + 4;
+
+    if (hlit > 286 or hdist > 30)
+        return Error::invalidData("invalid code counts");
+
+    Array<u8, NUM_CODELEN> codelenLens{};
+    for (usize i = 0; i < hclen; i++)
+        codelenLens[CODELEN_ORDER[i]] = try$(_take(3));
+
+    CodelenTable codelen;
+    try$(codelen.build(codelenLens, _codelenEntry));
+
+    Array<u8, NUM_LITLEN + NUM_DIST> lens{};
+    usize i = 0;
+    while (i < hlit + hdist) {
+        if (_nbits < 16)
+            try$(_refill());
+        u32 e = codelen.lookup(_bits, _nbits);
+        if (CodelenTable::kind(e) != CodelenTable::SYMBOL)
+            return Error::invalidData("invalid code length code");
+
+        u32 sym = CodelenTable::value(e);
+        if (sym < 16) {
+            lens[i++] = sym;
+            continue;
+        }
+
+        u8 val = 0;
+        usize rep;
+        if (sym == 16) {
+            if (i == 0)
+                return Error::invalidData("repeat without previous length");
+            val = lens[i - 1];
+            rep = 3 + try$(_take(2));
+        } else if (sym == 17) {
+            rep = 3 + try$(_take(3));
+        } else {
+            rep = 11 + try$(_take(7));
+        }
+
+        if (i + rep > hlit + hdist)
+            return Error::invalidData("code lengths overflow");
+
+        while (rep--)
+            lens[i++] = val;
+    }
+
+    if (_nbits < _overrun * 8)
+        return Error::invalidData("unexpected end of data");
+
+    if (lens[END_OF_BLOCK] == 0)
+        return Error::invalidData("missing end of block code");
+
+    try$(_litlen.build(sub(lens, 0, hlit), _litlenEntry));
+    _litlen.pairLiterals();
+    try$(_dist.build(sub(lens, hlit, hlit + hdist), _distEntry));
+
+    return Ok();
+}
+
+Res<> Decoder::_stored() {
+    usize n = min(_storedLeft, WINDOW_LIMIT - _pos);
+    try$(readRaw(mutSub(_window, _pos, _pos + n)));
+    _pos += n;
+    _storedLeft -= n;
+    if (_storedLeft == 0)
+        _state = _State::HEADER;
+    return Ok();
+}
+
+Res<> Decoder::_huffman() {
+    using L = LitlenTable;
+    using D = DistTable;
+
+    // NOTE: Everything used in the loop is kept in locals, stores to the
+    //       output would otherwise force the compiler to reload them.
+    u8* out = _window.buf();
+    usize pos = _pos;
+    u64 bits = _bits;
+    usize nbits = _nbits;
+    usize inPos = _inPos;
+    usize inLen = _inLen;
+    u8 const* in = _in.buf();
+
+    auto flush = [&] {
+        _pos = pos;
+        _bits = bits;
+        _nbits = nbits;
+        _inPos = inPos;
+    };
+
+    while (pos < WINDOW_LIMIT) {
+        // NOTE: One refill is enough for the longest symbol: 15 bits of
+        //       length code, 5 extra bits, 15 bits of distance code and
+        //       13 extra bits.
+        if (nbits < 48) {
+            if (inLen - inPos >= 8) [[likely]] {
+                u64 v;
+                memcpy(&v, in + inPos, 8);
+                bits |= toLe(v) << nbits;
+                inPos += (63 - nbits) >> 3;
+                nbits |= 56;
+            } else {
+                flush();
+                try$(_refillSlow());
+                bits = _bits;
+                nbits = _nbits;
+                inPos = _inPos;
+                inLen = _inLen;
+            }
+        }
+
+        u32 e = _litlen.lookup(bits, nbits);
+        auto kind = L::kind(e);
+
+        if (kind == L::LITERAL) [[likely]] {
+            out[pos++] = L::value(e);
+            continue;
+        }
+
+        if (kind == L::LITERAL2) {
+            u32 v = L::value(e);
+            out[pos] = v;
+            out[pos + 1] = v >> 8;
+            pos += 2;
+            continue;
+        }
+
+        if (kind == L::END) {
+            _state = _State::HEADER;
+            break;
+        }
+
+        if (kind != L::LENGTH)
+            return Error::invalidData("invalid literal/length code");
+
+        usize len = L::value(e) + (bits & ((1u << L::extra(e)) - 1));
+        bits >>= L::extra(e);
+        nbits -= L::extra(e);
+
+        u32 d = _dist.lookup(bits, nbits);
+        if (D::kind(d) != D::SYMBOL)
+            return Error::invalidData("invalid distance code");
+
+        usize dist = D::value(d) + (bits & ((1u << D::extra(d)) - 1));
+        bits >>= D::extra(d);
+        nbits -= D::extra(d);
+
+        if (dist > pos)
+            return Error::invalidData("distance too far back");
+
+        u8* dst = out + pos;
+        u8 const* src = dst - dist;
+        pos += len;
+
+        if (dist >= 8) {
+            // NOTE: Copies in 8 bytes chunks and may write past the end of
+            //       the match, the window has slack for that.
+            for (usize i = 0; i < len; i += 8) {
+                u64 chunk;
+                memcpy(&chunk, src + i, 8);
+                memcpy(dst + i, &chunk, 8);
+            }
+        } else if (dist == 1) {
+            memset(dst, *src, len);
+        } else {
+            for (usize i = 0; i < len; i++)
+                dst[i] = src[i];
+        }
+    }
+
+    flush();
+    if (_nbits < _overrun * 8)
+        return Error::invalidData("unexpected end of data");
+    return Ok();
+}
+
+Res<> Decoder::_decode() {
+    if (_pos > WINDOW_SIZE) {
+        memmove(_window.buf(), _window.buf() + _pos - WINDOW_SIZE, WINDOW_SIZE);
+        _pos = WINDOW_SIZE;
+        _read = WINDOW_SIZE;
+    }
+
+    while (_pos < WINDOW_LIMIT and _state != _State::DONE) {
+        if (_state == _State::HEADER)
+            try$(_header());
+        else if (_state == _State::STORED)
+            try$(_stored());
+        else
+            try$(_huffman());
+    }
+
+    return Ok();
+}
+
+Res<Bytes> Decoder::next() {
+    while (_read == _pos) {
+        if (_state == _State::DONE)
+            return Ok(Bytes{});
+        try$(_decode());
+    }
+
+    Bytes chunk = sub(_window, _read, _pos);
+    _read = _pos;
+    return Ok(chunk);
+}
+
+Res<usize> Decoder::read(MutBytes bytes) {
+    while (_read == _pos) {
+        if (_state == _State::DONE)
+            return Ok(0uz);
+        try$(_decode());
+    }
+
+    usize n = min(bytes.len(), _pos - _read);
+    memcpy(bytes.buf(), _window.buf() + _read, n);
+    _read += n;
+    return Ok(n);
+}
+
+Res<Buf<u8>> decode(Bytes bytes) {
+    Io::BufReader reader{bytes};
+    Decoder decoder{reader};
+    Buf<u8> res;
+
+    while (true) {
+        auto chunk = try$(decoder.next());
+        if (isEmpty(chunk))
+            break;
+        res.insert(COPY, res.len(), chunk.buf(), chunk.len());
+    }
+
+    return Ok(std::move(res));
+}
+
+} // namespace Inflate
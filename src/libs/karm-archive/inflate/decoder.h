@@ -0,0 +1,166 @@
+#pragma once
+
+#include <karm-base/buf.h>
+#include <karm-io/traits.h>
+
+#include "spec.h"
+
+namespace Inflate {
+
+// MARK: Huffman ---------------------------------------------------------------
+
+// Canonical Huffman code decoded with a single lookup indexed by the next
+// ROOT bits of the stream. Codes longer than ROOT bits go through a second
+// level table. Each entry packs everything needed to decode a symbol:
+//
+//   [0..8)   number of bits the code occupies
+//   [8..12)  number of extra bits following the code
+//   [12..16) kind of the entry
+//   [16..32) value (literal(s), base length, base distance, or table offset)
+template <usize ROOT, usize SIZE>
+struct Huffman {
+    enum Kind : u32 {
+        LITERAL,
+        LITERAL2,
+        LENGTH,
+        END,
+        SYMBOL,
+        SUBTABLE,
+        INVALID,
+    };
+
+    static constexpr u32 MASK = (1 << ROOT) - 1;
+
+    Array<u32, SIZE> _entries{};
+
+    static constexpr u32 entry(Kind kind, u32 value, u32 extra = 0, u32 len = 0) {
+        return len | (extra << 8) | (kind << 12) | (value << 16);
+    }
+
+    always_inline static u32 len(u32 e) { return e & 0xff; }
+
+    always_inline static u32 extra(u32 e) { return (e >> 8) & 0xf; }
+
+    always_inline static Kind kind(u32 e) { return (Kind)((e >> 12) & 0xf); }
+
+    always_inline static u32 value(u32 e) { return e >> 16; }
+
+    // Looks up the entry for the code at the start of bits, a second level
+    // entry has its length relative to the ROOT bits already consumed.
+    always_inline u32 lookup(u64& bits, usize& nbits) const {
+        u32 e = _entries[bits & MASK];
+        if (kind(e) == SUBTABLE) [[unlikely]] {
+            bits >>= ROOT;
+            nbits -= ROOT;
+            e = _entries[value(e) + (bits & ((1u << extra(e)) - 1))];
+        }
+        bits >>= len(e);
+        nbits -= len(e);
+        return e;
+    }
+
+    Res<> build(Slice<u8> lens, auto encode);
+
+    // Merges pairs of short literal codes into a single entry, so runs of
+    // literals decode two at a time.
+    void pairLiterals();
+};
+
+using LitlenTable = Huffman<11, 2048 + 16 * NUM_LITLEN>;
+using DistTable = Huffman<8, 256 + 128 * NUM_DIST>;
+using CodelenTable = Huffman<7, 128>;
+
+// MARK: Decoder ---------------------------------------------------------------
+
+// Streaming decoder for raw DEFLATE data, compressed bytes are pulled from
+// the underlying reader as needed and decompressed bytes are handed out
+// through read().
+struct Decoder : public Io::Reader {
+    enum struct _State {
+        HEADER,
+        STORED,
+        HUFFMAN,
+        DONE,
+    };
+
+    // Decoded bytes are kept in a window that holds the last WINDOW_SIZE
+    // bytes for back references plus some room to decode ahead.
+    static constexpr usize WINDOW_CAP = WINDOW_SIZE * 3;
+    static constexpr usize WINDOW_LIMIT = WINDOW_CAP - MAX_MATCH - 16;
+
+    Io::Reader& _reader;
+
+    Array<u8, 4096> _in;
+    usize _inPos = 0;
+    usize _inLen = 0;
+    usize _overrun = 0;
+
+    u64 _bits = 0;
+    usize _nbits = 0;
+
+    _State _state = _State::HEADER;
+    bool _final = false;
+    usize _storedLeft = 0;
+
+    LitlenTable _litlen;
+    DistTable _dist;
+
+    Buf<u8> _window = Buf<u8>::init(WINDOW_CAP);
+    usize _pos = 0;
+    usize _read = 0;
+
+    Decoder(Io::Reader& reader) : _reader(reader) {}
+
+    Res<usize> read(MutBytes bytes) override;
+
+    // Decodes and returns the next chunk of data without an extra copy, the
+    // bytes stay valid until the next call and are empty at the end.
+    Res<Bytes> next();
+
+    // True once the final block was decoded and every byte was read.
+    bool ended() const {
+        return _state == _State::DONE and _read == _pos;
+    }
+
+    // Reads bytes that are not part of the compressed data, starting at the
+    // next byte boundary (eg. the header or trailer of a container format).
+    Res<> readRaw(MutBytes bytes);
+
+    // MARK: Bits --------------------------------------------------------------
+
+    Res<bool> _fill();
+
+    Res<> _refillSlow();
+
+    always_inline Res<> _refill() {
+        if (_inLen - _inPos >= 8) [[likely]] {
+            u64 v;
+            memcpy(&v, _in.buf() + _inPos, 8);
+            _bits |= toLe(v) << _nbits;
+            _inPos += (63 - _nbits) >> 3;
+            _nbits |= 56;
+            return Ok();
+        }
+        return _refillSlow();
+    }
+
+    Res<u32> _take(usize n);
+
+    void _align();
+
+    // MARK: Blocks ------------------------------------------------------------
+
+    Res<> _header();
+
+    Res<> _dynamicTables();
+
+    Res<> _stored();
+
+    Res<> _huffman();
+
+    Res<> _decode();
+};
+
+Res<Buf<u8>> decode(Bytes bytes);
+
+} // namespace Inflate
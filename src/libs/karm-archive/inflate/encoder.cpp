@@ -0,0 +1,575 @@
+#include <karm-base/vec.h>
+
+#include "encoder.h"
+
+namespace Inflate {
+
+// MARK: Levels ----------------------------------------------------------------
+
+struct _Level {
+    usize maxChain;
+    usize niceLen;
+    usize goodLen;
+    bool lazy;
+};
+
+static constexpr Array<_Level, 10> _LEVELS = {
+    _Level{0, 0, 0, false},
+    _Level{4, 8, 4, false},
+    _Level{8, 16, 5, false},
+    _Level{32, 32, 6, false},
+    _Level{16, 16, 4, true},
+    _Level{32, 32, 8, true},
+    _Level{128, 128, 8, true},
+    _Level{256, 128, 8, true},
+    _Level{1024, 258, 32, true},
+    _Level{4096, 258, 32, true},
+};
+
+// MARK: Codes -----------------------------------------------------------------
+
+static constexpr Array<u8, MAX_MATCH + 1> _LENGTH_CODE = [] {
+    Array<u8, MAX_MATCH + 1> res{};
+    for (usize code = 0; code < LENGTH_BASE.len(); code++) {
+        usize end = code + 1 < LENGTH_BASE.len() ? LENGTH_BASE[code + 1] : MAX_MATCH + 1;
+        for (usize len = LENGTH_BASE[code]; len < end; len++)
+            res[len] = code;
+    }
+    // NOTE: 258 has its own code even though 227 + 31 would also reach it
+    res[MAX_MATCH] = LENGTH_BASE.len() - 1;
+    return res;
+}();
+
+// Distances up to 256 are looked up directly, larger ones by their upper
+// bits, the same trick zlib uses.
+static constexpr Array<u8, 512> _DIST_CODE = [] {
+    Array<u8, 512> res{};
+    for (usize code = 0; code < DIST_BASE.len(); code++) {
+        usize end = code + 1 < DIST_BASE.len() ? DIST_BASE[code + 1] : WINDOW_SIZE + 1;
+        for (usize dist = DIST_BASE[code]; dist < end; dist++) {
+            if (dist <= 256)
+                res[dist - 1] = code;
+            else
+                res[256 + ((dist - 1) >> 7)] = code;
+        }
+    }
+    return res;
+}();
+
+always_inline static usize _distCode(usize dist) {
+    return dist <= 256 ? _DIST_CODE[dist - 1] : _DIST_CODE[256 + ((dist - 1) >> 7)];
+}
+
+// Computes length limited Huffman code lengths from symbol frequencies.
+// When the tree gets too deep the frequencies are flattened and the tree is
+// rebuilt, which converges in a couple of rounds.
+static void _buildLengths(Slice<u32> freqs, MutSlice<u8> lens, usize limit) {
+    usize n = freqs.len();
+
+    Buf<u32> weights = Buf<u32>::init(n);
+    for (usize i = 0; i < n; i++)
+        weights[i] = freqs[i];
+
+    usize used = 0;
+    for (usize i = 0; i < n; i++)
+        used += weights[i] != 0;
+
+    // NOTE: Decoders want at least two codes, even when only one symbol
+    //       (or none) is used.
+    for (usize i = 0; used < 2 and i < n; i++) {
+        if (not weights[i]) {
+            weights[i] = 1;
+            used++;
+        }
+    }
+
+    Vec<u16> leaves(n);
+    Vec<u32> nodeWeight(n * 2);
+    Vec<u16> parent(n * 2);
+
+    while (true) {
+        leaves.trunc(0);
+        // NOTE: There are at most 288 symbols, insertion sort is plenty
+        for (usize i = 0; i < n; i++) {
+            if (not weights[i])
+                continue;
+            leaves.pushBack(i);
+            for (usize j = leaves.len() - 1; j > 0 and weights[leaves[j - 1]] > weights[leaves[j]]; j--)
+                std::swap(leaves[j - 1], leaves[j]);
+        }
+
+        usize count = leaves.len();
+        nodeWeight.trunc(0);
+        parent.trunc(0);
+        for (usize i = 0; i < count; i++) {
+            nodeWeight.pushBack(weights[leaves[i]]);
+            parent.pushBack(0);
+        }
+
+        // Two queues merge: leaves are sorted and internal nodes are created
+        // in increasing weight order.
+        usize leaf = 0;
+        usize node = count;
+        auto pick = [&] -> usize {
+            if (leaf < count and (node >= nodeWeight.len() or nodeWeight[leaf] <= nodeWeight[node]))
+                return leaf++;
+            return node++;
+        };
+
+        for (usize i = 0; i + 1 < count; i++) {
+            usize a = pick();
+            usize b = pick();
+            nodeWeight.pushBack(nodeWeight[a] + nodeWeight[b]);
+            parent.pushBack(0);
+            parent[a] = nodeWeight.len() - 1;
+            parent[b] = nodeWeight.len() - 1;
+        }
+
+        // Depths are computed from the root down, parents always come after
+        // their children.
+        Buf<u8> depth = Buf<u8>::init(nodeWeight.len());
+        usize maxDepth = 0;
+        for (usize i = nodeWeight.len() - 1; i-- > 0;) {
+            depth[i] = depth[parent[i]] + 1;
+            if (i < count)
+                maxDepth = max(maxDepth, (usize)depth[i]);
+        }
+
+        if (maxDepth <= limit) {
+            for (usize i = 0; i < n; i++)
+                lens[i] = 0;
+            for (usize i = 0; i < count; i++)
+                lens[leaves[i]] = depth[i];
+            return;
+        }
+
+        for (usize i = 0; i < n; i++)
+            if (weights[i])
+                weights[i] = (weights[i] >> 1) | 1;
+    }
+}
+
+static void _buildCodes(Slice<u8> lens, MutSlice<u16> codes) {
+    Array<u16, MAX_BITS + 1> count{};
+    for (auto l : lens)
+        count[l]++;
+    count[0] = 0;
+
+    Array<u32, MAX_BITS + 1> next{};
+    u32 code = 0;
+    for (usize l = 1; l <= MAX_BITS; l++) {
+        code = (code + count[l - 1]) << 1;
+        next[l] = code;
+    }
+
+    for (usize sym = 0; sym < lens.len(); sym++) {
+        usize l = lens[sym];
+        if (not l)
+            continue;
+
+        // NOTE: Codes are packed starting from their most significant bit
+        u32 c = next[l]++;
+        u32 rev = 0;
+        for (usize i = 0; i < l; i++) {
+            rev = (rev << 1) | (c & 1);
+            c >>= 1;
+        }
+        codes[sym] = rev;
+    }
+}
+
+// MARK: Bits ------------------------------------------------------------------
+
+struct _BitWriter {
+    Io::Writer& _writer;
+    Buf<u8> _out{};
+    u64 _bits = 0;
+    usize _nbits = 0;
+
+    always_inline void put(u32 v, usize n) {
+        _bits |= (u64)v << _nbits;
+        _nbits += n;
+        if (_nbits >= 32) {
+            u32 w = toLe((u32)_bits);
+            _out.insert(COPY, _out.len(), (u8 const*)&w, 4);
+            _bits >>= 32;
+            _nbits -= 32;
+        }
+    }
+
+    void align() {
+        while (_nbits > 0) {
+            _out.insert(_out.len(), (u8)_bits);
+            _bits >>= 8;
+            _nbits = _nbits > 8 ? _nbits - 8 : 0;
+        }
+        _bits = 0;
+    }
+
+    void bytes(Bytes b) {
+        _out.insert(COPY, _out.len(), b.buf(), b.len());
+    }
+
+    Res<> flush(bool force = false) {
+        if (not force and _out.len() < 64 * 1024)
+            return Ok();
+        try$(_writer.write(_out));
+        _out.trunc(0);
+        return Ok();
+    }
+};
+
+// MARK: Blocks ----------------------------------------------------------------
+
+struct _Symbol {
+    u16 litlen; // literal, or match length when dist is not zero
+    u16 dist;
+};
+
+struct _Block {
+    Vec<_Symbol> syms{};
+    Array<u32, NUM_LITLEN> litlenFreqs{};
+    Array<u32, NUM_DIST> distFreqs{};
+
+    void literal(u8 b) {
+        syms.pushBack({b, 0});
+        litlenFreqs[b]++;
+    }
+
+    void match(usize len, usize dist) {
+        syms.pushBack({(u16)len, (u16)dist});
+        litlenFreqs[257 + _LENGTH_CODE[len]]++;
+        distFreqs[_distCode(dist)]++;
+    }
+
+    void clear() {
+        syms.trunc(0);
+        litlenFreqs = {};
+        distFreqs = {};
+    }
+};
+
+static usize _symbolsCost(_Block const& block, Slice<u8> litlenLens, Slice<u8> distLens) {
+    usize bits = 0;
+    for (usize i = 0; i < NUM_LITLEN; i++) {
+        bits += block.litlenFreqs[i] * litlenLens[i];
+        if (i >= 257 and i - 257 < LENGTH_EXTRA.len())
+            bits += block.litlenFreqs[i] * LENGTH_EXTRA[i - 257];
+    }
+    for (usize i = 0; i < DIST_EXTRA.len(); i++)
+        bits += block.distFreqs[i] * (distLens[i] + DIST_EXTRA[i]);
+    return bits;
+}
+
+static void _writeSymbols(_BitWriter& w, _Block const& block, Slice<u16> litlenCodes, Slice<u8> litlenLens, Slice<u16> distCodes, Slice<u8> distLens) {
+    for (auto const& s : block.syms) {
+        if (not s.dist) {
+            w.put(litlenCodes[s.litlen], litlenLens[s.litlen]);
+            continue;
+        }
+
+        usize lc = _LENGTH_CODE[s.litlen];
+        w.put(litlenCodes[257 + lc], litlenLens[257 + lc]);
+        w.put(s.litlen - LENGTH_BASE[lc], LENGTH_EXTRA[lc]);
+
+        usize dc = _distCode(s.dist);
+        w.put(distCodes[dc], distLens[dc]);
+        w.put(s.dist - DIST_BASE[dc], DIST_EXTRA[dc]);
+    }
+    w.put(litlenCodes[END_OF_BLOCK], litlenLens[END_OF_BLOCK]);
+}
+
+static void _writeStored(_BitWriter& w, Bytes raw, bool final) {
+    do {
+        usize n = min(raw.len(), 0xffffuz);
+        bool last = final and n == raw.len();
+        w.put(last, 1);
+        w.put((u32)BlockType::STORED, 2);
+        w.align();
+        Array<u8, 4> hdr = {(u8)n, (u8)(n >> 8), (u8)~n, (u8)(~n >> 8)};
+        w.bytes(hdr);
+        w.bytes(sub(raw, 0, n));
+        raw = next(raw, n);
+    } while (raw.len());
+}
+
+// Picks the cheapest of stored, fixed and dynamic Huffman codes for the
+// block and writes it out.
+static void _writeBlock(_BitWriter& w, _Block& block, Bytes raw, bool final) {
+    block.litlenFreqs[END_OF_BLOCK]++;
+
+    Array<u8, NUM_LITLEN> litlenLens{};
+    Array<u8, NUM_DIST> distLens{};
+    _buildLengths(sub(block.litlenFreqs, 0, 286), mutSub(litlenLens, 0, 286), MAX_BITS);
+    _buildLengths(sub(block.distFreqs, 0, 30), mutSub(distLens, 0, 30), MAX_BITS);
+
+    usize hlit = 286;
+    while (hlit > 257 and litlenLens[hlit - 1] == 0)
+        hlit--;
+    usize hdist = 30;
+    while (hdist > 1 and distLens[hdist - 1] == 0)
+        hdist--;
+
+    // Run length encode the code lengths with the 16, 17 and 18 codes
+    Array<u8, NUM_LITLEN + NUM_DIST> all{};
+    for (usize i = 0; i < hlit; i++)
+        all[i] = litlenLens[i];
+    for (usize i = 0; i < hdist; i++)
+        all[hlit + i] = distLens[i];
+    usize total = hlit + hdist;
+
+    struct Run {
+        u8 sym;
+        u8 extra;
+    };
+    Vec<Run> runs{};
+    Array<u32, NUM_CODELEN> codelenFreqs{};
+
+    for (usize i = 0; i < total;) {
+        u8 l = all[i];
+        usize rep = 1;
+        while (i + rep < total and all[i + rep] == l)
+            rep++;
+
+        if (l == 0 and rep >= 3) {
+            rep = min(rep, 138uz);
+            if (rep <= 10)
+                runs.pushBack({17, (u8)(rep - 3)});
+            else
+                runs.pushBack({18, (u8)(rep - 11)});
+        } else if (l != 0 and rep >= 4) {
+            runs.pushBack({l, 0});
+            rep = 1 + min(rep - 1, 6uz);
+            runs.pushBack({16, (u8)(rep - 4)});
+        } else {
+            rep = 1;
+            runs.pushBack({l, 0});
+        }
+        codelenFreqs[last(runs).sym]++;
+        if (last(runs).sym == 16)
+            codelenFreqs[l]++;
+        i += rep;
+    }
+
+    Array<u8, NUM_CODELEN> codelenLens{};
+    _buildLengths(codelenFreqs, codelenLens, 7);
+
+    usize hclen = NUM_CODELEN;
+    while (hclen > 4 and codelenLens[CODELEN_ORDER[hclen - 1]] == 0)
+        hclen--;
+
+    usize dynamicCost = 3 + 5 + 5 + 4 + 3 * hclen;
+    for (auto const& r : runs) {
+        dynamicCost += codelenLens[r.sym];
+        dynamicCost += r.sym == 16 ? 2 : r.sym == 17 ? 3 : r.sym == 18 ? 7 : 0;
+    }
+    dynamicCost += _symbolsCost(block, litlenLens, distLens);
+
+    static constexpr auto FIXED_LITLEN = fixedLitlenLengths();
+    static constexpr auto FIXED_DIST = fixedDistLengths();
+    usize fixedCost = 3 + _symbolsCost(block, FIXED_LITLEN, FIXED_DIST);
+
+    usize storedCost = (raw.len() + 5 * (raw.len() / 0xffff + 1)) * 8 + 7;
+
+    if (storedCost <= fixedCost and storedCost <= dynamicCost) {
+        _writeStored(w, raw, final);
+    } else if (fixedCost <= dynamicCost) {
+        Array<u16, NUM_LITLEN> litlenCodes{};
+        Array<u16, NUM_DIST> distCodes{};
+        _buildCodes(FIXED_LITLEN, litlenCodes);
+        _buildCodes(FIXED_DIST, distCodes);
+
+        w.put(final, 1);
+        w.put((u32)BlockType::FIXED, 2);
+        _writeSymbols(w, block, litlenCodes, FIXED_LITLEN, distCodes, FIXED_DIST);
+    } else {
+        Array<u16, NUM_LITLEN> litlenCodes{};
+        Array<u16, NUM_DIST> distCodes{};
+        Array<u16, NUM_CODELEN> codelenCodes{};
+        _buildCodes(litlenLens, litlenCodes);
+        _buildCodes(distLens, distCodes);
+        _buildCodes(codelenLens, codelenCodes);
+
+        w.put(final, 1);
+        w.put((u32)BlockType::DYNAMIC, 2);
+        w.put(hlit - 257, 5);
+        w.put(hdist - 1, 5);
+        w.put(hclen - 4, 4);
+        for (usize i = 0; i < hclen; i++)
+            w.put(codelenLens[CODELEN_ORDER[i]], 3);
+
+        for (auto const& r : runs) {
+            w.put(codelenCodes[r.sym], codelenLens[r.sym]);
+            if (r.sym == 16)
+                w.put(r.extra, 2);
+            else if (r.sym == 17)
+                w.put(r.extra, 3);
+            else if (r.sym == 18)
+                w.put(r.extra, 7);
+        }
+
+        _writeSymbols(w, block, litlenCodes, litlenLens, distCodes, distLens);
+    }
+
+    block.clear();
+}
+
+// MARK: Matching --------------------------------------------------------------
+
+static constexpr usize HASH_BITS = 15;
+static constexpr usize HASH_SIZE = 1 << HASH_BITS;
+static constexpr usize WINDOW_MASK = WINDOW_SIZE - 1;
+static constexpr usize BLOCK_SYMBOLS = 16 * 1024;
+
+// NOTE: Three byte matches far away usually cost more than the literals
+static constexpr usize TOO_FAR = 4096;
+
+always_inline static u32 _hash(u8 const* p) {
+    u32 v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (v * 0x9e3779b1u) >> (32 - HASH_BITS);
+}
+
+always_inline static usize _matchLen(u8 const* a, u8 const* b, usize max) {
+    usize len = 0;
+    while (len + 8 <= max) {
+        u64 x, y;
+        memcpy(&x, a + len, 8);
+        memcpy(&y, b + len, 8);
+        if (u64 diff = x ^ y)
+            return len + (__builtin_ctzll(toLe(diff)) >> 3);
+        len += 8;
+    }
+    while (len < max and a[len] == b[len])
+        len++;
+    return len;
+}
+
+struct _Matcher {
+    Bytes _data;
+    _Level _level;
+    Buf<i32> _head = Buf<i32>::init(HASH_SIZE, -1);
+    Buf<i32> _prev = Buf<i32>::init(WINDOW_SIZE, -1);
+
+    always_inline void insert(usize pos) {
+        if (pos + MIN_MATCH > _data.len())
+            return;
+        u32 h = _hash(_data.buf() + pos);
+        _prev[pos & WINDOW_MASK] = _head[h];
+        _head[h] = pos;
+    }
+
+    // Walks the hash chain of pos looking for a match longer than prevLen
+    always_inline usize find(usize pos, usize prevLen, usize& bestDist) {
+        usize maxLen = min(MAX_MATCH, _data.len() - pos);
+        if (maxLen < MIN_MATCH or prevLen >= maxLen)
+            return 0;
+
+        usize chain = _level.maxChain;
+        if (prevLen >= _level.goodLen)
+            chain >>= 2;
+
+        u8 const* buf = _data.buf();
+        usize best = prevLen;
+        isize cur = _head[_hash(buf + pos)];
+
+        while (cur >= 0 and chain--) {
+            usize dist = pos - cur;
+            if (dist == 0 or dist >= WINDOW_SIZE)
+                break;
+
+            if (buf[cur + best] == buf[pos + best] or best < MIN_MATCH) {
+                usize len = _matchLen(buf + cur, buf + pos, maxLen);
+                if (len > best and not(len == MIN_MATCH and dist > TOO_FAR)) {
+                    best = len;
+                    bestDist = dist;
+                    if (len >= _level.niceLen or len == maxLen)
+                        break;
+                }
+            }
+
+            cur = _prev[cur & WINDOW_MASK];
+        }
+
+        return best > prevLen ? best : 0;
+    }
+};
+
+Res<> encode(Bytes bytes, Io::Writer& writer, usize level) {
+    _BitWriter w{writer};
+
+    if (level == STORE_LEVEL) {
+        _writeStored(w, bytes, true);
+        w.align();
+        return w.flush(true);
+    }
+
+    _Matcher m{bytes, _LEVELS[min(level, BEST_LEVEL)]};
+    _Block block;
+    usize blockStart = 0;
+    usize pos = 0;
+    usize n = bytes.len();
+
+    usize prevLen = 0;
+    usize prevDist = 0;
+    bool pending = false;
+
+    auto flushBlock = [&](usize end, bool final) -> Res<> {
+        _writeBlock(w, block, sub(bytes, blockStart, end), final);
+        blockStart = end;
+        return w.flush();
+    };
+
+    while (pos < n) {
+        usize dist = 0;
+        usize len = 0;
+
+        if (not m._level.lazy) {
+            len = m.find(pos, MIN_MATCH - 1, dist);
+            m.insert(pos);
+            if (len) {
+                block.match(len, dist);
+                // NOTE: Long matches aren't worth indexing in fast modes
+                if (len <= m._level.niceLen)
+                    for (usize i = 1; i < len; i++)
+                        m.insert(pos + i);
+                pos += len;
+            } else {
+                block.literal(bytes[pos]);
+                pos++;
+            }
+        } else {
+            if (prevLen < m._level.niceLen)
+                len = m.find(pos, max(prevLen, MIN_MATCH - 1), dist);
+            m.insert(pos);
+
+            if (pending and prevLen >= MIN_MATCH and len == 0) {
+                // The match that started at the previous byte is the better one
+                block.match(prevLen, prevDist);
+                for (usize i = 1; i < prevLen - 1; i++)
+                    m.insert(pos + i);
+                pos += prevLen - 1;
+                pending = false;
+                prevLen = 0;
+            } else {
+                if (pending)
+                    block.literal(bytes[pos - 1]);
+                pending = true;
+                prevLen = len;
+                prevDist = dist;
+                pos++;
+            }
+        }
+
+        if (block.syms.len() >= BLOCK_SYMBOLS)
+            try$(flushBlock(pos - pending, false));
+    }
+
+    if (pending)
+        block.literal(bytes[n - 1]);
+
+    try$(flushBlock(n, true));
+    w.align();
+    return w.flush(true);
+}
+
+} // namespace Inflate
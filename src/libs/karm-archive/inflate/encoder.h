@@ -0,0 +1,18 @@
+#pragma once
+
+#include <karm-io/traits.h>
+
+#include "spec.h"
+
+namespace Inflate {
+
+static constexpr usize STORE_LEVEL = 0;
+static constexpr usize FAST_LEVEL = 1;
+static constexpr usize DEFAULT_LEVEL = 6;
+static constexpr usize BEST_LEVEL = 9;
+
+// Compresses bytes into a raw DEFLATE stream, level 0 only stores the data,
+// 1 to 9 trade speed for compression ratio the same way zlib does.
+Res<> encode(Bytes bytes, Io::Writer& writer, usize level = DEFAULT_LEVEL);
+
+} // namespace Inflate
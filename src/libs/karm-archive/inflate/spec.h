@@ -1,7 +1,74 @@
 #pragma once
 
 // https://github.com/jibsen/tinf
+// https://www.rfc-editor.org/rfc/rfc1951
+
+#include <karm-base/array.h>
 
 namespace Inflate {
 
+enum struct BlockType : u8 {
+    STORED = 0,
+    FIXED = 1,
+    DYNAMIC = 2,
+    INVALID = 3,
+};
+
+static constexpr usize WINDOW_SIZE = 32 * 1024;
+static constexpr usize MIN_MATCH = 3;
+static constexpr usize MAX_MATCH = 258;
+static constexpr usize MAX_BITS = 15;
+
+static constexpr usize NUM_LITLEN = 288;
+static constexpr usize NUM_DIST = 32;
+static constexpr usize NUM_CODELEN = 19;
+
+static constexpr usize END_OF_BLOCK = 256;
+
+static constexpr Array<u8, NUM_CODELEN> CODELEN_ORDER = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// Length codes 257..285
+static constexpr Array<u16, 29> LENGTH_BASE = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static constexpr Array<u8, 29> LENGTH_EXTRA = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+// Distance codes 0..29
+static constexpr Array<u16, 30> DIST_BASE = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static constexpr Array<u8, 30> DIST_EXTRA = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static constexpr Array<u8, NUM_LITLEN> fixedLitlenLengths() {
+    Array<u8, NUM_LITLEN> lens{};
+    for (usize i = 0; i < 144; i++)
+        lens[i] = 8;
+    for (usize i = 144; i < 256; i++)
+        lens[i] = 9;
+    for (usize i = 256; i < 280; i++)
+        lens[i] = 7;
+    for (usize i = 280; i < NUM_LITLEN; i++)
+        lens[i] = 8;
+    return lens;
+}
+
+static constexpr Array<u8, NUM_DIST> fixedDistLengths() {
+    Array<u8, NUM_DIST> lens{};
+    for (usize i = 0; i < NUM_DIST; i++)
+        lens[i] = 5;
+    return lens;
+}
+
 } // namespace Inflate
@@ -0,0 +1,48 @@
+#include <karm-archive/gzip/decoder.h>
+#include <karm-archive/gzip/encoder.h>
+#include <karm-io/impls.h>
+#include <karm-test/macros.h>
+
+namespace Gzip::Tests {
+
+static constexpr Array<u8, 33> HELLO = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xf3,
+    0x48, 0xcd, 0xc9, 0xc9, 0xd7, 0x51, 0x28, 0xcf, 0x2f, 0xca, 0x49,
+    0x51, 0x04, 0x00, 0xe6, 0xc6, 0xe6, 0xeb, 0x0d, 0x00, 0x00, 0x00
+};
+
+test$("gzip-decode") {
+    auto out = try$(decode(HELLO));
+    expect$(Bytes{out} == bytes("Hello, world!"s));
+    return Ok();
+}
+
+test$("gzip-reject") {
+    auto corrupt = HELLO;
+
+    // Bad CRC-32
+    corrupt[25] ^= 1;
+    expectNot$(decode(corrupt).has());
+    corrupt[25] ^= 1;
+
+    // Bad size
+    corrupt[29] ^= 1;
+    expectNot$(decode(corrupt).has());
+
+    return Ok();
+}
+
+test$("gzip-roundtrip") {
+    Str text = "The quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy dog";
+
+    for (usize level : {Inflate::STORE_LEVEL, Inflate::FAST_LEVEL, Inflate::DEFAULT_LEVEL, Inflate::BEST_LEVEL}) {
+        Io::BufferWriter writer;
+        try$(encode(bytes(text), writer, level));
+        auto out = try$(decode(writer.bytes()));
+        expect$(Bytes{out} == bytes(text));
+    }
+
+    return Ok();
+}
+
+} // namespace Gzip::Tests
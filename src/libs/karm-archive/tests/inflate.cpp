@@ -0,0 +1,103 @@
+#include <karm-archive/inflate/decoder.h>
+#include <karm-archive/inflate/encoder.h>
+#include <karm-io/impls.h>
+#include <karm-test/macros.h>
+
+namespace Inflate::Tests {
+
+test$("inflate-decode") {
+    auto testCase = [&](Bytes data, Str expected) -> Res<> {
+        auto out = try$(decode(data));
+        expect$(Bytes{out} == bytes(expected));
+        return Ok();
+    };
+
+    // Stored block
+    Array<u8, 10> stored = {0x01, 0x05, 0x00, 0xfa, 0xff, 0x68, 0x65, 0x6c, 0x6c, 0x6f};
+    try$(testCase(stored, "hello"));
+
+    // Fixed Huffman codes with a back reference
+    Array<u8, 10> fixed = {0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0xc8, 0x40, 0x27, 0x01};
+    try$(testCase(fixed, "hello hello hello hello"));
+
+    // Empty final fixed block
+    Array<u8, 2> empty = {0x03, 0x00};
+    try$(testCase(empty, ""));
+
+    return Ok();
+}
+
+test$("inflate-reject") {
+    // Stored block with a length that doesn't match its complement
+    Array<u8, 10> badLen = {0x01, 0x05, 0x00, 0xfb, 0xff, 0x68, 0x65, 0x6c, 0x6c, 0x6f};
+    expectNot$(decode(badLen).has());
+
+    // Reserved block type
+    Array<u8, 1> badType = {0x07};
+    expectNot$(decode(badType).has());
+
+    // Truncated stream
+    Array<u8, 4> truncated = {0xcb, 0x48, 0xcd, 0xc9};
+    expectNot$(decode(truncated).has());
+
+    return Ok();
+}
+
+static Buf<u8> _sample() {
+    // Text-like data with repetitions at every distance and a few runs
+    auto buf = Buf<u8>::init(100000);
+    u32 seed = 1;
+    for (usize i = 0; i < buf.len(); i++) {
+        seed = seed * 1103515245 + 12345;
+        if (i > 300 and (seed >> 16) % 4 != 0)
+            buf[i] = buf[i - 1 - (seed >> 20) % 300];
+        else
+            buf[i] = 'a' + (seed >> 16) % 26;
+    }
+    return buf;
+}
+
+test$("inflate-roundtrip") {
+    auto data = _sample();
+
+    for (usize level = STORE_LEVEL; level <= BEST_LEVEL; level++) {
+        Io::BufferWriter writer;
+        try$(encode(data, writer, level));
+        auto compressed = writer.take();
+
+        if (level != STORE_LEVEL)
+            expectLt$(compressed.len(), data.len());
+
+        auto out = try$(decode(compressed));
+        expect$(Bytes{out} == Bytes{data});
+    }
+
+    return Ok();
+}
+
+test$("inflate-read") {
+    auto data = _sample();
+
+    Io::BufferWriter writer;
+    try$(encode(data, writer));
+    auto compressed = writer.take();
+
+    // Pull the data through the reader interface in small, odd sized pieces
+    Io::BufReader reader{compressed};
+    Decoder decoder{reader};
+    Buf<u8> out;
+    Array<u8, 777> chunk;
+    while (true) {
+        usize n = try$(decoder.read(chunk));
+        if (n == 0)
+            break;
+        out.insert(COPY, out.len(), chunk.buf(), n);
+    }
+
+    expect$(decoder.ended());
+    expect$(Bytes{out} == Bytes{data});
+
+    return Ok();
+}
+
+} // namespace Inflate::Tests
@@ -0,0 +1,47 @@
+#include <karm-archive/zlib/decoder.h>
+#include <karm-archive/zlib/encoder.h>
+#include <karm-io/impls.h>
+#include <karm-test/macros.h>
+
+namespace Zlib::Tests {
+
+static constexpr Array<u8, 21> HELLO = {
+    0x78, 0x9c, 0xf3, 0x48, 0xcd, 0xc9, 0xc9, 0xd7, 0x51, 0x28, 0xcf,
+    0x2f, 0xca, 0x49, 0x51, 0x04, 0x00, 0x20, 0x5e, 0x04, 0x8a
+};
+
+test$("zlib-decode") {
+    auto out = try$(decode(HELLO));
+    expect$(Bytes{out} == bytes("Hello, world!"s));
+    return Ok();
+}
+
+test$("zlib-reject") {
+    auto corrupt = HELLO;
+
+    // Bad header check
+    corrupt[1] ^= 1;
+    expectNot$(decode(corrupt).has());
+    corrupt[1] ^= 1;
+
+    // Bad Adler-32
+    corrupt[20] ^= 1;
+    expectNot$(decode(corrupt).has());
+
+    return Ok();
+}
+
+test$("zlib-roundtrip") {
+    Str text = "The quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy dog";
+
+    for (usize level : {Inflate::STORE_LEVEL, Inflate::FAST_LEVEL, Inflate::DEFAULT_LEVEL, Inflate::BEST_LEVEL}) {
+        Io::BufferWriter writer;
+        try$(encode(bytes(text), writer, level));
+        auto out = try$(decode(writer.bytes()));
+        expect$(Bytes{out} == bytes(text));
+    }
+
+    return Ok();
+}
+
+} // namespace Zlib::Tests
@@ -0,0 +1,84 @@
+#include <karm-crypto/adler32.h>
+#include <karm-io/impls.h>
+
+#include "decoder.h"
+
+namespace Zlib {
+
+Res<> Decoder::_readHeader() {
+    Array<u8, HEADER_LEN> hdr;
+    try$(_inflate.readRaw(hdr));
+
+    u8 cmf = hdr[0];
+    u8 flg = hdr[1];
+
+    if ((cmf & 0xf) != CM_DEFLATE)
+        return Error::invalidData("unsupported compression method");
+
+    if ((cmf >> 4) > CINFO_MAX)
+        return Error::invalidData("invalid window size");
+
+    if (((cmf << 8) | flg) % 31 != 0)
+        return Error::invalidData("invalid header checksum");
+
+    if (flg & FLG_FDICT)
+        return Error::invalidData("preset dictionaries are not supported");
+
+    _header = true;
+    return Ok();
+}
+
+Res<> Decoder::_readTrailer() {
+    Array<u8, TRAILER_LEN> trailer;
+    try$(_inflate.readRaw(trailer));
+
+    u32 adler = (trailer[0] << 24) | (trailer[1] << 16) | (trailer[2] << 8) | trailer[3];
+    if (adler != _adler)
+        return Error::invalidData("adler32 mismatch");
+
+    _trailer = true;
+    return Ok();
+}
+
+Res<Bytes> Decoder::next() {
+    if (not _header)
+        try$(_readHeader());
+
+    auto chunk = try$(_inflate.next());
+    _adler = Crypto::adler32(chunk, _adler);
+
+    if (isEmpty(chunk) and not _trailer)
+        try$(_readTrailer());
+
+    return Ok(chunk);
+}
+
+Res<usize> Decoder::read(MutBytes bytes) {
+    if (not _header)
+        try$(_readHeader());
+
+    usize n = try$(_inflate.read(bytes));
+    _adler = Crypto::adler32(sub(bytes, 0, n), _adler);
+
+    if (n == 0 and not _trailer)
+        try$(_readTrailer());
+
+    return Ok(n);
+}
+
+Res<Buf<u8>> decode(Bytes bytes) {
+    Io::BufReader reader{bytes};
+    Decoder decoder{reader};
+    Buf<u8> res;
+
+    while (true) {
+        auto chunk = try$(decoder.next());
+        if (isEmpty(chunk))
+            break;
+        res.insert(COPY, res.len(), chunk.buf(), chunk.len());
+    }
+
+    return Ok(std::move(res));
+}
+
+} // namespace Zlib
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../inflate/decoder.h"
+#include "spec.h"
+
+namespace Zlib {
+
+// Streaming decoder for zlib wrapped DEFLATE data, the header is checked
+// before the first byte is decoded and the Adler-32 checksum once the
+// compressed data ended.
+struct Decoder : public Io::Reader {
+    Inflate::Decoder _inflate;
+    bool _header = false;
+    bool _trailer = false;
+    u32 _adler = 1;
+
+    Decoder(Io::Reader& reader) : _inflate(reader) {}
+
+    Res<usize> read(MutBytes bytes) override;
+
+    Res<Bytes> next();
+
+    Res<> _readHeader();
+
+    Res<> _readTrailer();
+};
+
+Res<Buf<u8>> decode(Bytes bytes);
+
+} // namespace Zlib
@@ -0,0 +1,30 @@
+#include <karm-crypto/adler32.h>
+
+#include "encoder.h"
+
+namespace Zlib {
+
+Res<> encode(Bytes bytes, Io::Writer& writer, usize level) {
+    u8 cmf = (CINFO_MAX << 4) | CM_DEFLATE;
+    u8 flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    u8 flg = flevel << 6;
+    flg |= 31 - ((cmf << 8) | flg) % 31;
+
+    Array<u8, HEADER_LEN> hdr = {cmf, flg};
+    try$(writer.write(hdr));
+
+    try$(Inflate::encode(bytes, writer, level));
+
+    u32 adler = Crypto::adler32(bytes);
+    Array<u8, TRAILER_LEN> trailer = {
+        (u8)(adler >> 24),
+        (u8)(adler >> 16),
+        (u8)(adler >> 8),
+        (u8)adler,
+    };
+    try$(writer.write(trailer));
+
+    return Ok();
+}
+
+} // namespace Zlib
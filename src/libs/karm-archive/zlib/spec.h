@@ -1,5 +1,17 @@
 #pragma once
 
+// https://www.rfc-editor.org/rfc/rfc1950
+
+#include <karm-base/base.h>
+
 namespace Zlib {
 
+static constexpr u8 CM_DEFLATE = 8;
+static constexpr u8 CINFO_MAX = 7;
+
+static constexpr u8 FLG_FDICT = 1 << 5;
+
+static constexpr usize HEADER_LEN = 2;
+static constexpr usize TRAILER_LEN = 4;
+
 } // namespace Zlib
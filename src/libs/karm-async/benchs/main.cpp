@@ -0,0 +1,97 @@
+#include <karm-async/promise.h>
+#include <karm-async/run.h>
+#include <karm-async/task.h>
+#include <karm-sys/entry.h>
+#include <karm-sys/time.h>
+#include <stdlib.h>
+
+// Every allocation of the process goes through here, so the benchmarks can
+// tell how many of them an await costs.
+static usize _allocs = 0;
+
+void* operator new(usize size) {
+    _allocs++;
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, usize) noexcept {
+    free(ptr);
+}
+
+static constexpr usize AWAITS = 1000000;
+
+static Async::_Task<usize> leafAsync(usize i) {
+    co_return i;
+}
+
+static Async::_Task<usize> chainAsync(usize depth) {
+    if (depth == 0)
+        co_return co_await leafAsync(depth);
+    co_return co_await chainAsync(depth - 1) + 1;
+}
+
+static Async::_Task<usize> awaitTasksAsync() {
+    usize sum = 0;
+    for (usize i = 0; i < AWAITS; i++)
+        sum += co_await leafAsync(i);
+    co_return sum;
+}
+
+static Async::_Task<usize> awaitChainsAsync() {
+    static constexpr usize DEPTH = 15;
+    usize sum = 0;
+    for (usize i = 0; i < AWAITS / (DEPTH + 1); i++)
+        sum += co_await chainAsync(DEPTH);
+    co_return sum;
+}
+
+static Async::_Task<usize> awaitFuturesAsync() {
+    usize sum = 0;
+    for (usize i = 0; i < AWAITS; i++) {
+        Async::_Promise<usize> promise;
+        auto future = promise.future();
+        promise.resolve(i);
+        sum += co_await future;
+    }
+    co_return sum;
+}
+
+static Async::_Task<usize> awaitSlotsAsync() {
+    usize sum = 0;
+    for (usize i = 0; i < AWAITS; i++) {
+        Async::_Slot<usize> slot;
+        slot.resolve(i);
+        sum += co_await slot.wait();
+    }
+    co_return sum;
+}
+
+static void bench(Str name, auto f) {
+    // Warm up the frame pool, so the numbers reflect steady state.
+    (void)Async::run(f());
+
+    auto allocs = _allocs;
+    auto start = Sys::instant();
+    auto sum = Async::run(f());
+    auto elapsed = Sys::instant() - start;
+    allocs = _allocs - allocs;
+
+    f64 nsPerAwait = elapsed.toUSecs() * 1000.0 / AWAITS;
+    f64 allocsPerAwait = (f64)allocs / AWAITS;
+    Sys::println(
+        "{}: {} ({} ns/await, {} allocations, {} per await, checksum {})",
+        name, elapsed, nsPerAwait, allocs, allocsPerAwait, sum
+    );
+}
+
+Async::Task<> entryPointAsync(Sys::Context&) {
+    bench("task", awaitTasksAsync);
+    bench("task chain", awaitChainsAsync);
+    bench("future", awaitFuturesAsync);
+    bench("slot", awaitSlotsAsync);
+    co_return Ok();
+}
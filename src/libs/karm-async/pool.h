@@ -0,0 +1,148 @@
+#pragma once
+
+#include <karm-base/array.h>
+#include <karm-base/base.h>
+#include <karm-base/lock.h>
+
+namespace Karm::Async {
+
+// Free lists of small blocks, sorted by size class, used for coroutine
+// frames and the other short lived allocations of async operations. Freed
+// blocks are kept around to be reused by the next allocation of the same
+// class instead of going back to the system allocator.
+//
+// NOTE: Each thread has its own pool, a block freed on another thread than
+//       the one that allocated it simply moves to the free list of that
+//       thread. Freestanding targets have no thread local storage, all the
+//       CPUs share a single pool behind a lock.
+struct FramePool {
+    static constexpr usize GRANULE = 64;
+    static constexpr usize CLASSES = 16;
+    static constexpr usize MAX_SIZE = GRANULE * CLASSES;
+
+    // Upper bound on the number of free blocks kept per class, so a burst
+    // of operations doesn't pin its peak memory usage forever.
+    static constexpr usize MAX_FREE = 256;
+
+    struct _Block {
+        _Block* next;
+    };
+
+    Array<_Block*, CLASSES> _free{};
+    Array<usize, CLASSES> _len{};
+#ifdef __ck_freestanding__
+    Lock _lock;
+#endif
+
+    FramePool() = default;
+
+    FramePool(FramePool const&) = delete;
+
+    FramePool& operator=(FramePool const&) = delete;
+
+    ~FramePool() {
+        for (auto* block : _free) {
+            while (block) {
+                auto* next = block->next;
+                ::operator delete(block);
+                block = next;
+            }
+        }
+    }
+
+    // Returns the pool of the current thread, or nullptr once it has been
+    // destroyed, the destructors of thread locals constructed before it may
+    // still free blocks while the thread exits.
+    static FramePool* local() {
+#ifdef __ck_freestanding__
+        static FramePool pool;
+        return &pool;
+#else
+        // NOTE: Trivially destructible, so it stays valid after the pool.
+        thread_local constinit bool dead = false;
+        if (dead) [[unlikely]]
+            return nullptr;
+
+        struct Local {
+            FramePool pool;
+
+            ~Local() {
+                dead = true;
+            }
+        };
+
+        thread_local Local local;
+        return &local.pool;
+#endif
+    }
+
+    static usize _classOf(usize size) {
+        return (size + GRANULE - 1) / GRANULE - 1;
+    }
+
+    void* alloc(usize size) {
+        if (size == 0 or size > MAX_SIZE) [[unlikely]]
+            return ::operator new(size);
+
+        auto c = _classOf(size);
+        if (auto* block = _pop(c))
+            return block;
+
+        return ::operator new((c + 1) * GRANULE);
+    }
+
+    void free(void* ptr, usize size) {
+        if (size == 0 or size > MAX_SIZE) [[unlikely]] {
+            ::operator delete(ptr);
+            return;
+        }
+
+        if (not _push(_classOf(size), static_cast<_Block*>(ptr)))
+            ::operator delete(ptr);
+    }
+
+    _Block* _pop(usize c) {
+#ifdef __ck_freestanding__
+        LockScope scope{_lock};
+#endif
+        auto* block = _free[c];
+        if (block) {
+            _free[c] = block->next;
+            _len[c]--;
+        }
+        return block;
+    }
+
+    bool _push(usize c, _Block* block) {
+#ifdef __ck_freestanding__
+        LockScope scope{_lock};
+#endif
+        if (_len[c] >= MAX_FREE)
+            return false;
+
+        block->next = _free[c];
+        _free[c] = block;
+        _len[c]++;
+        return true;
+    }
+};
+
+// Routes the allocations of a type through the frame pool of the current
+// thread, for promise types and operation states allocated on the heap.
+// Once the pool of the thread is gone, they go straight to the system
+// allocator, which is where pooled blocks come from anyway.
+struct Pooled {
+    static void* operator new(usize size) {
+        if (auto* pool = FramePool::local())
+            return pool->alloc(size);
+        return ::operator new(size);
+    }
+
+    static void operator delete(void* ptr, usize size) {
+        if (auto* pool = FramePool::local())
+            return pool->free(ptr, size);
+        ::operator delete(ptr);
+    }
+};
+
+} // namespace Karm::Async
@@ -116,4 +116,79 @@ struct _Promise : Meta::NoCopy {
 template <typename V = None, typename E = Error>
 using Promise = _Promise<Res<V, E>>;
 
+// A single-shot value stored inline in the object that resolves it, for
+// when that object already lives as long as the operation waiting on it
+// and a separate heap cell for the state would be wasted. Unlike a promise
+// it can only be waited on once, and the value is moved out to the waiter.
+template <typename T>
+struct _Slot : Meta::Pinned {
+    struct _Listener {
+        virtual ~_Listener() = default;
+        virtual void resume() = 0;
+    };
+
+    Opt<T> _value;
+    _Listener* _listener = nullptr;
+    bool _waited = false;
+
+    void resolve(T value) {
+        if (_value.has()) [[unlikely]]
+            panic("slot already resolved");
+        _value = std::move(value);
+        if (auto* listener = std::exchange(_listener, nullptr))
+            listener->resume();
+    }
+
+    template <Receiver<T> R>
+    struct _Operation :
+        public _Listener,
+        Meta::Pinned {
+
+        _Slot* _slot;
+        R _r;
+
+        _Operation(_Slot* slot, R r)
+            : _slot{slot}, _r{std::move(r)} {}
+
+        ~_Operation() {
+            if (_slot->_listener == this)
+                _slot->_listener = nullptr;
+        }
+
+        void resume() override {
+            _r.recv(Async::LATER, _slot->_value.take());
+        }
+
+        bool start() {
+            if (std::exchange(_slot->_waited, true)) [[unlikely]]
+                panic("slot already waited on");
+
+            if (not _slot->_value.has()) {
+                _slot->_listener = this;
+                return false;
+            }
+            _r.recv(Async::INLINE, _slot->_value.take());
+            return true;
+        }
+    };
+
+    struct _Sender {
+        using Inner = T;
+
+        _Slot* _slot;
+
+        template <Receiver<T> R>
+        auto connect(R r) {
+            return _Operation<R>{_slot, std::move(r)};
+        }
+    };
+
+    _Sender wait() {
+        return _Sender{this};
+    }
+};
+
+template <typename V = None, typename E = Error>
+using Slot = _Slot<Res<V, E>>;
+
 } // namespace Karm::Async
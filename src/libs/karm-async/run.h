@@ -3,6 +3,7 @@
 #include <karm-base/opt.h>
 
 #include "base.h"
+#include "pool.h"
 
 namespace Karm::Async {
 
@@ -56,7 +57,7 @@ static inline void detach(S s, Cb cb) {
         }
     };
 
-    struct Holder : public _Holder {
+    struct Holder : public _Holder, Pooled {
         using Op = OperationOf<S, Receiver>;
         Op _op;
         Cb _cb;
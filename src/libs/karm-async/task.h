@@ -4,6 +4,7 @@
 #include <karm-base/res.h>
 
 #include "awaiter.h"
+#include "pool.h"
 
 namespace Karm::Async {
 
@@ -17,7 +18,9 @@ template <typename T>
 struct [[nodiscard]] _Task {
     using Inner = T;
 
-    struct promise_type {
+    // NOTE: Frames come from the frame pool, a task awaiting another
+    //       task usually gets back the block its previous callee freed.
+    struct promise_type : public Pooled {
         Continuation<T>* _resume = nullptr;
         Cfp _cfp = Cfp::INDETERMINATE;
 
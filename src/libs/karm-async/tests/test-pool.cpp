@@ -0,0 +1,49 @@
+#include <karm-async/pool.h>
+#include <karm-async/run.h>
+#include <karm-async/task.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Async::Tests {
+
+test$("karm-async-pool-reuse") {
+    FramePool pool;
+
+    auto* a = pool.alloc(100);
+    pool.free(a, 100);
+
+    // Same size class, same block.
+    auto* b = pool.alloc(120);
+    expect$(a == b);
+
+    // Different size class, fresh block.
+    auto* c = pool.alloc(300);
+    expect$(b != c);
+
+    pool.free(b, 120);
+    pool.free(c, 300);
+    return Ok();
+}
+
+test$("karm-async-pool-large") {
+    FramePool pool;
+    auto* ptr = pool.alloc(FramePool::MAX_SIZE + 1);
+    expect$(ptr != nullptr);
+    pool.free(ptr, FramePool::MAX_SIZE + 1);
+    return Ok();
+}
+
+Async::_Task<int> taskPooled(int depth) {
+    if (depth == 0)
+        co_return 0;
+    co_return co_await taskPooled(depth - 1) + 1;
+}
+
+test$("karm-async-pool-tasks") {
+    for (int i = 0; i < 4; i++) {
+        auto res = Async::run(taskPooled(64));
+        expectEq$(res, 64);
+    }
+    return Ok();
+}
+
+} // namespace Karm::Async::Tests
@@ -39,4 +39,21 @@ test$("karm-async-promise-multiple-futures") {
     return Ok();
 }
 
+test$("karm-async-slot-resolved") {
+    Async::_Slot<int> slot;
+    slot.resolve(42);
+    auto res = Async::run(slot.wait());
+    expectEq$(res, 42);
+    return Ok();
+}
+
+test$("karm-async-slot-pending") {
+    Async::_Slot<int> slot;
+    auto res = Async::run(slot.wait(), [&] {
+        slot.resolve(42);
+    });
+    expectEq$(res, 42);
+    return Ok();
+}
+
 } // namespace Karm::Async::Tests
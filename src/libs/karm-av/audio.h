@@ -1,5 +1,6 @@
 #pragma once
 
+#include <karm-base/enum.h>
 #include <karm-base/func.h>
 #include <karm-base/rc.h>
 #include <karm-base/res.h>
@@ -64,6 +65,21 @@ enum struct AudioChannel : u32 {
     FRONT_BACK = FRONT_CENTER | BACK_CENTER
 };
 
+/// The number of channels in a layout.
+inline usize channelCount(AudioChannel layout) {
+    if (layout == AudioChannel::INVALID)
+        return 0;
+    return __builtin_popcount(toUnderlyingType(layout));
+}
+
+/// The default layout for a number of channels, as used by WAV files
+/// that don't specify one.
+inline AudioChannel defaultLayout(usize channels) {
+    if (channels == 0 or channels > 26)
+        return AudioChannel::INVALID;
+    return (AudioChannel)((1u << channels) - 1);
+}
+
 enum struct AudioFormat {
     UNSPECIFIED = 0,
 
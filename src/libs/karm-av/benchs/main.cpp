@@ -0,0 +1,50 @@
+#include <karm-av/mixer.h>
+#include <karm-math/funcs.h>
+#include <karm-sys/entry.h>
+#include <karm-sys/time.h>
+
+static Rc<Av::Source> sine(f64 freq, usize sampleRate) {
+    Vec<f32> samples;
+    samples.resize(sampleRate);
+    for (usize i = 0; i < samples.len(); i++)
+        samples[i] = Math::sin(2 * Math::PI * freq * i / sampleRate) * 0.5;
+    return makeRc<Av::BufferSource>(std::move(samples), Av::AudioChannel::MONO, sampleRate, true);
+}
+
+static Res<> bench(Str name, usize voices, usize sourceRate) {
+    static constexpr usize SAMPLE_RATE = 48000;
+    static constexpr usize SECONDS = 4;
+
+    Av::Mixer mixer{Av::AudioChannel::STEREO, SAMPLE_RATE};
+    for (usize i = 0; i < voices; i++)
+        try$(mixer.add(sine(110 + i * 10, sourceRate), 1.0 / voices));
+
+    Vec<f32> out;
+    out.resize(Av::Mixer::BLOCK * mixer.channels());
+
+    Duration pumpTime = Duration::zero();
+    Duration mixTime = Duration::zero();
+    for (usize i = 0; i < SAMPLE_RATE * SECONDS / Av::Mixer::BLOCK; i++) {
+        auto start = Sys::now();
+        try$(mixer.pump());
+        auto mid = Sys::now();
+        mixer.mix(out);
+        mixTime += Sys::now() - mid;
+        pumpTime += mid - start;
+    }
+
+    f64 realtime = SECONDS * 1e6;
+    Sys::println(
+        "{} ({} voices): pump {} ({}% of real time), mix {} ({}% of real time)",
+        name, voices,
+        pumpTime, pumpTime.toUSecs() / realtime * 100,
+        mixTime, mixTime.toUSecs() / realtime * 100
+    );
+    return Ok();
+}
+
+Async::Task<> entryPointAsync(Sys::Context&) {
+    co_try$(bench("native rate", 64, 48000));
+    co_try$(bench("resampled", 64, 44100));
+    co_return Ok();
+}
@@ -0,0 +1,180 @@
+#include <karm-base/simd.h>
+
+#include "mixer.h"
+#include "resample.h"
+
+namespace Karm::Av {
+
+// MARK: Voice -----------------------------------------------------------------
+
+Voice::Voice(Rc<Source> source, Remap remap, usize ringCap, usize block, f32 gain)
+    : _source(source),
+      _remap(std::move(remap)),
+      _ring(ringCap),
+      _gain(__builtin_bit_cast(u32, gain)) {
+    _decoded.resize(block * _remap.inChannels(), 0);
+    _remapped.resize(block * _remap.outChannels(), 0);
+    _mixed.resize(block * _remap.outChannels(), 0);
+}
+
+Res<> Voice::_pump() {
+    auto channels = _remap.outChannels();
+    while (not _ended.load(RELAXED) and _ring.writable() >= _remapped.len()) {
+        auto frames = try$(_source->read(_decoded));
+        if (frames == 0) {
+            _ended.store(true, RELEASE);
+            break;
+        }
+
+        _remap.apply(_decoded, _remapped, frames);
+        _ring.push(sub(_remapped, 0, frames * channels));
+    }
+    return Ok();
+}
+
+// MARK: Mixer -----------------------------------------------------------------
+
+Res<Rc<Voice>> Mixer::add(Rc<Source> source, f32 gain) {
+    _reclaim();
+    if (_voices.len() >= MAX_VOICES)
+        return Error::outOfMemory("too many voices");
+
+    if (source->sampleRate() != _sampleRate)
+        source = makeRc<Resampler>(source, _sampleRate);
+
+    auto voice = makeRc<Voice>(
+        source,
+        Remap::between(source->layout(), _layout),
+        RING_FRAMES * channels(),
+        BLOCK,
+        gain
+    );
+    _voices.pushBack(voice);
+
+    Array<_Command, 1> cmd = {_Command{_Command::ADD, &*voice}};
+    _commands.push(cmd);
+    return Ok(voice);
+}
+
+void Mixer::remove(Rc<Voice> voice) {
+    _reclaim();
+    if (voice->_removed)
+        return;
+
+    for (auto& v : _voices) {
+        if (&*v == &*voice) {
+            voice->_removed = true;
+            Array<_Command, 1> cmd = {_Command{_Command::REMOVE, &*voice}};
+            _commands.push(cmd);
+            return;
+        }
+    }
+}
+
+void Mixer::_reclaim() {
+    Array<Voice*, 16> retired;
+    while (auto n = _retired.pop(retired)) {
+        for (auto* voice : sub(retired, 0, n)) {
+            for (usize i = 0; i < _voices.len(); i++) {
+                if (&*_voices[i] == voice) {
+                    _voices.removeAt(i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+Res<> Mixer::pump() {
+    _reclaim();
+    for (auto& voice : _voices)
+        try$(voice->_pump());
+    return Ok();
+}
+
+// out += in * gain, eight samples at a time.
+static void _accumulate(f32* out, f32 const* in, usize len, f32 gain) {
+    usize i = 0;
+    f32x8 g = f32x8{} + gain;
+    for (; i + 8 <= len; i += 8) {
+        f32x8 a, b;
+        memcpy(&a, out + i, sizeof(a));
+        memcpy(&b, in + i, sizeof(b));
+        a += b * g;
+        memcpy(out + i, &a, sizeof(a));
+    }
+
+    for (; i < len; i++)
+        out[i] += in[i] * gain;
+}
+
+void Mixer::_retire(usize index) {
+    Array<Voice*, 1> voice = {_active.removeAt(index)};
+    _retired.push(voice);
+}
+
+void Mixer::_applyCommands() {
+    Array<_Command, 16> cmds;
+    while (auto n = _commands.pop(cmds)) {
+        for (auto& cmd : sub(cmds, 0, n)) {
+            if (cmd.op == _Command::ADD) {
+                _active.pushBack(cmd.voice);
+                continue;
+            }
+
+            // NOTE: A voice that ended may have been handed back already,
+            //       it's only compared against, never dereferenced.
+            for (usize i = 0; i < _active.len(); i++) {
+                if (_active[i] == cmd.voice) {
+                    _retire(i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void Mixer::mix(MutSlice<f32> out) {
+    _applyCommands();
+
+    for (usize i = 0; i < out.len(); i++)
+        out[i] = 0;
+
+    for (usize i = 0; i < _active.len();) {
+        auto& voice = *_active[i];
+        auto gain = voice.gain();
+
+        for (usize start = 0; start < out.len();) {
+            auto chunk = min(out.len() - start, voice._mixed.len());
+            auto n = voice._ring.pop(mutSub(voice._mixed, 0, chunk));
+            if (n == 0)
+                break;
+            _accumulate(out.buf() + start, voice._mixed.buf(), n, gain);
+            start += n;
+        }
+
+        // NOTE: Voices that are done are handed back once everything
+        //       they decoded has been mixed.
+        if (voice.ended() and voice._ring.readable() == 0)
+            _retire(i);
+        else
+            i++;
+    }
+}
+
+Res<> Mixer::render(Sink& sink, usize frames) {
+    Vec<f32> block;
+    block.resize(BLOCK * channels(), 0);
+
+    while (frames) {
+        auto n = min(frames, BLOCK);
+        try$(pump());
+        auto samples = mutSub(block, 0, n * channels());
+        mix(samples);
+        try$(sink.write(samples));
+        frames -= n;
+    }
+    return Ok();
+}
+
+} // namespace Karm::Av
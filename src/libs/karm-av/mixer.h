@@ -0,0 +1,132 @@
+#pragma once
+
+#include <karm-base/rc.h>
+
+#include "remap.h"
+#include "ring.h"
+#include "sink.h"
+#include "source.h"
+
+namespace Karm::Av {
+
+struct Voice {
+    Rc<Source> _source;
+    Remap _remap;
+    SpscRing<f32> _ring;
+    Vec<f32> _decoded;  // Producer side scratch, in the source layout
+    Vec<f32> _remapped; // Producer side scratch, in the mixer layout
+    Vec<f32> _mixed;    // Consumer side scratch
+    Atomic<u32> _gain;
+    Atomic<bool> _ended{};
+
+    Voice(Rc<Source> source, Remap remap, usize ringCap, usize block, f32 gain);
+
+    f32 gain() {
+        return __builtin_bit_cast(f32, _gain.load(RELAXED));
+    }
+
+    // Can be called from any thread, takes effect on the next block mixed.
+    void setGain(f32 gain) {
+        _gain.store(__builtin_bit_cast(u32, gain), RELAXED);
+    }
+
+    bool ended() {
+        return _ended.load(ACQUIRE);
+    }
+
+    bool _removed = false; // Producer side, remove() was called
+
+    Res<> _pump();
+};
+
+// Mixes many voices into one stream of interleaved samples.
+//
+// Decoding runs on the producer side, in pump(), which fills a lock-free
+// ring per voice. mix() runs on the real-time side, it only reads from
+// those rings and never blocks or allocates; a voice that didn't keep up
+// is silent until it catches up.
+//
+// add(), remove() and pump() must be called from the producer side, they
+// can run at the same time as mix(). The two sides never share the list
+// of voices: voices are handed over to the mixing side through a command
+// queue, and handed back through another one once it's done with them,
+// so they are always freed on the producer side.
+struct Mixer {
+    static constexpr usize BLOCK = 256;
+    static constexpr usize RING_FRAMES = 4096;
+    static constexpr usize MAX_VOICES = 256;
+
+    struct _Command {
+        enum struct Op : u8 {
+            ADD,
+            REMOVE,
+        };
+
+        using enum Op;
+
+        Op op;
+        Voice* voice;
+    };
+
+    AudioChannel _layout;
+    usize _sampleRate;
+
+    // Producer side, every voice until the mixing side handed it back.
+    Vec<Rc<Voice>> _voices;
+
+    // NOTE: Each voice is added, removed and handed back at most once,
+    //       so the queues can't fill up while there are fewer voices
+    //       than MAX_VOICES.
+    SpscRing<_Command> _commands{MAX_VOICES * 2};
+    SpscRing<Voice*> _retired{MAX_VOICES};
+
+    // Mixing side, the voices being mixed.
+    Vec<Voice*> _active;
+
+    Mixer(AudioChannel layout, usize sampleRate)
+        : _layout(layout), _sampleRate(sampleRate) {
+        _voices.ensure(MAX_VOICES);
+        _active.ensure(MAX_VOICES);
+    }
+
+    AudioChannel layout() const {
+        return _layout;
+    }
+
+    usize sampleRate() const {
+        return _sampleRate;
+    }
+
+    usize channels() const {
+        return channelCount(_layout);
+    }
+
+    /// Adds a voice, resampled to the rate of the mixer and remapped to
+    /// its layout as needed. Fails if there are already MAX_VOICES voices.
+    Res<Rc<Voice>> add(Rc<Source> source, f32 gain = 1);
+
+    void remove(Rc<Voice> voice);
+
+    /// Decodes ahead into the voices, until their rings are full or their
+    /// sources are over.
+    Res<> pump();
+
+    /// Mixes the next frames into `out`, replacing its content.
+    void mix(MutSlice<f32> out);
+
+    /// Pumps and mixes `frames` frames into `sink`, for rendering without
+    /// an audio device.
+    Res<> render(Sink& sink, usize frames);
+
+    // Producer side, frees the voices the mixing side handed back.
+    void _reclaim();
+
+    // Mixing side, takes the voices added and removed since the last
+    // block into account.
+    void _applyCommands();
+
+    // Mixing side, stops mixing the voice at `index` and hands it back.
+    void _retire(usize index);
+};
+
+} // namespace Karm::Av
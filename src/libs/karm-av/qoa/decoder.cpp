@@ -0,0 +1,117 @@
+#include <karm-io/bscan.h>
+#include <karm-io/funcs.h>
+
+#include "decoder.h"
+
+namespace Qoa {
+
+static Res<Opt<u64>> _readU64be(Io::Reader& reader) {
+    Array<u8, 8> buf;
+    auto n = try$(Io::readFull(reader, buf));
+    if (n == 0)
+        return Ok(NONE);
+    if (n != buf.len())
+        return Error::invalidData("unexpected end of file");
+    return Ok(Io::BScan{buf}.nextU64be());
+}
+
+Res<Decoder> Decoder::init(Io::Reader& reader) {
+    auto fileHeader = try$(_readU64be(reader));
+    if (not fileHeader or (*fileHeader >> 32) != 0x716F6166)
+        return Error::invalidData("not a qoa file");
+
+    auto frameHeader = try$(_readU64be(reader));
+    if (not frameHeader)
+        return Error::invalidData("no frames");
+
+    usize channels = (*frameHeader >> 56) & 0xff;
+    usize sampleRate = (*frameHeader >> 32) & 0xffffff;
+    if (channels == 0 or channels > MAX_CHANNELS or sampleRate == 0)
+        return Error::invalidData("invalid frame header");
+
+    return Ok(Decoder{reader, channels, sampleRate, (usize)(*fileHeader & 0xffffffff), *frameHeader});
+}
+
+// Decodes the next frame into _decoded, returns false at the end of the
+// stream.
+Res<bool> Decoder::_decodeFrame() {
+    if (not _header)
+        _header = try$(_readU64be(_reader));
+    if (not _header)
+        return Ok(false);
+
+    u64 header = _header.take();
+    usize channels = (header >> 56) & 0xff;
+    usize sampleRate = (header >> 32) & 0xffffff;
+    usize samples = (header >> 16) & 0xffff;
+    usize size = header & 0xffff;
+
+    if (channels != _channels or sampleRate != _sampleRate)
+        return Error::notImplemented("qoa streams with varying formats are not supported");
+
+    usize slices = (samples + SLICE_LEN - 1) / SLICE_LEN;
+    usize expected = FRAME_HEADER_SIZE + LMS_SIZE * channels + 8 * slices * channels;
+    if (samples == 0 or samples > FRAME_LEN or size != expected)
+        return Error::invalidData("invalid frame size");
+
+    _frame.resize(size - FRAME_HEADER_SIZE);
+    if (try$(Io::readFull(_reader, _frame)) != _frame.len())
+        return Error::invalidData("unexpected end of file");
+
+    Io::BScan s{_frame};
+
+    for (usize c = 0; c < channels; c++) {
+        u64 history = s.nextU64be();
+        u64 weights = s.nextU64be();
+        for (usize i = 0; i < 4; i++) {
+            _lms[c].history[i] = (i16)(history >> 48);
+            history <<= 16;
+            _lms[c].weights[i] = (i16)(weights >> 48);
+            weights <<= 16;
+        }
+    }
+
+    _decoded.resize(samples * channels);
+    _pos = 0;
+
+    for (usize start = 0; start < samples; start += SLICE_LEN) {
+        usize end = min(start + SLICE_LEN, samples);
+        for (usize c = 0; c < channels; c++) {
+            u64 slice = s.nextU64be();
+            auto const& dequant = DEQUANT[(slice >> 60) & 0xf];
+            slice <<= 4;
+
+            auto& lms = _lms[c];
+            for (usize i = start; i < end; i++) {
+                i32 predicted = lms.predict();
+                i32 dequantized = dequant[(slice >> 61) & 0x7];
+                i32 reconstructed = clamp(predicted + dequantized, -32768, 32767);
+                slice <<= 3;
+
+                _decoded[i * channels + c] = reconstructed / 32768.0f;
+                lms.update(reconstructed, dequantized);
+            }
+        }
+    }
+
+    return Ok(true);
+}
+
+Res<usize> Decoder::read(MutSlice<f32> samples) {
+    usize frames = samples.len() / _channels;
+    usize n = 0;
+    while (n < frames) {
+        if (_pos == _decoded.len()) {
+            if (not try$(_decodeFrame()))
+                break;
+        }
+
+        usize chunk = min((frames - n) * _channels, _decoded.len() - _pos);
+        copy(sub(_decoded, _pos, _pos + chunk), mutNext(samples, n * _channels));
+        _pos += chunk;
+        n += chunk / _channels;
+    }
+    return Ok(n);
+}
+
+} // namespace Qoa
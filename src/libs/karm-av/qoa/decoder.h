@@ -0,0 +1,50 @@
+#pragma once
+
+#include <karm-io/traits.h>
+
+#include "../source.h"
+#include "spec.h"
+
+namespace Qoa {
+
+// Streams the samples of a QOA file out of a reader, one frame of up to
+// 5120 samples per channel at a time. The reader must outlive the decoder.
+struct Decoder : public Karm::Av::Source {
+    Io::Reader& _reader;
+    usize _channels;
+    usize _sampleRate;
+    usize _samples; // Samples per channel, zero when streaming
+
+    Opt<u64> _header = NONE; // Header of the next frame, if already read
+    Array<Lms, MAX_CHANNELS> _lms{};
+    Vec<u8> _frame;
+    Vec<f32> _decoded;
+    usize _pos = 0;
+
+    Decoder(Io::Reader& reader, usize channels, usize sampleRate, usize samples, u64 header)
+        : _reader(reader),
+          _channels(channels),
+          _sampleRate(sampleRate),
+          _samples(samples),
+          _header(header) {}
+
+    static bool sniff(Bytes bytes) {
+        return bytes.len() >= 4 and sub(bytes, 0, 4) == MAGIC;
+    }
+
+    static Res<Decoder> init(Io::Reader& reader);
+
+    Karm::Av::AudioChannel layout() const override {
+        return Karm::Av::defaultLayout(_channels);
+    }
+
+    usize sampleRate() const override {
+        return _sampleRate;
+    }
+
+    Res<bool> _decodeFrame();
+
+    Res<usize> read(MutSlice<f32> samples) override;
+};
+
+} // namespace Qoa
@@ -2,6 +2,67 @@
 
 // https://github.com/phoboslab/qoa
 
+#include <karm-base/array.h>
+
 namespace Qoa {
 
+// magic "qoaf"
+static constexpr Array<u8, 4> MAGIC = {
+    0x71, 0x6F, 0x61, 0x66
+};
+
+static constexpr usize FILE_HEADER_SIZE = 8;
+static constexpr usize FRAME_HEADER_SIZE = 8;
+static constexpr usize LMS_SIZE = 16;
+static constexpr usize SLICE_LEN = 20;
+static constexpr usize SLICES_PER_FRAME = 256;
+static constexpr usize FRAME_LEN = SLICES_PER_FRAME * SLICE_LEN;
+static constexpr usize MAX_CHANNELS = 8;
+
+// round(pow(s + 1, 2.75))
+static constexpr Array<i32, 16> SCALEFACTORS = {
+    1, 7, 21, 45, 84, 138, 211, 304, 421, 562, 731, 928, 1157, 1419, 1715, 2048
+};
+
+// The residuals of the quantized values, times four: 0.75, -0.75, 2.5,
+// -2.5, 4.5, -4.5, 7 and -7
+static constexpr Array<i32, 8> DEQUANT_STEPS = {
+    3, -3, 10, -10, 18, -18, 28, -28
+};
+
+// Scalefactor times step, rounded half away from zero.
+static constexpr Array<Array<i32, 8>, 16> DEQUANT = [] {
+    Array<Array<i32, 8>, 16> tab{};
+    for (usize s = 0; s < 16; s++) {
+        for (usize q = 0; q < 8; q++) {
+            i32 v = SCALEFACTORS[s] * DEQUANT_STEPS[q];
+            tab[s][q] = v < 0 ? -((-v + 2) / 4) : (v + 2) / 4;
+        }
+    }
+    return tab;
+}();
+
+struct Lms {
+    Array<i32, 4> history;
+    Array<i32, 4> weights;
+
+    i32 predict() const {
+        i32 prediction = 0;
+        for (usize i = 0; i < 4; i++)
+            prediction += weights[i] * history[i];
+        return prediction >> 13;
+    }
+
+    void update(i32 sample, i32 residual) {
+        i32 delta = residual >> 4;
+        for (usize i = 0; i < 4; i++)
+            weights[i] += history[i] < 0 ? -delta : delta;
+
+        history[0] = history[1];
+        history[1] = history[2];
+        history[2] = history[3];
+        history[3] = sample;
+    }
+};
+
 } // namespace Qoa
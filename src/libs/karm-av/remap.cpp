@@ -0,0 +1,152 @@
+#include "remap.h"
+
+namespace Karm::Av {
+
+// MARK: Remap -----------------------------------------------------------------
+
+static constexpr f32 HALF_POWER = 0.70710678f;
+
+static usize _indexOf(AudioChannel layout, u32 channel) {
+    auto bits = toUnderlyingType(layout);
+    return __builtin_popcount(bits & (channel - 1));
+}
+
+static bool _has(AudioChannel layout, AudioChannel channel) {
+    return toUnderlyingType(layout) & toUnderlyingType(channel);
+}
+
+Remap Remap::between(AudioChannel from, AudioChannel to) {
+    Remap remap;
+    remap._in = channelCount(from);
+    remap._out = channelCount(to);
+    remap._identity = from == to;
+    remap._matrix.resize(remap._in * remap._out, 0);
+
+    auto set = [&](AudioChannel out, u32 in, f32 gain) {
+        if (not _has(to, out))
+            return false;
+        remap._matrix[_indexOf(to, toUnderlyingType(out)) * remap._in + _indexOf(from, in)] += gain;
+        return true;
+    };
+
+    for (u32 bit = 1; bit and bit <= toUnderlyingType(from); bit <<= 1) {
+        if (not(toUnderlyingType(from) & bit))
+            continue;
+
+        // Mono goes to both front speakers, and everything goes to
+        // the only speaker there is.
+        if (from == AudioChannel::MONO) {
+            bool front = set(AudioChannel::FRONT_LEFT, bit, 1) |
+                         set(AudioChannel::FRONT_RIGHT, bit, 1);
+            if (not front)
+                set(AudioChannel::FRONT_CENTER, bit, 1);
+            continue;
+        }
+
+        if (to == AudioChannel::MONO) {
+            if (bit != toUnderlyingType(AudioChannel::LOW_FREQUENCY))
+                set(AudioChannel::FRONT_LEFT, bit, 1.0f / remap._in);
+            continue;
+        }
+
+        if (set((AudioChannel)bit, bit, 1))
+            continue;
+
+        // NOTE: The low frequency channel is dropped rather than folded,
+        //       as the other speakers can't reproduce it anyway.
+        switch ((AudioChannel)bit) {
+        case AudioChannel::LOW_FREQUENCY:
+        case AudioChannel::LOW_FREQUENCY_2:
+            break;
+
+        case AudioChannel::FRONT_CENTER:
+        case AudioChannel::BACK_CENTER:
+        case AudioChannel::TOP_CENTER:
+        case AudioChannel::TOP_FRONT_CENTER:
+        case AudioChannel::TOP_BACK_CENTER:
+        case AudioChannel::BOTTOM_FRONT_CENTER:
+            set(AudioChannel::FRONT_LEFT, bit, HALF_POWER);
+            set(AudioChannel::FRONT_RIGHT, bit, HALF_POWER);
+            break;
+
+        case AudioChannel::BACK_LEFT:
+            if (not set(AudioChannel::SIDE_LEFT, bit, 1))
+                set(AudioChannel::FRONT_LEFT, bit, HALF_POWER);
+            break;
+
+        case AudioChannel::BACK_RIGHT:
+            if (not set(AudioChannel::SIDE_RIGHT, bit, 1))
+                set(AudioChannel::FRONT_RIGHT, bit, HALF_POWER);
+            break;
+
+        case AudioChannel::SIDE_LEFT:
+            if (not set(AudioChannel::BACK_LEFT, bit, 1))
+                set(AudioChannel::FRONT_LEFT, bit, HALF_POWER);
+            break;
+
+        case AudioChannel::SIDE_RIGHT:
+            if (not set(AudioChannel::BACK_RIGHT, bit, 1))
+                set(AudioChannel::FRONT_RIGHT, bit, HALF_POWER);
+            break;
+
+        case AudioChannel::FRONT_LEFT_OF_CENTER:
+        case AudioChannel::FRONT_WIDE_LEFT:
+        case AudioChannel::TOP_FRONT_LEFT:
+        case AudioChannel::TOP_BACK_LEFT:
+        case AudioChannel::TOP_SIDE_LEFT:
+        case AudioChannel::BOTTOM_FRONT_LEFT:
+            set(AudioChannel::FRONT_LEFT, bit, HALF_POWER);
+            break;
+
+        case AudioChannel::FRONT_RIGHT_OF_CENTER:
+        case AudioChannel::FRONT_WIDE_RIGHT:
+        case AudioChannel::TOP_FRONT_RIGHT:
+        case AudioChannel::TOP_BACK_RIGHT:
+        case AudioChannel::TOP_SIDE_RIGHT:
+        case AudioChannel::BOTTOM_FRONT_RIGHT:
+            set(AudioChannel::FRONT_RIGHT, bit, HALF_POWER);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return remap;
+}
+
+void Remap::apply(Slice<f32> in, MutSlice<f32> out, usize frames) const {
+    if (_identity) {
+        copy(sub(in, 0, frames * _in), out);
+        return;
+    }
+
+    for (usize f = 0; f < frames; f++) {
+        auto const* src = in.buf() + f * _in;
+        auto* dst = out.buf() + f * _out;
+        for (usize o = 0; o < _out; o++) {
+            f32 acc = 0;
+            for (usize i = 0; i < _in; i++)
+                acc += src[i] * _matrix[o * _in + i];
+            dst[o] = acc;
+        }
+    }
+}
+
+// MARK: Planar ----------------------------------------------------------------
+
+void deinterleave(Slice<f32> in, usize channels, MutSlice<f32> out) {
+    usize frames = in.len() / channels;
+    for (usize c = 0; c < channels; c++)
+        for (usize f = 0; f < frames; f++)
+            out[c * frames + f] = in[f * channels + c];
+}
+
+void interleave(Slice<f32> in, usize channels, MutSlice<f32> out) {
+    usize frames = in.len() / channels;
+    for (usize c = 0; c < channels; c++)
+        for (usize f = 0; f < frames; f++)
+            out[f * channels + c] = in[c * frames + f];
+}
+
+} // namespace Karm::Av
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <karm-base/slice.h>
+#include <karm-base/vec.h>
+
+#include "audio.h"
+
+namespace Karm::Av {
+
+// Mixing matrix from the channels of one layout to the channels of
+// another, channels missing from the target are folded into the ones
+// closest to them.
+struct Remap {
+    usize _in = 0;
+    usize _out = 0;
+    bool _identity = false;
+    Vec<f32> _matrix; // _out rows of _in coefficients
+
+    static Remap between(AudioChannel from, AudioChannel to);
+
+    usize inChannels() const { return _in; }
+
+    usize outChannels() const { return _out; }
+
+    f32 gain(usize out, usize in) const {
+        return _matrix[out * _in + in];
+    }
+
+    /// Remaps `frames` interleaved frames from `in` into `out`.
+    void apply(Slice<f32> in, MutSlice<f32> out, usize frames) const;
+};
+
+/// Splits interleaved frames into one contiguous plane per channel.
+void deinterleave(Slice<f32> in, usize channels, MutSlice<f32> out);
+
+/// Merges one plane per channel into interleaved frames.
+void interleave(Slice<f32> in, usize channels, MutSlice<f32> out);
+
+} // namespace Karm::Av
@@ -0,0 +1,116 @@
+#include <karm-math/const.h>
+#include <karm-math/funcs.h>
+
+#include "resample.h"
+
+namespace Karm::Av {
+
+static f64 _sinc(f64 x) {
+    if (Math::abs(x) < 1e-9)
+        return 1;
+    return Math::sin(Math::PI * x) / (Math::PI * x);
+}
+
+static f64 _blackman(f64 t) {
+    return 0.42 + 0.5 * Math::cos(Math::PI * t) + 0.08 * Math::cos(2 * Math::PI * t);
+}
+
+Resampler::Resampler(Rc<Source> source, usize sampleRate)
+    : _source(source),
+      _sampleRate(sampleRate),
+      _channels(source->channels()),
+      _step((f64)source->sampleRate() / sampleRate) {
+
+    // NOTE: When downsampling, the cutoff follows the output rate so what
+    //       it can't represent is filtered out instead of folded back.
+    f64 cutoff = min(1.0, 1.0 / _step) * 0.95;
+
+    _kernel.resize((PHASES + 1) * TAPS, 0);
+    for (usize p = 0; p <= PHASES; p++) {
+        f64 frac = (f64)p / PHASES;
+        f64 sum = 0;
+        for (usize k = 0; k < TAPS; k++) {
+            f64 x = (f64)k - (HALF_TAPS - 1) - frac;
+            f64 v = cutoff * _sinc(cutoff * x) * _blackman(x / HALF_TAPS);
+            _kernel[p * TAPS + k] = v;
+            sum += v;
+        }
+
+        // Unity gain at DC for every phase
+        for (usize k = 0; k < TAPS; k++)
+            _kernel[p * TAPS + k] /= sum;
+    }
+
+    _scratch.resize(BLOCK * _channels, 0);
+
+    // Silence before the first frame, so the kernel can be centered on it
+    _in.resize((HALF_TAPS - 1) * _channels, 0);
+    _pos = HALF_TAPS - 1;
+}
+
+Res<> Resampler::_fill(usize frames) {
+    while (_in.len() < frames * _channels) {
+        if (_ended) {
+            _in.resize(frames * _channels, 0);
+            break;
+        }
+
+        auto n = try$(_source->read(_scratch));
+        if (n == 0) {
+            _ended = true;
+            _end = _in.len() / _channels;
+            continue;
+        }
+
+        auto block = sub(_scratch, 0, n * _channels);
+        _in.pushBack(block);
+    }
+    return Ok();
+}
+
+Res<usize> Resampler::read(MutSlice<f32> samples) {
+    usize frames = samples.len() / _channels;
+    usize n = 0;
+
+    Array<f32, TAPS> coefs;
+    while (n < frames) {
+        auto base = (usize)_pos;
+        try$(_fill(base + HALF_TAPS + 1));
+        if (_ended and _pos >= _end)
+            break;
+
+        f64 phase = (_pos - base) * PHASES;
+        auto p0 = (usize)phase;
+        f32 t = phase - p0;
+        auto const* k0 = _kernel.buf() + p0 * TAPS;
+        auto const* k1 = k0 + TAPS;
+        for (usize k = 0; k < TAPS; k++)
+            coefs[k] = k0[k] + (k1[k] - k0[k]) * t;
+
+        auto const* src = _in.buf() + (base - (HALF_TAPS - 1)) * _channels;
+        auto* dst = samples.buf() + n * _channels;
+        for (usize c = 0; c < _channels; c++) {
+            f32 acc = 0;
+            for (usize k = 0; k < TAPS; k++)
+                acc += src[k * _channels + c] * coefs[k];
+            dst[c] = acc;
+        }
+
+        n++;
+        _pos += _step;
+    }
+
+    // Drop the frames the kernel has moved past, a block at a time
+    auto base = (usize)_pos;
+    if (base > HALF_TAPS - 1 + BLOCK) {
+        usize drop = base - (HALF_TAPS - 1);
+        _in.removeRange(0, drop * _channels);
+        _pos -= drop;
+        if (_ended)
+            _end -= drop;
+    }
+
+    return Ok(n);
+}
+
+} // namespace Karm::Av
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <karm-base/rc.h>
+
+#include "source.h"
+
+namespace Karm::Av {
+
+// Band-limited sample rate conversion, with a Blackman windowed sinc
+// kernel tabulated at a fixed number of fractional positions and
+// interpolated between them.
+struct Resampler : public Source {
+    static constexpr usize HALF_TAPS = 8;
+    static constexpr usize TAPS = HALF_TAPS * 2;
+    static constexpr usize PHASES = 64;
+    static constexpr usize BLOCK = 256;
+
+    Rc<Source> _source;
+    usize _sampleRate;
+    usize _channels;
+    f64 _step;
+
+    Vec<f32> _kernel; // PHASES + 1 rows of TAPS coefficients
+    Vec<f32> _in;     // Interleaved input frames around the read position
+    Vec<f32> _scratch;
+    f64 _pos = 0;
+    bool _ended = false;
+    usize _end = 0; // Frames of _in that came from the source, once ended
+
+    Resampler(Rc<Source> source, usize sampleRate);
+
+    AudioChannel layout() const override {
+        return _source->layout();
+    }
+
+    usize sampleRate() const override {
+        return _sampleRate;
+    }
+
+    Res<> _fill(usize frames);
+
+    Res<usize> read(MutSlice<f32> samples) override;
+};
+
+} // namespace Karm::Av
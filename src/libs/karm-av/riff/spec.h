@@ -2,6 +2,25 @@
 
 // https://johnloomis.org/cpe102/asgn/asgn1/riff.html#:~:text=The%20basis%20of%20the%20RIFF,area%20and%20the%20data%20itself.
 
+#include <karm-base/array.h>
+#include <karm-base/endian.h>
+
 namespace Riff {
 
+using FourCC = Array<u8, 4>;
+
+static constexpr FourCC RIFF = {'R', 'I', 'F', 'F'};
+
+struct ChunkHeader {
+    FourCC id;
+    u32le size;
+};
+
+static_assert(sizeof(ChunkHeader) == 8);
+
+// Chunks are padded to an even size.
+static constexpr usize padded(usize size) {
+    return size + (size & 1);
+}
+
 } // namespace Riff
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <karm-base/atomic.h>
+#include <karm-base/vec.h>
+#include <karm-meta/nocopy.h>
+
+namespace Karm::Av {
+
+// A lock-free queue between exactly one producer thread and one consumer
+// thread, used to hand decoded samples over to the mixer without it ever
+// waiting on a decoder.
+template <typename T>
+struct SpscRing : Meta::Pinned {
+    static_assert(Meta::TrivialyCopyable<T>);
+
+    Vec<T> _buf;
+    usize _mask;
+
+    // NOTE: The indices only ever grow and wrap around on overflow, each
+    //       one is written by a single side and kept on its own cache line.
+    alignas(64) Atomic<usize> _head{}; // Written by the producer
+    alignas(64) Atomic<usize> _tail{}; // Written by the consumer
+
+    SpscRing(usize cap) {
+        usize size = 1;
+        while (size < cap)
+            size <<= 1;
+        _buf.resize(size);
+        _mask = size - 1;
+    }
+
+    usize cap() const {
+        return _mask + 1;
+    }
+
+    // How many items can be popped, from the consumer side.
+    usize readable() {
+        return _head.load(ACQUIRE) - _tail.load(RELAXED);
+    }
+
+    // How many items can be pushed, from the producer side.
+    usize writable() {
+        return cap() - (_head.load(RELAXED) - _tail.load(ACQUIRE));
+    }
+
+    // Pushes as many items as fit, returns how many were pushed.
+    usize push(Slice<T> items) {
+        auto head = _head.load(RELAXED);
+        auto n = min(items.len(), cap() - (head - _tail.load(ACQUIRE)));
+        for (usize i = 0; i < n; i++)
+            _buf[(head + i) & _mask] = items[i];
+        _head.store(head + n, RELEASE);
+        return n;
+    }
+
+    // Pops as many items as available, returns how many were popped.
+    usize pop(MutSlice<T> items) {
+        auto tail = _tail.load(RELAXED);
+        auto n = min(items.len(), _head.load(ACQUIRE) - tail);
+        for (usize i = 0; i < n; i++)
+            items[i] = _buf[(tail + i) & _mask];
+        _tail.store(tail + n, RELEASE);
+        return n;
+    }
+};
+
+} // namespace Karm::Av
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <karm-base/vec.h>
+#include <karm-io/traits.h>
+
+#include "audio.h"
+#include "wav/encoder.h"
+
+namespace Karm::Av {
+
+// Where mixed samples end up, an audio device or a file.
+struct Sink {
+    virtual ~Sink() = default;
+
+    /// Consumes interleaved samples.
+    virtual Res<> write(Slice<f32> samples) = 0;
+};
+
+// Collects samples and writes them out as a WAV file on flush(), so the
+// audio pipeline can run without an audio device.
+struct WavSink : public Sink {
+    Io::Writer& _writer;
+    AudioChannel _layout;
+    usize _sampleRate;
+    AudioFormat _format;
+    Vec<f32> _samples;
+
+    WavSink(Io::Writer& writer, AudioChannel layout, usize sampleRate, AudioFormat format = AudioFormat::PCM_I16)
+        : _writer(writer),
+          _layout(layout),
+          _sampleRate(sampleRate),
+          _format(format) {}
+
+    Slice<f32> samples() const {
+        return _samples;
+    }
+
+    Res<> write(Slice<f32> samples) override {
+        _samples.pushBack(samples);
+        return Ok();
+    }
+
+    Res<> flush() {
+        return Wav::encode(_writer, _samples, _layout, _sampleRate, _format);
+    }
+};
+
+} // namespace Karm::Av
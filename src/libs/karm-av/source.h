@@ -0,0 +1,69 @@
+#pragma once
+
+#include <karm-base/slice.h>
+#include <karm-base/vec.h>
+
+#include "audio.h"
+
+namespace Karm::Av {
+
+// A stream of interleaved samples, in [-1, 1], pulled a block at a time.
+struct Source {
+    virtual ~Source() = default;
+
+    virtual AudioChannel layout() const = 0;
+
+    virtual usize sampleRate() const = 0;
+
+    usize channels() const {
+        return channelCount(layout());
+    }
+
+    /// Reads as many whole frames as fit in `samples`, returns how many
+    /// frames were read, zero once the stream is over.
+    virtual Res<usize> read(MutSlice<f32> samples) = 0;
+};
+
+// Samples already in memory, played once or looped forever.
+struct BufferSource : public Source {
+    Vec<f32> _samples;
+    AudioChannel _layout;
+    usize _sampleRate;
+    bool _loop;
+    usize _pos = 0;
+
+    BufferSource(Vec<f32> samples, AudioChannel layout, usize sampleRate, bool loop = false)
+        : _samples(std::move(samples)),
+          _layout(layout),
+          _sampleRate(sampleRate),
+          _loop(loop) {}
+
+    AudioChannel layout() const override {
+        return _layout;
+    }
+
+    usize sampleRate() const override {
+        return _sampleRate;
+    }
+
+    Res<usize> read(MutSlice<f32> samples) override {
+        auto chans = channels();
+        usize len = (samples.len() / chans) * chans;
+        usize n = 0;
+        while (n < len) {
+            if (_pos == _samples.len()) {
+                if (not _loop or _samples.len() == 0)
+                    break;
+                _pos = 0;
+            }
+
+            auto chunk = min(len - n, _samples.len() - _pos);
+            copy(sub(_samples, _pos, _pos + chunk), mutNext(samples, n));
+            _pos += chunk;
+            n += chunk;
+        }
+        return Ok(n / chans);
+    }
+};
+
+} // namespace Karm::Av
@@ -0,0 +1,150 @@
+#include <karm-av/mixer.h>
+#include <karm-av/resample.h>
+#include <karm-io/impls.h>
+#include <karm-math/funcs.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Av::Tests {
+
+static Rc<Source> _constant(f32 value, usize frames, AudioChannel layout, usize sampleRate) {
+    Vec<f32> samples;
+    samples.resize(frames * channelCount(layout), value);
+    return makeRc<BufferSource>(std::move(samples), layout, sampleRate);
+}
+
+test$("av-ring") {
+    SpscRing<u32> ring{4};
+    Array<u32, 6> in = {1, 2, 3, 4, 5, 6};
+    Array<u32, 6> out = {};
+
+    expectEq$(ring.push(in), 4uz);
+    expectEq$(ring.pop(mutSub(out, 0, 3)), 3uz);
+    expectEq$(ring.push(sub(in, 4, 6)), 2uz);
+    expectEq$(ring.readable(), 3uz);
+    expectEq$(ring.pop(out), 3uz);
+
+    expectEq$(out[0], 4u);
+    expectEq$(out[1], 5u);
+    expectEq$(out[2], 6u);
+    return Ok();
+}
+
+test$("av-remap-stereo-to-mono") {
+    auto remap = Remap::between(AudioChannel::STEREO, AudioChannel::MONO);
+    Array<f32, 2> in = {1, 0};
+    Array<f32, 1> out = {};
+    remap.apply(in, out, 1);
+    expectEq$(out[0], 0.5f);
+    return Ok();
+}
+
+test$("av-mixer-gain") {
+    Mixer mixer{AudioChannel::STEREO, 48000};
+    try$(mixer.add(_constant(0.25, 1000, AudioChannel::MONO, 48000)));
+    try$(mixer.add(_constant(0.5, 1000, AudioChannel::MONO, 48000), 0.5));
+
+    Io::BufferWriter writer;
+    WavSink sink{writer, AudioChannel::STEREO, 48000, AudioFormat::PCM_F32};
+    try$(mixer.render(sink, 1000));
+
+    expectEq$(sink.samples().len(), 2000uz);
+    for (auto s : sink.samples())
+        expectEq$(s, 0.5f);
+
+    // The voices are dropped once they are done
+    try$(mixer.render(sink, 256));
+    expectEq$(mixer._voices.len(), 0uz);
+
+    return Ok();
+}
+
+test$("av-mixer-remove") {
+    Mixer mixer{AudioChannel::MONO, 48000};
+    try$(mixer.add(_constant(0.25, 48000, AudioChannel::MONO, 48000)));
+    auto voice = try$(mixer.add(_constant(0.5, 48000, AudioChannel::MONO, 48000)));
+
+    Array<f32, Mixer::BLOCK> out;
+    try$(mixer.pump());
+    mixer.mix(out);
+    expectEq$(out[0], 0.75f);
+
+    // NOTE: The voice is kept alive until the mixing side handed it back.
+    mixer.remove(voice);
+    mixer.remove(voice);
+    expectEq$(mixer._voices.len(), 2uz);
+
+    mixer.mix(out);
+    expectEq$(out[0], 0.25f);
+    try$(mixer.pump());
+    expectEq$(mixer._voices.len(), 1uz);
+
+    return Ok();
+}
+
+test$("av-mixer-threads") {
+    static constexpr usize VOICES = 1000;
+    static constexpr usize FRAMES = 300;
+
+    Mixer mixer{AudioChannel::MONO, 48000};
+    Atomic<bool> done = false;
+    Atomic<usize> added = 0;
+
+    // NOTE: The producer adds, removes and pumps voices while the mixing
+    //       side runs, every voice adds 0.25 to every sample it covers.
+    auto producer = try$(Sys::spawn([&] {
+        for (usize i = 0; i < VOICES;) {
+            auto voice = mixer.add(_constant(0.25, FRAMES, AudioChannel::MONO, 48000));
+            if (voice) {
+                if (i % 3 == 0)
+                    mixer.remove(voice.unwrap());
+                added.inc();
+                i++;
+            }
+            (void)mixer.pump();
+        }
+
+        while (not done.load())
+            (void)mixer.pump();
+    }));
+
+    // NOTE: The expectations are only checked once the producer is
+    //       joined, it uses the mixer on the stack of this function.
+    bool valid = true;
+    Array<f32, Mixer::BLOCK> out;
+    while (added.load() < VOICES) {
+        mixer.mix(out);
+        for (auto s : out) {
+            if (s < 0 or s > 0.25f * Mixer::MAX_VOICES or s / 0.25f != Math::floor(s / 0.25f))
+                valid = false;
+        }
+    }
+
+    done.store(true);
+    try$(producer->join());
+    expect$(valid);
+
+    // NOTE: Once both sides are done, every voice ends up handed back.
+    for (usize i = 0; i < 64 and mixer._voices.len(); i++) {
+        try$(mixer.pump());
+        mixer.mix(out);
+    }
+    expectEq$(mixer._voices.len(), 0uz);
+    expectEq$(mixer._active.len(), 0uz);
+
+    return Ok();
+}
+
+test$("av-resample-dc") {
+    Resampler resampler{_constant(0.5, 2000, AudioChannel::MONO, 44100), 48000};
+    Array<f32, 1000> out;
+    expectEq$(try$(resampler.read(out)), 1000uz);
+
+    // NOTE: The first frames blend with the silence before the stream.
+    for (usize i = Resampler::TAPS; i < out.len(); i++)
+        expectLt$(Math::abs(out[i] - 0.5f), 1e-3f);
+
+    return Ok();
+}
+
+} // namespace Karm::Av::Tests
@@ -0,0 +1,48 @@
+#include <karm-av/qoa/decoder.h>
+#include <karm-io/bscan.h>
+#include <karm-io/impls.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Av::Tests {
+
+test$("qoa-decode-frame") {
+    // One mono frame of 40 samples, with a silent predictor. The first
+    // slice only has +1 residuals, the second only -1 residuals.
+    Io::BufferWriter writer;
+    Io::BEmit e{writer};
+    e.writeBytes(Qoa::MAGIC);
+    e.writeU32be(40);
+
+    e.writeU8be(1);
+    e.writeU8be(0x00);
+    e.writeU16be(44100);
+    e.writeU16be(40);
+    e.writeU16be(8 + 16 + 2 * 8);
+
+    e.writeU64be(0);
+    e.writeU64be(0);
+
+    e.writeU64be(0);
+    u64 negative = 0;
+    for (usize i = 0; i < Qoa::SLICE_LEN; i++)
+        negative |= 1ull << (57 - 3 * i);
+    e.writeU64be(negative);
+
+    Io::BufReader reader{writer.bytes()};
+    auto dec = try$(Qoa::Decoder::init(reader));
+    expectEq$(dec.channels(), 1uz);
+    expectEq$(dec.sampleRate(), 44100uz);
+
+    Array<f32, 64> samples;
+    expectEq$(try$(dec.read(samples)), 40uz);
+    for (usize i = 0; i < 20; i++)
+        expectEq$(samples[i], 1 / 32768.0f);
+    for (usize i = 20; i < 40; i++)
+        expectEq$(samples[i], -1 / 32768.0f);
+
+    expectEq$(try$(dec.read(samples)), 0uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Av::Tests
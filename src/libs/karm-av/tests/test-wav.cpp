@@ -0,0 +1,65 @@
+#include <karm-av/wav/decoder.h>
+#include <karm-av/wav/encoder.h>
+#include <karm-io/impls.h>
+#include <karm-math/funcs.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Av::Tests {
+
+static Res<Vec<f32>> _decodeAll(Wav::Decoder& dec) {
+    Vec<f32> result;
+    Array<f32, 64 * 4> block;
+    while (true) {
+        auto frames = try$(dec.read(block));
+        if (frames == 0)
+            break;
+        auto samples = sub(block, 0, frames * dec.channels());
+        result.pushBack(samples);
+    }
+    return Ok(result);
+}
+
+test$("wav-roundtrip-i16") {
+    Vec<f32> samples;
+    for (usize i = 0; i < 1000; i++)
+        samples.pushBack((i % 200) / 100.0f - 1.0f);
+
+    Io::BufferWriter writer;
+    try$(Wav::encode(writer, samples, AudioChannel::STEREO, 44100));
+
+    Io::BufReader reader{writer.bytes()};
+    auto dec = try$(Wav::Decoder::init(reader));
+    expect$(dec.layout() == AudioChannel::STEREO);
+    expectEq$(dec.sampleRate(), 44100uz);
+    expectEq$(dec.frames(), 500uz);
+
+    auto decoded = try$(_decodeAll(dec));
+    expectEq$(decoded.len(), samples.len());
+    for (usize i = 0; i < samples.len(); i++)
+        expectLt$(Math::abs(decoded[i] - samples[i]), 2 / 32768.0f);
+
+    return Ok();
+}
+
+test$("wav-roundtrip-f32-layout") {
+    Vec<f32> samples;
+    for (usize i = 0; i < 400; i++)
+        samples.pushBack(i / 400.0f);
+
+    Io::BufferWriter writer;
+    try$(Wav::encode(writer, samples, AudioChannel::QUAD_SIDE, 48000, AudioFormat::PCM_F32));
+
+    Io::BufReader reader{writer.bytes()};
+    auto dec = try$(Wav::Decoder::init(reader));
+    expect$(dec.layout() == AudioChannel::QUAD_SIDE);
+    expectEq$(dec.frames(), 100uz);
+
+    auto decoded = try$(_decodeAll(dec));
+    expectEq$(decoded.len(), samples.len());
+    for (usize i = 0; i < samples.len(); i++)
+        expectEq$(decoded[i], samples[i]);
+
+    return Ok();
+}
+
+} // namespace Karm::Av::Tests
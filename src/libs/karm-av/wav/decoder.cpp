@@ -0,0 +1,147 @@
+#include <karm-io/funcs.h>
+
+#include "decoder.h"
+
+namespace Wav {
+
+template <typename T>
+static Res<> _readStruct(Io::Reader& reader, T& value) {
+    MutBytes bytes{reinterpret_cast<Byte*>(&value), sizeof(T)};
+    if (try$(Io::readFull(reader, bytes)) != sizeof(T))
+        return Error::invalidData("unexpected end of file");
+    return Ok();
+}
+
+static bool _supported(Format format, usize bits) {
+    if (format == Format::PCM)
+        return bits == 8 or bits == 16 or bits == 24 or bits == 32;
+    if (format == Format::IEEE_FLOAT)
+        return bits == 32 or bits == 64;
+    return false;
+}
+
+Res<Decoder> Decoder::init(Io::Reader& reader) {
+    Array<u8, 12> header;
+    if (try$(Io::readFull(reader, header)) != header.len() or not sniff(header))
+        return Error::invalidData("not a wav file");
+
+    Opt<Fmt> fmt = NONE;
+    Format format = Format::PCM;
+    auto layout = Karm::Av::AudioChannel::INVALID;
+
+    while (true) {
+        Riff::ChunkHeader chunk;
+        try$(_readStruct(reader, chunk));
+        usize size = chunk.size;
+
+        if (chunk.id == DATA) {
+            if (not fmt)
+                return Error::invalidData("data chunk before fmt chunk");
+            return Ok(Decoder{reader, *fmt, format, layout, size});
+        }
+
+        if (chunk.id != FMT) {
+            try$(Io::skip(reader, Riff::padded(size)));
+            continue;
+        }
+
+        if (size < sizeof(Fmt))
+            return Error::invalidData("fmt chunk too small");
+
+        Fmt f;
+        try$(_readStruct(reader, f));
+        format = (Format)f.format.value();
+        layout = Karm::Av::defaultLayout(f.channels);
+        usize rest = Riff::padded(size) - sizeof(Fmt);
+
+        if (format == Format::EXTENSIBLE and rest >= sizeof(FmtExtensible)) {
+            FmtExtensible ext;
+            try$(_readStruct(reader, ext));
+            rest -= sizeof(FmtExtensible);
+            format = (Format)ext.subFormat.value();
+
+            // NOTE: WAV channel masks use the same bits as AudioChannel.
+            auto mask = (Karm::Av::AudioChannel)ext.channelMask.value();
+            if (Karm::Av::channelCount(mask) == f.channels)
+                layout = mask;
+        }
+
+        if (layout == Karm::Av::AudioChannel::INVALID)
+            return Error::invalidData("invalid channel count");
+
+        if (not _supported(format, f.bitsPerSample) or
+            f.blockAlign != f.channels * (f.bitsPerSample / 8))
+            return Error::notImplemented("unsupported sample format");
+
+        try$(Io::skip(reader, rest));
+        fmt = f;
+    }
+}
+
+Res<usize> Decoder::read(MutSlice<f32> samples) {
+    usize channels = _fmt.channels;
+    usize blockAlign = _fmt.blockAlign;
+    usize frames = min(samples.len() / channels, _remaining / blockAlign);
+    if (frames == 0)
+        return Ok(0uz);
+
+    _buf.resize(frames * blockAlign);
+    auto read = try$(Io::readFull(_reader, _buf));
+
+    // NOTE: A truncated file just ends early.
+    if (read < frames * blockAlign)
+        _remaining = 0;
+    else
+        _remaining -= read;
+    frames = read / blockAlign;
+
+    usize n = frames * channels;
+    u8 const* src = _buf.buf();
+    f32* dst = samples.buf();
+
+    switch (_fmt.bitsPerSample) {
+    case 8:
+        for (usize i = 0; i < n; i++)
+            dst[i] = (src[i] - 128) / 128.0f;
+        break;
+
+    case 16:
+        for (usize i = 0; i < n; i++)
+            dst[i] = (i16)(src[i * 2] | (src[i * 2 + 1] << 8)) / 32768.0f;
+        break;
+
+    case 24:
+        for (usize i = 0; i < n; i++) {
+            i32 v = (src[i * 3] << 8) | (src[i * 3 + 1] << 16) | (src[i * 3 + 2] << 24);
+            dst[i] = (v >> 8) / 8388608.0f;
+        }
+        break;
+
+    case 32:
+        if (_format == Format::IEEE_FLOAT) {
+            for (usize i = 0; i < n; i++) {
+                f32 v;
+                memcpy(&v, src + i * 4, 4);
+                dst[i] = v;
+            }
+        } else {
+            for (usize i = 0; i < n; i++) {
+                i32 v = src[i * 4] | (src[i * 4 + 1] << 8) | (src[i * 4 + 2] << 16) | ((u32)src[i * 4 + 3] << 24);
+                dst[i] = v / 2147483648.0f;
+            }
+        }
+        break;
+
+    case 64:
+        for (usize i = 0; i < n; i++) {
+            f64 v;
+            memcpy(&v, src + i * 8, 8);
+            dst[i] = v;
+        }
+        break;
+    }
+
+    return Ok(frames);
+}
+
+} // namespace Wav
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <karm-io/traits.h>
+
+#include "../source.h"
+#include "spec.h"
+
+namespace Wav {
+
+// Streams the samples of a WAV file out of a reader, converting them to
+// floats a block at a time. The reader must outlive the decoder.
+struct Decoder : public Karm::Av::Source {
+    Io::Reader& _reader;
+    Fmt _fmt;
+    Format _format;
+    Karm::Av::AudioChannel _layout;
+    usize _remaining; // Bytes left in the data chunk
+    Vec<u8> _buf;
+
+    Decoder(Io::Reader& reader, Fmt fmt, Format format, Karm::Av::AudioChannel layout, usize remaining)
+        : _reader(reader),
+          _fmt(fmt),
+          _format(format),
+          _layout(layout),
+          _remaining(remaining) {}
+
+    static bool sniff(Bytes bytes) {
+        return bytes.len() >= 12 and
+               sub(bytes, 0, 4) == Riff::RIFF and
+               sub(bytes, 8, 12) == WAVE;
+    }
+
+    static Res<Decoder> init(Io::Reader& reader);
+
+    Karm::Av::AudioChannel layout() const override {
+        return _layout;
+    }
+
+    usize sampleRate() const override {
+        return _fmt.sampleRate;
+    }
+
+    usize frames() const {
+        return _remaining / _fmt.blockAlign;
+    }
+
+    Res<usize> read(MutSlice<f32> samples) override;
+};
+
+} // namespace Wav
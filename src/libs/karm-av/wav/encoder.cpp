@@ -0,0 +1,82 @@
+#include <karm-io/funcs.h>
+
+#include "encoder.h"
+
+namespace Wav {
+
+static constexpr Array<u8, 14> SUBFORMAT_GUID = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+    0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+template <typename T>
+static Res<> _writeStruct(Io::Writer& writer, T const& value) {
+    Bytes bytes{reinterpret_cast<Byte const*>(&value), sizeof(T)};
+    if (try$(writer.write(bytes)) != sizeof(T))
+        return Error::writeZero();
+    return Ok();
+}
+
+Res<> encode(Io::Writer& writer, Slice<f32> samples, Karm::Av::AudioChannel layout, usize sampleRate, Karm::Av::AudioFormat format) {
+    if (format != Karm::Av::AudioFormat::PCM_I16 and
+        format != Karm::Av::AudioFormat::PCM_F32)
+        return Error::notImplemented("unsupported sample format");
+
+    usize channels = Karm::Av::channelCount(layout);
+    usize bytesPerSample = format == Karm::Av::AudioFormat::PCM_I16 ? 2 : 4;
+    Format tag = format == Karm::Av::AudioFormat::PCM_I16 ? Format::PCM : Format::IEEE_FLOAT;
+    bool extensible = layout != Karm::Av::defaultLayout(channels);
+
+    usize fmtSize = sizeof(Fmt) + (extensible ? sizeof(FmtExtensible) : 0);
+    usize dataSize = samples.len() * bytesPerSample;
+
+    try$(writer.write(Riff::RIFF));
+    try$(_writeStruct(writer, u32le(4 + 8 + fmtSize + 8 + Riff::padded(dataSize))));
+    try$(writer.write(WAVE));
+
+    try$(_writeStruct(writer, Riff::ChunkHeader{FMT, (u32)fmtSize}));
+    try$(_writeStruct(writer, Fmt{
+        .format = toUnderlyingType(extensible ? Format::EXTENSIBLE : tag),
+        .channels = (u16)channels,
+        .sampleRate = (u32)sampleRate,
+        .byteRate = (u32)(sampleRate * channels * bytesPerSample),
+        .blockAlign = (u16)(channels * bytesPerSample),
+        .bitsPerSample = (u16)(bytesPerSample * 8),
+    }));
+
+    if (extensible) {
+        try$(_writeStruct(writer, FmtExtensible{
+            .size = 22,
+            .validBitsPerSample = (u16)(bytesPerSample * 8),
+            .channelMask = toUnderlyingType(layout),
+            .subFormat = toUnderlyingType(tag),
+            .guid = SUBFORMAT_GUID,
+        }));
+    }
+
+    try$(_writeStruct(writer, Riff::ChunkHeader{DATA, (u32)dataSize}));
+
+    Array<u8, 4096> buf;
+    usize perBlock = buf.len() / bytesPerSample;
+    for (usize start = 0; start < samples.len(); start += perBlock) {
+        auto end = min(start + perBlock, samples.len());
+        for (usize i = start; i < end; i++) {
+            auto* dst = buf.buf() + (i - start) * bytesPerSample;
+            if (format == Karm::Av::AudioFormat::PCM_I16) {
+                auto v = (i16)clamp(samples[i] * 32768.0f, -32768.0f, 32767.0f);
+                dst[0] = v & 0xff;
+                dst[1] = (v >> 8) & 0xff;
+            } else {
+                memcpy(dst, &samples[i], 4);
+            }
+        }
+        try$(writer.write(sub(buf, 0, (end - start) * bytesPerSample)));
+    }
+
+    if (dataSize & 1)
+        try$(Io::putByte(writer, 0));
+
+    return Ok();
+}
+
+} // namespace Wav
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <karm-io/traits.h>
+
+#include "../audio.h"
+#include "spec.h"
+
+namespace Wav {
+
+/// Writes interleaved samples as a WAV file, either as 16-bit integers
+/// or as 32-bit floats.
+Res<> encode(
+    Io::Writer& writer,
+    Slice<f32> samples,
+    Karm::Av::AudioChannel layout,
+    usize sampleRate,
+    Karm::Av::AudioFormat format = Karm::Av::AudioFormat::PCM_I16
+);
+
+} // namespace Wav
@@ -2,6 +2,42 @@
 
 // https://en.wikipedia.org/wiki/WAV
 
+#include <karm-base/endian.h>
+
+#include "../riff/spec.h"
+
 namespace Wav {
 
+static constexpr Riff::FourCC WAVE = {'W', 'A', 'V', 'E'};
+static constexpr Riff::FourCC FMT = {'f', 'm', 't', ' '};
+static constexpr Riff::FourCC DATA = {'d', 'a', 't', 'a'};
+
+enum struct Format : u16 {
+    PCM = 0x0001,
+    IEEE_FLOAT = 0x0003,
+    EXTENSIBLE = 0xFFFE,
+};
+
+struct Fmt {
+    u16le format;
+    u16le channels;
+    u32le sampleRate;
+    u32le byteRate;
+    u16le blockAlign;
+    u16le bitsPerSample;
+};
+
+static_assert(sizeof(Fmt) == 16);
+
+// WAVE_FORMAT_EXTENSIBLE, following the basic fmt fields.
+struct FmtExtensible {
+    u16le size;
+    u16le validBitsPerSample;
+    u32le channelMask;
+    u16le subFormat; // The rest of the GUID is always the same
+    Array<u8, 14> guid;
+};
+
+static_assert(sizeof(FmtExtensible) == 24);
+
 } // namespace Wav
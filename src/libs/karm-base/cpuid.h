@@ -0,0 +1,66 @@
+#pragma once
+
+#include "base.h"
+
+namespace Karm {
+
+// Instruction set extensions that can be picked at runtime by the hot paths
+// that have a specialized implementation, everything is false on
+// architectures that don't have them.
+struct CpuFeatures {
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool pclmul = false;
+    bool avx2 = false;
+    bool sha = false;
+
+#ifdef __ck_arch_x86_64__
+    static void _cpuid(u32 leaf, u32 subleaf, u32& eax, u32& ebx, u32& ecx, u32& edx) {
+        asm volatile("cpuid"
+                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                     : "a"(leaf), "c"(subleaf));
+    }
+
+    static CpuFeatures detect() {
+        CpuFeatures res{};
+        u32 eax, ebx, ecx, edx;
+
+        _cpuid(0, 0, eax, ebx, ecx, edx);
+        u32 maxLeaf = eax;
+
+        _cpuid(1, 0, eax, ebx, ecx, edx);
+        res.ssse3 = ecx & (1 << 9);
+        res.sse41 = ecx & (1 << 19);
+        res.pclmul = ecx & (1 << 1);
+
+        // NOTE: AVX registers are only usable if the OS saves them
+        bool osAvx = false;
+        if (ecx & (1 << 27)) {
+            u32 xcr0Lo, xcr0Hi;
+            asm volatile("xgetbv"
+                         : "=a"(xcr0Lo), "=d"(xcr0Hi)
+                         : "c"(0));
+            osAvx = (xcr0Lo & 0b110) == 0b110;
+        }
+
+        if (maxLeaf >= 7) {
+            _cpuid(7, 0, eax, ebx, ecx, edx);
+            res.avx2 = osAvx and (ebx & (1 << 5));
+            res.sha = ebx & (1 << 29);
+        }
+
+        return res;
+    }
+#else
+    static CpuFeatures detect() {
+        return {};
+    }
+#endif
+};
+
+inline CpuFeatures const& cpuFeatures() {
+    static CpuFeatures features = CpuFeatures::detect();
+    return features;
+}
+
+} // namespace Karm
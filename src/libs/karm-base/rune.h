@@ -6,6 +6,7 @@
 #include "array.h"
 #include "buf.h"
 #include "cursor.h"
+#include "simd.h"
 
 namespace Karm {
 
@@ -171,6 +172,62 @@ struct Utf8 {
 
         return true;
     }
+
+    // Returns the length of the longest prefix of bytes made only of
+    // complete and well-formed sequences (no overlongs, surrogates or runes
+    // past U+10FFFF). ASCII is skipped 16 bytes at a time.
+    static usize validLen(Bytes bytes) {
+        u8 const* buf = bytes.buf();
+        usize len = bytes.len();
+        usize i = 0;
+
+        while (i < len) {
+            if (i + 16 <= len) {
+                u64x2 v;
+                memcpy(&v, buf + i, 16);
+                if (((v[0] | v[1]) & 0x8080808080808080) == 0) {
+                    i += 16;
+                    continue;
+                }
+            }
+
+            u8 first = buf[i];
+            if (first < 0x80) {
+                i++;
+                continue;
+            }
+
+            usize n = 0;
+            u8 lo = 0x80, hi = 0xbf;
+            if (first >= 0xc2 and first <= 0xdf) {
+                n = 2;
+            } else if (first >= 0xe0 and first <= 0xef) {
+                n = 3;
+                if (first == 0xe0)
+                    lo = 0xa0;
+                else if (first == 0xed)
+                    hi = 0x9f;
+            } else if (first >= 0xf0 and first <= 0xf4) {
+                n = 4;
+                if (first == 0xf0)
+                    lo = 0x90;
+                else if (first == 0xf4)
+                    hi = 0x8f;
+            } else {
+                return i;
+            }
+
+            if (i + n > len or buf[i + 1] < lo or buf[i + 1] > hi)
+                return i;
+            for (usize j = 2; j < n; j++) {
+                if ((buf[i + j] & 0xc0) != 0x80)
+                    return i;
+            }
+            i += n;
+        }
+
+        return i;
+    }
 };
 
 [[gnu::used]] inline Utf8 UTF8;
@@ -0,0 +1,40 @@
+#include <karm-base/string.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+static usize _validLen(Str str) {
+    return Utf8::validLen(bytes(str));
+}
+
+test$("utf8-valid-len") {
+    expectEq$(_validLen(""), 0uz);
+    expectEq$(_validLen("Hello, World!"), 13uz);
+    expectEq$(_validLen("The quick brown fox jumps over the lazy dog"), 43uz);
+    expectEq$(_validLen("caf\xc3\xa9 \xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80"), 17uz);
+
+    return Ok();
+}
+
+test$("utf8-valid-len-malformed") {
+    // Continuation byte without a lead byte
+    expectEq$(_validLen("abc\x80"), 3uz);
+    // Overlong encodings
+    expectEq$(_validLen("a\xc0\xaf"), 1uz);
+    expectEq$(_validLen("a\xe0\x80\xaf"), 1uz);
+    expectEq$(_validLen("a\xf0\x80\x80\xaf"), 1uz);
+    // Surrogates
+    expectEq$(_validLen("a\xed\xa0\x80"), 1uz);
+    // Past U+10FFFF
+    expectEq$(_validLen("a\xf4\x90\x80\x80"), 1uz);
+    expectEq$(_validLen("a\xf5\x80\x80\x80"), 1uz);
+    // Sequence cut short
+    expectEq$(_validLen("a\xe2\x82"), 1uz);
+    expectEq$(_validLen("a\xe2\x82z"), 1uz);
+    // Malformed byte after a run of ASCII longer than a vector
+    expectEq$(_validLen("0123456789abcdefghijklmnopqrstuvwxyz\xff"), 36uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
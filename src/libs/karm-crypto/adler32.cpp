@@ -1,3 +1,9 @@
+#include <karm-base/cpuid.h>
+
+#ifdef __ck_arch_x86_64__
+#    include <immintrin.h>
+#endif
+
 #include "adler32.h"
 
 namespace Karm::Crypto {
@@ -5,11 +11,13 @@ namespace Karm::Crypto {
 static constexpr usize ADLER32_BASE = 65521;
 static constexpr usize ADLER32_NMAX = 5552;
 
-u32 adler32(Bytes bytes) {
+// MARK: Scalar ----------------------------------------------------------------
+
+u32 adler32Scalar(Bytes bytes, u32 adler) {
     auto [buf, len] = bytes;
 
-    u32 s1 = 1;
-    u32 s2 = 0;
+    u32 s1 = adler & 0xffff;
+    u32 s2 = adler >> 16;
 
     while (len > 0) {
         usize k = len < ADLER32_NMAX ? len : ADLER32_NMAX;
@@ -64,4 +72,78 @@ u32 adler32(Bytes bytes) {
     return (s2 << 16) | s1;
 }
 
+// MARK: SSSE3 -----------------------------------------------------------------
+
+#ifdef __ck_arch_x86_64__
+
+// Processes the input in 32 bytes blocks, s1 is accumulated with a sum of
+// absolute differences against zero, s2 with a multiply-add against the
+// position weights of each byte in the block. Every block also adds 32 times
+// the previous s1 to s2, which is tracked separately in vps.
+[[gnu::target("ssse3")]]
+static u32 _adler32Ssse3(u8 const* buf, usize blocks, u32 adler) {
+    u32 s1 = adler & 0xffff;
+    u32 s2 = adler >> 16;
+
+    __m128i const tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    __m128i const tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const ones = _mm_set1_epi16(1);
+
+    while (blocks) {
+        usize n = ADLER32_NMAX / 32;
+        if (n > blocks)
+            n = blocks;
+        blocks -= n;
+
+        __m128i vps = _mm_set_epi32(0, 0, 0, s1 * n);
+        __m128i vs2 = _mm_set_epi32(0, 0, 0, s2);
+        __m128i vs1 = _mm_setzero_si128();
+
+        do {
+            __m128i b1 = _mm_loadu_si128((__m128i const *)buf);
+            __m128i b2 = _mm_loadu_si128((__m128i const *)(buf + 16));
+
+            vps = _mm_add_epi32(vps, vs1);
+
+            vs1 = _mm_add_epi32(vs1, _mm_sad_epu8(b1, zero));
+            vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(b1, tap1), ones));
+            vs1 = _mm_add_epi32(vs1, _mm_sad_epu8(b2, zero));
+            vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(b2, tap2), ones));
+
+            buf += 32;
+        } while (--n);
+
+        vs2 = _mm_add_epi32(vs2, _mm_slli_epi32(vps, 5));
+
+        vs1 = _mm_add_epi32(vs1, _mm_shuffle_epi32(vs1, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 += _mm_cvtsi128_si32(vs1);
+
+        vs2 = _mm_add_epi32(vs2, _mm_shuffle_epi32(vs2, _MM_SHUFFLE(2, 3, 0, 1)));
+        vs2 = _mm_add_epi32(vs2, _mm_shuffle_epi32(vs2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s2 = _mm_cvtsi128_si32(vs2);
+
+        s1 %= ADLER32_BASE;
+        s2 %= ADLER32_BASE;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+#endif
+
+// MARK: Dispatch --------------------------------------------------------------
+
+u32 adler32(Bytes bytes, u32 adler) {
+#ifdef __ck_arch_x86_64__
+    if (bytes.len() >= 64 and cpuFeatures().ssse3) {
+        usize blocks = bytes.len() / 32;
+        adler = _adler32Ssse3(bytes.buf(), blocks, adler);
+        bytes = next(bytes, blocks * 32);
+    }
+#endif
+
+    return adler32Scalar(bytes, adler);
+}
+
 } // namespace Karm::Crypto
@@ -4,6 +4,8 @@
 
 namespace Karm::Crypto {
 
-u32 adler32(Bytes bytes);
+u32 adler32Scalar(Bytes bytes, u32 adler = 1);
+
+u32 adler32(Bytes bytes, u32 adler = 1);
 
 } // namespace Karm::Crypto
@@ -0,0 +1,86 @@
+#include <karm-crypto/adler32.h>
+#include <karm-crypto/crc32.h>
+#include <karm-crypto/sha2.h>
+#include <karm-sys/entry.h>
+#include <karm-sys/time.h>
+
+// NOTE: The nibble-at-a-time CRC32 this library used before, kept as a baseline.
+static Array<u32, 16> const NIBBLE_TAB = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190,
+    0x6B6B51F4, 0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344,
+    0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278,
+    0xBDBDF21C
+};
+
+static u32 crc32Nibble(Bytes bytes) {
+    u32 crc = 0xFFFFFFFF;
+    for (auto b : bytes) {
+        crc ^= b;
+        crc = NIBBLE_TAB[crc & 0x0F] ^ (crc >> 4);
+        crc = NIBBLE_TAB[crc & 0x0F] ^ (crc >> 4);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static void bench(Str name, Bytes data, auto f) {
+    static constexpr usize ROUNDS = 8;
+
+    u32 check = 0;
+    auto start = Sys::now();
+    for (usize i = 0; i < ROUNDS; i++)
+        check ^= f(data);
+    auto elapsed = Sys::now() - start;
+
+    f64 secs = elapsed.toUSecs() / 1e6;
+    f64 gbps = (data.len() * ROUNDS) / secs / 1e9;
+    Sys::println("{}: {} ({} GB/s, {:08x})", name, elapsed, gbps, check);
+}
+
+Async::Task<> entryPointAsync(Sys::Context&) {
+    Vec<u8> data;
+    data.resize(16 * 1024 * 1024);
+
+    u32 seed = 0x12345678;
+    for (auto& b : data) {
+        seed = seed * 1664525 + 1013904223;
+        b = seed >> 24;
+    }
+
+    bench("crc32 (nibble)", data, crc32Nibble);
+    bench("crc32", data, [](Bytes b) {
+        return Crypto::crc32(b);
+    });
+    bench("adler32 (scalar)", data, [](Bytes b) {
+        return Crypto::adler32Scalar(b);
+    });
+    bench("adler32", data, [](Bytes b) {
+        return Crypto::adler32(b);
+    });
+
+    bench("sha256", data, [](Bytes b) {
+        return Crypto::sha256(b)[0];
+    });
+    bench("sha512", data, [](Bytes b) {
+        return Crypto::sha512(b)[0];
+    });
+
+    // NOTE: 4KiB messages, roughly the size of a small file in a package
+    Vec<Bytes> messages;
+    for (usize off = 0; off < data.len(); off += 4096)
+        messages.pushBack(sub(data, off, off + 4096));
+    Vec<Array<u8, Crypto::SHA256_BYTES>> digests256;
+    digests256.resize(messages.len());
+    Vec<Array<u8, Crypto::SHA512_BYTES>> digests512;
+    digests512.resize(messages.len());
+
+    bench("sha256 (multi-buffer)", data, [&](Bytes) {
+        Crypto::sha256Multi(messages, digests256);
+        return digests256[0][0];
+    });
+    bench("sha512 (multi-buffer)", data, [&](Bytes) {
+        Crypto::sha512Multi(messages, digests512);
+        return digests512[0][0];
+    });
+
+    co_return Ok();
+}
@@ -0,0 +1,131 @@
+#include <karm-base/align.h>
+#include <karm-base/cpuid.h>
+
+#ifdef __ck_arch_x86_64__
+#    include <immintrin.h>
+#endif
+
+#include "crc32.h"
+
+namespace Karm::Crypto {
+
+u32 _crc32Slice8(u32 crc, Bytes bytes) {
+    auto [buf, len] = bytes;
+    auto const& t = CRC32_TABS;
+
+    while (len >= 8) {
+        u32 lo, hi;
+        memcpy(&lo, buf, 4);
+        memcpy(&hi, buf + 4, 4);
+        lo ^= crc;
+
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+
+        buf += 8;
+        len -= 8;
+    }
+
+    while (len--)
+        crc = t[0][(crc ^ *buf++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+#ifdef __ck_arch_x86_64__
+
+[[gnu::target("pclmul,sse4.1")]]
+static __m128i _crc32Fold(__m128i x, __m128i k, __m128i next) {
+    __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, next), lo);
+}
+
+// Folding with carry-less multiplication, as described in "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel.
+// Expects at least 64 bytes and a multiple of 16.
+[[gnu::target("pclmul,sse4.1")]]
+static u32 _crc32Clmul(u32 crc, u8 const* buf, usize len) {
+    __m128i const k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    __m128i const k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    __m128i const k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    __m128i const poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+
+    __m128i x1 = _mm_loadu_si128((__m128i const*)(buf + 0x00));
+    __m128i x2 = _mm_loadu_si128((__m128i const*)(buf + 0x10));
+    __m128i x3 = _mm_loadu_si128((__m128i const*)(buf + 0x20));
+    __m128i x4 = _mm_loadu_si128((__m128i const*)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+
+    buf += 64;
+    len -= 64;
+
+    // Fold by four 128-bit lanes
+    while (len >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((__m128i const*)(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((__m128i const*)(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((__m128i const*)(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((__m128i const*)(buf + 0x30)));
+
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold into a single 128-bit lane
+    x1 = _crc32Fold(x1, k3k4, x2);
+    x1 = _crc32Fold(x1, k3k4, x3);
+    x1 = _crc32Fold(x1, k3k4, x4);
+
+    while (len >= 16) {
+        x1 = _crc32Fold(x1, k3k4, _mm_loadu_si128((__m128i const*)buf));
+        buf += 16;
+        len -= 16;
+    }
+
+    // Fold 128 bits down to 64 bits
+    __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction down to 32 bits
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return _mm_extract_epi32(x1, 1);
+}
+
+#endif
+
+u32 _crc32Update(u32 crc, Bytes bytes) {
+#ifdef __ck_arch_x86_64__
+    if (bytes.len() >= 64 and cpuFeatures().pclmul and cpuFeatures().sse41) {
+        usize len = alignDown(bytes.len(), 16);
+        crc = _crc32Clmul(crc, bytes.buf(), len);
+        bytes = next(bytes, len);
+    }
+#endif
+
+    return _crc32Slice8(crc, bytes);
+}
+
+} // namespace Karm::Crypto
@@ -1,18 +1,34 @@
 #pragma once
 
-// https://github.com/Michaelangel007/crc32
-
 #include <karm-base/array.h>
 #include <karm-base/slice.h>
 
 namespace Karm::Crypto {
 
-static Array<u32, 16> const CRC32_TAB = {
-    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190,
-    0x6B6B51F4, 0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344,
-    0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278,
-    0xBDBDF21C
-};
+static constexpr u32 CRC32_POLY = 0xEDB88320;
+
+// Slicing-by-8 tables, CRC32_TABS[0] is the classic byte-wise table and
+// CRC32_TABS[n] advances a byte that is followed by n more bytes.
+static constexpr Array<Array<u32, 256>, 8> CRC32_TABS = [] {
+    Array<Array<u32, 256>, 8> tabs{};
+
+    for (u32 i = 0; i < 256; i++) {
+        u32 crc = i;
+        for (usize k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (crc & 1 ? CRC32_POLY : 0);
+        tabs[0][i] = crc;
+    }
+
+    for (u32 i = 0; i < 256; i++)
+        for (usize s = 1; s < 8; s++)
+            tabs[s][i] = (tabs[s - 1][i] >> 8) ^ tabs[0][tabs[s - 1][i] & 0xFF];
+
+    return tabs;
+}();
+
+u32 _crc32Slice8(u32 crc, Bytes bytes);
+
+u32 _crc32Update(u32 crc, Bytes bytes);
 
 struct Crc32 {
     using Digest = u32;
@@ -24,16 +40,11 @@ struct Crc32 {
     always_inline Crc32(u32 crc) : _crc(crc) {}
 
     always_inline void update(u8 byte) {
-        _crc ^= byte;
-        _crc = CRC32_TAB[_crc & 0x0F] ^ (_crc >> 4);
-        _crc = CRC32_TAB[_crc & 0x0F] ^ (_crc >> 4);
+        _crc = CRC32_TABS[0][(_crc ^ byte) & 0xFF] ^ (_crc >> 8);
     }
 
     always_inline void update(Bytes bytes) {
-        auto [buf, len] = bytes;
-
-        for (usize i = 0; i < len; ++i)
-            update(buf[i]);
+        _crc = _crc32Update(_crc, bytes);
     }
 
     always_inline Digest digest() {
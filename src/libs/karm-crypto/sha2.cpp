@@ -1,7 +1,13 @@
 #include <karm-base/array.h>
 #include <karm-base/base.h>
+#include <karm-base/cpuid.h>
+#include <karm-base/simd.h>
 #include <karm-base/slice.h>
 
+#ifdef __ck_arch_x86_64__
+#    include <immintrin.h>
+#endif
+
 #include "sha2.h"
 
 namespace Karm::Crypto {
@@ -120,55 +126,114 @@ static inline void _sha256ComputeBlock(Array<u32, 8>& state, u8 const* buf) {
     state[7] += h;
 }
 
-static inline Array<u32, 8> _sha256Internal(Array<u32, 8> const& init, Bytes bytes) {
-    Array<u32, 8> state = init;
-    auto [buf, len] = bytes;
-    u64 padlen = len << 3;
+// MARK: SHA-NI ----------------------------------------------------------------
 
-    for (; len >= 64; len -= 64, buf += 64) {
-        _sha256ComputeBlock(state, buf);
-    }
+#ifdef __ck_arch_x86_64__
 
-    Array<u8, 64> padding{};
+// Four rounds of SHA-256, the state is kept as ABEF/CDGH as expected by
+// sha256rnds2.
+[[gnu::target("sha,sse4.1")]]
+always_inline static void _sha256NiRounds(__m128i& abef, __m128i& cdgh, __m128i msg, usize idx) {
+    msg = _mm_add_epi32(msg, _mm_loadu_si128((__m128i const*)&SHA256_K[idx * 4]));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+    msg = _mm_shuffle_epi32(msg, 0x0e);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, msg);
+}
 
-    for (usize idx = 0; idx < len; idx++) {
-        padding[idx] = buf[idx];
-    }
-    padding[len] = 0x80;
+// Computes w[idx * 4 + 4..idx * 4 + 8] into next from the three previous
+// groups of the message schedule.
+[[gnu::target("sha,sse4.1")]]
+always_inline static void _sha256NiSchedule(__m128i& next, __m128i prev, __m128i curr) {
+    next = _mm_add_epi32(next, _mm_alignr_epi8(curr, prev, 4));
+    next = _mm_sha256msg2_epu32(next, curr);
+}
+
+[[gnu::target("sha,sse4.1")]]
+static void _sha256ComputeBlocksNi(Array<u32, 8>& state, u8 const* buf, usize blocks) {
+    __m128i const shuf = _mm_set_epi64x(0x0c0d0e0f08090a0b, 0x0405060700010203);
+
+    __m128i tmp = _mm_loadu_si128((__m128i const*)&state[0]);
+    __m128i cdgh = _mm_loadu_si128((__m128i const*)&state[4]);
+
+    tmp = _mm_shuffle_epi32(tmp, 0xb1);             // CDAB
+    cdgh = _mm_shuffle_epi32(cdgh, 0x1b);           // EFGH
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);   // ABEF
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);        // CDGH
+
+    for (; blocks; blocks--, buf += 64) {
+        __m128i abefSave = abef;
+        __m128i cdghSave = cdgh;
+
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(buf + 0)), shuf);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(buf + 16)), shuf);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(buf + 32)), shuf);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(buf + 48)), shuf);
+
+        _sha256NiRounds(abef, cdgh, m0, 0);
+
+        _sha256NiRounds(abef, cdgh, m1, 1);
+        m0 = _mm_sha256msg1_epu32(m0, m1);
+
+        _sha256NiRounds(abef, cdgh, m2, 2);
+        m1 = _mm_sha256msg1_epu32(m1, m2);
+
+        _sha256NiRounds(abef, cdgh, m3, 3);
+        _sha256NiSchedule(m0, m2, m3);
+        m2 = _mm_sha256msg1_epu32(m2, m3);
+
+        for (usize idx = 4; idx < 12; idx += 4) {
+            _sha256NiRounds(abef, cdgh, m0, idx + 0);
+            _sha256NiSchedule(m1, m3, m0);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
 
-    if (len >= 56) {
-        _sha256ComputeBlock(state, padding.buf());
-        for (usize idx = 0; idx < padding.len(); idx++) {
-            padding[idx] = 0;
+            _sha256NiRounds(abef, cdgh, m1, idx + 1);
+            _sha256NiSchedule(m2, m0, m1);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            _sha256NiRounds(abef, cdgh, m2, idx + 2);
+            _sha256NiSchedule(m3, m1, m2);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            _sha256NiRounds(abef, cdgh, m3, idx + 3);
+            _sha256NiSchedule(m0, m2, m3);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
         }
-    }
 
-    padding[56] = padlen >> 56;
-    padding[57] = padlen >> 48;
-    padding[58] = padlen >> 40;
-    padding[59] = padlen >> 32;
-    padding[60] = padlen >> 24;
-    padding[61] = padlen >> 16;
-    padding[62] = padlen >> 8;
-    padding[63] = padlen;
+        _sha256NiRounds(abef, cdgh, m0, 12);
+        _sha256NiSchedule(m1, m3, m0);
+        m3 = _mm_sha256msg1_epu32(m3, m0);
 
-    _sha256ComputeBlock(state, padding.buf());
+        _sha256NiRounds(abef, cdgh, m1, 13);
+        _sha256NiSchedule(m2, m0, m1);
 
-    for (usize idx = 0; idx < state.len(); idx++) {
-        state[idx] = toBe(state[idx]);
+        _sha256NiRounds(abef, cdgh, m2, 14);
+        _sha256NiSchedule(m3, m1, m2);
+
+        _sha256NiRounds(abef, cdgh, m3, 15);
+
+        abef = _mm_add_epi32(abef, abefSave);
+        cdgh = _mm_add_epi32(cdgh, cdghSave);
     }
 
-    return state;
-}
+    tmp = _mm_shuffle_epi32(abef, 0x1b);            // FEBA
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);           // DCHG
+    abef = _mm_blend_epi16(tmp, cdgh, 0xf0);        // DCBA
+    cdgh = _mm_alignr_epi8(cdgh, tmp, 8);           // HGFE
 
-Array<u8, SHA256_BYTES> sha256(Bytes bytes) {
-    return Array<u8, SHA256_BYTES>::from(_sha256Internal(SHA256_INITIAL, bytes).bytes());
+    _mm_storeu_si128((__m128i*)&state[0], abef);
+    _mm_storeu_si128((__m128i*)&state[4], cdgh);
 }
 
-Array<u8, SHA224_BYTES> sha224(Bytes bytes) {
-    auto state = _sha256Internal(SHA224_INITIAL, bytes);
+#endif
+
+static void _sha256ComputeBlocks(Array<u32, 8>& state, u8 const* buf, usize blocks) {
+#ifdef __ck_arch_x86_64__
+    if (cpuFeatures().sha and cpuFeatures().sse41)
+        return _sha256ComputeBlocksNi(state, buf, blocks);
+#endif
 
-    return Array<u8, SHA224_BYTES>::from(state.bytes());
+    for (; blocks; blocks--, buf += 64)
+        _sha256ComputeBlock(state, buf);
 }
 
 static inline void _sha512ComputeBlock(Array<u64, 8>& state, u8 const* buf) {
@@ -220,54 +285,395 @@ static inline void _sha512ComputeBlock(Array<u64, 8>& state, u8 const* buf) {
     state[7] += h;
 }
 
-static inline Array<u64, 8> _sha512Internal(Array<u64, 8> const& init, Bytes bytes) {
-    Array<u64, 8> state = init;
+static void _sha512ComputeBlocks(Array<u64, 8>& state, u8 const* buf, usize blocks) {
+    for (; blocks; blocks--, buf += 128)
+        _sha512ComputeBlock(state, buf);
+}
+
+// MARK: Padding ---------------------------------------------------------------
+
+// Appends the final padding and the message length in bits after the tail of
+// a message, returns the number of blocks that need to be processed.
+template <usize BLOCK>
+static usize _shaPad(Array<u8, BLOCK * 2>& out, Bytes tail, u64 len) {
+    static constexpr usize LEN_BYTES = BLOCK / 8;
+
+    memcpy(out.buf(), tail.buf(), tail.len());
+    out[tail.len()] = 0x80;
+
+    usize blocks = tail.len() + 1 + LEN_BYTES > BLOCK ? 2 : 1;
+    u64 bits = len << 3;
+    for (usize idx = 0; idx < 8; idx++)
+        out[blocks * BLOCK - 1 - idx] = bits >> (idx * 8);
+
+    return blocks;
+}
+
+template <typename D, typename W>
+static D _shaDigest(Array<W, 8> state) {
+    for (usize idx = 0; idx < state.len(); idx++)
+        state[idx] = toBe(state[idx]);
+    return D::from(state.bytes());
+}
+
+// MARK: Incremental -----------------------------------------------------------
+
+template <typename H>
+static void _shaUpdate(H& hasher, Bytes bytes, auto computeBlocks) {
     auto [buf, len] = bytes;
-    u64 padlen = len << 3;
+    hasher._len += len;
 
-    for (; len >= 128; len -= 128, buf += 128) {
-        _sha512ComputeBlock(state, buf);
+    if (hasher._pendingLen) {
+        usize n = min(len, H::BLOCK - hasher._pendingLen);
+        memcpy(hasher._pending.buf() + hasher._pendingLen, buf, n);
+        hasher._pendingLen += n;
+        buf += n;
+        len -= n;
+
+        if (hasher._pendingLen < H::BLOCK)
+            return;
+
+        computeBlocks(hasher._state, hasher._pending.buf(), 1);
+        hasher._pendingLen = 0;
     }
 
-    Array<u8, 128> padding{};
+    usize blocks = len / H::BLOCK;
+    computeBlocks(hasher._state, buf, blocks);
+    buf += blocks * H::BLOCK;
+    len -= blocks * H::BLOCK;
+
+    memcpy(hasher._pending.buf(), buf, len);
+    hasher._pendingLen = len;
+}
+
+template <typename H>
+static typename H::Digest _shaFinal(H const& hasher, auto computeBlocks) {
+    auto state = hasher._state;
+    Array<u8, H::BLOCK * 2> padding{};
+    usize blocks = _shaPad<H::BLOCK>(padding, sub(hasher._pending, 0, hasher._pendingLen), hasher._len);
+    computeBlocks(state, padding.buf(), blocks);
+    return _shaDigest<typename H::Digest>(state);
+}
+
+Sha256::Sha256() : _state(SHA256_INITIAL) {}
+
+Sha256 Sha256::sha224() {
+    return {SHA224_INITIAL};
+}
+
+void Sha256::update(Bytes bytes) {
+    _shaUpdate(*this, bytes, _sha256ComputeBlocks);
+}
+
+Sha256::Digest Sha256::digest() const {
+    return _shaFinal(*this, _sha256ComputeBlocks);
+}
+
+Sha512::Sha512() : _state(SHA512_INITIAL) {}
+
+Sha512 Sha512::sha384() {
+    return {SHA384_INITIAL};
+}
+
+void Sha512::update(Bytes bytes) {
+    _shaUpdate(*this, bytes, _sha512ComputeBlocks);
+}
+
+Sha512::Digest Sha512::digest() const {
+    return _shaFinal(*this, _sha512ComputeBlocks);
+}
+
+// MARK: One-shot --------------------------------------------------------------
+
+Array<u8, SHA256_BYTES> sha256(Bytes bytes) {
+    Sha256 hasher;
+    hasher.update(bytes);
+    return hasher.digest();
+}
+
+Array<u8, SHA224_BYTES> sha224(Bytes bytes) {
+    auto hasher = Sha256::sha224();
+    hasher.update(bytes);
+    return Array<u8, SHA224_BYTES>::from(hasher.digest());
+}
+
+Array<u8, SHA512_BYTES> sha512(Bytes bytes) {
+    Sha512 hasher;
+    hasher.update(bytes);
+    return hasher.digest();
+}
+
+Array<u8, SHA384_BYTES> sha384(Bytes bytes) {
+    auto hasher = Sha512::sha384();
+    hasher.update(bytes);
+    return Array<u8, SHA384_BYTES>::from(hasher.digest());
+}
 
-    for (usize idx = 0; idx < len; idx++) {
-        padding[idx] = buf[idx];
+// MARK: Streaming -------------------------------------------------------------
+
+// The reader fills the buffer and whole blocks are hashed right where they
+// landed. A trailing partial block stays at the front of the buffer and the
+// next read appends to it, so the data never goes through the hasher's
+// pending block until the very end.
+template <typename H>
+static Res<typename H::Digest> _shaRead(Io::Reader& reader, auto computeBlocks) {
+    H hasher;
+    Array<u8, 16 * 1024> buf;
+    usize len = 0;
+
+    while (true) {
+        usize n = try$(reader.read(mutSub(buf, len, buf.len())));
+        if (n == 0)
+            break;
+        len += n;
+
+        usize blocks = len / H::BLOCK;
+        computeBlocks(hasher._state, buf.buf(), blocks);
+        hasher._len += blocks * H::BLOCK;
+
+        usize tail = len - blocks * H::BLOCK;
+        memmove(buf.buf(), buf.buf() + blocks * H::BLOCK, tail);
+        len = tail;
     }
-    padding[len] = 0x80;
 
-    if (len >= 112) {
-        _sha512ComputeBlock(state, padding.buf());
-        for (usize idx = 0; idx < padding.len(); idx++) {
-            padding[idx] = 0;
+    hasher.update(sub(buf, 0, len));
+    return Ok(hasher.digest());
+}
+
+Res<Array<u8, SHA256_BYTES>> sha256(Io::Reader& reader) {
+    return _shaRead<Sha256>(reader, _sha256ComputeBlocks);
+}
+
+Res<Array<u8, SHA512_BYTES>> sha512(Io::Reader& reader) {
+    return _shaRead<Sha512>(reader, _sha512ComputeBlocks);
+}
+
+// MARK: Multi-buffer ----------------------------------------------------------
+
+struct _Sha256Traits {
+    using Word = u32;
+    using Digest = Array<u8, SHA256_BYTES>;
+
+    static constexpr usize BLOCK = 64;
+    static constexpr usize ROUNDS = 64;
+    static constexpr auto const& INITIAL = SHA256_INITIAL;
+    static constexpr auto const& K = SHA256_K;
+
+    static constexpr Array<u32, 12> ROT = {
+        7, 18, 3,   // σ0
+        17, 19, 10, // σ1
+        2, 13, 22,  // Σ0
+        6, 11, 25,  // Σ1
+    };
+};
+
+struct _Sha512Traits {
+    using Word = u64;
+    using Digest = Array<u8, SHA512_BYTES>;
+
+    static constexpr usize BLOCK = 128;
+    static constexpr usize ROUNDS = 80;
+    static constexpr auto const& INITIAL = SHA512_INITIAL;
+    static constexpr auto const& K = SHA512_K;
+
+    static constexpr Array<u64, 12> ROT = {
+        1, 8, 7,    // σ0
+        19, 61, 6,  // σ1
+        28, 34, 39, // Σ0
+        14, 18, 41, // Σ1
+    };
+};
+
+template <typename W, typename V>
+always_inline static V _shaRotr(V x, W n) {
+    return (x >> n) | (x << (W)(sizeof(W) * 8 - n));
+}
+
+// Runs one block of each lane through the compression function, every lane
+// holds the state of a different message.
+template <typename T, typename V, usize LANES>
+always_inline static void _shaLanesBlock(Array<V, 8>& state, Array<u8 const*, LANES> const& blocks) {
+    using W = typename T::Word;
+    auto const& r = T::ROT;
+
+    Array<V, T::ROUNDS> w;
+
+    for (usize idx = 0; idx < 16; idx++) {
+        for (usize lane = 0; lane < LANES; lane++) {
+            W v;
+            memcpy(&v, blocks[lane] + idx * sizeof(W), sizeof(W));
+            w[idx][lane] = toBe(v);
         }
     }
 
-    padding[120] = padlen >> 56;
-    padding[121] = padlen >> 48;
-    padding[122] = padlen >> 40;
-    padding[123] = padlen >> 32;
-    padding[124] = padlen >> 24;
-    padding[125] = padlen >> 16;
-    padding[126] = padlen >> 8;
-    padding[127] = padlen;
+    for (usize idx = 16; idx < T::ROUNDS; idx++) {
+        V s0 = _shaRotr<W>(w[idx - 15], r[0]) ^ _shaRotr<W>(w[idx - 15], r[1]) ^ (w[idx - 15] >> r[2]);
+        V s1 = _shaRotr<W>(w[idx - 2], r[3]) ^ _shaRotr<W>(w[idx - 2], r[4]) ^ (w[idx - 2] >> r[5]);
+        w[idx] = w[idx - 16] + s0 + w[idx - 7] + s1;
+    }
 
-    _sha512ComputeBlock(state, padding.buf());
+    V a = state[0];
+    V b = state[1];
+    V c = state[2];
+    V d = state[3];
+    V e = state[4];
+    V f = state[5];
+    V g = state[6];
+    V h = state[7];
+
+    for (usize idx = 0; idx < T::ROUNDS; idx++) {
+        V s1 = _shaRotr<W>(e, r[9]) ^ _shaRotr<W>(e, r[10]) ^ _shaRotr<W>(e, r[11]);
+        V ch = (e & f) ^ ((~e) & g);
+        V tmp1 = h + s1 + ch + T::K[idx] + w[idx];
+        V s0 = _shaRotr<W>(a, r[6]) ^ _shaRotr<W>(a, r[7]) ^ _shaRotr<W>(a, r[8]);
+        V tmp2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
 
-    for (usize idx = 0; idx < state.len(); idx++) {
-        state[idx] = toBe(state[idx]);
+        h = g;
+        g = f;
+        f = e;
+        e = d + tmp1;
+        d = c;
+        c = b;
+        b = a;
+        a = tmp1 + tmp2;
     }
-    return state;
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 }
 
-Array<u8, SHA512_BYTES> sha512(Bytes bytes) {
-    return Array<u8, SHA512_BYTES>::from(_sha512Internal(SHA512_INITIAL, bytes).bytes());
+// Each lane pulls the next message from the queue as soon as it is done with
+// the previous one, so messages of different lengths keep all lanes busy
+// until the queue runs dry.
+template <typename T, typename V>
+always_inline static void _shaMulti(Slice<Bytes> messages, MutSlice<typename T::Digest> digests) {
+    using W = typename T::Word;
+    static constexpr usize LANES = sizeof(V) / sizeof(W);
+
+    struct Lane {
+        bool busy = false;
+        usize index = 0;
+        u8 const* next = nullptr;
+        usize blocks = 0;
+        Array<u8, T::BLOCK * 2> padding{};
+        u8 const* paddingNext = nullptr;
+        usize paddingBlocks = 0;
+    };
+
+    static constexpr Array<u8, T::BLOCK> IDLE{};
+
+    Array<V, 8> state{};
+    Array<Lane, LANES> lanes{};
+    Array<u8 const*, LANES> blocks{};
+    usize queue = 0;
+
+    while (true) {
+        usize busy = 0;
+
+        for (usize l = 0; l < LANES; l++) {
+            auto& lane = lanes[l];
+
+            if (lane.blocks == 0 and lane.paddingBlocks == 0) {
+                if (lane.busy) {
+                    Array<W, 8> result;
+                    for (usize idx = 0; idx < 8; idx++)
+                        result[idx] = state[idx][l];
+                    digests[lane.index] = _shaDigest<typename T::Digest>(result);
+                    lane.busy = false;
+                }
+
+                if (queue < messages.len()) {
+                    auto msg = messages[queue];
+                    lane.busy = true;
+                    lane.index = queue++;
+                    lane.next = msg.buf();
+                    lane.blocks = msg.len() / T::BLOCK;
+                    lane.padding = {};
+                    lane.paddingBlocks = _shaPad<T::BLOCK>(
+                        lane.padding,
+                        next(msg, lane.blocks * T::BLOCK),
+                        msg.len()
+                    );
+                    lane.paddingNext = lane.padding.buf();
+
+                    for (usize idx = 0; idx < 8; idx++)
+                        state[idx][l] = T::INITIAL[idx];
+                }
+            }
+
+            if (not lane.busy) {
+                blocks[l] = IDLE.buf();
+                continue;
+            }
+
+            busy++;
+            if (lane.blocks) {
+                blocks[l] = lane.next;
+                lane.next += T::BLOCK;
+                lane.blocks--;
+            } else {
+                blocks[l] = lane.paddingNext;
+                lane.paddingNext += T::BLOCK;
+                lane.paddingBlocks--;
+            }
+        }
+
+        if (not busy)
+            break;
+
+        _shaLanesBlock<T, V, LANES>(state, blocks);
+    }
 }
 
-Array<u8, SHA384_BYTES> sha384(Bytes bytes) {
-    auto state = _sha512Internal(SHA384_INITIAL, bytes);
+#ifdef __ck_arch_x86_64__
+
+[[gnu::target("avx2")]]
+static void _sha256MultiAvx2(Slice<Bytes> messages, MutSlice<Array<u8, SHA256_BYTES>> digests) {
+    _shaMulti<_Sha256Traits, u32x8>(messages, digests);
+}
+
+[[gnu::target("avx2")]]
+static void _sha512MultiAvx2(Slice<Bytes> messages, MutSlice<Array<u8, SHA512_BYTES>> digests) {
+    _shaMulti<_Sha512Traits, u64x4>(messages, digests);
+}
+
+#endif
+
+void sha256Multi(Slice<Bytes> messages, MutSlice<Array<u8, SHA256_BYTES>> digests) {
+    if (messages.len() != digests.len()) [[unlikely]]
+        panic("sha256Multi: one digest per message expected");
+
+#ifdef __ck_arch_x86_64__
+    // NOTE: A single SHA-NI stream is still faster than eight AVX2 lanes
+    if (cpuFeatures().sha and cpuFeatures().sse41) {
+        for (usize idx = 0; idx < messages.len(); idx++)
+            digests[idx] = sha256(messages[idx]);
+        return;
+    }
+
+    if (cpuFeatures().avx2)
+        return _sha256MultiAvx2(messages, digests);
+#endif
+
+    _shaMulti<_Sha256Traits, u32x4>(messages, digests);
+}
+
+void sha512Multi(Slice<Bytes> messages, MutSlice<Array<u8, SHA512_BYTES>> digests) {
+    if (messages.len() != digests.len()) [[unlikely]]
+        panic("sha512Multi: one digest per message expected");
+
+#ifdef __ck_arch_x86_64__
+    if (cpuFeatures().avx2)
+        return _sha512MultiAvx2(messages, digests);
+#endif
 
-    return Array<u8, SHA384_BYTES>::from(state.bytes());
+    _shaMulti<_Sha512Traits, u64x2>(messages, digests);
 }
 
 } // namespace Karm::Crypto
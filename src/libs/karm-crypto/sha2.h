@@ -2,6 +2,7 @@
 
 #include <karm-base/array.h>
 #include <karm-base/slice.h>
+#include <karm-io/traits.h>
 
 namespace Karm::Crypto {
 
@@ -10,9 +11,69 @@ static constexpr usize SHA256_BYTES = 32;
 static constexpr usize SHA384_BYTES = 48;
 static constexpr usize SHA512_BYTES = 64;
 
+// MARK: Incremental -----------------------------------------------------------
+
+struct Sha256 {
+    using Digest = Array<u8, SHA256_BYTES>;
+
+    static constexpr usize BLOCK = 64;
+
+    Array<u32, 8> _state;
+    Array<u8, BLOCK> _pending{};
+    usize _pendingLen = 0;
+    u64 _len = 0;
+
+    Sha256();
+
+    Sha256(Array<u32, 8> const& init) : _state(init) {}
+
+    static Sha256 sha224();
+
+    void update(Bytes bytes);
+
+    Digest digest() const;
+};
+
+struct Sha512 {
+    using Digest = Array<u8, SHA512_BYTES>;
+
+    static constexpr usize BLOCK = 128;
+
+    Array<u64, 8> _state;
+    Array<u8, BLOCK> _pending{};
+    usize _pendingLen = 0;
+    u64 _len = 0;
+
+    Sha512();
+
+    Sha512(Array<u64, 8> const& init) : _state(init) {}
+
+    static Sha512 sha384();
+
+    void update(Bytes bytes);
+
+    Digest digest() const;
+};
+
+// MARK: One-shot --------------------------------------------------------------
+
 Array<u8, SHA224_BYTES> sha224(Bytes bytes);
 Array<u8, SHA256_BYTES> sha256(Bytes bytes);
 Array<u8, SHA384_BYTES> sha384(Bytes bytes);
 Array<u8, SHA512_BYTES> sha512(Bytes bytes);
 
+// MARK: Streaming -------------------------------------------------------------
+
+Res<Array<u8, SHA256_BYTES>> sha256(Io::Reader& reader);
+Res<Array<u8, SHA512_BYTES>> sha512(Io::Reader& reader);
+
+// MARK: Multi-buffer ----------------------------------------------------------
+
+// Hashes independent messages side by side, one per vector lane, which is
+// much faster than hashing them one after the other when there are many
+// small to medium messages (eg. the files of a package). There must be
+// exactly one digest per message.
+void sha256Multi(Slice<Bytes> messages, MutSlice<Array<u8, SHA256_BYTES>> digests);
+void sha512Multi(Slice<Bytes> messages, MutSlice<Array<u8, SHA512_BYTES>> digests);
+
 } // namespace Karm::Crypto
\ No newline at end of file
@@ -19,4 +19,42 @@ test$("crypto-adler32") {
     return Ok();
 }
 
+static Array<u8, 4096> _pattern() {
+    Array<u8, 4096> buf{};
+    for (usize i = 0; i < buf.len(); i++)
+        buf[i] = ((i * 31 + 7) ^ (i >> 8)) & 0xff;
+    return buf;
+}
+
+test$("crypto-adler32-long") {
+    // NOTE: Lengths straddle the block sizes of the accelerated paths
+    auto buf = _pattern();
+
+    auto testCase = [&](usize len, u32 expected) -> Res<> {
+        expectEq$(adler32(sub(buf, 0, len)), expected);
+        return Ok();
+    };
+
+    try$(testCase(7, 0x079302bd));
+    try$(testCase(8, 0x0b30039d));
+    try$(testCase(15, 0x32270721));
+    try$(testCase(16, 0x3a2007f9));
+    try$(testCase(63, 0xdfcc1f39));
+    try$(testCase(64, 0xffad1fe1));
+    try$(testCase(65, 0x206420a8));
+    try$(testCase(127, 0xd4203f59));
+    try$(testCase(1000, 0xd52ff1bc));
+    try$(testCase(4096, 0xc8a9f86a));
+
+    Array<u8, 4096> ones{};
+    for (auto& b : ones)
+        b = 0xff;
+    expectEq$(adler32(ones), (u32)0x8161f0e2);
+
+    for (usize i = 0; i < buf.len(); i += 97)
+        expectEq$(adler32(sub(buf, 0, i)), adler32Scalar(sub(buf, 0, i)));
+
+    return Ok();
+}
+
 } // namespace Karm::Crypto::Tests
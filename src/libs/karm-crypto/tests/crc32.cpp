@@ -17,4 +17,39 @@ test$("crypto-crc32") {
     return Ok();
 }
 
+static Array<u8, 4096> _pattern() {
+    Array<u8, 4096> buf{};
+    for (usize i = 0; i < buf.len(); i++)
+        buf[i] = ((i * 31 + 7) ^ (i >> 8)) & 0xff;
+    return buf;
+}
+
+test$("crypto-crc32-long") {
+    // NOTE: Lengths straddle the block sizes of the accelerated paths
+    auto buf = _pattern();
+
+    auto testCase = [&](usize len, u32 expected) -> Res<> {
+        expectEq$(crc32(sub(buf, 0, len)), expected);
+        return Ok();
+    };
+
+    try$(testCase(7, 0x3e483922));
+    try$(testCase(8, 0xa7560428));
+    try$(testCase(15, 0x8f77fabb));
+    try$(testCase(16, 0x0636a895));
+    try$(testCase(63, 0x794b269d));
+    try$(testCase(64, 0x84c86088));
+    try$(testCase(65, 0x34e57bec));
+    try$(testCase(127, 0x4a84318a));
+    try$(testCase(1000, 0x6590591b));
+    try$(testCase(4096, 0x0430be95));
+
+    Array<u8, 4096> ones{};
+    for (auto& b : ones)
+        b = 0xff;
+    expectEq$(crc32(ones), (u32)0xf154670a);
+
+    return Ok();
+}
+
 } // namespace Karm::Crypto::Tests
@@ -1,5 +1,7 @@
 #include <karm-base/array.h>
+#include <karm-base/vec.h>
 #include <karm-crypto/sha2.h>
+#include <karm-io/impls.h>
 #include <karm-test/macros.h>
 
 namespace Karm::Crypto::Tests {
@@ -160,4 +162,98 @@ test$("crypto-sha512") {
 
     return Ok();
 }
+
+static Array<u8, 4096> _pattern() {
+    Array<u8, 4096> buf{};
+    for (usize i = 0; i < buf.len(); i++)
+        buf[i] = ((i * 31 + 7) ^ (i >> 8)) & 0xff;
+    return buf;
+}
+
+test$("crypto-sha2-incremental") {
+    auto buf = _pattern();
+
+    for (usize chunk : {1uz, 7uz, 64uz, 100uz, 128uz, 1000uz}) {
+        Sha256 h256;
+        Sha512 h512;
+        for (usize off = 0; off < buf.len(); off += chunk) {
+            auto part = sub(buf, off, min(off + chunk, buf.len()));
+            h256.update(part);
+            h512.update(part);
+        }
+        expect$(h256.digest() == sha256(buf));
+        expect$(h512.digest() == sha512(buf));
+    }
+
+    return Ok();
+}
+
+test$("crypto-sha2-reader") {
+    auto buf = _pattern();
+
+    Io::BufReader r256{buf};
+    expect$(try$(sha256(r256)) == sha256(buf));
+
+    Io::BufReader r512{buf};
+    expect$(try$(sha512(r512)) == sha512(buf));
+
+    return Ok();
+}
+
+// Hands out the data in small uneven reads, so partial blocks have to be
+// carried over from one read to the next.
+struct _TrickleReader : public Io::Reader {
+    Bytes _buf;
+    usize _chunk;
+
+    _TrickleReader(Bytes buf, usize chunk)
+        : _buf(buf), _chunk(chunk) {}
+
+    Res<usize> read(MutBytes bytes) override {
+        usize n = min(min(bytes.len(), _chunk), _buf.len());
+        copy(sub(_buf, 0, n), bytes);
+        _buf = next(_buf, n);
+        return Ok(n);
+    }
+};
+
+test$("crypto-sha2-reader-chunked") {
+    Vec<u8> buf;
+    auto pattern = _pattern();
+    for (usize i = 0; i < 10; i++)
+        buf.pushBack(pattern);
+
+    for (usize chunk : {1uz, 37uz, 4000uz, 16384uz}) {
+        _TrickleReader r256{buf, chunk};
+        expect$(try$(sha256(r256)) == sha256(buf));
+
+        _TrickleReader r512{buf, chunk};
+        expect$(try$(sha512(r512)) == sha512(buf));
+    }
+
+    return Ok();
+}
+
+test$("crypto-sha2-multi") {
+    // NOTE: More messages than lanes, with lengths around the block and
+    //       padding boundaries, so lanes get refilled at different times
+    auto buf = _pattern();
+
+    Array<Bytes, 21> messages;
+    for (usize i = 0; i < messages.len(); i++)
+        messages[i] = sub(buf, i, i + (i * i * 29) % 600);
+
+    Array<Array<u8, SHA256_BYTES>, 21> d256;
+    Array<Array<u8, SHA512_BYTES>, 21> d512;
+    sha256Multi(messages, d256);
+    sha512Multi(messages, d512);
+
+    for (usize i = 0; i < messages.len(); i++) {
+        expect$(d256[i] == sha256(messages[i]));
+        expect$(d512[i] == sha512(messages[i]));
+    }
+
+    return Ok();
+}
+
 } // namespace Karm::Crypto::Tests
\ No newline at end of file
@@ -150,6 +150,10 @@ void Canvas::blit(Math::Vec2i dest, Pixels pixels) {
     blit(pixels.bound(), Math::Recti(dest, pixels.size()), pixels);
 }
 
+Opt<Math::Vec2i> Canvas::deviceSize(Math::Recti) const {
+    return NONE;
+}
+
 // MARK: Filter Operations -------------------------------------------------
 
 void Canvas::apply(Filter filter, Math::Rectf region, Math::Radiif radii) {
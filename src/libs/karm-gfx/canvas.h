@@ -197,6 +197,11 @@ struct Canvas : Meta::NoCopy {
     // Blit the given pixels to the current pixels at the given position.
     virtual void blit(Math::Vec2i dest, Pixels pixels);
 
+    // Returns the size in device pixels of dest once transformed, or NONE
+    // if the canvas isn't backed by pixels. Pictures blitted at this size
+    // don't need to be resampled.
+    virtual Opt<Math::Vec2i> deviceSize(Math::Recti dest) const;
+
     // MARK: Filter Operations -------------------------------------------------
 
     // Apply a filter on the given region.
@@ -2,6 +2,7 @@
 #include <karm-logger/logger.h>
 #include <karm-math/funcs.h>
 
+#include "../resample.h"
 #include "canvas.h"
 
 namespace Karm::Gfx {
@@ -314,6 +315,30 @@ void CpuCanvas::plot(Math::Recti rect, Color color) {
 
 // MARK: Blit Operations -------------------------------------------------------
 
+// Composites src over dest, both being the same size.
+static void _composite(Pixels src, auto srcFmt, MutPixels dest, auto destFmt) {
+    for (isize y = 0; y < dest.height(); y++) {
+        // NOTE: Opaque rows, which are most of them in photos and wallpapers,
+        //       are copied instead of blended.
+        if (isOpaque(src, y)) {
+            if constexpr (Meta::Same<decltype(srcFmt), decltype(destFmt)>) {
+                memcpy(dest.scanline(y), src.scanline(y), dest.width() * destFmt.bpp());
+            } else {
+                for (isize x = 0; x < dest.width(); x++)
+                    destFmt.store(dest.pixelUnsafe({x, y}), srcFmt.load(src.pixelUnsafe({x, y})));
+            }
+            continue;
+        }
+
+        for (isize x = 0; x < dest.width(); x++) {
+            u8* destPx = static_cast<u8*>(dest.pixelUnsafe({x, y}));
+            auto srcC = srcFmt.load(src.pixelUnsafe({x, y}));
+            auto destC = destFmt.load(destPx);
+            destFmt.store(destPx, srcC.blendOver(destC));
+        }
+    }
+}
+
 [[gnu::flatten]] void CpuCanvas::_blit(
     Pixels src, Math::Recti srcRect, auto srcFmt,
     MutPixels dest, Math::Recti destRect, auto destFmt
@@ -322,29 +347,26 @@ void CpuCanvas::plot(Math::Recti rect, Color color) {
     destRect = current().trans.apply(destRect.cast<f64>()).bound().cast<isize>();
 
     auto clipDest = current().clip.clipTo(destRect);
+    if (clipDest.width <= 0 or clipDest.height <= 0)
+        return;
 
-    auto hratio = srcRect.height / (f64)destRect.height;
-    auto wratio = srcRect.width / (f64)destRect.width;
-
-    for (isize y = 0; y < clipDest.height; ++y) {
-        isize yy = clipDest.y - destRect.y + y;
+    src = src.clip(srcRect);
+    Math::Recti clipSrc = {clipDest.xy - destRect.xy, clipDest.wh};
 
-        auto srcY = srcRect.y + yy * hratio;
-        auto destY = clipDest.y + y;
-
-        for (isize x = 0; x < clipDest.width; ++x) {
-            isize xx = clipDest.x - destRect.x + x;
-
-            auto srcX = srcRect.x + xx * wratio;
-            auto destX = clipDest.x + x;
-
-            u8 const* srcPx = static_cast<u8 const*>(src.pixelUnsafe({(isize)srcX, (isize)srcY}));
-            u8* destPx = static_cast<u8*>(dest.pixelUnsafe({destX, destY}));
-            auto srcC = srcFmt.load(srcPx);
-            auto destC = destFmt.load(destPx);
-            destFmt.store(destPx, srcC.blendOver(destC));
-        }
+    if (src.size() == destRect.size()) {
+        _composite(src.clip(clipSrc), srcFmt, dest.clip(clipDest), destFmt);
+        return;
     }
+
+    // NOTE: Only the visible part of the scaled picture is resampled,
+    //       callers drawing the same picture at the same size again and
+    //       again should cache a copy at deviceSize() (see Image::Picture).
+    usize stride = clipDest.width * src.fmt().bpp();
+    if (_scratch.len() < stride * clipDest.height)
+        _scratch.resize(stride * clipDest.height);
+    MutPixels scaled = {_scratch.buf(), clipDest.wh, stride, src.fmt()};
+    resample(scaled, src, destRect.wh, clipSrc.xy);
+    _composite(scaled, srcFmt, dest.clip(clipDest), destFmt);
 }
 
 void CpuCanvas::blit(Math::Recti src, Math::Recti dest, Pixels p) {
@@ -356,6 +378,12 @@ void CpuCanvas::blit(Math::Recti src, Math::Recti dest, Pixels p) {
     });
 }
 
+Opt<Math::Vec2i> CpuCanvas::deviceSize(Math::Recti dest) const {
+    // NOTE: Same rounding as _blit(), so that blitting pixels of this size
+    //       doesn't resample them.
+    return current().trans.apply(dest.cast<f64>()).bound().cast<isize>().wh;
+}
+
 // MARK: Filter Operations -----------------------------------------------------
 
 void CpuCanvas::apply(Filter filter) {
@@ -35,6 +35,9 @@ struct CpuCanvas : public Canvas {
     LcdLayout _lcdLayout = RGB;
     bool _useSpaa = false;
 
+    // Holds the visible part of pictures being scaled while blitting them.
+    Buf<u8> _scratch{};
+
     // MARK: Buffers -----------------------------------------------------------
 
     // Begin drawing operations on the given pixels.
@@ -151,6 +154,8 @@ struct CpuCanvas : public Canvas {
 
     void blit(Math::Recti src, Math::Recti dest, Pixels pixels) override;
 
+    Opt<Math::Vec2i> deviceSize(Math::Recti dest) const override;
+
     // MARK: Filter Operations -------------------------------------------------
 
     void apply(Filter filter) override;
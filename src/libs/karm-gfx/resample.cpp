@@ -0,0 +1,265 @@
+#include <karm-base/simd.h>
+#include <karm-math/funcs.h>
+
+#include "resample.h"
+
+namespace Karm::Gfx {
+
+// MARK: Filters ---------------------------------------------------------------
+
+static f64 _support(Resampling filter) {
+    switch (filter) {
+    case Resampling::BOX:
+        return 0.5;
+    case Resampling::BILINEAR:
+        return 1;
+    case Resampling::LANCZOS:
+        return 3;
+    default:
+        unreachable();
+    }
+}
+
+// sin(πx), Math::sin() is an approximation that is too far off for the
+// weights to round the same way as other implementations.
+static f64 _sinPi(f64 x) {
+    f64 n = Math::round(Math::abs(x));
+    f64 r = (Math::abs(x) - n) * Math::PI;
+    if (x < 0)
+        r = -r;
+
+    // NOTE: |r| <= π/2, so the series is exact to the last bits by then.
+    f64 r2 = r * r;
+    f64 term = r;
+    f64 sum = r;
+    for (usize i = 1; i < 12; i++) {
+        term *= -r2 / ((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+
+    return (u64)n % 2 ? -sum : sum;
+}
+
+static f64 _sinc(f64 x) {
+    if (x == 0)
+        return 1;
+    return _sinPi(x) / (x * Math::PI);
+}
+
+static f64 _weight(Resampling filter, f64 x) {
+    switch (filter) {
+    case Resampling::BOX:
+        return x > -0.5 and x <= 0.5 ? 1 : 0;
+    case Resampling::BILINEAR:
+        x = Math::abs(x);
+        return x < 1 ? 1 - x : 0;
+    case Resampling::LANCZOS:
+        return x > -3 and x < 3 ? _sinc(x) * _sinc(x / 3) : 0;
+    default:
+        unreachable();
+    }
+}
+
+// MARK: Taps ------------------------------------------------------------------
+
+// Weights are in fixed point with enough bits left for summing 8-bit
+// samples, the negative lobes of Lanczos included.
+static constexpr i32 PRECISION_BITS = 32 - 8 - 2;
+
+// Source samples each output sample of one axis is made of, and their
+// weights, for the outputs [offset, offset + count) of an axis scaled from
+// inSize to outSize.
+struct _Taps {
+    isize len;
+    Buf<isize> start;
+    Buf<isize> count;
+    Buf<i32> weights;
+
+    i32 const* weightsOf(isize i) const {
+        return weights.buf() + i * len;
+    }
+
+    static _Taps compute(isize inSize, isize outSize, isize offset, isize count, Resampling filter) {
+        f64 scale = inSize / (f64)outSize;
+        f64 filterScale = max(scale, 1.0);
+        f64 support = _support(filter) * filterScale;
+
+        isize len = Math::ceili(support) * 2 + 1;
+        _Taps taps{
+            .len = len,
+            .start = Buf<isize>::init(count),
+            .count = Buf<isize>::init(count),
+            .weights = Buf<i32>::init(count * len),
+        };
+
+        Buf<f64> w = Buf<f64>::init(taps.len);
+        for (isize i = 0; i < count; i++) {
+            f64 center = (offset + i + 0.5) * scale;
+            isize lo = max<isize>(center - support + 0.5, 0);
+            isize hi = min<isize>(center + support + 0.5, inSize);
+            hi = clamp(hi, lo + 1, min(lo + taps.len, inSize));
+
+            f64 total = 0;
+            for (isize k = lo; k < hi; k++) {
+                w[k - lo] = _weight(filter, (k - center + 0.5) / filterScale);
+                total += w[k - lo];
+            }
+
+            // NOTE: The kernel can miss every sample when scaling up a
+            //       picture by a lot, take the nearest one instead.
+            if (total == 0) {
+                w[0] = 1;
+                total = 1;
+                hi = lo + 1;
+            }
+
+            taps.start[i] = lo;
+            taps.count[i] = hi - lo;
+            i32* out = taps.weights.buf() + i * taps.len;
+            for (isize k = 0; k < hi - lo; k++) {
+                f64 v = w[k] / total * (1 << PRECISION_BITS);
+                out[k] = (i32)(v < 0 ? v - 0.5 : v + 0.5);
+            }
+        }
+
+        return taps;
+    }
+};
+
+// MARK: Pixels ----------------------------------------------------------------
+
+always_inline static u8 _mul8(u32 a, u32 b) {
+    u32 v = a * b + 128;
+    return (v + (v >> 8)) >> 8;
+}
+
+always_inline static u8 _unmul8(u32 c, u32 a) {
+    return min(c * 255 / a, 255u);
+}
+
+// Loads a row of the source as premultiplied RGBA, so transparent pixels
+// don't bleed their color into the opaque ones, widened for the filter.
+static void _loadRow(Pixels src, isize y, isize left, isize right, i32* out) {
+    src.fmt().visit([&](auto f) {
+        for (isize x = left; x < right; x++) {
+            auto c = f.load(src.pixelUnsafe({x, y}));
+            i32* p = out + (x - left) * 4;
+            if (c.alpha == 255) {
+                p[0] = c.red;
+                p[1] = c.green;
+                p[2] = c.blue;
+            } else {
+                p[0] = _mul8(c.red, c.alpha);
+                p[1] = _mul8(c.green, c.alpha);
+                p[2] = _mul8(c.blue, c.alpha);
+            }
+            p[3] = c.alpha;
+        }
+    });
+}
+
+// Sums the pixels at in, in + 4, ... weighted by w, rounded and clamped to
+// 8-bit.
+always_inline static i32x4 _convolve(i32 const* in, i32 const* w, isize count) {
+    i32 const round = 1 << (PRECISION_BITS - 1);
+    i32x4 acc = {round, round, round, round};
+    for (isize k = 0; k < count; k++) {
+        i32x4 px;
+        memcpy(&px, in + k * 4, sizeof(px));
+        acc += px * w[k];
+    }
+
+    acc >>= PRECISION_BITS;
+    acc &= ~(acc >> 31);
+    acc |= (255 - acc) >> 31;
+    return acc & 255;
+}
+
+// MARK: Resampling ------------------------------------------------------------
+
+void resample(MutPixels dst, Pixels src, Math::Vec2i size, Math::Vec2i offset, Resampling filter) {
+    if (dst.width() <= 0 or dst.height() <= 0 or src.width() <= 0 or src.height() <= 0)
+        return;
+
+    auto h = _Taps::compute(src.width(), size.x, offset.x, dst.width(), filter);
+    auto v = _Taps::compute(src.height(), size.y, offset.y, dst.height(), filter);
+
+    // Only the src columns the horizontal pass needs are loaded.
+    isize left = h.start[0];
+    isize right = left;
+    for (isize x = 0; x < dst.width(); x++)
+        right = max(right, h.start[x] + h.count[x]);
+
+    // NOTE: Rows are filtered horizontally as they are loaded, and the last
+    //       ones are kept in a ring as long as the vertical filter, as the
+    //       rows an output row is made of always come in order.
+    usize n = dst.width() * 4;
+    Buf<i32> line = Buf<i32>::init((right - left) * 4);
+    Buf<i32> ring = Buf<i32>::init(v.len * n);
+    Buf<isize> loaded = Buf<isize>::init(v.len, -1);
+    Buf<i32> acc = Buf<i32>::init(n);
+
+    auto rowAt = [&](isize y) -> i32 const* {
+        i32* out = ring.buf() + (y % v.len) * n;
+        if (loaded[y % v.len] == y)
+            return out;
+        loaded[y % v.len] = y;
+
+        _loadRow(src, y, left, right, line.buf());
+        for (isize x = 0; x < dst.width(); x++) {
+            i32x4 px = _convolve(line.buf() + (h.start[x] - left) * 4, h.weightsOf(x), h.count[x]);
+            memcpy(out + x * 4, &px, sizeof(px));
+        }
+        return out;
+    };
+
+    i32 const round = 1 << (PRECISION_BITS - 1);
+    dst.fmt().visit([&](auto f) {
+        for (isize y = 0; y < dst.height(); y++) {
+            i32* a = acc.buf();
+            for (usize i = 0; i < n; i++)
+                a[i] = round;
+
+            i32 const* w = v.weightsOf(y);
+            for (isize k = 0; k < v.count[y]; k++) {
+                i32 const* in = rowAt(v.start[y] + k);
+                i32 wk = w[k];
+                for (usize i = 0; i < n; i++)
+                    a[i] += in[i] * wk;
+            }
+
+            for (isize x = 0; x < dst.width(); x++) {
+                i32* p = a + x * 4;
+                u8 c[4];
+                for (usize i = 0; i < 4; i++)
+                    c[i] = clamp(p[i] >> PRECISION_BITS, 0, 255);
+
+                // Back to straight alpha
+                if (c[3] != 0 and c[3] != 255) {
+                    c[0] = _unmul8(c[0], c[3]);
+                    c[1] = _unmul8(c[1], c[3]);
+                    c[2] = _unmul8(c[2], c[3]);
+                }
+
+                f.store(dst.pixelUnsafe({x, y}), Color::fromRgba(c[0], c[1], c[2], c[3]));
+            }
+        }
+    });
+}
+
+Rc<Surface> resample(Pixels src, Math::Vec2i size, Resampling filter) {
+    auto surface = Surface::alloc(size, src.fmt());
+    resample(surface->mutPixels(), src, size, {}, filter);
+    return surface;
+}
+
+bool isOpaque(Pixels pixels, isize y) {
+    // NOTE: Every format has its alpha in the last byte of the pixel.
+    u8 const* row = static_cast<u8 const*>(pixels.scanline(y));
+    u8 alpha = 255;
+    for (isize x = 0; x < pixels.width(); x++)
+        alpha &= row[x * 4 + 3];
+    return alpha == 255;
+}
+
+} // namespace Karm::Gfx
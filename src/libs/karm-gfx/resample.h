@@ -0,0 +1,27 @@
+#pragma once
+
+#include "buffer.h"
+
+namespace Karm::Gfx {
+
+// Reconstruction filters for resampling, when scaling down they are widened
+// to cover every source pixel, so the result doesn't alias.
+enum struct Resampling {
+    BOX,
+    BILINEAR,
+    LANCZOS,
+
+    _LEN,
+};
+
+// Scales src to size with a separable filter in fixed point, and writes the
+// part of the result at offset and of the size of dst into dst.
+void resample(MutPixels dst, Pixels src, Math::Vec2i size, Math::Vec2i offset = {}, Resampling filter = Resampling::BILINEAR);
+
+// Same as resample() for a dst of the given size.
+Rc<Surface> resample(Pixels src, Math::Vec2i size, Resampling filter = Resampling::BILINEAR);
+
+// Returns true if every pixel of the row is fully opaque.
+bool isOpaque(Pixels pixels, isize y);
+
+} // namespace Karm::Gfx
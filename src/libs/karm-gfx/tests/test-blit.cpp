@@ -0,0 +1,99 @@
+#include <karm-gfx/cpu/canvas.h>
+#include <karm-gfx/resample.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Gfx::Tests {
+
+static Color const _BACKGROUND = Color::fromRgba(200, 100, 50, 255);
+
+// Opaque except for the second row, which has every level of alpha.
+static Rc<Surface> _source() {
+    auto surface = Surface::alloc({4, 3});
+    for (isize y = 0; y < 3; y++) {
+        for (isize x = 0; x < 4; x++) {
+            u8 alpha = y == 1 ? u8(x * 85) : 255;
+            surface->mutPixels().storeUnsafe({x, y}, Color::fromRgba(x * 60, y * 120, 255 - x * 30, alpha));
+        }
+    }
+    return surface;
+}
+
+static Rc<Surface> _canvas(Math::Vec2i size, Fmt fmt = RGBA8888) {
+    auto surface = Surface::alloc(size, fmt);
+    surface->mutPixels().clear(_BACKGROUND);
+    return surface;
+}
+
+static void _blitAt(Surface& dest, Pixels src, Math::Recti rect, Opt<Math::Recti> clip = NONE) {
+    CpuCanvas canvas;
+    canvas.begin(dest.mutPixels());
+    Canvas& g = canvas;
+    if (clip)
+        g.clip(*clip);
+    g.blit(rect, src);
+    canvas.end();
+}
+
+test$("gfx-blit-composite") {
+    auto src = _source();
+    auto dest = _canvas({6, 5});
+    _blitAt(*dest, src->pixels(), {1, 1, 4, 3});
+
+    for (isize y = 0; y < 5; y++) {
+        for (isize x = 0; x < 6; x++) {
+            Math::Vec2i pos = {x, y};
+            auto expected = _BACKGROUND;
+            if (Math::Recti{1, 1, 4, 3}.contains(pos))
+                expected = src->pixels().loadUnsafe(pos - Math::Vec2i{1, 1}).blendOver(_BACKGROUND);
+            expectEq$(dest->pixels().loadUnsafe(pos), expected);
+        }
+    }
+
+    return Ok();
+}
+
+test$("gfx-blit-composite-format") {
+    auto src = _source();
+
+    // NOTE: Opaque rows are converted rather than copied between formats.
+    auto rgba = _canvas({4, 3});
+    auto bgra = _canvas({4, 3}, BGRA8888);
+    _blitAt(*rgba, src->pixels(), {0, 0, 4, 3});
+    _blitAt(*bgra, src->pixels(), {0, 0, 4, 3});
+
+    for (isize y = 0; y < 3; y++)
+        for (isize x = 0; x < 4; x++)
+            expectEq$(bgra->pixels().loadUnsafe({x, y}), rgba->pixels().loadUnsafe({x, y}));
+
+    expectEq$(static_cast<u8 const*>(bgra->pixels().scanline(0))[0], 255);
+
+    return Ok();
+}
+
+test$("gfx-blit-scaled") {
+    auto src = _source();
+    auto scaled = resample(src->pixels(), {9, 7});
+    auto expected = _canvas({12, 10});
+    _blitAt(*expected, scaled->pixels(), {2, 1, 9, 7});
+
+    // NOTE: Scaling while blitting is the same as blitting a scaled copy,
+    //       clipped or not.
+    auto dest = _canvas({12, 10});
+    _blitAt(*dest, src->pixels(), {2, 1, 9, 7});
+    expect$(dest->pixels().bytes() == expected->pixels().bytes());
+
+    auto clipped = _canvas({12, 10});
+    Math::Recti clip = {4, 3, 5, 3};
+    _blitAt(*clipped, src->pixels(), {2, 1, 9, 7}, clip);
+    for (isize y = 0; y < 10; y++) {
+        for (isize x = 0; x < 12; x++) {
+            Math::Vec2i pos = {x, y};
+            auto color = clip.contains(pos) ? expected->pixels().loadUnsafe(pos) : _BACKGROUND;
+            expectEq$(clipped->pixels().loadUnsafe(pos), color);
+        }
+    }
+
+    return Ok();
+}
+
+} // namespace Karm::Gfx::Tests
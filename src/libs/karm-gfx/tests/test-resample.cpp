@@ -0,0 +1,207 @@
+#include <karm-gfx/resample.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Gfx::Tests {
+
+// MARK: Reference -------------------------------------------------------------
+
+// NOTE: Generated with Pillow 12, Image.resize() of a 5x4 RGBA picture filled
+//       by _pattern(), pixels are 0xRRGGBBAA.
+
+static Array<u32, 6> _OPAQUE_BOX_2X3 = {
+    0x350b5bff, 0xba0b18ff,
+    0x4f43acff, 0xd48ebeff,
+    0x687a52ff, 0x6d9064ff,
+};
+
+static Array<u32, 35> _OPAQUE_BOX_7X5 = {
+    0x000bffff, 0x350b06ff, 0x350b06ff, 0x6a0b0dff, 0x9f0b14ff, 0x9f0b14ff, 0xd40b1bff,
+    0x110bc3ff, 0x4630caff, 0x4630caff, 0x7b55d1ff, 0xb07ad8ff, 0xb07ad8ff, 0xe59fdfff,
+    0x220b87ff, 0x57558eff, 0x57558eff, 0x8c9f95ff, 0xc1e99cff, 0xc1e99cff, 0xf633a3ff,
+    0x220b87ff, 0x57558eff, 0x57558eff, 0x8c9f95ff, 0xc1e99cff, 0xc1e99cff, 0xf633a3ff,
+    0x330b4bff, 0x687a52ff, 0x687a52ff, 0x9de959ff, 0xd25860ff, 0xd25860ff, 0x07c767ff,
+};
+
+static Array<u32, 6> _OPAQUE_BILINEAR_2X3 = {
+    0x3a1679ff, 0xa42c4fff,
+    0x4f43acff, 0xb989baff,
+    0x636764ff, 0x949c72ff,
+};
+
+static Array<u32, 35> _OPAQUE_BILINEAR_7X5 = {
+    0x000bffff, 0x1e0b71ff, 0x440b08ff, 0x6a0b0dff, 0x900b12ff, 0xb60b17ff, 0xd40b1bff,
+    0x0c0bd5ff, 0x2a1aadff, 0x502d91ff, 0x763f96ff, 0x9c519bff, 0xc264a0ff, 0xe073a4ff,
+    0x1a0ba5ff, 0x382ba9ff, 0x5e53aeff, 0x847ab3ff, 0xaaa2b8ff, 0xd093bdff, 0xee69c1ff,
+    0x270b75ff, 0x453b79ff, 0x6b787eff, 0x91b583ff, 0xb7bb88ff, 0xbc958dff, 0xae5f91ff,
+    0x330b4bff, 0x514a4fff, 0x779a54ff, 0x9de959ff, 0xc3815eff, 0x7b8863ff, 0x07c767ff,
+};
+
+static Array<u32, 6> _OPAQUE_LANCZOS_2X3 = {
+    0x2d0e7eff, 0xab253eff,
+    0x4340b5ff, 0xc996ccff,
+    0x666858ff, 0x95a866ff,
+};
+
+static Array<u32, 35> _OPAQUE_LANCZOS_7X5 = {
+    0x000bffff, 0x170a74ff, 0x460900ff, 0x690801ff, 0x8c0808ff, 0xbb040cff, 0xd6000fff,
+    0x080adaff, 0x2215b3ff, 0x512a90ff, 0x743898ff, 0x983c9eff, 0xc363a3ff, 0xda84a6ff,
+    0x1608a5ff, 0x3225bbff, 0x6152d4ff, 0x847ad8ff, 0xa1d1dcff, 0xe7abe3ff, 0xff5ee6ff,
+    0x260670ff, 0x41316fff, 0x6f8571ff, 0x93bc76ff, 0xc1d87bff, 0xbf8d81ff, 0xac4984ff,
+    0x310549ff, 0x4c374cff, 0x77b552ff, 0x9eec57ff, 0xe86a5cff, 0x717862ff, 0x00e165ff,
+};
+
+static Array<u32, 6> _ALPHA_BOX_2X3 = {
+    0x570b0b43, 0xa20b156b,
+    0x6258aa81, 0xc777c969,
+    0x524d4d69, 0x4ba06666,
+};
+
+static Array<u32, 6> _ALPHA_BILINEAR_2X3 = {
+    0x5d205a4f, 0x98325a84,
+    0x5f55aa7b, 0xa878bf81,
+    0x5b59667d, 0x75907555,
+};
+
+static Array<u32, 6> _ALPHA_LANCZOS_2X3 = {
+    0x5811514b, 0x952d578c,
+    0x5a56b482, 0xb080cc89,
+    0x5d55597d, 0x709f5f4b,
+};
+
+static Array<u32, 35> _ALPHA_BILINEAR_7X5 = {
+    0x00000000, 0x350d0626, 0x4d0b0856, 0x6a0b0d86, 0x930b12b6, 0xa10c1578, 0xd415150c,
+    0x1108c11d, 0x3922a743, 0x56339f73, 0x76419fa3, 0x9f57a3d3, 0xb163a995, 0xe68fcd29,
+    0x1c0c983e, 0x4235a364, 0x635baa94, 0x847eafc4, 0xa182c598, 0xc277c96d, 0xf159b64a,
+    0x280a6f5e, 0x4d477584, 0x6a72819e, 0x8c9f9398, 0xa59e8c47, 0xa87b8744, 0x9c6c8d6a,
+    0x330a4a7b, 0x57554fa1, 0x67795288, 0xffff0001, 0xd0586231, 0x59986361, 0x07c66787,
+};
+
+static Color _pattern(isize x, isize y, bool alpha) {
+    return Color::fromRgba(
+        u8(x * 53 + y * 17),
+        u8(x * y * 37 + 11),
+        u8(255 - y * 60 + x * 7),
+        alpha ? u8(x * 67 + y * 41) : 255
+    );
+}
+
+static Rc<Surface> _source(bool alpha) {
+    auto surface = Surface::alloc({5, 4});
+    for (isize y = 0; y < 4; y++)
+        for (isize x = 0; x < 5; x++)
+            surface->mutPixels().storeUnsafe({x, y}, _pattern(x, y, alpha));
+    return surface;
+}
+
+static u32 _rgba(Color c) {
+    return (u32)c.red << 24 | (u32)c.green << 16 | (u32)c.blue << 8 | c.alpha;
+}
+
+static Vec<u32> _rgbas(Pixels pixels) {
+    Vec<u32> res;
+    for (isize y = 0; y < pixels.height(); y++)
+        for (isize x = 0; x < pixels.width(); x++)
+            res.pushBack(_rgba(pixels.loadUnsafe({x, y})));
+    return res;
+}
+
+// MARK: Resampling ------------------------------------------------------------
+
+test$("gfx-resample-reference") {
+    struct Case {
+        bool alpha;
+        Resampling filter;
+        Math::Vec2i size;
+        Slice<u32> expected;
+    };
+
+    Array cases = {
+        Case{false, Resampling::BOX, {2, 3}, _OPAQUE_BOX_2X3},
+        Case{false, Resampling::BOX, {7, 5}, _OPAQUE_BOX_7X5},
+        Case{false, Resampling::BILINEAR, {2, 3}, _OPAQUE_BILINEAR_2X3},
+        Case{false, Resampling::BILINEAR, {7, 5}, _OPAQUE_BILINEAR_7X5},
+        Case{false, Resampling::LANCZOS, {2, 3}, _OPAQUE_LANCZOS_2X3},
+        Case{false, Resampling::LANCZOS, {7, 5}, _OPAQUE_LANCZOS_7X5},
+        Case{true, Resampling::BOX, {2, 3}, _ALPHA_BOX_2X3},
+        Case{true, Resampling::BILINEAR, {2, 3}, _ALPHA_BILINEAR_2X3},
+        Case{true, Resampling::LANCZOS, {2, 3}, _ALPHA_LANCZOS_2X3},
+        Case{true, Resampling::BILINEAR, {7, 5}, _ALPHA_BILINEAR_7X5},
+    };
+
+    for (auto& c : cases) {
+        auto src = _source(c.alpha);
+        auto result = _rgbas(resample(src->pixels(), c.size, c.filter)->pixels());
+        expectEq$(result.len(), c.expected.len());
+        for (usize i = 0; i < result.len(); i++)
+            expectEq$(result[i], c.expected[i]);
+    }
+
+    return Ok();
+}
+
+test$("gfx-resample-window") {
+    auto src = _source(true);
+
+    // NOTE: Resampling a part of the output gives the same pixels as
+    //       cropping the whole of it, blits rely on it when clipped.
+    Math::Vec2i size = {11, 9};
+    Math::Recti window = {3, 2, 5, 4};
+    for (usize f = 0; f < toUnderlyingType(Resampling::_LEN); f++) {
+        auto filter = Resampling(f);
+        auto whole = resample(src->pixels(), size, filter);
+        auto part = Surface::alloc(window.wh);
+        resample(part->mutPixels(), src->pixels(), size, window.xy, filter);
+
+        for (isize y = 0; y < window.height; y++)
+            for (isize x = 0; x < window.width; x++)
+                expectEq$(_rgba(part->pixels().loadUnsafe({x, y})), _rgba(whole->pixels().loadUnsafe(window.xy + Math::Vec2i{x, y})));
+    }
+
+    return Ok();
+}
+
+test$("gfx-resample-same-size") {
+    auto src = _source(false);
+    for (usize f = 0; f < toUnderlyingType(Resampling::_LEN); f++) {
+        auto result = resample(src->pixels(), src->_size, Resampling(f));
+        expect$(result->pixels().bytes() == src->pixels().bytes());
+    }
+    return Ok();
+}
+
+test$("gfx-resample-bgra") {
+    auto src = _source(true);
+    auto bgra = Surface::alloc(src->_size, BGRA8888);
+    blitUnsafe(bgra->mutPixels(), src->pixels());
+
+    // NOTE: The format of the source is kept, and doesn't change the result.
+    auto result = resample(bgra->pixels(), {2, 3}, Resampling::BILINEAR);
+    expectEq$(result->_fmt.index(), Fmt{BGRA8888}.index());
+    expect$(_rgbas(result->pixels()) == _ALPHA_BILINEAR_2X3);
+
+    return Ok();
+}
+
+test$("gfx-is-opaque") {
+    auto surface = Surface::alloc({3, 3});
+    surface->mutPixels().clear(Color::fromRgba(10, 20, 30, 255));
+    surface->mutPixels().storeUnsafe({2, 1}, Color::fromRgba(10, 20, 30, 254));
+    surface->mutPixels().storeUnsafe({0, 2}, Color::fromRgba(10, 20, 30, 0));
+
+    expect$(isOpaque(surface->pixels(), 0));
+    expect$(not isOpaque(surface->pixels(), 1));
+    expect$(not isOpaque(surface->pixels(), 2));
+
+    // NOTE: Only the pixels inside of the view are looked at.
+    expect$(isOpaque(surface->pixels().clip({0, 1, 2, 2}), 0));
+
+    auto bgra = Surface::alloc({2, 1}, BGRA8888);
+    bgra->mutPixels().clear(Color::fromRgba(255, 0, 0, 255));
+    expect$(isOpaque(bgra->pixels(), 0));
+    bgra->mutPixels().storeUnsafe({1, 0}, Color::fromRgba(255, 0, 0, 128));
+    expect$(not isOpaque(bgra->pixels(), 0));
+
+    return Ok();
+}
+
+} // namespace Karm::Gfx::Tests
@@ -0,0 +1,120 @@
+#include <karm-image/jpeg/decoder.h>
+#include <karm-image/png/decoder.h>
+#include <karm-sys/dir.h>
+#include <karm-sys/entry.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-sys/time.h>
+
+static constexpr usize ROUNDS = 16;
+
+struct Stats {
+    Str name;
+    usize images = 0;
+    usize inBytes = 0;
+    usize outBytes = 0;
+    usize pixels = 0;
+    Duration total = Duration::fromUSecs(0);
+
+    void report() const {
+        if (not images)
+            return;
+
+        f64 secs = total.toUSecs() / 1e6;
+        Sys::println("{}: {} images decoded {} times in {}", name, images, ROUNDS, total);
+        Sys::println("  compressed: {} MB/s", inBytes / secs / 1e6);
+        Sys::println("  decoded: {} MB/s", outBytes / secs / 1e6);
+        Sys::println("  {} megapixels/s", pixels / secs / 1e6);
+    }
+};
+
+template <typename Decoder>
+static Res<> bench(Bytes bytes, Stats& stats) {
+    // NOTE: Skip the images that are corrupt on purpose (eg. in the PNG suite)
+    //       or use features the decoder doesn't support.
+    auto maybeDec = Decoder::init(bytes);
+    if (not maybeDec)
+        return Ok();
+    auto dec = maybeDec.take();
+
+    auto img = Gfx::Surface::alloc({dec.width(), dec.height()});
+
+    auto start = Sys::now();
+    for (usize i = 0; i < ROUNDS; i++)
+        try$(dec.decode(*img));
+    stats.total += Sys::now() - start;
+
+    stats.images++;
+    stats.inBytes += bytes.len() * ROUNDS;
+    stats.outBytes += dec.width() * dec.height() * 4 * ROUNDS;
+    stats.pixels += dec.width() * dec.height() * ROUNDS;
+
+    return Ok();
+}
+
+// Same as bench() for JPEGs decoded scaled down, as for thumbnails.
+static Res<> benchScaled(Bytes bytes, usize scale, Stats& stats) {
+    auto maybeDec = Jpeg::Decoder::init(bytes);
+    if (not maybeDec)
+        return Ok();
+    auto dec = maybeDec.take();
+
+    auto size = dec.scaledSize(scale);
+    auto img = Gfx::Surface::alloc(size);
+
+    auto start = Sys::now();
+    for (usize i = 0; i < ROUNDS; i++)
+        try$(dec.decode(*img, scale));
+    stats.total += Sys::now() - start;
+
+    stats.images++;
+    stats.inBytes += bytes.len() * ROUNDS;
+    stats.outBytes += size.x * size.y * 4 * ROUNDS;
+    stats.pixels += size.x * size.y * ROUNDS;
+
+    return Ok();
+}
+
+// Decodes every PNG and JPEG of a directory (eg. karm-image/png/tests/res/pngsuite
+// or karm-image/jpeg/tests/res) and reports the throughput of each decoder.
+Async::Task<> entryPointAsync(Sys::Context& ctx) {
+    auto& args = useArgs(ctx);
+
+    if (args.len() == 0)
+        co_return Error::invalidInput("Usage: karm-image.benchs <image-directory>");
+
+    auto url = co_try$(Mime::parseUrlOrPath(args[0]));
+    auto dir = co_try$(Sys::Dir::open(url));
+
+    Stats png{"png"};
+    Stats jpeg{"jpeg"};
+    Stats jpegHalf{"jpeg 1/2"};
+    Stats jpegEighth{"jpeg 1/8"};
+
+    for (auto const& entry : dir.entries()) {
+        bool isPng = endWith(entry.name, ".png"s) == Match::YES;
+        bool isJpeg = endWith(entry.name, ".jpg"s) == Match::YES or
+                      endWith(entry.name, ".jpeg"s) == Match::YES;
+
+        if (not isPng and not isJpeg)
+            continue;
+
+        auto file = co_try$(Sys::File::open(url.join(entry.name)));
+        auto map = co_try$(Sys::mmap().map(file));
+
+        if (isPng)
+            co_try$(bench<Png::Decoder>(map.bytes(), png));
+        else {
+            co_try$(bench<Jpeg::Decoder>(map.bytes(), jpeg));
+            co_try$(benchScaled(map.bytes(), 2, jpegHalf));
+            co_try$(benchScaled(map.bytes(), 8, jpegEighth));
+        }
+    }
+
+    png.report();
+    jpeg.report();
+    jpegHalf.report();
+    jpegEighth.report();
+
+    co_return Ok();
+}
@@ -0,0 +1,208 @@
+#include <karm-logger/logger.h>
+#include <karm-sys/file.h>
+#include <karm-sys/thread.h>
+
+#include "cache.h"
+#include "loader.h"
+
+namespace Karm::Image {
+
+// MARK: Cached ----------------------------------------------------------------
+
+bool Cached::_Entry::tryDecode() {
+    if (not state.cmpxchg(State::PENDING, State::DECODING))
+        return false;
+
+    if (auto result = load(map.take()); result) {
+        picture = result.take();
+    } else {
+        logWarn("could not decode {}: {}", url, result.none());
+        picture = Picture{Gfx::Surface::fallback()};
+    }
+
+    state.store(State::DONE);
+    Sys::unparkAll();
+    return true;
+}
+
+Picture Cached::picture() const {
+    auto& entry = *_entry;
+
+    // NOTE: The image might not have been picked up by a worker yet, or
+    //       none could be started, then it's decoded right here.
+    if (not entry.tryDecode()) {
+        Sys::parkWhile([&] {
+            return entry.state.load() != State::DONE;
+        });
+    }
+
+    return *entry.picture;
+}
+
+// MARK: Cache -----------------------------------------------------------------
+
+static Res<> _map(Cached::_Entry& entry, Res<Sys::FileReader>& file) {
+    if (not file)
+        return file.none();
+    auto map = try$(Sys::mmap().map(file.unwrap()));
+    entry.size = try$(sniffSize(map.bytes()));
+    entry.map = std::move(map);
+    return Ok();
+}
+
+Opt<Arc<Cached::_Entry>> Cache::_lookup(Mime::Url const& url, SystemTime stamp) {
+    for (usize i = 0; i < _entries.len(); i++) {
+        if (_entries[i]->url != url)
+            continue;
+
+        // NOTE: The file changed since it was cached, the old image is
+        //       only kept alive by the handles that are still around.
+        if (_entries[i]->stamp != stamp) {
+            _entries.removeAt(i--);
+            continue;
+        }
+
+        auto hit = _entries.removeAt(i);
+        _entries.pushFront(hit);
+        return hit;
+    }
+
+    return NONE;
+}
+
+Cached Cache::load(Mime::Url const& url) {
+    auto entry = makeArc<Cached::_Entry>(url);
+    auto file = Sys::File::open(url);
+    if (file) {
+        if (auto stat = file.unwrap().stat(); stat)
+            entry->stamp = stat.unwrap().modifyTime;
+    }
+
+    {
+        LockScope scope(_lock);
+        if (auto hit = _lookup(url, entry->stamp))
+            return {hit.take()};
+    }
+
+    // NOTE: The file is mapped and its headers read without holding the
+    //       lock, so it's looked up again before being inserted.
+    bool mapped = true;
+    if (auto result = _map(*entry, file); not result) {
+        logWarn("could not load {}: {}", url, result.none());
+        Picture fallback = Gfx::Surface::fallback();
+        entry->size = fallback.bound().size();
+        entry->picture = fallback;
+        entry->state.store(Cached::State::DONE);
+        mapped = false;
+    }
+
+    {
+        LockScope scope(_lock);
+        if (auto hit = _lookup(url, entry->stamp))
+            return {hit.take()};
+        _entries.pushFront(entry);
+        _evict();
+    }
+
+    if (mapped)
+        _schedule(entry);
+    return {entry};
+}
+
+usize Cache::used() {
+    LockScope scope(_lock);
+    usize used = 0;
+    for (auto& entry : _entries)
+        used += entry->size.x * entry->size.y * 4;
+    return used;
+}
+
+void Cache::setBudget(usize budget) {
+    LockScope scope(_lock);
+    _budget = budget;
+    _evict();
+}
+
+void Cache::clear() {
+    LockScope scope(_lock);
+    _entries.clear();
+}
+
+void Cache::_evict() {
+    // NOTE: The most recent image is always kept, even if it's alone over
+    //       budget, the handles that are still around keep theirs alive.
+    usize used = 0;
+    for (usize i = 0; i < _entries.len(); i++) {
+        used += _entries[i]->size.x * _entries[i]->size.y * 4;
+        if (i > 0 and used > _budget) {
+            _entries.trunc(i);
+            break;
+        }
+    }
+}
+
+void Cache::_schedule(Arc<Cached::_Entry> entry) {
+    bool spawn = false;
+    {
+        LockScope scope(_lock);
+        _queue.pushBack(entry);
+        if (_workers < Sys::concurrency()) {
+            _workers++;
+            spawn = true;
+        }
+    }
+
+    if (spawn) {
+        if (auto thread = Sys::spawn([this] {
+                _work();
+            })) {
+            LockScope scope(_lock);
+            _threads.pushBack(thread.take());
+        } else {
+            // NOTE: The images will be decoded by whoever needs them first.
+            LockScope scope(_lock);
+            _workers--;
+        }
+    }
+
+    Sys::unparkAll();
+}
+
+void Cache::_work() {
+    while (true) {
+        Opt<Arc<Cached::_Entry>> entry;
+        Sys::parkWhile([&] {
+            LockScope scope(_lock);
+            if (_queue.len() == 0)
+                return not _stopping;
+            entry = _queue.popFront();
+            return false;
+        });
+
+        if (not entry)
+            return;
+
+        (*entry)->tryDecode();
+    }
+}
+
+Cache::~Cache() {
+    Vec<Rc<Sys::Thread>> threads;
+    {
+        LockScope scope(_lock);
+        _stopping = true;
+        _queue.clear();
+        threads = std::move(_threads);
+    }
+
+    Sys::unparkAll();
+    for (auto& thread : threads)
+        (void)thread->join();
+}
+
+Cache& globalCache() {
+    static Cache cache;
+    return cache;
+}
+
+} // namespace Karm::Image
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <karm-base/atomic.h>
+#include <karm-base/lock.h>
+#include <karm-sys/mmap.h>
+#include <karm-sys/thread.h>
+
+#include "picture.h"
+
+namespace Karm::Image {
+
+// MARK: Cached ----------------------------------------------------------------
+
+// An image of the cache, its size is known from the headers right away while
+// its pixels are decoded in the background.
+struct Cached {
+    enum struct State : u8 {
+        PENDING,
+        DECODING,
+        DONE,
+    };
+
+    struct _Entry {
+        Mime::Url url;
+        SystemTime stamp = SystemTime::epoch();
+        Math::Vec2i size;
+        Atomic<State> state = State::PENDING;
+        Opt<Sys::Mmap> map;
+        Opt<Picture> picture;
+
+        // Decodes the image, unless someone else already is.
+        bool tryDecode();
+    };
+
+    mutable Arc<_Entry> _entry;
+
+    Math::Vec2i size() const {
+        return _entry->size;
+    }
+
+    Math::Recti bound() const {
+        return {0, 0, size().x, size().y};
+    }
+
+    bool ready() const {
+        return _entry->state.load() == State::DONE;
+    }
+
+    // Returns the decoded image, waiting for it if needed, the fallback
+    // image if it couldn't be decoded.
+    Picture picture() const;
+
+    void repr(Io::Emit& e) const {
+        e("(cached {} {}x{})", _entry->url, size().x, size().y);
+    }
+};
+
+// MARK: Cache -----------------------------------------------------------------
+
+// Decoded images shared by the whole process, keyed by URL and modification
+// time, and evicted least recently used first once over budget.
+struct Cache :
+    Meta::Pinned {
+
+    static constexpr usize DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+    Lock _lock;
+    usize _budget = DEFAULT_BUDGET;
+    Vec<Arc<Cached::_Entry>> _entries; // Most recently used first
+    Vec<Arc<Cached::_Entry>> _queue;
+
+    // Workers are started on demand, up to one per CPU, and parked while
+    // the queue is empty. They are stopped and joined by the destructor.
+    Vec<Rc<Sys::Thread>> _threads;
+    usize _workers = 0;
+    bool _stopping = false;
+
+    Cache() = default;
+
+    ~Cache();
+
+    // Returns the image at url, and starts decoding it on a worker thread if
+    // it isn't cached already.
+    Cached load(Mime::Url const& url);
+
+    // Memory used by the decoded images, in bytes.
+    usize used();
+
+    void setBudget(usize budget);
+
+    void clear();
+
+    // Returns the entry of url if it's cached and still up to date, and
+    // makes it the most recently used. Must be called with the lock held.
+    Opt<Arc<Cached::_Entry>> _lookup(Mime::Url const& url, SystemTime stamp);
+
+    void _evict();
+
+    // Queues the entry, and starts a new worker if there are fewer than
+    // the number of CPUs. Must be called without holding the lock.
+    void _schedule(Arc<Cached::_Entry> entry);
+
+    void _work();
+};
+
+Cache& globalCache();
+
+} // namespace Karm::Image
@@ -1,9 +1,57 @@
+#include <karm-base/simd.h>
 #include <karm-math/funcs.h>
 
 #include "base.h"
 
 namespace Jpeg {
 
+// MARK: Bit Reader ------------------------------------------------------------
+
+void BitReader::_fill() {
+    while (_nbits <= 56) {
+        u64 byte = 0;
+        if (not _marker and _pos < _bytes.len()) {
+            byte = _bytes[_pos];
+            if (byte != 0xFF) {
+                _pos++;
+            } else if (_pos + 1 < _bytes.len() and _bytes[_pos + 1] == 0x00) {
+                _pos += 2;
+            } else {
+                _marker = true;
+                byte = 0;
+            }
+        }
+        _bits |= byte << (56 - _nbits);
+        _nbits += 8;
+    }
+}
+
+Res<> BitReader::restart() {
+    _bits = 0;
+    _nbits = 0;
+    _marker = false;
+
+    // NOTE: The reader never goes past a marker, so the bytes left before it
+    //       are padding of the interval that was just decoded.
+    while (_pos + 1 < _bytes.len()) {
+        if (_bytes[_pos] != 0xFF or _bytes[_pos + 1] == 0x00 or _bytes[_pos + 1] == 0xFF) {
+            _pos++;
+            continue;
+        }
+
+        u8 marker = _bytes[_pos + 1];
+        if (marker < RST0 or marker > RST7) {
+            logError("jpeg: expected restart marker, got {:02x}", marker);
+            return Error::invalidData("expected restart marker");
+        }
+        _pos += 2;
+        return Ok();
+    }
+
+    logError("jpeg: missing restart marker");
+    return Error::invalidData("missing restart marker");
+}
+
 // MARK: Discrete Cosine Transform ---------------------------------------------
 
 static f32 const m0 = 2.0 * Math::cos(1.0 / 16.0 * 2.0 * Math::PI);
@@ -22,144 +70,6 @@ static f32 const s5 = Math::cos(5.0 / 16.0 * Math::PI) / 2.0;
 static f32 const s6 = Math::cos(6.0 / 16.0 * Math::PI) / 2.0;
 static f32 const s7 = Math::cos(7.0 / 16.0 * Math::PI) / 2.0;
 
-void idct(Mcu& mcu) {
-    for (usize i = 0; i < 8; ++i) {
-        f32 g0 = mcu[0 * 8 + i] * s0;
-        f32 g1 = mcu[4 * 8 + i] * s4;
-        f32 g2 = mcu[2 * 8 + i] * s2;
-        f32 g3 = mcu[6 * 8 + i] * s6;
-        f32 g4 = mcu[5 * 8 + i] * s5;
-        f32 g5 = mcu[1 * 8 + i] * s1;
-        f32 g6 = mcu[7 * 8 + i] * s7;
-        f32 g7 = mcu[3 * 8 + i] * s3;
-
-        f32 f0 = g0;
-        f32 f1 = g1;
-        f32 f2 = g2;
-        f32 f3 = g3;
-        f32 f4 = g4 - g7;
-        f32 f5 = g5 + g6;
-        f32 f6 = g5 - g6;
-        f32 f7 = g4 + g7;
-
-        f32 e0 = f0;
-        f32 e1 = f1;
-        f32 e2 = f2 - f3;
-        f32 e3 = f2 + f3;
-        f32 e4 = f4;
-        f32 e5 = f5 - f7;
-        f32 e6 = f6;
-        f32 e7 = f5 + f7;
-        f32 e8 = f4 + f6;
-
-        f32 d0 = e0;
-        f32 d1 = e1;
-        f32 d2 = e2 * m1;
-        f32 d3 = e3;
-        f32 d4 = e4 * m2;
-        f32 d5 = e5 * m3;
-        f32 d6 = e6 * m4;
-        f32 d7 = e7;
-        f32 d8 = e8 * m5;
-
-        f32 c0 = d0 + d1;
-        f32 c1 = d0 - d1;
-        f32 c2 = d2 - d3;
-        f32 c3 = d3;
-        f32 c4 = d4 + d8;
-        f32 c5 = d5 + d7;
-        f32 c6 = d6 - d8;
-        f32 c7 = d7;
-        f32 c8 = c5 - c6;
-
-        f32 b0 = c0 + c3;
-        f32 b1 = c1 + c2;
-        f32 b2 = c1 - c2;
-        f32 b3 = c0 - c3;
-        f32 b4 = c4 - c8;
-        f32 b5 = c8;
-        f32 b6 = c6 - c7;
-        f32 b7 = c7;
-
-        mcu[0 * 8 + i] = b0 + b7;
-        mcu[1 * 8 + i] = b1 + b6;
-        mcu[2 * 8 + i] = b2 + b5;
-        mcu[3 * 8 + i] = b3 + b4;
-        mcu[4 * 8 + i] = b3 - b4;
-        mcu[5 * 8 + i] = b2 - b5;
-        mcu[6 * 8 + i] = b1 - b6;
-        mcu[7 * 8 + i] = b0 - b7;
-    }
-
-    for (usize i = 0; i < 8; ++i) {
-        f32 g0 = mcu[i * 8 + 0] * s0;
-        f32 g1 = mcu[i * 8 + 4] * s4;
-        f32 g2 = mcu[i * 8 + 2] * s2;
-        f32 g3 = mcu[i * 8 + 6] * s6;
-        f32 g4 = mcu[i * 8 + 5] * s5;
-        f32 g5 = mcu[i * 8 + 1] * s1;
-        f32 g6 = mcu[i * 8 + 7] * s7;
-        f32 g7 = mcu[i * 8 + 3] * s3;
-
-        f32 f0 = g0;
-        f32 f1 = g1;
-        f32 f2 = g2;
-        f32 f3 = g3;
-        f32 f4 = g4 - g7;
-        f32 f5 = g5 + g6;
-        f32 f6 = g5 - g6;
-        f32 f7 = g4 + g7;
-
-        f32 e0 = f0;
-        f32 e1 = f1;
-        f32 e2 = f2 - f3;
-        f32 e3 = f2 + f3;
-        f32 e4 = f4;
-        f32 e5 = f5 - f7;
-        f32 e6 = f6;
-        f32 e7 = f5 + f7;
-        f32 e8 = f4 + f6;
-
-        f32 d0 = e0;
-        f32 d1 = e1;
-        f32 d2 = e2 * m1;
-        f32 d3 = e3;
-        f32 d4 = e4 * m2;
-        f32 d5 = e5 * m3;
-        f32 d6 = e6 * m4;
-        f32 d7 = e7;
-        f32 d8 = e8 * m5;
-
-        f32 c0 = d0 + d1;
-        f32 c1 = d0 - d1;
-        f32 c2 = d2 - d3;
-        f32 c3 = d3;
-        f32 c4 = d4 + d8;
-        f32 c5 = d5 + d7;
-        f32 c6 = d6 - d8;
-        f32 c7 = d7;
-        f32 c8 = c5 - c6;
-
-        f32 b0 = c0 + c3;
-        f32 b1 = c1 + c2;
-        f32 b2 = c1 - c2;
-        f32 b3 = c0 - c3;
-        f32 b4 = c4 - c8;
-        f32 b5 = c8;
-        f32 b6 = c6 - c7;
-        f32 b7 = c7;
-
-        mcu[i * 8 + 0] = b0 + b7;
-        mcu[i * 8 + 1] = b1 + b6;
-        mcu[i * 8 + 2] = b2 + b5;
-        mcu[i * 8 + 3] = b3 + b4;
-        mcu[i * 8 + 4] = b3 - b4;
-        mcu[i * 8 + 5] = b2 - b5;
-        mcu[i * 8 + 6] = b1 - b6;
-        mcu[i * 8 + 7] = b0 - b7;
-    }
-}
-
 void fdtc(Mcu& mcu) {
     for (usize i = 0; i < 8; ++i) {
         f32 a0 = mcu[0 * 8 + i];
@@ -314,6 +224,245 @@ void fdtc(Mcu& mcu) {
     }
 }
 
+// MARK: Inverse DCT -----------------------------------------------------------
+
+// Integer version of the Loeffler, Ligtenberg and Moschytz algorithm, the
+// same as the IJG "islow" IDCT so the output matches the reference decoder.
+// Each 1-D pass transforms four columns at once, the block being split in
+// its left and right halves so the vectors fit a SSE/NEON register.
+
+static constexpr i32 CONST_BITS = 13;
+static constexpr i32 PASS1_BITS = 2;
+
+static constexpr i32 FIX_0_298631336 = 2446;
+static constexpr i32 FIX_0_390180644 = 3196;
+static constexpr i32 FIX_0_541196100 = 4433;
+static constexpr i32 FIX_0_765366865 = 6270;
+static constexpr i32 FIX_0_899976223 = 7373;
+static constexpr i32 FIX_1_175875602 = 9633;
+static constexpr i32 FIX_1_501321110 = 12299;
+static constexpr i32 FIX_1_847759065 = 15137;
+static constexpr i32 FIX_1_961570560 = 16069;
+static constexpr i32 FIX_2_053119869 = 16819;
+static constexpr i32 FIX_2_562915447 = 20995;
+static constexpr i32 FIX_3_072711026 = 25172;
+
+template <i32 SHIFT, typename V>
+always_inline static void _idct8(Array<V, 8>& v) {
+    // Even part
+    V z2 = v[2];
+    V z3 = v[6];
+    V z1 = (z2 + z3) * FIX_0_541196100;
+    V tmp2 = z1 + z3 * -FIX_1_847759065;
+    V tmp3 = z1 + z2 * FIX_0_765366865;
+
+    V tmp0 = (v[0] + v[4]) << CONST_BITS;
+    V tmp1 = (v[0] - v[4]) << CONST_BITS;
+
+    V tmp10 = tmp0 + tmp3;
+    V tmp13 = tmp0 - tmp3;
+    V tmp11 = tmp1 + tmp2;
+    V tmp12 = tmp1 - tmp2;
+
+    // Odd part
+    tmp0 = v[7];
+    tmp1 = v[5];
+    tmp2 = v[3];
+    tmp3 = v[1];
+
+    z1 = tmp0 + tmp3;
+    z2 = tmp1 + tmp2;
+    z3 = tmp0 + tmp2;
+    V z4 = tmp1 + tmp3;
+    V z5 = (z3 + z4) * FIX_1_175875602;
+
+    tmp0 *= FIX_0_298631336;
+    tmp1 *= FIX_2_053119869;
+    tmp2 *= FIX_3_072711026;
+    tmp3 *= FIX_1_501321110;
+    z1 *= -FIX_0_899976223;
+    z2 *= -FIX_2_562915447;
+    z3 = z3 * -FIX_1_961570560 + z5;
+    z4 = z4 * -FIX_0_390180644 + z5;
+
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+
+    i32 round = 1 << (SHIFT - 1);
+    v[0] = (tmp10 + tmp3 + round) >> SHIFT;
+    v[7] = (tmp10 - tmp3 + round) >> SHIFT;
+    v[1] = (tmp11 + tmp2 + round) >> SHIFT;
+    v[6] = (tmp11 - tmp2 + round) >> SHIFT;
+    v[2] = (tmp12 + tmp1 + round) >> SHIFT;
+    v[5] = (tmp12 - tmp1 + round) >> SHIFT;
+    v[3] = (tmp13 + tmp0 + round) >> SHIFT;
+    v[4] = (tmp13 - tmp0 + round) >> SHIFT;
+}
+
+always_inline static void _transpose4(i32x4& a, i32x4& b, i32x4& c, i32x4& d) {
+    i32x4 t0 = __builtin_shufflevector(a, b, 0, 4, 1, 5);
+    i32x4 t1 = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+    i32x4 t2 = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+    i32x4 t3 = __builtin_shufflevector(c, d, 2, 6, 3, 7);
+    a = __builtin_shufflevector(t0, t2, 0, 1, 4, 5);
+    b = __builtin_shufflevector(t0, t2, 2, 3, 6, 7);
+    c = __builtin_shufflevector(t1, t3, 0, 1, 4, 5);
+    d = __builtin_shufflevector(t1, t3, 2, 3, 6, 7);
+}
+
+// Transposes the 8x8 matrix whose rows are split in l (left half) and r.
+always_inline static void _transpose(Array<i32x4, 8>& l, Array<i32x4, 8>& r) {
+    _transpose4(l[0], l[1], l[2], l[3]);
+    _transpose4(l[4], l[5], l[6], l[7]);
+    _transpose4(r[0], r[1], r[2], r[3]);
+    _transpose4(r[4], r[5], r[6], r[7]);
+    for (usize i = 0; i < 4; i++)
+        std::swap(l[i + 4], r[i]);
+}
+
+// Shifts samples back to [0, 255] and clamps them.
+always_inline static i32x4 _level(i32x4 v) {
+    v += 128;
+    v &= ~(v >> 31);
+    v |= (255 - v) >> 31;
+    return v & 255;
+}
+
+void idct(Block const& block, u8* out, usize stride) {
+    Array<i32x4, 8> l, r;
+    for (usize y = 0; y < 8; y++) {
+        memcpy(&l[y], block.buf() + y * 8, 16);
+        memcpy(&r[y], block.buf() + y * 8 + 4, 16);
+    }
+
+    _idct8<CONST_BITS - PASS1_BITS>(l);
+    _idct8<CONST_BITS - PASS1_BITS>(r);
+    _transpose(l, r);
+    _idct8<CONST_BITS + PASS1_BITS + 3>(l);
+    _idct8<CONST_BITS + PASS1_BITS + 3>(r);
+    _transpose(l, r);
+
+    for (usize y = 0; y < 8; y++) {
+        i32x8 v = __builtin_shufflevector(_level(l[y]), _level(r[y]), 0, 1, 2, 3, 4, 5, 6, 7);
+        u8x8 px = __builtin_convertvector(__builtin_convertvector(v, i16x8), u8x8);
+        memcpy(out + y * stride, &px, 8);
+    }
+}
+
+void idctDc(i32 dc, u8* out, usize stride, usize size) {
+    i32 s = clamp((((dc << PASS1_BITS) + (1 << (PASS1_BITS + 2))) >> (PASS1_BITS + 3)) + 128, 0, 255);
+    for (usize y = 0; y < size; y++)
+        memset(out + y * stride, s, size);
+}
+
+// MARK: Reduced Inverse DCT ---------------------------------------------------
+
+// Same as the IJG reduced IDCTs (jidctred.c), in 32-bit fixed point like the
+// SIMD ones of libjpeg-turbo. Only the columns the second pass needs are
+// transformed, the first pass still runs on four columns at once.
+
+static constexpr i32 FIX_0_211164243 = 1730;
+static constexpr i32 FIX_0_509795579 = 4176;
+static constexpr i32 FIX_0_601344887 = 4926;
+static constexpr i32 FIX_0_720959822 = 5906;
+static constexpr i32 FIX_0_850430095 = 6967;
+static constexpr i32 FIX_1_061594337 = 8697;
+static constexpr i32 FIX_1_272758580 = 10426;
+static constexpr i32 FIX_1_451774981 = 11893;
+static constexpr i32 FIX_2_172734803 = 17799;
+static constexpr i32 FIX_3_624509785 = 29692;
+
+// Transforms 8 coefficients into 4 samples, the coefficient 4 isn't used.
+template <i32 SHIFT, typename V>
+always_inline static void _idct4(Array<V, 8> const& v, Array<V, 4>& out) {
+    // Even part
+    V tmp0 = v[0] << (CONST_BITS + 1);
+    V tmp2 = v[2] * FIX_1_847759065 + v[6] * -FIX_0_765366865;
+    V tmp10 = tmp0 + tmp2;
+    V tmp12 = tmp0 - tmp2;
+
+    // Odd part
+    tmp0 = v[7] * -FIX_0_211164243 + v[5] * FIX_1_451774981 +
+           v[3] * -FIX_2_172734803 + v[1] * FIX_1_061594337;
+    tmp2 = v[7] * -FIX_0_509795579 + v[5] * -FIX_0_601344887 +
+           v[3] * FIX_0_899976223 + v[1] * FIX_2_562915447;
+
+    i32 round = 1 << (SHIFT - 1);
+    out[0] = (tmp10 + tmp2 + round) >> SHIFT;
+    out[3] = (tmp10 - tmp2 + round) >> SHIFT;
+    out[1] = (tmp12 + tmp0 + round) >> SHIFT;
+    out[2] = (tmp12 - tmp0 + round) >> SHIFT;
+}
+
+void idct4x4(Block const& block, u8* out, usize stride) {
+    Array<i32x4, 8> l, r;
+    for (usize y = 0; y < 8; y++) {
+        memcpy(&l[y], block.buf() + y * 8, 16);
+        memcpy(&r[y], block.buf() + y * 8 + 4, 16);
+    }
+
+    // Columns into 4 rows of 8, then back to columns.
+    Array<i32x4, 4> rl, rr;
+    _idct4<CONST_BITS - PASS1_BITS + 1>(l, rl);
+    _idct4<CONST_BITS - PASS1_BITS + 1>(r, rr);
+    _transpose4(rl[0], rl[1], rl[2], rl[3]);
+    _transpose4(rr[0], rr[1], rr[2], rr[3]);
+    Array<i32x4, 8> ws = {rl[0], rl[1], rl[2], rl[3], rr[0], rr[1], rr[2], rr[3]};
+
+    Array<i32x4, 4> cols;
+    _idct4<CONST_BITS + PASS1_BITS + 3 + 1>(ws, cols);
+    for (auto& c : cols)
+        c = _level(c);
+    _transpose4(cols[0], cols[1], cols[2], cols[3]);
+
+    for (usize y = 0; y < 4; y++) {
+        u8x4 px = __builtin_convertvector(cols[y], u8x4);
+        memcpy(out + y * stride, &px, 4);
+    }
+}
+
+// Transforms 8 coefficients into 2 samples, only the DC and the odd
+// coefficients are used.
+template <i32 SHIFT, typename V>
+always_inline static void _idct2(Array<V, 8> const& v, Array<V, 2>& out) {
+    V tmp10 = v[0] << (CONST_BITS + 2);
+    V tmp0 = v[7] * -FIX_0_720959822 + v[5] * FIX_0_850430095 +
+             v[3] * -FIX_1_272758580 + v[1] * FIX_3_624509785;
+
+    i32 round = 1 << (SHIFT - 1);
+    out[0] = (tmp10 + tmp0 + round) >> SHIFT;
+    out[1] = (tmp10 - tmp0 + round) >> SHIFT;
+}
+
+void idct2x2(Block const& block, u8* out, usize stride) {
+    Array<i32x4, 8> l, r;
+    for (usize y = 0; y < 8; y++) {
+        memcpy(&l[y], block.buf() + y * 8, 16);
+        memcpy(&r[y], block.buf() + y * 8 + 4, 16);
+    }
+
+    Array<i32x4, 2> rl, rr;
+    _idct2<CONST_BITS - PASS1_BITS + 2>(l, rl);
+    _idct2<CONST_BITS - PASS1_BITS + 2>(r, rr);
+
+    for (usize y = 0; y < 2; y++) {
+        Array<i32, 8> ws;
+        memcpy(ws.buf(), &rl[y], 16);
+        memcpy(ws.buf() + 4, &rr[y], 16);
+
+        Array<i32, 2> px;
+        _idct2<CONST_BITS + PASS1_BITS + 3 + 2>(ws, px);
+        out[y * stride + 0] = clamp(px[0] + 128, 0, 255);
+        out[y * stride + 1] = clamp(px[1] + 128, 0, 255);
+    }
+}
+
+void idct1x1(Block const& block, u8* out, usize) {
+    out[0] = clamp(((block[0] + 4) >> 3) + 128, 0, 255);
+}
+
 // MARK: Quantization ----------------------------------------------------------
 
 void quantize(Mcu& mcu, Quant const& quant) {
@@ -345,19 +494,40 @@ Array<usize, 256> const& Huff::codes() {
     return *_codes;
 }
 
-Res<Byte> Huff::next(BitReader& bs) {
+Res<> Huff::build() {
+    _lookup = {};
     usize code = 0;
-    for (usize i = 0; i < 16; ++i) {
-        code = (code << 1) | try$(bs.nextBit());
-        for (usize j = offs[i]; j < offs[i + 1]; ++j) {
-            if (code == codes()[j]) {
-                return Ok(syms[j]);
-            }
+    for (usize len = 1; len <= 16; ++len) {
+        usize first = offs[len - 1];
+        usize last = offs[len];
+        if (last < first or code + (last - first) > ((usize)1 << len)) {
+            logError("jpeg: invalid huffman table");
+            return Error::invalidData("invalid huffman table");
+        }
+
+        _valoff[len] = (i32)first - (i32)code;
+        for (usize j = first; j < last; ++j, ++code) {
+            if (len > LOOKAHEAD)
+                continue;
+            usize shift = LOOKAHEAD - len;
+            for (usize k = 0; k < ((usize)1 << shift); ++k)
+                _lookup[(code << shift) | k] = (len << 8) | syms[j];
         }
+        _maxcode[len] = last > first ? (i32)code - 1 : -1;
+        code <<= 1;
     }
+    return Ok();
+}
 
-    logError("jpeg: invalid huffman code {x}", code);
-    return Error::invalidData("invalid huffman code");
+isize Huff::_decodeSlow(BitReader& bs) const {
+    for (usize len = LOOKAHEAD + 1; len <= 16; ++len) {
+        i32 code = bs.peek(len);
+        if (code <= _maxcode[len]) {
+            bs.consume(len);
+            return syms[code + _valoff[len]];
+        }
+    }
+    return -1;
 }
 
 bool Huff::getCode(u8 symbol, usize& code, usize& codeLength) {
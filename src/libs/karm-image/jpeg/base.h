@@ -138,63 +138,49 @@ struct BitWriter {
     }
 };
 
+// Reads the entropy-coded segment of a scan. Bits are kept left-aligned in a
+// 64-bit buffer and refilled a byte at a time, stuffed zero bytes are dropped
+// and the stream reads as zeros once a marker (or the end) is reached.
 struct BitReader {
-    Io::BScan& s;
+    Bytes _bytes;
+    usize _pos = 0;
 
-    u8 _buf = 0;
-    u8 _len = 0;
+    u64 _bits = 0;
+    usize _nbits = 0;
+    bool _marker = false;
 
-    always_inline BitReader(Io::BScan& s) : s(s) {}
+    always_inline BitReader(Bytes bytes) : _bytes(bytes) {}
 
-    always_inline void reset() {
-        _buf = 0x0;
-        _len = 0x0;
-    }
+    void _fill();
 
-    always_inline Res<> fill() {
-        if (_len)
-            return Ok();
-
-        _buf = s.nextU8be();
-        while (_buf == 0xFF) {
-            u8 marker = s.peekU8be();
-
-            while (marker == 0xFF) {
-                s.nextU8be();
-                marker = s.peekU8be();
-            }
-
-            if (marker == 0x00) {
-                s.nextU8be();
-                break;
-            } else if (RST0 <= marker and marker <= RST7) {
-                s.nextU8be();
-                _buf = s.nextU8be();
-            } else {
-                logError("jpeg: invalid marker");
-                return Error::invalidData("invalid marker");
-            }
-        }
+    always_inline void ensure(usize n) {
+        if (_nbits < n) [[unlikely]]
+            _fill();
+    }
 
-        _len = 8;
-        return Ok();
+    // Must be preceded by ensure(n), n being in [1, 32].
+    always_inline u32 peek(usize n) const {
+        return _bits >> (64 - n);
     }
 
-    always_inline Res<u8> nextBit() {
-        try$(fill());
-        u8 bit = _buf >> 7;
-        _buf <<= 1;
-        _len--;
-        return Ok(bit);
+    always_inline void consume(usize n) {
+        _bits <<= n;
+        _nbits -= n;
     }
 
-    always_inline Res<usize> nextBits(u8 n) {
-        usize res = 0;
-        while (n--) {
-            res = (res << 1) | try$(nextBit());
-        }
-        return Ok(res);
+    // Reads an n-bit magnitude and sign-extends it as described in F.2.2.1
+    always_inline i32 receive(usize n) {
+        if (n == 0)
+            return 0;
+        ensure(n);
+        i32 v = peek(n);
+        consume(n);
+        return v < (1 << (n - 1)) ? v - (1 << n) + 1 : v;
     }
+
+    // Drops the bits left in the current interval and skips the next RSTn
+    // marker.
+    Res<> restart();
 };
 
 // MARK: MCUs ------------------------------------------------------------------
@@ -222,9 +208,25 @@ static inline Mcu mcuFetch(Gfx::Pixels pixels, usize mx, usize my, usize compone
     return mcu;
 }
 
+// Dequantized coefficients of a block in natural (row-major) order.
+using Block = Array<i32, 64>;
+
 // MARK: Discrete Cosine Transform ---------------------------------------------
 
-void idct(Mcu& mcu);
+// Inverse DCT of a block into 8x8 level-shifted and clamped samples.
+void idct(Block const& block, u8* out, usize stride);
+
+// Reduced inverse DCTs, they only keep the low frequencies of the block to
+// output 4x4, 2x2 or 1x1 samples, for decoding at 1/2, 1/4 or 1/8 scale.
+void idct4x4(Block const& block, u8* out, usize stride);
+
+void idct2x2(Block const& block, u8* out, usize stride);
+
+void idct1x1(Block const& block, u8* out, usize stride);
+
+// Same as the inverse DCTs above for a block without AC coefficients, every
+// one of the size x size samples has the same value.
+void idctDc(i32 dc, u8* out, usize stride, usize size = 8);
 
 void fdtc(Mcu& mcu);
 
@@ -239,13 +241,35 @@ void dequantize(Mcu& mcu, Quant const& quant);
 // MARK: Huffman Tables --------------------------------------------------------
 
 struct Huff {
+    // Codes of up to LOOKAHEAD bits are decoded with a single lookup in
+    // _lookup, whose entries are (length << 8) | symbol, or zero for codes
+    // that are longer. These go through the canonical maxcode/valoff tables.
+    static constexpr usize LOOKAHEAD = 9;
+
     Array<u8, 17> offs = {};
     Array<u8, 162> syms = {};
     Opt<Array<usize, 256>> _codes = {};
 
+    Array<u16, 1 << LOOKAHEAD> _lookup = {};
+    Array<i32, 17> _maxcode = {};
+    Array<i32, 17> _valoff = {};
+
     Array<usize, 256> const& codes();
 
-    Res<Byte> next(BitReader& bs);
+    Res<> build();
+
+    isize _decodeSlow(BitReader& bs) const;
+
+    // Returns the next symbol, or -1 if the bits don't form a valid code.
+    always_inline isize decode(BitReader& bs) const {
+        bs.ensure(16);
+        u16 e = _lookup[bs.peek(LOOKAHEAD)];
+        if (e) [[likely]] {
+            bs.consume(e >> 8);
+            return e & 0xff;
+        }
+        return _decodeSlow(bs);
+    }
 
     bool getCode(u8 symbol, usize& code, usize& codeLength);
 };
@@ -1,3 +1,7 @@
+#include <karm-base/buf.h>
+#include <karm-base/simd.h>
+#include <karm-base/vec.h>
+
 #include "decoder.h"
 
 namespace Jpeg {
@@ -39,7 +43,7 @@ Res<Decoder> Decoder::init(Bytes slice) {
             dec.skipMarker(s);
         } else if (marker == DQT) {
             try$(dec.defineQuantizationTable(s));
-        } else if (marker == SOF0) {
+        } else if (marker == SOF0 or marker == SOF1) {
             try$(dec.startOfFrame(s));
         } else if (marker == DRI) {
             try$(dec.defineRestartInterval(s));
@@ -47,7 +51,7 @@ Res<Decoder> Decoder::init(Bytes slice) {
             try$(dec.defineHuffmanTable(s));
         } else if (marker == SOS) {
             try$(dec.startOfScan(s));
-            try$(dec.decodeHuffman(s));
+            try$(dec.skipHuffman(s));
         } else if (marker == EOI) {
             reachedEoi = true;
         } else if (marker == TEM) {
@@ -122,6 +126,11 @@ Res<> Decoder::startOfFrame(Io::BScan& x) {
     _height = s.nextU16be();
     _width = s.nextU16be();
 
+    if (_width == 0 or _height == 0) {
+        logError("jpeg: invalid image size: {}x{}", _width, _height);
+        return Error::invalidData("invalid image size");
+    }
+
     u8 componentCount = s.nextU8be();
     if (componentCount != 1 and componentCount != 3) {
         logError("jpeg: invalid component count: {}", componentCount);
@@ -153,13 +162,43 @@ Res<> Decoder::startOfFrame(Io::BScan& x) {
         u8 factors = s.nextU8be();
         u8 quantId = s.nextU8be();
 
+        u8 hFactor = factors >> 4;
+        u8 vFactor = factors & 0xF;
+
+        if (hFactor < 1 or hFactor > 4 or vFactor < 1 or vFactor > 4) {
+            logError("jpeg: invalid sampling factors: {}x{}", hFactor, vFactor);
+            return Error::invalidData("invalid sampling factors");
+        }
+
+        // NOTE: The scan of a single component image isn't interleaved, so
+        //       each MCU is a single block whatever the sampling factors.
+        if (componentCount == 1) {
+            hFactor = 1;
+            vFactor = 1;
+        }
+
         _components[id].emplace(Component{
-            (u8)(factors >> 4),
-            (u8)(factors & 0xF),
+            hFactor,
+            vFactor,
             quantId,
         });
 
         _componentCount = max(_componentCount, (usize)id + 1);
+        _hMax = max(_hMax, hFactor);
+        _vMax = max(_vMax, vFactor);
+    }
+
+    for (usize i = 0; i < _componentCount; ++i) {
+        if (not _components[i]) {
+            logError("jpeg: undefined component id: {}", i);
+            return Error::invalidData("undefined component id");
+        }
+
+        auto& c = _components[i].unwrap();
+        if (_hMax % c.hFactor or _vMax % c.vFactor) {
+            logError("jpeg: unsupported sampling factors: {}x{}", c.hFactor, c.vFactor);
+            return Error::invalidData("unsupported sampling factors");
+        }
     }
 
     return Ok();
@@ -213,6 +252,8 @@ Res<> Decoder::defineHuffmanTable(Io::BScan& x) {
         for (usize i = 0; i < sum; ++i) {
             table.syms[i] = s.nextU8be();
         }
+
+        try$(table.build());
     }
 
     return Ok();
@@ -298,136 +339,440 @@ Res<> Decoder::startOfScan(Io::BScan& x) {
     return Ok();
 }
 
-Res<> Decoder::decodeHuffman(Io::BScan& s) {
-    _mcus.resize(mcuWidth() * mcuHeight() * _componentCount);
+Res<> Decoder::skipHuffman(Io::BScan& s) {
+    if (_scan.len()) {
+        logError("jpeg: multiple scans are not supported");
+        return Error::invalidData("multiple scans are not supported");
+    }
 
-    Array<isize, 3> prevDc = {};
+    // NOTE: The entropy-coded data ends at the first marker that is neither
+    //       a stuffed zero byte, nor a restart marker, nor fill bytes.
+    Bytes bytes = s.remBytes();
+    usize len = 0;
+    while (len + 1 < bytes.len()) {
+        u8 next = bytes[len + 1];
+        if (bytes[len] == 0xFF and next != 0x00 and next != 0xFF and (next < RST0 or next > RST7))
+            break;
+        len++;
+    }
 
-    BitReader bs{s};
+    if (len + 1 >= bytes.len())
+        len = bytes.len();
 
-    for (usize i = 0; i < _mcus.len(); ++i) {
-        Mcu& mcu = _mcus[i];
-        usize cid = i % _componentCount;
+    _scan = sub(bytes, 0, len);
+    s.skip(len);
+    return Ok();
+}
 
-        // logDebug("jpeg: decoding mcu {} of {} (cid: {})", i + 1, _mcus.len(), cid);
+// MARK: Planes ----------------------------------------------------------------
 
-        // handle restart interval
-        if (_restartInterval > 0 and (i / _componentCount) % _restartInterval == 0) {
-            prevDc = {};
-            bs.reset();
-        }
+// Rows of samples are padded on both sides so the upsamplers can read one
+// sample past each edge, and vector loads can run past the last sample.
+static constexpr usize ROW_PAD = 16;
 
-        if (not _scanComponents[cid]) {
-            logError("jpeg: undefined component id: {}", cid);
-            return Error::invalidData("undefined component id");
-        }
+template <typename V>
+always_inline static V _load(u8 const* p) {
+    V v;
+    memcpy(&v, p, sizeof(V));
+    return v;
+}
 
-        auto& c = _scanComponents[cid].unwrap();
+always_inline static i16x8 _widen16(u8 const* p) {
+    return __builtin_convertvector(_load<u8x8>(p), i16x8);
+}
 
-        // logDebug("jpeg: decoding using huffman table (dc: {}, ac: {})", c.dcHuffId, c.acHuffId);
+always_inline static i32x4 _widen32(u8 const* p) {
+    return __builtin_convertvector(_load<u8x4>(p), i32x4);
+}
 
-        if (not _dcHuff[c.dcHuffId]) {
-            logError("jpeg: undefined dc huffman table id: {}", c.dcHuffId);
-            return Error::invalidData("undefined dc huffman table id");
+// Samples of a component for the MCU row being output (a band), along with
+// the rows the upsampler needs around it: the last row of the band above and
+// the band below, which is decoded ahead.
+struct _Plane {
+    usize hFactor;
+    usize vFactor;
+
+    // Size of the blocks in samples, less than 8 when decoding a scaled
+    // down image.
+    usize size;
+
+    // Size in samples, without the padding of the partial MCUs
+    usize width;
+    usize height;
+
+    // Scale from the samples of the component to the pixels of the image
+    usize hRatio;
+    usize vRatio;
+    bool fancy;
+
+    usize stride;
+    usize rows;
+
+    Quant const* quant;
+    Huff const* dc;
+    Huff const* ac;
+    i32 pred = 0;
+
+    Buf<u8> cur;
+    Buf<u8> next;
+    Buf<u8> above;
+
+    u8* samples(Buf<u8>& band, usize y) {
+        return band.buf() + y * stride + ROW_PAD;
+    }
+
+    // Returns the row y of the component, rows outside of the component
+    // repeat the ones at its edges as libjpeg does.
+    u8 const* row(usize band, isize y) {
+        y = clamp(y, (isize)0, (isize)height - 1);
+        isize top = band * rows;
+        if (y < top)
+            return above.buf() + ROW_PAD;
+        if (y >= top + (isize)rows)
+            return samples(next, y - top - rows);
+        return samples(cur, y - top);
+    }
+};
+
+static Res<> _decodeBlock(BitReader& bs, _Plane& p, u8* out) {
+    Quant const& quant = *p.quant;
+
+    isize s = p.dc->decode(bs);
+    if (s < 0 or s > 11) {
+        logError("jpeg: invalid dc huffman code");
+        return Error::invalidData("invalid dc huffman code");
+    }
+    p.pred += bs.receive(s);
+
+    Block block{};
+    block[0] = p.pred * (i32)quant[0];
+
+    // NOTE: Coefficients are dequantized as they are decoded, and blocks
+    //       without any AC coefficient (common in smooth areas) skip the IDCT.
+    bool hasAc = false;
+    usize k = 1;
+    while (k < 64) {
+        isize rs = p.ac->decode(bs);
+        if (rs < 0) {
+            logError("jpeg: invalid ac huffman code");
+            return Error::invalidData("invalid ac huffman code");
         }
 
-        auto& dcHuff = _dcHuff[c.dcHuffId].unwrap();
+        usize run = rs >> 4;
+        usize size = rs & 0xF;
 
-        if (not _acHuff[c.acHuffId]) {
-            logError("jpeg: undefined ac huffman table id: {}", c.acHuffId);
-            return Error::invalidData("undefined ac huffman table id");
+        if (size == 0) {
+            if (run != 15)
+                break;
+            k += 16;
+            continue;
+        }
+
+        k += run;
+        if (k >= 64 or size > 10) {
+            logError("jpeg: invalid ac coefficient");
+            return Error::invalidData("invalid ac coefficient");
         }
 
-        auto& acHuff = _acHuff[c.acHuffId].unwrap();
+        usize z = ZIGZAG[k++];
+        block[z] = bs.receive(size) * (i32)quant[z];
+        hasAc = true;
+    }
+
+    if (not hasAc)
+        idctDc(block[0], out, p.stride, p.size);
+    else if (p.size == 8)
+        idct(block, out, p.stride);
+    else if (p.size == 4)
+        idct4x4(block, out, p.stride);
+    else if (p.size == 2)
+        idct2x2(block, out, p.stride);
+    else
+        idct1x1(block, out, p.stride);
 
-        Byte len = try$(dcHuff.next(bs));
+    return Ok();
+}
 
-        if (len > 11) {
-            logError("jpeg: invalid dc huffman code length: {}", len);
-            return Error::invalidData("invalid dc huffman code length");
+static Res<> _decodeBand(Decoder& dec, BitReader& bs, Vec<_Plane>& planes, usize& mcu) {
+    for (isize x = 0; x < dec.mcuWidth(); x++) {
+        if (dec._restartInterval and mcu and mcu % dec._restartInterval == 0) {
+            try$(bs.restart());
+            for (auto& p : planes)
+                p.pred = 0;
         }
+        mcu++;
 
-        isize coeff = try$(bs.nextBits(len));
+        for (auto& p : planes) {
+            for (usize by = 0; by < p.vFactor; by++)
+                for (usize bx = 0; bx < p.hFactor; bx++)
+                    try$(_decodeBlock(bs, p, p.samples(p.next, by * p.size) + (x * p.hFactor + bx) * p.size));
+        }
+    }
 
-        if (len != 0 and coeff < (1 << (len - 1))) {
-            coeff -= (1 << len) - 1;
+    // Repeat the samples at the edges into the padding.
+    for (auto& p : planes) {
+        for (usize y = 0; y < p.rows; y++) {
+            u8* row = p.samples(p.next, y);
+            row[-1] = row[0];
+            memset(row + p.width, row[p.width - 1], p.stride - ROW_PAD - p.width);
         }
+    }
 
-        mcu[0] = prevDc[cid] + coeff;
-        prevDc[cid] = mcu[0];
+    return Ok();
+}
 
-        usize k = 1;
-        while (k < 64) {
-            Byte sym = try$(acHuff.next(bs));
+// MARK: Upsampling ------------------------------------------------------------
+
+// "Fancy" upsampling of libjpeg, a triangle filter that puts each output
+// sample between the input ones instead of repeating them. The row near is
+// the input row above or below the current one, whichever is the closest
+// to the output row.
+
+static void _upsampleH2V1(u8 const* in, usize width, u8* out) {
+    for (usize x = 0; x < width; x += 8) {
+        i16x8 c = _widen16(in + x) * 3;
+        i16x8 even = (c + _widen16(in + x - 1) + 1) >> 2;
+        i16x8 odd = (c + _widen16(in + x + 1) + 2) >> 2;
+        u8x16 px = __builtin_convertvector(
+            __builtin_shufflevector(even, odd, 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15),
+            u8x16
+        );
+        memcpy(out + x * 2, &px, 16);
+    }
+}
 
-            if (sym == 0) {
-                break;
-            }
+static void _upsampleH2V2(u8 const* in, u8 const* near, usize width, u8* out) {
+    for (usize x = 0; x < width; x += 8) {
+        i16x8 c = _widen16(in + x) * 3 + _widen16(near + x);
+        i16x8 l = _widen16(in + x - 1) * 3 + _widen16(near + x - 1);
+        i16x8 r = _widen16(in + x + 1) * 3 + _widen16(near + x + 1);
+        i16x8 even = (c * 3 + l + 8) >> 4;
+        i16x8 odd = (c * 3 + r + 7) >> 4;
+        u8x16 px = __builtin_convertvector(
+            __builtin_shufflevector(even, odd, 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15),
+            u8x16
+        );
+        memcpy(out + x * 2, &px, 16);
+    }
+}
 
-            Byte numZeroes = sym >> 4;
+static void _upsampleH1V2(u8 const* in, u8 const* near, usize width, i16 bias, u8* out) {
+    for (usize x = 0; x < width; x += 8) {
+        i16x8 v = (_widen16(in + x) * 3 + _widen16(near + x) + bias) >> 2;
+        u8x8 px = __builtin_convertvector(v, u8x8);
+        memcpy(out + x, &px, 8);
+    }
+}
 
-            if (sym == 0xF0) {
-                numZeroes = 16;
-            }
+static void _upsampleNearest(u8 const* in, usize ratio, usize width, u8* out) {
+    for (usize x = 0; x < width; x++)
+        out[x] = in[x / ratio];
+}
 
-            if (k + numZeroes >= 64) {
-                logError("jpeg: zero run length exceeds block size: {}", k + numZeroes);
-                return Error::invalidData("zero run length exceeds block size");
-            }
+// Returns the samples of the component at the output row y of the band,
+// upsampled to the width of the image.
+static u8 const* _upsample(_Plane& p, usize band, usize y, usize width, u8* tmp) {
+    isize cy = band * p.rows + y / p.vRatio;
+    u8 const* in = p.row(band, cy);
+
+    bool below = y % 2;
+
+    if (p.hRatio == 1 and p.vRatio == 1) {
+        return in;
+    } else if (p.hRatio == 2 and p.vRatio == 1 and p.fancy and p.width > 2) {
+        _upsampleH2V1(in, p.width, tmp);
+    } else if (p.hRatio == 2 and p.vRatio == 2 and p.fancy and p.width > 2) {
+        _upsampleH2V2(in, p.row(band, below ? cy + 1 : cy - 1), p.width, tmp);
+    } else if (p.hRatio == 1 and p.vRatio == 2 and p.fancy) {
+        _upsampleH1V2(in, p.row(band, below ? cy + 1 : cy - 1), p.width, below ? 2 : 1, tmp);
+    } else {
+        _upsampleNearest(in, p.hRatio, width, tmp);
+    }
 
-            k += numZeroes;
+    return tmp;
+}
 
-            Byte len = sym & 0xF;
+// MARK: Color Conversion ------------------------------------------------------
 
-            if (len > 10) {
-                logError("jpeg: invalid ac huffman code length: {}", len);
-                return Error::invalidData("invalid ac huffman code length");
-            }
+always_inline static u32x4 _clamp8(i32x4 v) {
+    v &= ~(v >> 31);
+    v |= (255 - v) >> 31;
+    return (u32x4)(v & 255);
+}
 
-            if (len) {
-                coeff = try$(bs.nextBits(len));
+// YCbCr to RGB as specified by JFIF, in 16-bit fixed point like libjpeg.
+static void _yccToRgba(u8 const* y, u8 const* cb, u8 const* cr, usize width, u8* out) {
+    for (usize x = 0; x < width; x += 4) {
+        i32x4 l = _widen32(y + x);
+        i32x4 b = _widen32(cb + x) - 128;
+        i32x4 r = _widen32(cr + x) - 128;
 
-                if (coeff < (1 << (len - 1))) {
-                    coeff -= (1 << len) - 1;
-                }
+        u32x4 px = _clamp8(l + ((r * 91881 + 32768) >> 16)) |
+                   _clamp8(l + ((b * -22554 + r * -46802 + 32768) >> 16)) << 8 |
+                   _clamp8(l + ((b * 116130 + 32768) >> 16)) << 16 |
+                   0xff000000;
 
-                mcu[ZIGZAG[k++]] = coeff;
-            }
-        }
+        memcpy(out + x * 4, &px, min<usize>(width - x, 4) * 4);
     }
+}
 
-    return Ok();
+static void _greyToRgba(u8 const* y, usize width, u8* out) {
+    for (usize x = 0; x < width; x += 4) {
+        u32x4 l = (u32x4)_widen32(y + x);
+        u32x4 px = l | l << 8 | l << 16 | 0xff000000;
+        memcpy(out + x * 4, &px, min<usize>(width - x, 4) * 4);
+    }
 }
 
-Res<> Decoder::decode(Gfx::MutPixels pixels) {
-    for (usize i = 0; i < _mcus.len(); i += _componentCount) {
-        usize x = (i / _componentCount) % mcuWidth();
-        usize y = (i / _componentCount) / mcuWidth();
+// MARK: Decoding --------------------------------------------------------------
 
-        for (usize j = 0; j < _componentCount; j++) {
-            auto& mcu = _mcus[i + j];
+usize Decoder::scaleFor(Math::Vec2i size) const {
+    for (usize scale = 8; scale > 1; scale /= 2) {
+        auto scaled = scaledSize(scale);
+        if (scaled.x >= size.x and scaled.y >= size.y)
+            return scale;
+    }
+    return 1;
+}
 
-            if (not _quant[_components[j]->quantId]) {
-                logError("jpeg: undefined quantization table id: {}", _components[j]->quantId);
-                return Error::invalidData("undefined quantization table id");
-            }
+Math::Vec2i Decoder::scaledSize(usize scale) const {
+    return {
+        (_width + (isize)scale - 1) / (isize)scale,
+        (_height + (isize)scale - 1) / (isize)scale,
+    };
+}
 
-            auto& quant = _quant[_components[j]->quantId].unwrap();
-            dequantize(mcu, quant);
-            idct(mcu);
+Res<> Decoder::decode(Gfx::MutPixels pixels, usize scale) {
+    if (scale != 1 and scale != 2 and scale != 4 and scale != 8) {
+        logError("jpeg: unsupported scale: {}", scale);
+        return Error::invalidInput("unsupported scale");
+    }
+
+    // Size of the blocks of the components with the highest sampling
+    // factors, which are the ones that aren't upsampled.
+    usize blockSize = 8 / scale;
+
+    if (not _scan.len()) {
+        logError("jpeg: missing scan");
+        return Error::invalidData("missing scan");
+    }
+
+    Vec<_Plane> planes;
+    for (usize i = 0; i < _componentCount; ++i) {
+        auto& c = _components[i].unwrap();
+
+        if (not _quant[c.quantId]) {
+            logError("jpeg: undefined quantization table id: {}", c.quantId);
+            return Error::invalidData("undefined quantization table id");
         }
 
-        auto& yMcu = _mcus[i + 0];
-        auto& cbMcu = _mcus[i + 1];
-        auto& crMcu = _mcus[i + 2];
+        if (not _scanComponents[i]) {
+            logError("jpeg: undefined component id: {}", i);
+            return Error::invalidData("undefined component id");
+        }
 
-        for (usize k = 0; k < 64; ++k) {
-            isize px = x * 8 + k % 8;
-            isize py = y * 8 + k / 8;
+        auto& sc = _scanComponents[i].unwrap();
 
-            Gfx::YCbCr ycbcr{(float)yMcu[k], (float)cbMcu[k], (float)crMcu[k]};
-            pixels.storeUnsafe({px, py}, Gfx::yCbCrToRgb(ycbcr));
+        if (not _dcHuff[sc.dcHuffId]) {
+            logError("jpeg: undefined dc huffman table id: {}", sc.dcHuffId);
+            return Error::invalidData("undefined dc huffman table id");
         }
+
+        if (not _acHuff[sc.acHuffId]) {
+            logError("jpeg: undefined ac huffman table id: {}", sc.acHuffId);
+            return Error::invalidData("undefined ac huffman table id");
+        }
+
+        // NOTE: Subsampled components are decoded with bigger blocks when
+        //       scaling down, as long as they stay smaller than the image,
+        //       to upsample them less. Like libjpeg, so the output matches.
+        usize size = blockSize;
+        while (size < 8 and
+               (_hMax * blockSize) % (c.hFactor * size * 2) == 0 and
+               (_vMax * blockSize) % (c.vFactor * size * 2) == 0)
+            size *= 2;
+
+        usize stride = ROW_PAD + mcuWidth() * c.hFactor * size + ROW_PAD;
+        usize rows = c.vFactor * size;
+
+        planes.pushBack(_Plane{
+            .hFactor = c.hFactor,
+            .vFactor = c.vFactor,
+            .size = size,
+            .width = (_width * c.hFactor * size + _hMax * 8 - 1) / (_hMax * 8),
+            .height = (_height * c.vFactor * size + _vMax * 8 - 1) / (_vMax * 8),
+            .hRatio = _hMax * blockSize / (c.hFactor * size),
+            .vRatio = _vMax * blockSize / (c.vFactor * size),
+            // NOTE: libjpeg doesn't smooth the image at 1/8 scale.
+            .fancy = blockSize > 1,
+            .stride = stride,
+            .rows = rows,
+            .quant = &_quant[c.quantId].unwrap(),
+            .dc = &_dcHuff[sc.dcHuffId].unwrap(),
+            .ac = &_acHuff[sc.acHuffId].unwrap(),
+            .cur = Buf<u8>::init(stride * rows),
+            .next = Buf<u8>::init(stride * rows),
+            .above = Buf<u8>::init(stride),
+        });
+    }
+
+    auto scaled = scaledSize(scale);
+    usize width = min(scaled.x, pixels.width());
+    usize height = min(scaled.y, pixels.height());
+    usize rowLen = alignUp(scaled.x, 8) + ROW_PAD;
+
+    Array<Buf<u8>, 3> tmp = {
+        Buf<u8>::init(rowLen),
+        Buf<u8>::init(rowLen),
+        Buf<u8>::init(rowLen),
+    };
+    Buf<u8> rgba = Buf<u8>::init(rowLen * 4);
+
+    bool direct = pixels.fmt().is<Gfx::Rgba8888>();
+
+    BitReader bs{_scan};
+    usize mcu = 0;
+    try$(_decodeBand(*this, bs, planes, mcu));
+
+    for (usize band = 0; band < (usize)mcuHeight(); band++) {
+        for (auto& p : planes)
+            std::swap(p.cur, p.next);
+
+        if (band + 1 < (usize)mcuHeight())
+            try$(_decodeBand(*this, bs, planes, mcu));
+
+        usize top = band * _vMax * blockSize;
+        usize bottom = min(top + _vMax * blockSize, height);
+        for (usize y = top; y < bottom; y++) {
+            u8* out = direct ? (u8*)pixels.scanline(y) : rgba.buf();
+
+            if (planes.len() == 1) {
+                _greyToRgba(_upsample(planes[0], band, y - top, width, tmp[0].buf()), width, out);
+            } else {
+                _yccToRgba(
+                    _upsample(planes[0], band, y - top, width, tmp[0].buf()),
+                    _upsample(planes[1], band, y - top, width, tmp[1].buf()),
+                    _upsample(planes[2], band, y - top, width, tmp[2].buf()),
+                    width, out
+                );
+            }
+
+            if (direct)
+                continue;
+
+            pixels.fmt().visit([&](auto f) {
+                for (usize x = 0; x < width; x++) {
+                    u8 const* p = rgba.buf() + x * 4;
+                    f.store(
+                        pixels.pixelUnsafe({(isize)x, (isize)y}),
+                        Gfx::Color::fromRgba(p[0], p[1], p[2], p[3])
+                    );
+                }
+            });
+        }
+
+        for (auto& p : planes)
+            memcpy(p.above.buf(), p.samples(p.cur, p.rows - 1) - ROW_PAD, p.stride);
     }
 
     return Ok();
@@ -8,7 +8,6 @@
 //  - https://github.com/dannye/jed/blob/master/src/decoder.cpp
 //  - https://www.youtube.com/watch?v=CPT4FSkFUgs
 
-#include <karm-base/vec.h>
 #include <karm-gfx/buffer.h>
 #include <karm-gfx/colors.h>
 #include <karm-io/bscan.h>
@@ -44,9 +43,11 @@ struct Decoder {
 
     isize height() const { return _height; }
 
-    isize mcuWidth() const { return (_width + 7) / 8; }
+    // Number of MCUs across and down the image, a MCU covers 8x8 samples of
+    // the components with the highest sampling factors.
+    isize mcuWidth() const { return (_width + 8 * _hMax - 1) / (8 * _hMax); }
 
-    isize mcuHeight() const { return (_height + 7) / 8; }
+    isize mcuHeight() const { return (_height + 8 * _vMax - 1) / (8 * _vMax); }
 
     struct Component {
         u8 hFactor;
@@ -56,6 +57,8 @@ struct Decoder {
 
     Array<Opt<Component>, 4> _components;
     usize _componentCount = 0;
+    u8 _hMax = 1;
+    u8 _vMax = 1;
 
     Res<> startOfFrame(Io::BScan& x);
 
@@ -89,13 +92,28 @@ struct Decoder {
 
     // MARK: Huffman Data ------------------------------------------------------
 
-    Vec<Mcu> _mcus;
+    // Entropy-coded data of the scan, it points into the bytes given to init()
+    // and is only decoded by decode().
+    Bytes _scan = {};
 
-    Res<> decodeHuffman(Io::BScan& s);
+    Res<> skipHuffman(Io::BScan& s);
 
     // MARK: Decoding ----------------------------------------------------------
 
-    Res<> decode(Gfx::MutPixels pixels);
+    // Returns the largest of 1, 2, 4 or 8 the image can be scaled down by
+    // while staying at least as big as size.
+    usize scaleFor(Math::Vec2i size) const;
+
+    // Size of the image decoded at 1/scale.
+    Math::Vec2i scaledSize(usize scale) const;
+
+    // Decodes the image one MCU row at a time, so memory use is a few rows of
+    // samples per component whatever the size of the image.
+    //
+    // The image is scaled down by 2, 4 or 8 in the DCT domain by only
+    // computing the low frequencies of each block, this is much cheaper
+    // than decoding at full size and resampling, as libjpeg does.
+    Res<> decode(Gfx::MutPixels pixels, usize scale = 1);
 
     // MARK: Dumping -----------------------------------------------------------
 
@@ -0,0 +1,141 @@
+#include <karm-image/jpeg/decoder.h>
+#include <karm-image/png/decoder.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-test/macros.h>
+
+namespace Jpeg::Tests {
+
+// The references are decoded by an independent decoder using a floating
+// point IDCT and color conversion, and the same "fancy" upsampling as
+// libjpeg. The integer arithmetic of the decoder can be off by a few
+// levels, but not on average.
+static constexpr isize MAX_ERROR = 3;
+static constexpr f64 MAX_MEAN_ERROR = 0.1;
+
+static Res<Sys::Mmap> _map(Str name) {
+    auto url = "bundle://karm-image.jpeg.tests"_url.join(name);
+    auto file = try$(Sys::File::open(url));
+    return Sys::mmap().map(file);
+}
+
+static Res<Rc<Gfx::Surface>> _decodeReference(Str name) {
+    auto map = try$(_map(name));
+    auto dec = try$(Png::Decoder::init(map.bytes()));
+    auto surface = Gfx::Surface::alloc({dec.width(), dec.height()});
+    try$(dec.decode(*surface));
+    return Ok(surface);
+}
+
+static Res<Rc<Gfx::Surface>> _decode(Str name, usize scale = 1) {
+    auto map = try$(_map(name));
+    auto dec = try$(Decoder::init(map.bytes()));
+    auto surface = Gfx::Surface::alloc(dec.scaledSize(scale));
+    try$(dec.decode(*surface, scale));
+    return Ok(surface);
+}
+
+static Res<> _expectMatches(Str name, Gfx::Pixels actual, Gfx::Pixels expected) {
+    if (actual.size() != expected.size()) {
+        logError("jpeg: {} decoded to {}, expected {}", name, actual.size(), expected.size());
+        return Error::invalidData("size mismatch");
+    }
+
+    isize maxError = 0;
+    usize sum = 0;
+    for (isize y = 0; y < actual.height(); y++) {
+        for (isize x = 0; x < actual.width(); x++) {
+            auto a = actual.loadUnsafe({x, y});
+            auto e = expected.loadUnsafe({x, y});
+            Array<isize, 3> errors = {
+                Math::abs(a.red - e.red),
+                Math::abs(a.green - e.green),
+                Math::abs(a.blue - e.blue),
+            };
+            for (auto error : errors) {
+                maxError = max(maxError, error);
+                sum += error;
+            }
+        }
+    }
+
+    f64 meanError = sum / (3.0 * actual.width() * actual.height());
+    if (maxError > MAX_ERROR or meanError > MAX_MEAN_ERROR) {
+        logError("jpeg: {} is off by up to {}, {} on average", name, maxError, meanError);
+        return Error::invalidData("pixels mismatch");
+    }
+
+    return Ok();
+}
+
+static Res<> _testReference(Str name) {
+    auto actual = try$(_decode(try$(Io::format("{}.jpg", name))));
+    auto expected = try$(_decodeReference(try$(Io::format("{}.ref.png", name))));
+    return _expectMatches(name, *actual, *expected);
+}
+
+static Res<> _testScaledReference(Str name, usize scale) {
+    auto actual = try$(_decode(try$(Io::format("{}.jpg", name)), scale));
+    auto expected = try$(_decodeReference(try$(Io::format("{}.ref-{}.png", name, scale))));
+    return _expectMatches(try$(Io::format("{} at 1/{}", name, scale)), *actual, *expected);
+}
+
+test$("jpeg-decode-444") {
+    try$(_testReference("cat-1mcu"));
+    try$(_testReference("cat-8mcu"));
+    try$(_testReference("jpeg-home"));
+    return Ok();
+}
+
+test$("jpeg-decode-subsampled") {
+    // NOTE: 61x45 so the last row and column of MCUs are partial, the 4:2:0
+    //       and 4:4:0 images also have restart intervals.
+    try$(_testReference("pattern-420"));
+    try$(_testReference("pattern-422"));
+    try$(_testReference("pattern-440"));
+    return Ok();
+}
+
+test$("jpeg-decode-grayscale") {
+    try$(_testReference("pattern-grey"));
+    return Ok();
+}
+
+test$("jpeg-decode-scaled") {
+    // NOTE: The references average the full size output over 2x2, 4x4 or
+    //       8x8 squares before upsampling, like the reduced IDCTs of libjpeg.
+    Array<Str, 6> names = {
+        "cat-1mcu",
+        "cat-8mcu",
+        "pattern-420",
+        "pattern-422",
+        "pattern-440",
+        "pattern-grey",
+    };
+
+    for (auto name : names) {
+        try$(_testScaledReference(name, 2));
+        try$(_testScaledReference(name, 4));
+        try$(_testScaledReference(name, 8));
+    }
+
+    return Ok();
+}
+
+test$("jpeg-decode-progressive") {
+    // NOTE: Progressive images aren't supported, they must be rejected
+    //       rather than decoded to garbage.
+    Array<Str, 3> names = {"birch.jpg", "clouds.jpg", "park.jpg"};
+    for (auto name : names) {
+        auto map = try$(_map(name));
+        auto dec = Decoder::init(map.bytes());
+        if (not dec)
+            continue;
+        auto surface = Gfx::Surface::alloc({dec.unwrap().width(), dec.unwrap().height()});
+        expect$(not dec.unwrap().decode(*surface));
+    }
+
+    return Ok();
+}
+
+} // namespace Jpeg::Tests
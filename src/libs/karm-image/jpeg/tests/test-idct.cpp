@@ -0,0 +1,143 @@
+#include <karm-image/jpeg/base.h>
+#include <karm-image/jpeg/decoder.h>
+#include <karm-math/rand.h>
+#include <karm-test/macros.h>
+
+namespace Jpeg::Tests {
+
+// _BASIS[u][x] is C(u) * cos((2x + 1)uπ / 16) / 2, the 8x8 inverse DCT is
+// the sum over u and v of _BASIS[u][x] * _BASIS[v][y] * block[v * 8 + u].
+static constexpr Array<Array<f64, 8>, 8> _BASIS = {{
+    {0.353553391, 0.353553391, 0.353553391, 0.353553391, 0.353553391, 0.353553391, 0.353553391, 0.353553391},
+    {0.490392640, 0.415734806, 0.277785117, 0.097545161, -0.097545161, -0.277785117, -0.415734806, -0.490392640},
+    {0.461939766, 0.191341716, -0.191341716, -0.461939766, -0.461939766, -0.191341716, 0.191341716, 0.461939766},
+    {0.415734806, -0.097545161, -0.490392640, -0.277785117, 0.277785117, 0.490392640, 0.097545161, -0.415734806},
+    {0.353553391, -0.353553391, -0.353553391, 0.353553391, 0.353553391, -0.353553391, -0.353553391, 0.353553391},
+    {0.277785117, -0.490392640, 0.097545161, 0.415734806, -0.415734806, -0.097545161, 0.490392640, -0.277785117},
+    {0.191341716, -0.461939766, 0.461939766, -0.191341716, -0.191341716, 0.461939766, -0.461939766, 0.191341716},
+    {0.097545161, -0.277785117, 0.415734806, -0.490392640, 0.490392640, -0.415734806, 0.277785117, -0.097545161},
+}};
+
+// The reduced inverse DCTs output the average of the full one over squares
+// of 2x2, 4x4 or 8x8 samples, it's how the IJG derived theirs.
+static Array<u8, 64> _idctReference(Block const& block, usize size) {
+    Array<f64, 64> full{};
+    for (usize y = 0; y < 8; y++)
+        for (usize x = 0; x < 8; x++)
+            for (usize v = 0; v < 8; v++)
+                for (usize u = 0; u < 8; u++)
+                    full[y * 8 + x] += _BASIS[u][x] * _BASIS[v][y] * block[v * 8 + u];
+
+    usize k = 8 / size;
+    Array<u8, 64> out{};
+    for (usize y = 0; y < size; y++) {
+        for (usize x = 0; x < size; x++) {
+            f64 sum = 0;
+            for (usize j = 0; j < k; j++)
+                for (usize i = 0; i < k; i++)
+                    sum += full[(y * k + j) * 8 + x * k + i];
+            out[y * 8 + x] = clamp(Math::roundi(sum / (k * k) + 128), 0, 255);
+        }
+    }
+    return out;
+}
+
+// Mostly low frequencies, of decreasing magnitude, like the dequantized
+// blocks of real images.
+static Block _randomBlock(Math::Rand& rand) {
+    Block block{};
+    block[0] = rand.nextInt(-1024, 1016);
+
+    usize n = rand.nextInt(1, 24);
+    for (usize i = 0; i < n; i++) {
+        usize k = rand.nextInt(1, 64);
+        isize limit = 1024 / (1 + k / 4);
+        block[ZIGZAG[k]] = rand.nextInt(-limit, limit);
+    }
+    return block;
+}
+
+using IdctFn = void (*)(Block const&, u8*, usize);
+
+// The fixed point transforms are allowed to be off by one level.
+static Res<> _testIdct(IdctFn idct, usize size) {
+    Math::Rand rand{0x1dc7};
+    for (usize i = 0; i < 1000; i++) {
+        auto block = _randomBlock(rand);
+        Array<u8, 64> out{};
+        idct(block, out.buf(), 8);
+
+        auto expected = _idctReference(block, size);
+        for (usize y = 0; y < size; y++) {
+            for (usize x = 0; x < size; x++) {
+                isize error = Math::abs((isize)out[y * 8 + x] - (isize)expected[y * 8 + x]);
+                if (error > 1) {
+                    logError("jpeg: {}x{} idct is off by {} at {}, {}", size, size, error, x, y);
+                    return Error::invalidData("idct mismatch");
+                }
+            }
+        }
+    }
+
+    return Ok();
+}
+
+test$("jpeg-idct") {
+    return _testIdct(idct, 8);
+}
+
+test$("jpeg-idct-reduced") {
+    try$(_testIdct(idct4x4, 4));
+    try$(_testIdct(idct2x2, 2));
+    try$(_testIdct(idct1x1, 1));
+    return Ok();
+}
+
+test$("jpeg-idct-dc") {
+    // NOTE: Blocks without AC coefficients skip the transforms, the result
+    //       must be the same whatever the size.
+    Array<usize, 4> sizes = {8, 4, 2, 1};
+    Array<IdctFn, 4> idcts = {idct, idct4x4, idct2x2, idct1x1};
+    for (i32 dc = -1024; dc < 1024; dc += 7) {
+        Block block{};
+        block[0] = dc;
+        for (usize i = 0; i < sizes.len(); i++) {
+            Array<u8, 64> expected{}, actual{};
+            idcts[i](block, expected.buf(), 8);
+            idctDc(dc, actual.buf(), 8, sizes[i]);
+            expect$(expected == actual);
+        }
+    }
+
+    return Ok();
+}
+
+test$("jpeg-scale-for") {
+    Decoder dec{};
+    dec._width = 1920;
+    dec._height = 1080;
+
+    expectEq$(dec.scaleFor({1920, 1080}), 1uz);
+    expectEq$(dec.scaleFor({4000, 10}), 1uz);
+    expectEq$(dec.scaleFor({961, 540}), 1uz);
+    expectEq$(dec.scaleFor({960, 540}), 2uz);
+    expectEq$(dec.scaleFor({480, 270}), 4uz);
+    expectEq$(dec.scaleFor({241, 135}), 4uz);
+    expectEq$(dec.scaleFor({240, 135}), 8uz);
+    expectEq$(dec.scaleFor({0, 0}), 8uz);
+
+    // NOTE: Scaled sizes are rounded up, as the partial blocks are output.
+    dec._width = 61;
+    dec._height = 45;
+
+    expectEq$(dec.scaledSize(2), (Math::Vec2i{31, 23}));
+    expectEq$(dec.scaledSize(4), (Math::Vec2i{16, 12}));
+    expectEq$(dec.scaledSize(8), (Math::Vec2i{8, 6}));
+    expectEq$(dec.scaleFor({31, 23}), 2uz);
+    expectEq$(dec.scaleFor({31, 24}), 1uz);
+    expectEq$(dec.scaleFor({8, 1}), 8uz);
+
+    return Ok();
+}
+
+} // namespace Jpeg::Tests
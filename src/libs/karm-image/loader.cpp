@@ -33,10 +33,11 @@ static Res<Picture> loadPng(Bytes bytes) {
     return Ok(img);
 }
 
-static Res<Picture> loadJpeg(Bytes bytes) {
+static Res<Picture> loadJpeg(Bytes bytes, Opt<Math::Vec2i> size) {
     auto jpeg = try$(Jpeg::Decoder::init(bytes));
-    auto img = Gfx::Surface::alloc({jpeg.width(), jpeg.height()});
-    try$(jpeg.decode(*img));
+    usize scale = size ? jpeg.scaleFor(*size) : 1;
+    auto img = Gfx::Surface::alloc(jpeg.scaledSize(scale));
+    try$(jpeg.decode(*img, scale));
     return Ok(img);
 }
 
@@ -54,24 +55,61 @@ static Res<Picture> loadGif(Bytes bytes) {
     return Ok(img);
 }
 
-Res<Picture> load(Sys::Mmap&& map) {
-    if (Bmp::Decoder::sniff(map.bytes())) {
-        return loadBmp(map.bytes());
-    } else if (Qoi::Decoder::sniff(map.bytes())) {
-        return loadQoi(map.bytes());
-    } else if (Png::Decoder::sniff(map.bytes())) {
-        return loadPng(map.bytes());
-    } else if (Jpeg::Decoder::sniff(map.bytes())) {
-        return loadJpeg(map.bytes());
-    } else if (Tga::Decoder::sniff(map.bytes())) {
-        return loadTga(map.bytes());
-    } else if (Gif::Decoder::sniff(map.bytes())) {
-        return loadGif(map.bytes());
+static Res<Picture> loadBytes(Bytes bytes, Opt<Math::Vec2i> size) {
+    if (Bmp::Decoder::sniff(bytes)) {
+        return loadBmp(bytes);
+    } else if (Qoi::Decoder::sniff(bytes)) {
+        return loadQoi(bytes);
+    } else if (Png::Decoder::sniff(bytes)) {
+        return loadPng(bytes);
+    } else if (Jpeg::Decoder::sniff(bytes)) {
+        return loadJpeg(bytes, size);
+    } else if (Tga::Decoder::sniff(bytes)) {
+        return loadTga(bytes);
+    } else if (Gif::Decoder::sniff(bytes)) {
+        return loadGif(bytes);
     } else {
         return Error::invalidData("unknown image format");
     }
 }
 
+template <typename Decoder>
+static Res<Math::Vec2i> sniffSize(Bytes bytes) {
+    auto dec = try$(Decoder::init(bytes));
+    return Ok(Math::Vec2i{dec.width(), dec.height()});
+}
+
+Res<Math::Vec2i> sniffSize(Bytes bytes) {
+    if (Bmp::Decoder::sniff(bytes)) {
+        return sniffSize<Bmp::Decoder>(bytes);
+    } else if (Qoi::Decoder::sniff(bytes)) {
+        return sniffSize<Qoi::Decoder>(bytes);
+    } else if (Png::Decoder::sniff(bytes)) {
+        // NOTE: Png::Decoder::init() checks every chunk, but the size is
+        //       always at the start of the IHDR chunk, right after the
+        //       signature.
+        if (bytes.len() < 24)
+            return Error::invalidData("missing IHDR chunk");
+        Io::BScan s{bytes};
+        s.skip(16);
+        isize width = s.nextU32be();
+        isize height = s.nextU32be();
+        return Ok(Math::Vec2i{width, height});
+    } else if (Jpeg::Decoder::sniff(bytes)) {
+        return sniffSize<Jpeg::Decoder>(bytes);
+    } else if (Tga::Decoder::sniff(bytes)) {
+        return sniffSize<Tga::Decoder>(bytes);
+    } else if (Gif::Decoder::sniff(bytes)) {
+        return sniffSize<Gif::Decoder>(bytes);
+    } else {
+        return Error::invalidData("unknown image format");
+    }
+}
+
+Res<Picture> load(Sys::Mmap&& map) {
+    return loadBytes(map.bytes(), NONE);
+}
+
 Res<Picture> load(Mime::Url url) {
     auto file = try$(Sys::File::open(url));
     auto map = try$(Sys::mmap().map(file));
@@ -84,4 +122,20 @@ Res<Picture> loadOrFallback(Mime::Url url) {
     return Ok(Gfx::Surface::fallback());
 }
 
+Res<Picture> load(Sys::Mmap&& map, Math::Vec2i size) {
+    return loadBytes(map.bytes(), size);
+}
+
+Res<Picture> load(Mime::Url url, Math::Vec2i size) {
+    auto file = try$(Sys::File::open(url));
+    auto map = try$(Sys::mmap().map(file));
+    return load(std::move(map), size);
+}
+
+Res<Picture> loadOrFallback(Mime::Url url, Math::Vec2i size) {
+    if (auto result = load(url, size); result)
+        return result;
+    return Ok(Gfx::Surface::fallback());
+}
+
 } // namespace Karm::Image
@@ -6,10 +6,22 @@
 
 namespace Karm::Image {
 
+// Returns the size of the image from its headers, without decoding it.
+Res<Math::Vec2i> sniffSize(Bytes bytes);
+
 Res<Picture> load(Sys::Mmap&& map);
 
 Res<Picture> load(Mime::Url url);
 
 Res<Picture> loadOrFallback(Mime::Url url);
 
+// Loads the image at its smallest size that still covers the given size, for
+// thumbnails. Only JPEGs can be decoded scaled down (by 2, 4 or 8), the other
+// formats are loaded at full size.
+Res<Picture> load(Sys::Mmap&& map, Math::Vec2i size);
+
+Res<Picture> load(Mime::Url url, Math::Vec2i size);
+
+Res<Picture> loadOrFallback(Mime::Url url, Math::Vec2i size);
+
 } // namespace Karm::Image
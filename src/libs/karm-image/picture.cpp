@@ -0,0 +1,72 @@
+#include <karm-gfx/resample.h>
+
+#include "picture.h"
+
+namespace Karm::Image {
+
+static Opt<Arc<Gfx::Surface const>> _lookup(Vec<Arc<Gfx::Surface const>>& scaled, Math::Vec2i size) {
+    for (usize i = 0; i < scaled.len(); i++) {
+        if (scaled[i]->_size != size)
+            continue;
+        auto surface = scaled.removeAt(i);
+        scaled.pushFront(surface);
+        return surface;
+    }
+    return NONE;
+}
+
+static Opt<Arc<Gfx::Surface const>> _mip(Picture::_Cache& cache, usize i) {
+    LockScope scope(cache._lock);
+    if (i < cache.mips.len())
+        return cache.mips[i];
+    return NONE;
+}
+
+// NOTE: The lock is only held while looking at the lists, resampling is done
+//       without it, two threads drawing the same picture at the same time
+//       might both resample it, but only the first copy is kept.
+Arc<Gfx::Surface const> Picture::scaled(Math::Vec2i size) const {
+    if (size == _surface->_size or size.x <= 0 or size.y <= 0)
+        return _surface;
+
+    auto& cache = *_cache;
+    {
+        LockScope scope(cache._lock);
+        if (auto surface = _lookup(cache.scaled, size))
+            return surface.take();
+    }
+
+    // Start from the smallest mip level still bigger than size, so the
+    // filter only ever covers a few pixels.
+    Arc<Gfx::Surface const> level = _surface;
+    for (usize i = 0;; i++) {
+        Math::Vec2i half = {(level->width() + 1) / 2, (level->height() + 1) / 2};
+        if (half.x < size.x or half.y < size.y or half == level->_size)
+            break;
+
+        if (auto mip = _mip(cache, i)) {
+            level = mip.take();
+            continue;
+        }
+
+        auto next = _share(Gfx::resample(level->pixels(), half, Gfx::Resampling::BOX));
+        LockScope scope(cache._lock);
+        if (i == cache.mips.len())
+            cache.mips.pushBack(next);
+        level = cache.mips[i];
+    }
+
+    auto surface = _share(Gfx::resample(level->pixels(), size));
+
+    LockScope scope(cache._lock);
+    if (auto other = _lookup(cache.scaled, size))
+        return other.take();
+
+    cache.scaled.pushFront(surface);
+    if (cache.scaled.len() > MAX_SCALED)
+        cache.scaled.popBack();
+
+    return surface;
+}
+
+} // namespace Karm::Image
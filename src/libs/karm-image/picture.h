@@ -1,18 +1,46 @@
 #pragma once
 
+#include <karm-base/lock.h>
+#include <karm-base/rc.h>
+#include <karm-base/vec.h>
 #include <karm-gfx/buffer.h>
 #include <karm-meta/nocopy.h>
 
 namespace Karm::Image {
 
 struct Picture {
-    Rc<Gfx::Surface const> _surface;
+    // How many scaled copies of the picture are kept around.
+    static constexpr usize MAX_SCALED = 4;
 
-    Picture(Rc<Gfx::Surface const> surface)
+    // Shared by the copies of the picture, so views and scene nodes holding
+    // the same picture reuse the scaled copies of each other. Pictures are
+    // handed between threads by the image cache, so it's behind a lock.
+    struct _Cache {
+        Lock _lock;
+
+        // Successive halvings of the picture, built on demand.
+        Vec<Arc<Gfx::Surface const>> mips;
+
+        // Copies at the sizes the picture was drawn at, most recent first.
+        Vec<Arc<Gfx::Surface const>> scaled;
+    };
+
+    Arc<Gfx::Surface const> _surface;
+    mutable Arc<_Cache> _cache = makeArc<_Cache>();
+
+    // Takes the surface over if nothing else refers to it, and copies it
+    // otherwise.
+    static Arc<Gfx::Surface const> _share(Rc<Gfx::Surface> surface) {
+        if (surface.refs() == 1)
+            return makeArc<Gfx::Surface>(std::move(*surface));
+        return makeArc<Gfx::Surface>(*surface);
+    }
+
+    Picture(Arc<Gfx::Surface const> surface)
         : _surface(std::move(surface)) {}
 
     Picture(Rc<Gfx::Surface> surface)
-        : _surface(std::move(surface)) {}
+        : _surface(_share(std::move(surface))) {}
 
     always_inline operator Gfx::Pixels() const {
         return pixels();
@@ -38,6 +66,13 @@ struct Picture {
         return pixels().sample(pos);
     }
 
+    // Returns the picture resampled to size. Copies are cached, drawing the
+    // picture at the same size again is a plain blit, and scaling down
+    // starts from the closest mip level. The size should be the one in
+    // device pixels, see Gfx::Canvas::deviceSize().
+    // Safe to call from any thread.
+    Arc<Gfx::Surface const> scaled(Math::Vec2i size) const;
+
     void repr(Io::Emit& e) const {
         e("(picture {}x{})", width(), height());
     }
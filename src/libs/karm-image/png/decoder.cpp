@@ -0,0 +1,456 @@
+#include <karm-archive/zlib/decoder.h>
+#include <karm-base/simd.h>
+#include <karm-crypto/crc32.h>
+
+#include "decoder.h"
+
+namespace Png {
+
+// MARK: Init ------------------------------------------------------------------
+
+static bool _validDepth(ColorType type, u8 depth) {
+    switch (type) {
+    case ColorType::GRAYSCALE:
+        return depth == 1 or depth == 2 or depth == 4 or depth == 8 or depth == 16;
+    case ColorType::INDEXED:
+        return depth == 1 or depth == 2 or depth == 4 or depth == 8;
+    case ColorType::TRUECOLOR:
+    case ColorType::GRAYSCALE_ALPHA:
+    case ColorType::TRUECOLOR_ALPHA:
+        return depth == 8 or depth == 16;
+    }
+    return false;
+}
+
+Res<Decoder> Decoder::init(Bytes slice) {
+    if (not sniff(slice))
+        return Error::invalidData("invalid signature");
+
+    Decoder dec{slice};
+    bool first = true;
+    bool idat = false;
+
+    for (auto chunk : dec.iterChunks()) {
+        if (chunk.critical() and Crypto::crc32(chunk.checked()) != chunk.crc32)
+            return Error::invalidData("chunk checksum mismatch");
+
+        if (first and chunk.sig != Ihdr::SIG)
+            return Error::invalidData("missing IHDR chunk");
+        first = false;
+
+        if (chunk.sig == Ihdr::SIG) {
+            if (chunk.len != 13)
+                return Error::invalidData("invalid IHDR chunk");
+            dec._ihdr = Ihdr{chunk.data};
+        } else if (chunk.sig == Plte::SIG) {
+            if (chunk.len % 3 != 0 or chunk.len > 256 * 3)
+                return Error::invalidData("invalid PLTE chunk");
+            dec._plte = Plte{chunk.data};
+        } else if (chunk.sig == Trns::SIG) {
+            dec._trns = Trns{chunk.data};
+        } else if (chunk.sig == Idat::SIG) {
+            idat = true;
+        }
+    }
+
+    if (not dec._ihdr.present())
+        return Error::invalidData("missing IHDR chunk");
+
+    if (not idat)
+        return Error::invalidData("missing IDAT chunk");
+
+    if (dec.width() <= 0 or dec.height() <= 0)
+        return Error::invalidData("invalid image size");
+
+    if (not _validDepth(dec.colorType(), dec.bitDepth()))
+        return Error::invalidData("invalid color type or bit depth");
+
+    if (dec._ihdr.compressionMethod() != 0 or dec._ihdr.filterMethod() != 0)
+        return Error::invalidData("unsupported compression or filter method");
+
+    if (dec._ihdr.interlaceMethod() > 1)
+        return Error::invalidData("unsupported interlace method");
+
+    if (dec.colorType() == ColorType::INDEXED and not dec._plte.present())
+        return Error::invalidData("missing PLTE chunk");
+
+    return Ok(dec);
+}
+
+// MARK: Image Data ------------------------------------------------------------
+
+// Presents the data of consecutive IDAT chunks as a single stream.
+struct _IdatReader : public Io::Reader {
+    Io::BScan _s;
+    Bytes _chunk{};
+    bool _started = false;
+
+    _IdatReader(Bytes slice) : _s(slice) {
+        _s.skip(8);
+    }
+
+    Res<usize> read(MutBytes bytes) override {
+        while (isEmpty(_chunk)) {
+            if (_s.rem() < 12)
+                return Ok(0uz);
+
+            usize len = _s.nextU32be();
+            Str sig = _s.nextStr(4);
+            if (_s.rem() < len + 4)
+                return Error::invalidData("truncated chunk");
+
+            Bytes data = _s.nextBytes(len);
+            _s.skip(4);
+
+            if (sig == Idat::SIG) {
+                _started = true;
+                _chunk = data;
+            } else if (_started) {
+                // Image data must be in consecutive chunks
+                return Ok(0uz);
+            }
+        }
+
+        usize n = min(bytes.len(), _chunk.len());
+        memcpy(bytes.buf(), _chunk.buf(), n);
+        _chunk = next(_chunk, n);
+        return Ok(n);
+    }
+};
+
+static Res<> _readFull(Io::Reader& reader, MutBytes bytes) {
+    while (bytes.len()) {
+        usize n = try$(reader.read(bytes));
+        if (n == 0)
+            return Error::invalidData("unexpected end of image data");
+        bytes = mutNext(bytes, n);
+    }
+    return Ok();
+}
+
+// MARK: Filters ---------------------------------------------------------------
+
+// Rows are stored with this much padding on both sides, so the pixel left of
+// the first one reads as zero and vector loads can run past the last pixel.
+static constexpr usize ROW_PAD = 8;
+
+template <typename V>
+always_inline static V _load(u8 const* p) {
+    V v;
+    memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template <usize BPP, typename V>
+always_inline static void _store(u8* p, V v) {
+    memcpy(p, &v, BPP);
+}
+
+template <typename V>
+always_inline static V _abs(V v) {
+    V sign = v >> 15;
+    return (v ^ sign) - sign;
+}
+
+// Filters other than Up depend on the previous pixel so they run one pixel at
+// a time, with every channel of the pixel in the lanes of a vector. U is a
+// byte vector at least BPP wide, I the matching 16-bit vector for Paeth.
+template <usize BPP, typename U, typename I>
+static void _unfilterPixels(Filter filter, u8* cur, u8 const* prev, usize len) {
+    switch (filter) {
+    case Filter::SUB:
+        for (usize i = 0; i < len; i += BPP) {
+            U a = _load<U>(cur + i - BPP);
+            _store<BPP>(cur + i, _load<U>(cur + i) + a);
+        }
+        break;
+
+    case Filter::AVERAGE:
+        for (usize i = 0; i < len; i += BPP) {
+            U a = _load<U>(cur + i - BPP);
+            U b = _load<U>(prev + i);
+            // NOTE: floor((a + b) / 2) without widening to 16 bits
+            U avg = (a & b) + ((a ^ b) >> 1);
+            _store<BPP>(cur + i, _load<U>(cur + i) + avg);
+        }
+        break;
+
+    case Filter::PAETH:
+        for (usize i = 0; i < len; i += BPP) {
+            I a = __builtin_convertvector(_load<U>(cur + i - BPP), I);
+            I b = __builtin_convertvector(_load<U>(prev + i), I);
+            I c = __builtin_convertvector(_load<U>(prev + i - BPP), I);
+
+            I pa = _abs(b - c);
+            I pb = _abs(a - c);
+            I pc = _abs((b - c) + (a - c));
+
+            I useA = (pa <= pb) & (pa <= pc);
+            I useB = ~useA & (pb <= pc);
+            I pred = (useA & a) | (useB & b) | (~(useA | useB) & c);
+
+            _store<BPP>(cur + i, _load<U>(cur + i) + __builtin_convertvector(pred, U));
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void _unfilterScalar(Filter filter, u8* cur, u8 const* prev, usize len, usize bpp) {
+    switch (filter) {
+    case Filter::SUB:
+        for (usize i = 0; i < len; i++)
+            cur[i] += cur[i - bpp];
+        break;
+
+    case Filter::AVERAGE:
+        for (usize i = 0; i < len; i++)
+            cur[i] += (cur[i - bpp] + prev[i]) >> 1;
+        break;
+
+    case Filter::PAETH:
+        for (usize i = 0; i < len; i++) {
+            i16 a = cur[i - bpp];
+            i16 b = prev[i];
+            i16 c = prev[i - bpp];
+            i16 p = a + b - c;
+            i16 pa = p > a ? p - a : a - p;
+            i16 pb = p > b ? p - b : b - p;
+            i16 pc = p > c ? p - c : c - p;
+            cur[i] += pa <= pb and pa <= pc ? a : pb <= pc ? b : c;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static Res<> _unfilter(Filter filter, u8* cur, u8 const* prev, usize len, usize bpp) {
+    if (filter == Filter::NONE)
+        return Ok();
+
+    if ((u8)filter > (u8)Filter::PAETH)
+        return Error::invalidData("invalid filter type");
+
+    // Up has no dependency between pixels and runs over whole vectors
+    if (filter == Filter::UP) {
+        usize i = 0;
+        for (; i + 16 <= len; i += 16) {
+            u8x16 v = _load<u8x16>(cur + i) + _load<u8x16>(prev + i);
+            memcpy(cur + i, &v, 16);
+        }
+        for (; i < len; i++)
+            cur[i] += prev[i];
+        return Ok();
+    }
+
+    switch (bpp) {
+    case 3:
+        _unfilterPixels<3, u8x4, i16x4>(filter, cur, prev, len);
+        break;
+    case 4:
+        _unfilterPixels<4, u8x4, i16x4>(filter, cur, prev, len);
+        break;
+    case 6:
+        _unfilterPixels<6, u8x8, i16x8>(filter, cur, prev, len);
+        break;
+    case 8:
+        _unfilterPixels<8, u8x8, i16x8>(filter, cur, prev, len);
+        break;
+    default:
+        _unfilterScalar(filter, cur, prev, len, bpp);
+        break;
+    }
+
+    return Ok();
+}
+
+// MARK: Pixels ----------------------------------------------------------------
+
+struct _Palette {
+    Array<Gfx::Color, 256> colors{};
+};
+
+static _Palette _buildPalette(Bytes plte, Bytes trns) {
+    _Palette pal;
+    for (usize i = 0; i < 256; i++)
+        pal.colors[i] = Gfx::Color::fromRgba(0, 0, 0, 255);
+    for (usize i = 0; i * 3 + 2 < plte.len(); i++)
+        pal.colors[i] = Gfx::Color::fromRgba(plte[i * 3], plte[i * 3 + 1], plte[i * 3 + 2], 255);
+    for (usize i = 0; i < trns.len() and i < 256; i++)
+        pal.colors[i].alpha = trns[i];
+    return pal;
+}
+
+always_inline static u16 _sample(u8 const* row, usize index, u8 depth) {
+    if (depth == 8)
+        return row[index];
+    if (depth == 16)
+        return (row[index * 2] << 8) | row[index * 2 + 1];
+    usize bit = index * depth;
+    return (row[bit / 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+}
+
+// Expands a scanline to 8-bit RGBA, 16-bit samples keep their high byte.
+static void _expand(Decoder& dec, _Palette const& pal, u8 const* row, usize width, u8* out) {
+    u8 depth = dec.bitDepth();
+    Bytes trns = dec._trns.bytes();
+    bool hasKey = trns.len() >= 2;
+
+    switch (dec.colorType()) {
+    case ColorType::GRAYSCALE: {
+        u16 key = hasKey ? (trns[0] << 8) | trns[1] : 0;
+        u16 scale = depth < 8 ? 255 / ((1 << depth) - 1) : 1;
+        for (usize x = 0; x < width; x++) {
+            u16 v = _sample(row, x, depth);
+            u8 g = depth == 16 ? v >> 8 : v * scale;
+            out[x * 4 + 0] = g;
+            out[x * 4 + 1] = g;
+            out[x * 4 + 2] = g;
+            out[x * 4 + 3] = hasKey and v == key ? 0 : 255;
+        }
+        break;
+    }
+
+    case ColorType::TRUECOLOR: {
+        hasKey = trns.len() >= 6;
+        Array<u16, 3> key{};
+        for (usize c = 0; hasKey and c < 3; c++)
+            key[c] = (trns[c * 2] << 8) | trns[c * 2 + 1];
+
+        for (usize x = 0; x < width; x++) {
+            bool transparent = hasKey;
+            for (usize c = 0; c < 3; c++) {
+                u16 v = _sample(row, x * 3 + c, depth);
+                out[x * 4 + c] = depth == 16 ? v >> 8 : v;
+                transparent = transparent and v == key[c];
+            }
+            out[x * 4 + 3] = transparent ? 0 : 255;
+        }
+        break;
+    }
+
+    case ColorType::INDEXED:
+        for (usize x = 0; x < width; x++) {
+            auto c = pal.colors[_sample(row, x, depth)];
+            out[x * 4 + 0] = c.red;
+            out[x * 4 + 1] = c.green;
+            out[x * 4 + 2] = c.blue;
+            out[x * 4 + 3] = c.alpha;
+        }
+        break;
+
+    case ColorType::GRAYSCALE_ALPHA: {
+        usize step = depth / 8;
+        for (usize x = 0; x < width; x++) {
+            u8 const* p = row + x * 2 * step;
+            out[x * 4 + 0] = p[0];
+            out[x * 4 + 1] = p[0];
+            out[x * 4 + 2] = p[0];
+            out[x * 4 + 3] = p[step];
+        }
+        break;
+    }
+
+    case ColorType::TRUECOLOR_ALPHA:
+        if (depth == 8) {
+            memcpy(out, row, width * 4);
+        } else {
+            for (usize x = 0; x < width * 4; x++)
+                out[x] = row[x * 2];
+        }
+        break;
+    }
+}
+
+// MARK: Decode ----------------------------------------------------------------
+
+struct _Pass {
+    usize x, y, dx, dy;
+};
+
+static constexpr Array<_Pass, 7> ADAM7 = {
+    _Pass{0, 0, 8, 8},
+    _Pass{4, 0, 8, 8},
+    _Pass{0, 4, 4, 8},
+    _Pass{2, 0, 4, 4},
+    _Pass{0, 2, 2, 4},
+    _Pass{1, 0, 2, 2},
+    _Pass{0, 1, 1, 2},
+};
+
+static Res<> _decodePass(Decoder& dec, _Palette const& pal, Io::Reader& reader, _Pass pass, Gfx::MutPixels dest) {
+    usize imgWidth = dec.width();
+    usize imgHeight = dec.height();
+
+    if (pass.x >= imgWidth or pass.y >= imgHeight)
+        return Ok();
+
+    usize width = (imgWidth - pass.x + pass.dx - 1) / pass.dx;
+    usize height = (imgHeight - pass.y + pass.dy - 1) / pass.dy;
+    usize bpp = dec.bpp();
+    usize rowLen = (width * dec.channels() * dec.bitDepth() + 7) / 8;
+
+    // The filter type byte is read right before the row, in the padding
+    Buf<u8> prevBuf = Buf<u8>::init(ROW_PAD + rowLen + ROW_PAD);
+    Buf<u8> curBuf = Buf<u8>::init(ROW_PAD + rowLen + ROW_PAD);
+    Buf<u8> rgba = Buf<u8>::init(width * 4);
+
+    bool direct = pass.dx == 1 and dest.fmt().is<Gfx::Rgba8888>();
+
+    for (usize y = 0; y < height; y++) {
+        u8* cur = curBuf.buf() + ROW_PAD;
+        u8 const* prev = prevBuf.buf() + ROW_PAD;
+
+        try$(_readFull(reader, {cur - 1, rowLen + 1}));
+        Filter filter = (Filter)cur[-1];
+        cur[-1] = 0;
+
+        try$(_unfilter(filter, cur, prev, rowLen, bpp));
+
+        usize destY = pass.y + y * pass.dy;
+        if (direct and dec.colorType() == ColorType::TRUECOLOR_ALPHA and dec.bitDepth() == 8) {
+            memcpy(dest.scanline(destY), cur, width * 4);
+        } else if (direct) {
+            _expand(dec, pal, cur, width, (u8*)dest.scanline(destY));
+        } else {
+            _expand(dec, pal, cur, width, rgba.buf());
+            dest.fmt().visit([&](auto f) {
+                for (usize x = 0; x < width; x++) {
+                    u8 const* p = rgba.buf() + x * 4;
+                    f.store(
+                        dest.pixelUnsafe({(isize)(pass.x + x * pass.dx), (isize)destY}),
+                        Gfx::Color::fromRgba(p[0], p[1], p[2], p[3])
+                    );
+                }
+            });
+        }
+
+        std::swap(prevBuf, curBuf);
+    }
+
+    return Ok();
+}
+
+Res<> Decoder::decode(Gfx::MutPixels dest) {
+    if (dest.width() < width() or dest.height() < height())
+        return Error::invalidInput("destination too small");
+
+    auto pal = _buildPalette(_plte.bytes(), _trns.bytes());
+
+    _IdatReader idat{_slice};
+    Zlib::Decoder zlib{idat};
+
+    if (not interlaced())
+        return _decodePass(*this, pal, zlib, {0, 0, 1, 1}, dest);
+
+    for (auto const& pass : ADAM7)
+        try$(_decodePass(*this, pal, zlib, pass, dest));
+
+    return Ok();
+}
+
+} // namespace Png
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <karm-base/string.h>
-#include <karm-gfx/canvas.h>
+#include <karm-gfx/buffer.h>
 #include <karm-io/bscan.h>
 #include <karm-logger/logger.h>
 
@@ -43,6 +43,10 @@ struct Plte : public Io::BChunk {
     static constexpr Str SIG = "PLTE";
 };
 
+struct Trns : public Io::BChunk {
+    static constexpr Str SIG = "tRNS";
+};
+
 struct Idat : public Io::BChunk {
     static constexpr Str SIG = "IDAT";
 };
@@ -51,6 +55,22 @@ struct Iend : public Io::BChunk {
     static constexpr Str SIG = "IEND";
 };
 
+enum struct ColorType : u8 {
+    GRAYSCALE = 0,
+    TRUECOLOR = 2,
+    INDEXED = 3,
+    GRAYSCALE_ALPHA = 4,
+    TRUECOLOR_ALPHA = 6,
+};
+
+enum struct Filter : u8 {
+    NONE = 0,
+    SUB = 1,
+    UP = 2,
+    AVERAGE = 3,
+    PAETH = 4,
+};
+
 struct Decoder {
     static constexpr Array<u8, 8> SIG = {
         0x89, 0x50, 0x4E, 0x47,
@@ -61,7 +81,7 @@ struct Decoder {
 
     Ihdr _ihdr;
     Plte _plte;
-    Idat _idat;
+    Trns _trns;
 
     Bytes sig() {
         return begin().nextBytes(8);
@@ -71,18 +91,7 @@ struct Decoder {
         return slice.len() >= 8 and sub(slice, 0, 8) == SIG;
     }
 
-    static Res<Decoder> init(Bytes slice) {
-        Decoder dec{slice};
-
-        if (dec.sig() == SIG)
-            return Error::invalidData("invalid signature");
-
-        dec._ihdr = dec.lookupChunk<Ihdr>();
-        dec._plte = dec.lookupChunk<Plte>();
-        dec._idat = dec.lookupChunk<Idat>();
-
-        return Ok(dec);
-    }
+    static Res<Decoder> init(Bytes slice);
 
     Decoder(Bytes slice)
         : _slice(slice) {}
@@ -100,15 +109,30 @@ struct Decoder {
             usize len;
             Bytes data;
             u32 crc32;
+
+            // The type and data, which are covered by the checksum
+            Bytes checked() const {
+                return {(u8 const*)sig.buf(), data.len() + 4};
+            }
+
+            bool critical() const {
+                return sig[0] >= 'A' and sig[0] <= 'Z';
+            }
         };
 
         return Iter{[s] mutable -> Opt<Chunk> {
             Chunk c;
 
-            c.len = s.nextI32be();
+            if (s.rem() < 12)
+                return NONE;
+
+            c.len = s.nextU32be();
             c.sig = s.nextStr(4);
+            if (s.rem() < c.len + 4)
+                return NONE;
+
             c.data = s.nextBytes(c.len);
-            c.crc32 = s.nextI32be();
+            c.crc32 = s.nextU32be();
 
             if (c.sig == Iend::SIG) {
                 return NONE;
@@ -138,9 +162,41 @@ struct Decoder {
         return _ihdr.size().y;
     }
 
-    Res<> decode(Gfx::MutPixels) {
-        return Ok();
+    ColorType colorType() {
+        return (ColorType)_ihdr.colorType();
+    }
+
+    u8 bitDepth() {
+        return _ihdr.bitDepth();
+    }
+
+    bool interlaced() {
+        return _ihdr.interlaceMethod() == 1;
+    }
+
+    // Number of bytes a pixel occupies in a scanline, rounded up to one for
+    // bit depths smaller than a byte, which is also the distance the filters
+    // look back to.
+    usize bpp() {
+        return max((channels() * bitDepth()) / 8, 1uz);
     }
+
+    usize channels() {
+        switch (colorType()) {
+        case ColorType::GRAYSCALE:
+        case ColorType::INDEXED:
+            return 1;
+        case ColorType::GRAYSCALE_ALPHA:
+            return 2;
+        case ColorType::TRUECOLOR:
+            return 3;
+        case ColorType::TRUECOLOR_ALPHA:
+            return 4;
+        }
+        return 0;
+    }
+
+    Res<> decode(Gfx::MutPixels dest);
 };
 
 } // namespace Png
@@ -0,0 +1,254 @@
+#include <karm-crypto/crc32.h>
+#include <karm-image/png/decoder.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-test/macros.h>
+
+namespace Png::Tests {
+
+// Size and CRC-32 of the RGBA8 pixels of every valid image of the PNG
+// suite, as produced by an independent decoder following the same
+// conventions: 16-bit samples keep their high byte, low bit depth gray is
+// scaled to 0..255 and tRNS keys become fully transparent.
+struct _Expected {
+    Str name;
+    isize width;
+    isize height;
+    u32 crc32;
+};
+
+static constexpr Array _EXPECTED = {
+    _Expected{"PngSuite.png", 256, 256, 0xc3a88ff4},
+    _Expected{"basi0g01.png", 32, 32, 0x0da28714},
+    _Expected{"basi0g02.png", 32, 32, 0x2e3fe285},
+    _Expected{"basi0g04.png", 32, 32, 0x8d0f641b},
+    _Expected{"basi0g08.png", 32, 32, 0xc395683c},
+    _Expected{"basi0g16.png", 32, 32, 0x8b47d810},
+    _Expected{"basi2c08.png", 32, 32, 0x2fb54036},
+    _Expected{"basi2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"basi3p01.png", 32, 32, 0x4d8431a4},
+    _Expected{"basi3p02.png", 32, 32, 0xe4dbb6bc},
+    _Expected{"basi3p04.png", 32, 32, 0x671f880f},
+    _Expected{"basi3p08.png", 32, 32, 0x39528682},
+    _Expected{"basi4a08.png", 32, 32, 0x905d5b60},
+    _Expected{"basi4a16.png", 32, 32, 0x9c7c3556},
+    _Expected{"basi6a08.png", 32, 32, 0xa74df32c},
+    _Expected{"basi6a16.png", 32, 32, 0x285be560},
+    _Expected{"basn0g01.png", 32, 32, 0x0da28714},
+    _Expected{"basn0g02.png", 32, 32, 0x2e3fe285},
+    _Expected{"basn0g04.png", 32, 32, 0x8d0f641b},
+    _Expected{"basn0g08.png", 32, 32, 0xc395683c},
+    _Expected{"basn0g16.png", 32, 32, 0x8b47d810},
+    _Expected{"basn2c08.png", 32, 32, 0x2fb54036},
+    _Expected{"basn2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"basn3p01.png", 32, 32, 0x4d8431a4},
+    _Expected{"basn3p02.png", 32, 32, 0xe4dbb6bc},
+    _Expected{"basn3p04.png", 32, 32, 0x671f880f},
+    _Expected{"basn3p08.png", 32, 32, 0x39528682},
+    _Expected{"basn4a08.png", 32, 32, 0x905d5b60},
+    _Expected{"basn4a16.png", 32, 32, 0x9c7c3556},
+    _Expected{"basn6a08.png", 32, 32, 0xa74df32c},
+    _Expected{"basn6a16.png", 32, 32, 0x285be560},
+    _Expected{"bgai4a08.png", 32, 32, 0x905d5b60},
+    _Expected{"bgai4a16.png", 32, 32, 0x9c7c3556},
+    _Expected{"bgan6a08.png", 32, 32, 0xa74df32c},
+    _Expected{"bgan6a16.png", 32, 32, 0x285be560},
+    _Expected{"bgbn4a08.png", 32, 32, 0x905d5b60},
+    _Expected{"bggn4a16.png", 32, 32, 0x9c7c3556},
+    _Expected{"bgwn6a08.png", 32, 32, 0xa74df32c},
+    _Expected{"bgyn6a16.png", 32, 32, 0x285be560},
+    _Expected{"ccwn2c08.png", 32, 32, 0x40a6a67c},
+    _Expected{"ccwn3p08.png", 32, 32, 0x9192bfaa},
+    _Expected{"cdfn2c08.png", 8, 32, 0x2af2ddf8},
+    _Expected{"cdhn2c08.png", 32, 8, 0x23cb0319},
+    _Expected{"cdsn2c08.png", 8, 8, 0xd81f3e6b},
+    _Expected{"cdun2c08.png", 32, 32, 0x878a46a3},
+    _Expected{"ch1n3p04.png", 32, 32, 0x671f880f},
+    _Expected{"ch2n3p08.png", 32, 32, 0x39528682},
+    _Expected{"cm0n0g04.png", 32, 32, 0xb743ec84},
+    _Expected{"cm7n0g04.png", 32, 32, 0xb743ec84},
+    _Expected{"cm9n0g04.png", 32, 32, 0xb743ec84},
+    _Expected{"cs3n2c16.png", 32, 32, 0x0a0758b6},
+    _Expected{"cs3n3p08.png", 32, 32, 0xe1ccec94},
+    _Expected{"cs5n2c08.png", 32, 32, 0x8423bc98},
+    _Expected{"cs5n3p08.png", 32, 32, 0x8423bc98},
+    _Expected{"cs8n2c08.png", 32, 32, 0x0a0758b6},
+    _Expected{"cs8n3p08.png", 32, 32, 0x0a0758b6},
+    _Expected{"ct0n0g04.png", 32, 32, 0xb743ec84},
+    _Expected{"ct1n0g04.png", 32, 32, 0xb743ec84},
+    _Expected{"cten0g04.png", 32, 32, 0x77c3d4de},
+    _Expected{"ctfn0g04.png", 32, 32, 0xfb03c836},
+    _Expected{"ctgn0g04.png", 32, 32, 0x1495e441},
+    _Expected{"cthn0g04.png", 32, 32, 0x6b22f4da},
+    _Expected{"ctjn0g04.png", 32, 32, 0x7ac255fd},
+    _Expected{"ctzn0g04.png", 32, 32, 0xb743ec84},
+    _Expected{"exif2c08.png", 32, 32, 0x80d91236},
+    _Expected{"f00n0g08.png", 32, 32, 0x0b907dec},
+    _Expected{"f00n2c08.png", 32, 32, 0x9ad4b08b},
+    _Expected{"f01n0g08.png", 32, 32, 0x2119c97f},
+    _Expected{"f01n2c08.png", 32, 32, 0xe31d06f2},
+    _Expected{"f02n0g08.png", 32, 32, 0xc03634d7},
+    _Expected{"f02n2c08.png", 32, 32, 0xba0d4b27},
+    _Expected{"f03n0g08.png", 32, 32, 0x3a9c7b91},
+    _Expected{"f03n2c08.png", 32, 32, 0x6d296175},
+    _Expected{"f04n0g08.png", 32, 32, 0x28fca0b1},
+    _Expected{"f04n2c08.png", 32, 32, 0xc5c4baad},
+    _Expected{"f99n0g04.png", 32, 32, 0xf8617313},
+    _Expected{"g03n0g16.png", 32, 32, 0x7c364c58},
+    _Expected{"g03n2c08.png", 32, 32, 0xf6882c1f},
+    _Expected{"g03n3p04.png", 32, 32, 0x13427f49},
+    _Expected{"g04n0g16.png", 32, 32, 0x71d8adfd},
+    _Expected{"g04n2c08.png", 32, 32, 0x92bcece3},
+    _Expected{"g04n3p04.png", 32, 32, 0x8441c56f},
+    _Expected{"g05n0g16.png", 32, 32, 0xf968c4a8},
+    _Expected{"g05n2c08.png", 32, 32, 0x754dcc75},
+    _Expected{"g05n3p04.png", 32, 32, 0x2788ce48},
+    _Expected{"g07n0g16.png", 32, 32, 0x3bd60fba},
+    _Expected{"g07n2c08.png", 32, 32, 0x304cc4f1},
+    _Expected{"g07n3p04.png", 32, 32, 0x3977f102},
+    _Expected{"g10n0g16.png", 32, 32, 0xa360b8f0},
+    _Expected{"g10n2c08.png", 32, 32, 0x6df63c8c},
+    _Expected{"g10n3p04.png", 32, 32, 0x810df60d},
+    _Expected{"g25n0g16.png", 32, 32, 0x1197ce63},
+    _Expected{"g25n2c08.png", 32, 32, 0xf3f12041},
+    _Expected{"g25n3p04.png", 32, 32, 0xfb71efa9},
+    _Expected{"oi1n0g16.png", 32, 32, 0x8b47d810},
+    _Expected{"oi1n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"oi2n0g16.png", 32, 32, 0x8b47d810},
+    _Expected{"oi2n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"oi4n0g16.png", 32, 32, 0x8b47d810},
+    _Expected{"oi4n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"oi9n0g16.png", 32, 32, 0x8b47d810},
+    _Expected{"oi9n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"pp0n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"pp0n6a08.png", 32, 32, 0x0ee05c61},
+    _Expected{"ps1n0g08.png", 32, 32, 0xc395683c},
+    _Expected{"ps1n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"ps2n0g08.png", 32, 32, 0xc395683c},
+    _Expected{"ps2n2c16.png", 32, 32, 0xf3bb75e6},
+    _Expected{"s01i3p01.png", 1, 1, 0x9f62cde3},
+    _Expected{"s01n3p01.png", 1, 1, 0x9f62cde3},
+    _Expected{"s02i3p01.png", 2, 2, 0xfc958ebf},
+    _Expected{"s02n3p01.png", 2, 2, 0xfc958ebf},
+    _Expected{"s03i3p01.png", 3, 3, 0xf53615d1},
+    _Expected{"s03n3p01.png", 3, 3, 0xf53615d1},
+    _Expected{"s04i3p01.png", 4, 4, 0xce2b2aa8},
+    _Expected{"s04n3p01.png", 4, 4, 0xce2b2aa8},
+    _Expected{"s05i3p02.png", 5, 5, 0x71f99a5f},
+    _Expected{"s05n3p02.png", 5, 5, 0x71f99a5f},
+    _Expected{"s06i3p02.png", 6, 6, 0x1707ae6e},
+    _Expected{"s06n3p02.png", 6, 6, 0x1707ae6e},
+    _Expected{"s07i3p02.png", 7, 7, 0xf3a27b20},
+    _Expected{"s07n3p02.png", 7, 7, 0xf3a27b20},
+    _Expected{"s08i3p02.png", 8, 8, 0x2eb65a34},
+    _Expected{"s08n3p02.png", 8, 8, 0x2eb65a34},
+    _Expected{"s09i3p02.png", 9, 9, 0x44d29bb4},
+    _Expected{"s09n3p02.png", 9, 9, 0x44d29bb4},
+    _Expected{"s32i3p04.png", 32, 32, 0x9410d2a5},
+    _Expected{"s32n3p04.png", 32, 32, 0x9410d2a5},
+    _Expected{"s33i3p04.png", 33, 33, 0xd001d86b},
+    _Expected{"s33n3p04.png", 33, 33, 0xd001d86b},
+    _Expected{"s34i3p04.png", 34, 34, 0x17cfe1ad},
+    _Expected{"s34n3p04.png", 34, 34, 0x17cfe1ad},
+    _Expected{"s35i3p04.png", 35, 35, 0xb8c8407d},
+    _Expected{"s35n3p04.png", 35, 35, 0xb8c8407d},
+    _Expected{"s36i3p04.png", 36, 36, 0xd5aec69b},
+    _Expected{"s36n3p04.png", 36, 36, 0xd5aec69b},
+    _Expected{"s37i3p04.png", 37, 37, 0xa1563224},
+    _Expected{"s37n3p04.png", 37, 37, 0xa1563224},
+    _Expected{"s38i3p04.png", 38, 38, 0xbdaf2e8a},
+    _Expected{"s38n3p04.png", 38, 38, 0xbdaf2e8a},
+    _Expected{"s39i3p04.png", 39, 39, 0x5cb9f129},
+    _Expected{"s39n3p04.png", 39, 39, 0x5cb9f129},
+    _Expected{"s40i3p04.png", 40, 40, 0xbf29afa5},
+    _Expected{"s40n3p04.png", 40, 40, 0xbf29afa5},
+    _Expected{"tbbn0g04.png", 32, 32, 0x5c8eaf83},
+    _Expected{"tbbn2c16.png", 32, 32, 0x0370ef89},
+    _Expected{"tbbn3p08.png", 32, 32, 0x9d56cd67},
+    _Expected{"tbgn2c16.png", 32, 32, 0x0370ef89},
+    _Expected{"tbgn3p08.png", 32, 32, 0x9d56cd67},
+    _Expected{"tbrn2c08.png", 32, 32, 0x0370ef89},
+    _Expected{"tbwn0g16.png", 32, 32, 0xb24d0a34},
+    _Expected{"tbwn3p08.png", 32, 32, 0x9d56cd67},
+    _Expected{"tbyn3p08.png", 32, 32, 0x9d56cd67},
+    _Expected{"tm3n3p02.png", 32, 32, 0xe7daa7f5},
+    _Expected{"tp0n0g08.png", 32, 32, 0x57965874},
+    _Expected{"tp0n2c08.png", 32, 32, 0x679d24b4},
+    _Expected{"tp0n3p08.png", 32, 32, 0x130aa165},
+    _Expected{"tp1n3p08.png", 32, 32, 0x9d56cd67},
+    _Expected{"z00n2c08.png", 32, 32, 0x67290c15},
+    _Expected{"z03n2c08.png", 32, 32, 0x67290c15},
+    _Expected{"z06n2c08.png", 32, 32, 0x67290c15},
+    _Expected{"z09n2c08.png", 32, 32, 0x67290c15},
+};
+
+// Corrupted files of the suite, which must all be rejected.
+static constexpr Array _CORRUPTED = {
+    "xc1n0g08.png"s,
+    "xc9n2c08.png"s,
+    "xcrn0g04.png"s,
+    "xcsn0g01.png"s,
+    "xd0n2c08.png"s,
+    "xd3n2c08.png"s,
+    "xd9n2c08.png"s,
+    "xdtn0g01.png"s,
+    "xhdn0g08.png"s,
+    "xlfn0g04.png"s,
+    "xs1n0g01.png"s,
+    "xs2n0g01.png"s,
+    "xs4n0g01.png"s,
+    "xs7n0g01.png"s,
+};
+
+static Res<Sys::Mmap> _map(Str name) {
+    auto url = "bundle://karm-image.png.tests/pngsuite"_url.join(name);
+    auto file = try$(Sys::File::open(url));
+    return Sys::mmap().map(file);
+}
+
+static Res<> _decode(Bytes bytes, Rc<Gfx::Surface>& out) {
+    auto dec = try$(Decoder::init(bytes));
+    out = Gfx::Surface::alloc({dec.width(), dec.height()});
+    return dec.decode(*out);
+}
+
+test$("png-suite-decode") {
+    for (auto const& expected : _EXPECTED) {
+        auto map = try$(_map(expected.name));
+        auto surface = Gfx::Surface::alloc({1, 1});
+        if (not _decode(map.bytes(), surface)) {
+            logError("png: {} failed to decode", expected.name);
+            expect$(false);
+        }
+
+        expectEq$(surface->width(), expected.width);
+        expectEq$(surface->height(), expected.height);
+
+        Crypto::Crc32 crc;
+        auto pixels = surface->pixels();
+        for (isize y = 0; y < pixels.height(); y++)
+            crc.update(Bytes{(u8 const*)pixels.scanline(y), (usize)pixels.width() * 4});
+
+        if (crc.digest() != expected.crc32) {
+            logError("png: {} decoded to the wrong pixels", expected.name);
+            expect$(false);
+        }
+    }
+
+    return Ok();
+}
+
+test$("png-suite-corrupted") {
+    for (auto name : _CORRUPTED) {
+        auto map = try$(_map(name));
+        auto surface = Gfx::Surface::alloc({1, 1});
+        if (_decode(map.bytes(), surface)) {
+            logError("png: {} should have been rejected", name);
+            expect$(false);
+        }
+    }
+
+    return Ok();
+}
+
+} // namespace Png::Tests
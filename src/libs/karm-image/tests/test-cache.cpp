@@ -0,0 +1,165 @@
+#include <karm-image/cache.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Image::Tests {
+
+// NOTE: The images are all 2x2, so 16 bytes once decoded.
+static constexpr usize IMAGE_BYTES = 2 * 2 * 4;
+
+static Mime::Url _url(Str name) {
+    return "bundle://karm-image.tests"_url.join(name);
+}
+
+static bool _same(Cached const& a, Cached const& b) {
+    return &a._entry.unwrap() == &b._entry.unwrap();
+}
+
+static bool _cached(Cache& cache, Str name) {
+    for (auto& entry : cache._entries)
+        if (entry->url == _url(name))
+            return true;
+    return false;
+}
+
+test$("image-cache-hit") {
+    Cache cache;
+
+    auto a = cache.load(_url("image.png"));
+    auto b = cache.load(_url("image.png"));
+    expect$(_same(a, b));
+    expectEq$(a.size(), (Math::Vec2i{2, 2}));
+
+    auto picture = a.picture();
+    expect$(a.ready());
+    expectEq$(picture.width(), 2);
+    expectEq$(picture.height(), 2);
+
+    return Ok();
+}
+
+test$("image-cache-lru") {
+    Cache cache;
+    cache.setBudget(IMAGE_BYTES * 2);
+
+    cache.load(_url("image.png"));
+    cache.load(_url("image.jpg"));
+
+    // NOTE: Loading image.png again makes image.jpg the least recently used.
+    cache.load(_url("image.png"));
+    cache.load(_url("image.gif"));
+
+    expect$(_cached(cache, "image.png"));
+    expect$(_cached(cache, "image.gif"));
+    expect$(not _cached(cache, "image.jpg"));
+    expectEq$(cache._entries[0]->url, _url("image.gif"));
+
+    return Ok();
+}
+
+test$("image-cache-budget") {
+    Cache cache;
+    cache.setBudget(IMAGE_BYTES * 3);
+
+    Array<Str, 4> names = {"image.png", "image.jpg", "image.gif", "image.tga"};
+    for (auto name : names) {
+        cache.load(_url(name));
+        expect$(cache.used() <= IMAGE_BYTES * 3);
+    }
+    expectEq$(cache.used(), IMAGE_BYTES * 3);
+
+    // NOTE: The most recent image is kept even when it alone is over budget.
+    cache.setBudget(0);
+    expectEq$(cache._entries.len(), 1uz);
+    expect$(_cached(cache, "image.tga"));
+
+    return Ok();
+}
+
+test$("image-cache-evicted-handle") {
+    Cache cache;
+    cache.setBudget(0);
+
+    // NOTE: Handles keep their image alive after it has been evicted.
+    auto a = cache.load(_url("image.png"));
+    cache.load(_url("image.jpg"));
+    expect$(not _cached(cache, "image.png"));
+    expectEq$(a.picture().width(), 2);
+
+    return Ok();
+}
+
+test$("image-cache-stamp") {
+    Cache cache;
+
+    auto a = cache.load(_url("image.png"));
+    auto stamp = a._entry->stamp;
+
+    // NOTE: Pretend the file changed since it was cached.
+    a._entry->stamp = stamp - Duration::fromMSecs(1);
+
+    auto b = cache.load(_url("image.png"));
+    expect$(not _same(a, b));
+    expect$(b._entry->stamp == stamp);
+
+    // NOTE: The stale entry is dropped rather than kept until evicted.
+    expectEq$(cache._entries.len(), 1uz);
+
+    auto c = cache.load(_url("image.png"));
+    expect$(_same(b, c));
+
+    return Ok();
+}
+
+test$("image-cache-concurrent-load") {
+    Cache cache;
+
+    // NOTE: Every thread gets the same entry, whichever inserted it.
+    Array<Opt<Cached>, 4> loaded;
+    Vec<Rc<Sys::Thread>> threads;
+    for (auto& slot : loaded) {
+        threads.pushBack(try$(Sys::spawn([&] {
+            slot = cache.load(_url("image.png"));
+        })));
+    }
+
+    for (auto& thread : threads)
+        try$(thread->join());
+
+    expectEq$(cache._entries.len(), 1uz);
+    for (auto& slot : loaded)
+        expect$(_same(slot.unwrap(), loaded[0].unwrap()));
+
+    return Ok();
+}
+
+test$("image-cache-concurrent-picture") {
+    Cache cache;
+    auto cached = cache.load(_url("image.png"));
+
+    // NOTE: Pictures can be copied and dropped from any thread, they only
+    //       hold thread safe handles.
+    Atomic<usize> done = 0;
+    Vec<Rc<Sys::Thread>> threads;
+    for (usize i = 0; i < 4; i++) {
+        threads.pushBack(try$(Sys::spawn([&] {
+            for (usize j = 0; j < 64; j++) {
+                if (cached.picture().width() == 2)
+                    done.inc();
+            }
+        })));
+    }
+
+    for (auto& thread : threads)
+        try$(thread->join());
+    threads.clear();
+
+    expectEq$(done.load(), 4 * 64uz);
+    expect$(cached.ready());
+
+    auto picture = cached.picture();
+    expectEq$(picture._surface.strong(), 2uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Image::Tests
@@ -0,0 +1,116 @@
+#include <karm-base/atomic.h>
+#include <karm-gfx/colors.h>
+#include <karm-gfx/resample.h>
+#include <karm-image/picture.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Image::Tests {
+
+static Rc<Gfx::Surface> _surface(Math::Vec2i size) {
+    auto surface = Gfx::Surface::alloc(size);
+    for (isize y = 0; y < size.y; y++)
+        for (isize x = 0; x < size.x; x++)
+            surface->mutPixels().storeUnsafe({x, y}, Gfx::Color::fromRgba(x * 4, y * 4, (x ^ y) * 4, 255));
+    return surface;
+}
+
+static bool _same(Arc<Gfx::Surface const> const& a, Arc<Gfx::Surface const> const& b) {
+    return &a.unwrap() == &b.unwrap();
+}
+
+test$("image-picture-scaled-cached") {
+    Picture picture = _surface({64, 48});
+
+    // NOTE: Drawing at the picture's own size is a plain blit.
+    expect$(_same(picture.scaled({64, 48}), picture._surface));
+
+    auto a = picture.scaled({20, 15});
+    expectEq$(a->_size, (Math::Vec2i{20, 15}));
+    expect$(_same(picture.scaled({20, 15}), a));
+
+    // NOTE: Copies of the picture share their scaled copies.
+    Picture copy = picture;
+    expect$(_same(copy.scaled({20, 15}), a));
+
+    return Ok();
+}
+
+test$("image-picture-scaled-evict") {
+    Picture picture = _surface({64, 48});
+    auto first = picture.scaled({10, 10});
+
+    for (isize i = 1; i <= (isize)Picture::MAX_SCALED; i++)
+        picture.scaled({10 + i, 10});
+
+    expectEq$(picture._cache->scaled.len(), Picture::MAX_SCALED);
+    expect$(not _same(picture.scaled({10, 10}), first));
+
+    return Ok();
+}
+
+test$("image-picture-scaled-mips") {
+    auto surface = _surface({64, 48});
+    Picture picture = surface;
+
+    // NOTE: Scaling down starts from the smallest half still bigger than the
+    //       requested size, 64x48 -> 32x24 -> 16x12 -> 10x10.
+    auto scaled = picture.scaled({10, 10});
+    expectEq$(picture._cache->mips.len(), 2uz);
+    expectEq$(picture._cache->mips[1]->_size, (Math::Vec2i{16, 12}));
+
+    auto half = Gfx::resample(surface->pixels(), {32, 24}, Gfx::Resampling::BOX);
+    auto quarter = Gfx::resample(half->pixels(), {16, 12}, Gfx::Resampling::BOX);
+    auto expected = Gfx::resample(quarter->pixels(), {10, 10});
+    expect$(scaled->pixels().bytes() == expected->pixels().bytes());
+
+    // NOTE: Scaling up doesn't need any.
+    Picture small = _surface({8, 8});
+    small.scaled({30, 30});
+    expectEq$(small._cache->mips.len(), 0uz);
+
+    return Ok();
+}
+
+test$("image-picture-surface") {
+    // NOTE: A surface nothing else refers to is taken over, one that is
+    //       still in use is copied, so changing it doesn't change the picture.
+    auto surface = _surface({4, 4});
+    Picture picture = surface;
+    surface->mutPixels().clear(Gfx::BLACK);
+    expect$(picture.pixels().loadUnsafe({3, 3}) != Gfx::BLACK);
+    expect$(picture.pixels().bytes() == _surface({4, 4})->pixels().bytes());
+
+    return Ok();
+}
+
+test$("image-picture-scaled-threads") {
+    Picture picture = _surface({64, 48});
+
+    Atomic<usize> done = 0;
+    Vec<Rc<Sys::Thread>> threads;
+    for (usize i = 0; i < 4; i++) {
+        threads.pushBack(try$(Sys::spawn([&, copy = picture] {
+            for (isize j = 0; j < 64; j++) {
+                auto scaled = copy.scaled({10 + j % 8, 10});
+                if (scaled->_size == Math::Vec2i{10 + j % 8, 10})
+                    done.inc();
+            }
+        })));
+    }
+
+    for (auto& thread : threads)
+        try$(thread->join());
+    threads.clear();
+
+    expectEq$(done.load(), 4 * 64uz);
+    expectEq$(picture._cache->scaled.len(), Picture::MAX_SCALED);
+
+    // NOTE: Every copy made by the threads has been released.
+    expectEq$(picture._cache.strong(), 1uz);
+    expectEq$(picture._surface.strong(), 1uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Image::Tests
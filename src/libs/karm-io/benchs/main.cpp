@@ -0,0 +1,52 @@
+#include <karm-io/fmt.h>
+#include <karm-sys/entry.h>
+#include <karm-sys/time.h>
+
+static void bench(Str name, auto f) {
+    static constexpr usize ROUNDS = 1000000;
+
+    Io::StringWriter writer;
+    usize bytes = 0;
+    auto start = Sys::now();
+    for (usize i = 0; i < ROUNDS; i++) {
+        writer.clear();
+        f(writer, i);
+        bytes += writer.len();
+    }
+    auto elapsed = Sys::now() - start;
+
+    f64 nsPerCall = elapsed.toUSecs() * 1000.0 / ROUNDS;
+    f64 mbps = bytes / (elapsed.toUSecs() / 1e6) / 1e6;
+    Sys::println("{}: {} ({} ns/call, {} MB/s)", name, elapsed, nsPerCall, mbps);
+}
+
+Async::Task<> entryPointAsync(Sys::Context&) {
+    bench("literal", [](Io::TextWriter& w, usize) {
+        (void)Io::format(w, "GET /index.html HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+    });
+
+    bench("integers", [](Io::TextWriter& w, usize i) {
+        (void)Io::format(w, "{} {} {x} {08}", i, -(isize)i, i, i % 1000);
+    });
+
+    bench("floats", [](Io::TextWriter& w, usize i) {
+        (void)Io::format(w, "{} {}", i * 0.1, 1.0 / (i + 1));
+    });
+
+    bench("http header", [](Io::TextWriter& w, usize i) {
+        (void)Io::format(
+            w,
+            "HTTP/1.1 {} {}\r\n"
+            "Connection: close\r\n"
+            "Content-Length: {}\r\n"
+            "\r\n",
+            200, "OK"s, i
+        );
+    });
+
+    bench("log line", [](Io::TextWriter& w, usize i) {
+        (void)Io::format(w, "{}:{}: loaded {} fonts in {}", "src/libs/karm-text/book.cpp"s, 42, i, Duration::fromUSecs(i));
+    });
+
+    co_return Ok();
+}
@@ -84,6 +84,27 @@ struct Emit : public Io::TextWriterBase<> {
         return Ok(written);
     }
 
+    Res<usize> writeUtf8(Str str) override {
+        usize written = 0;
+        usize start = 0;
+        for (usize i = 0; i <= str.len(); i++) {
+            if (i < str.len() and str[i] != '\n')
+                continue;
+
+            if (i > start) {
+                if (_newline)
+                    written += try$(_insertNewline());
+                written += try$(_writer.writeStr(Str{str.buf() + start, i - start}));
+            }
+
+            if (i < str.len())
+                newline();
+            start = i + 1;
+        }
+        _total += written;
+        return Ok(written);
+    }
+
     void operator()(Rune r) {
         if (r == '\n') {
             newline();
@@ -97,13 +118,18 @@ struct Emit : public Io::TextWriterBase<> {
     }
 
     template <typename... Ts>
-    void operator()(Str format, Ts&&... ts) {
+    void operator()(Io::Fmt<Ts...> format, Ts&&... ts) {
         _tryWrapper(Io::format(*this, format, std::forward<Ts>(ts)...));
     }
 
+    void ln(Str str) {
+        _tryWrapper(writeStr(str));
+        newline();
+    }
+
     template <typename... Ts>
-    void ln(Ts&&... ts) {
-        _tryWrapper(Io::format(*this, std::forward<Ts>(ts)...));
+    void ln(Io::Fmt<Ts...> format, Ts&&... ts) {
+        _tryWrapper(Io::format(*this, format, std::forward<Ts>(ts)...));
         newline();
     }
 
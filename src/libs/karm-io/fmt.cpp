@@ -300,4 +300,301 @@ Res<String> changeCase(Str str, Case toCase) {
     }
 }
 
+// MARK: Format Strings --------------------------------------------------------
+
+void _malformedFormatString(char const* reason) {
+    panic(reason);
+}
+
+// MARK: Float Formatting ------------------------------------------------------
+
+// Grisu2, from "Printing Floating-Point Numbers Quickly and Accurately with
+// Integers" by Florian Loitsch. The digits always read back as the same
+// value and are the shortest ones for all but a few rare inputs.
+
+struct DiyFp {
+    u64 f;
+    isize e;
+
+    DiyFp operator-(DiyFp other) const {
+        return {f - other.f, e};
+    }
+
+    DiyFp operator*(DiyFp other) const {
+        u128 p = (u128)f * other.f;
+        u64 h = p >> 64;
+        if ((u64)p & (1ull << 63))
+            h++;
+        return {h, e + other.e + 64};
+    }
+
+    DiyFp normalized() const {
+        isize shift = __builtin_clzll(f);
+        return {f << shift, e - shift};
+    }
+};
+
+// 10^k for k = -348, -340, ..., 340, normalized to 64 bits.
+static Array<DiyFp, 87> const CACHED_POWERS = {{
+    {0xfa8fd5a0081c0288, -1220},
+    {0xbaaee17fa23ebf76, -1193},
+    {0x8b16fb203055ac76, -1166},
+    {0xcf42894a5dce35ea, -1140},
+    {0x9a6bb0aa55653b2d, -1113},
+    {0xe61acf033d1a45df, -1087},
+    {0xab70fe17c79ac6ca, -1060},
+    {0xff77b1fcbebcdc4f, -1034},
+    {0xbe5691ef416bd60c, -1007},
+    {0x8dd01fad907ffc3c, -980},
+    {0xd3515c2831559a83, -954},
+    {0x9d71ac8fada6c9b5, -927},
+    {0xea9c227723ee8bcb, -901},
+    {0xaecc49914078536d, -874},
+    {0x823c12795db6ce57, -847},
+    {0xc21094364dfb5637, -821},
+    {0x9096ea6f3848984f, -794},
+    {0xd77485cb25823ac7, -768},
+    {0xa086cfcd97bf97f4, -741},
+    {0xef340a98172aace5, -715},
+    {0xb23867fb2a35b28e, -688},
+    {0x84c8d4dfd2c63f3b, -661},
+    {0xc5dd44271ad3cdba, -635},
+    {0x936b9fcebb25c996, -608},
+    {0xdbac6c247d62a584, -582},
+    {0xa3ab66580d5fdaf6, -555},
+    {0xf3e2f893dec3f126, -529},
+    {0xb5b5ada8aaff80b8, -502},
+    {0x87625f056c7c4a8b, -475},
+    {0xc9bcff6034c13053, -449},
+    {0x964e858c91ba2655, -422},
+    {0xdff9772470297ebd, -396},
+    {0xa6dfbd9fb8e5b88f, -369},
+    {0xf8a95fcf88747d94, -343},
+    {0xb94470938fa89bcf, -316},
+    {0x8a08f0f8bf0f156b, -289},
+    {0xcdb02555653131b6, -263},
+    {0x993fe2c6d07b7fac, -236},
+    {0xe45c10c42a2b3b06, -210},
+    {0xaa242499697392d3, -183},
+    {0xfd87b5f28300ca0e, -157},
+    {0xbce5086492111aeb, -130},
+    {0x8cbccc096f5088cc, -103},
+    {0xd1b71758e219652c, -77},
+    {0x9c40000000000000, -50},
+    {0xe8d4a51000000000, -24},
+    {0xad78ebc5ac620000, 3},
+    {0x813f3978f8940984, 30},
+    {0xc097ce7bc90715b3, 56},
+    {0x8f7e32ce7bea5c70, 83},
+    {0xd5d238a4abe98068, 109},
+    {0x9f4f2726179a2245, 136},
+    {0xed63a231d4c4fb27, 162},
+    {0xb0de65388cc8ada8, 189},
+    {0x83c7088e1aab65db, 216},
+    {0xc45d1df942711d9a, 242},
+    {0x924d692ca61be758, 269},
+    {0xda01ee641a708dea, 295},
+    {0xa26da3999aef774a, 322},
+    {0xf209787bb47d6b85, 348},
+    {0xb454e4a179dd1877, 375},
+    {0x865b86925b9bc5c2, 402},
+    {0xc83553c5c8965d3d, 428},
+    {0x952ab45cfa97a0b3, 455},
+    {0xde469fbd99a05fe3, 481},
+    {0xa59bc234db398c25, 508},
+    {0xf6c69a72a3989f5c, 534},
+    {0xb7dcbf5354e9bece, 561},
+    {0x88fcf317f22241e2, 588},
+    {0xcc20ce9bd35c78a5, 614},
+    {0x98165af37b2153df, 641},
+    {0xe2a0b5dc971f303a, 667},
+    {0xa8d9d1535ce3b396, 694},
+    {0xfb9b7cd9a4a7443c, 720},
+    {0xbb764c4ca7a44410, 747},
+    {0x8bab8eefb6409c1a, 774},
+    {0xd01fef10a657842c, 800},
+    {0x9b10a4e5e9913129, 827},
+    {0xe7109bfba19c0c9d, 853},
+    {0xac2820d9623bf429, 880},
+    {0x80444b5e7aa7cf85, 907},
+    {0xbf21e44003acdd2d, 933},
+    {0x8e679c2f5e44ff8f, 960},
+    {0xd433179d9c8cb841, 986},
+    {0x9e19db92b4e31ba9, 1013},
+    {0xeb96bf6ebadf77d9, 1039},
+    {0xaf87023b9bf0ee6b, 1066},
+}};
+
+static Array<u32, 10> const POW10 = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static void _grisuRound(MutSlice<char> digits, u64 delta, u64 rest, u64 tenKappa, u64 wpW) {
+    while (rest < wpW and
+           delta - rest >= tenKappa and
+           (rest + tenKappa < wpW or wpW - rest > rest + tenKappa - wpW)) {
+        digits[digits.len() - 1]--;
+        rest += tenKappa;
+    }
+}
+
+static usize _digitGen(DiyFp w, DiyFp mp, u64 delta, MutSlice<char> buf, isize& k) {
+    DiyFp one = {1ull << -mp.e, mp.e};
+    DiyFp wpW = mp - w;
+    u32 p1 = mp.f >> -one.e;
+    u64 p2 = mp.f & (one.f - 1);
+
+    isize kappa = 1;
+    while (kappa < 10 and p1 >= POW10[kappa])
+        kappa++;
+
+    usize len = 0;
+    while (kappa > 0) {
+        u32 d = p1 / POW10[kappa - 1];
+        p1 %= POW10[kappa - 1];
+        if (d or len)
+            buf[len++] = '0' + d;
+        kappa--;
+
+        u64 rest = ((u64)p1 << -one.e) + p2;
+        if (rest <= delta) {
+            k += kappa;
+            _grisuRound(mutSub(buf, 0, len), delta, rest, (u64)POW10[kappa] << -one.e, wpW.f);
+            return len;
+        }
+    }
+
+    while (true) {
+        p2 *= 10;
+        delta *= 10;
+        u8 d = p2 >> -one.e;
+        if (d or len)
+            buf[len++] = '0' + d;
+        p2 &= one.f - 1;
+        kappa--;
+
+        if (p2 < delta) {
+            k += kappa;
+            usize index = -kappa;
+            _grisuRound(mutSub(buf, 0, len), delta, p2, one.f, wpW.f * (index < 10 ? POW10[index] : 0));
+            return len;
+        }
+    }
+}
+
+// Generates the digits of f * 2^e, a float with `bits` explicit significand
+// bits, such that the value is digits * 10^k.
+static usize _grisu2(u64 f, isize e, usize bits, MutSlice<char> buf, isize& k) {
+    DiyFp v = {f, e};
+    DiyFp plus = DiyFp{(f << 1) + 1, e - 1}.normalized();
+    DiyFp minus = f == (1ull << bits)
+                      ? DiyFp{(f << 2) - 1, e - 2}
+                      : DiyFp{(f << 1) - 1, e - 1};
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    // Pick a cached power bringing the exponent in [-60, -32]
+    f64 dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    isize ik = (isize)dk;
+    if (dk - ik > 0.0)
+        ik++;
+    usize index = (ik >> 3) + 1;
+    k = -(-348 + (isize)(index << 3));
+    DiyFp c = CACHED_POWERS[index];
+
+    DiyFp w = v.normalized() * c;
+    DiyFp wp = plus * c;
+    DiyFp wm = minus * c;
+    wm.f++;
+    wp.f--;
+    return _digitGen(w, wp, wp.f - wm.f, buf, k);
+}
+
+static Res<usize> _formatDecimal(Io::TextWriter& writer, bool negative, Slice<char> digits, isize k) {
+    // NOTE: Large enough for the sign, "0." and the 323 zeros in front of
+    //       the digits of the smallest f64.
+    Array<char, 352> buf;
+    usize len = 0;
+    auto put = [&](char c) {
+        buf[len++] = c;
+    };
+
+    if (negative)
+        put('-');
+
+    // The value is 0.digits * 10^n
+    isize n = digits.len() + k;
+    if (k >= 0) {
+        for (auto d : digits)
+            put(d);
+        for (isize i = 0; i < k; i++)
+            put('0');
+    } else if (0 < n) {
+        for (usize i = 0; i < digits.len(); i++) {
+            if (i == (usize)n)
+                put('.');
+            put(digits[i]);
+        }
+    } else {
+        put('0');
+        put('.');
+        for (isize i = 0; i < -n; i++)
+            put('0');
+        for (auto d : digits)
+            put(d);
+    }
+
+    return writer.writeStr(Str{buf.buf(), len});
+}
+
+static Res<usize> _formatFloat(Io::TextWriter& writer, bool negative, u64 exponent, u64 significand, usize bits, isize bias) {
+    u64 f = significand;
+    isize e = 1 - bias;
+    if (exponent != 0) {
+        f |= 1ull << bits;
+        e = (isize)exponent - bias;
+    }
+
+    Array<char, 32> digits;
+    isize k = 0;
+    usize len = _grisu2(f, e, bits, digits, k);
+    return _formatDecimal(writer, negative, sub(digits, 0, len), k);
+}
+
+Res<usize> formatFloat(Io::TextWriter& writer, f64 val) {
+    u64 bits = __builtin_bit_cast(u64, val);
+    bool negative = bits >> 63;
+    u64 exponent = (bits >> 52) & 0x7ff;
+    u64 significand = bits & ((1ull << 52) - 1);
+
+    if (exponent == 0x7ff) {
+        if (significand)
+            return writer.writeStr("nan"s);
+        return writer.writeStr(negative ? "-inf"s : "inf"s);
+    }
+
+    if (exponent == 0 and significand == 0)
+        return writer.writeStr("0"s);
+
+    return _formatFloat(writer, negative, exponent, significand, 52, 1075);
+}
+
+Res<usize> formatFloat(Io::TextWriter& writer, f32 val) {
+    u32 bits = __builtin_bit_cast(u32, val);
+    bool negative = bits >> 31;
+    u64 exponent = (bits >> 23) & 0xff;
+    u64 significand = bits & ((1u << 23) - 1);
+
+    if (exponent == 0xff) {
+        if (significand)
+            return writer.writeStr("nan"s);
+        return writer.writeStr(negative ? "-inf"s : "inf"s);
+    }
+
+    if (exponent == 0 and significand == 0)
+        return writer.writeStr("0"s);
+
+    return _formatFloat(writer, negative, exponent, significand, 23, 150);
+}
+
 } // namespace Karm::Io
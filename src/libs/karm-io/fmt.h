@@ -1,5 +1,6 @@
 #pragma once
 
+#include <karm-base/array.h>
 #include <karm-base/backtrace.h>
 #include <karm-base/box.h>
 #include <karm-base/cow.h>
@@ -21,92 +22,230 @@ namespace Karm::Io {
 template <typename T>
 struct Formatter;
 
-struct _Args {
-    virtual ~_Args() = default;
-    virtual usize len() = 0;
-    virtual Res<usize> format(Io::SScan& scan, Io::TextWriter& writer, usize index) = 0;
+// MARK: Format Strings --------------------------------------------------------
+
+// Not constexpr on purpose: reaching it while checking a format string turns
+// the malformed string into a compile error.
+void _malformedFormatString(char const* reason);
+
+// The options of a number placeholder, `{#08x}` for example.
+struct NumberSpec {
+    bool prefix = false;
+    bool isChar = false;
+    usize base = 10;
+    usize width = 0;
+    char fillChar = ' ';
+
+    // Returns how many units of `str` were used.
+    constexpr usize parse(Str str) {
+        usize i = 0;
+        auto skip = [&](char c) {
+            if (i < str.len() and str[i] == c) {
+                i++;
+                return true;
+            }
+            return false;
+        };
+
+        if (skip('#'))
+            prefix = true;
+
+        if (skip('0'))
+            fillChar = '0';
+
+        width = 0;
+        while (i < str.len() and str[i] >= '0' and str[i] <= '9')
+            width = width * 10 + (str[i++] - '0');
+
+        if (i == str.len())
+            return i;
+
+        switch (str[i++]) {
+        case 'b':
+            base = 2;
+            break;
+
+        case 'o':
+            base = 8;
+            break;
+
+        case 'd':
+            base = 10;
+            break;
+
+        case 'x':
+            base = 16;
+            break;
+
+        case 'p':
+            prefix = true;
+            base = 16;
+            fillChar = '0';
+            width = sizeof(usize) * 2;
+            break;
+
+        case 'c':
+            isChar = true;
+            break;
+
+        default:
+            break;
+        }
+
+        return i;
+    }
 };
 
+// Arguments formatted by a NumberFormatter, their spec is parsed along with
+// the format string.
+template <typename T>
+concept _NumberArg = Meta::Integral<T> and not Meta::Boolean<T>;
+
+// A format string checked and split at compile time against the types of its
+// arguments. The text around the placeholders is written in bulk and every
+// argument goes straight to the formatter of its type.
 template <typename... Ts>
-struct Args : public _Args {
-    Tuple<Ts...> _tuple{};
+struct _Fmt {
+    static constexpr usize LEN = sizeof...(Ts);
 
-    Args(Ts&&... ts) : _tuple(std::forward<Ts>(ts)...) {}
+    struct Span {
+        usize start = 0;
+        usize len = 0;
+        bool newline = false;
+    };
 
-    usize len() override {
-        return _tuple.len();
-    }
+    Str _str;
+    Array<Span, LEN + 1> _literals{};
+    Array<Span, LEN + 1> _specs{};
+    Array<NumberSpec, LEN + 1> _numbers{};
 
-    Res<usize> format(Io::SScan& scan, Io::TextWriter& writer, usize index) override {
-        Res<usize> result = Error::invalidData("format index out of range");
+    consteval _Fmt(char const* str)
+        : _Fmt(Str{str}) {}
+
+    consteval _Fmt(Str str) : _str(str) {
+        usize index = 0;
+        usize start = 0;
         usize i = 0;
-        _tuple.visit([&](auto const& t) {
-            if (index == i) {
-                using U = Meta::RemoveConstVolatileRef<decltype(t)>;
-                Formatter<U> formatter;
-                if constexpr (requires() {
-                                  formatter.parse(scan);
-                              }) {
-                    formatter.parse(scan);
-                }
-                result = formatter.format(writer, t);
+
+        while (i < str.len()) {
+            if (str[i] != '{') {
+                i++;
+                continue;
             }
+
+            if (index == LEN)
+                _malformedFormatString("more placeholders than arguments");
+            _literals[index] = _span(start, i);
+
             i++;
+            if (i < str.len() and str[i] == ':')
+                i++;
+
+            usize specStart = i;
+            while (i < str.len() and str[i] != '}') {
+                if (str[i] == '{')
+                    _malformedFormatString("'{' inside a placeholder");
+                i++;
+            }
 
-            return true;
-        });
-        return result;
+            if (i == str.len())
+                _malformedFormatString("unterminated placeholder");
+            _specs[index] = _span(specStart, i);
+
+            index++;
+            start = ++i;
+        }
+
+        if (index != LEN)
+            _malformedFormatString("fewer placeholders than arguments");
+        _literals[LEN] = _span(start, str.len());
+
+        [&]<usize... Is>(std::index_sequence<Is...>) {
+            ((_NumberArg<Ts> ? (void)_numbers[Is].parse(_sub(_specs[Is])) : (void)0), ...);
+        }(std::make_index_sequence<LEN>());
     }
-};
 
-inline Res<usize> _format(Io::TextWriter& writer, Str format, _Args& args) {
-    Io::SScan scan{format};
-    usize written = 0;
-    usize index = 0;
+    constexpr Span _span(usize start, usize end) const {
+        Span span{start, end - start};
+        for (usize i = start; i < end; i++)
+            if (_str[i] == '\n')
+                span.newline = true;
+        return span;
+    }
 
-    while (not scan.ended()) {
-        Rune c = scan.next();
+    constexpr Str _sub(Span span) const {
+        return {_str.buf() + span.start, span.len};
+    }
 
-        if (c == '{') {
-            scan.skip(':');
-            scan.begin();
-            while (scan.peek() != '}') {
-                scan.next();
-            }
-            scan.next();
-            Io::SScan inner{scan.end()};
-            written += try$(args.format(inner, writer, index));
-            index++;
-        } else if (c == '\n') {
-            // normalize newlines
+    Res<usize> _writeLiteral(Io::TextWriter& writer, Span span) const {
+        Str str = _sub(span);
+        if (not span.newline or Str{Sys::LINE_ENDING} == "\n")
+            return writer.writeStr(str);
+
+        // normalize newlines
+        usize written = 0;
+        usize start = 0;
+        for (usize i = 0; i < str.len(); i++) {
+            if (str[i] != '\n')
+                continue;
+            written += try$(writer.writeStr(Str{str.buf() + start, i - start}));
             written += try$(writer.writeStr(Str{Sys::LINE_ENDING}));
-        } else {
-            written += try$(writer.writeRune(c));
+            start = i + 1;
         }
+        written += try$(writer.writeStr(Str{str.buf() + start, str.len() - start}));
+        return Ok(written);
     }
 
-    return Ok(written);
-}
+    template <typename T>
+    Res<usize> _formatArg(Io::TextWriter& writer, usize index, T const& arg) const {
+        usize written = try$(_writeLiteral(writer, _literals[index]));
+        Formatter<T> formatter;
+        if constexpr (_NumberArg<T>) {
+            static_cast<NumberSpec&>(formatter) = _numbers[index];
+        } else if constexpr (requires(Io::SScan& scan) {
+                                 formatter.parse(scan);
+                             }) {
+            // NOTE: Other specs are still scanned here, but only when the
+            //       placeholder has one.
+            if (_specs[index].len) {
+                Io::SScan scan{_sub(_specs[index])};
+                formatter.parse(scan);
+            }
+        }
+        written += try$(formatter.format(writer, arg));
+        return Ok(written);
+    }
 
-inline Res<usize> format(Io::TextWriter& writer, Str format) {
-    return writer.writeStr(format);
-}
+    Res<usize> format(Io::TextWriter& writer, Ts const&... args) const {
+        usize written = 0;
+        Res<> result = Ok();
+        auto formatOne = [&](usize index, auto const& arg) -> Res<> {
+            written += try$(_formatArg(writer, index, arg));
+            return Ok();
+        };
+
+        [&]<usize... Is>(std::index_sequence<Is...>) {
+            (void)((result = formatOne(Is, args)) and ...);
+        }(std::make_index_sequence<LEN>());
+        try$(result);
+
+        written += try$(_writeLiteral(writer, _literals[LEN]));
+        return Ok(written);
+    }
+};
 
 template <typename... Ts>
-inline Res<usize> format(Io::TextWriter& writer, Str format, Ts&&... ts) {
-    Args<Ts...> args{std::forward<Ts>(ts)...};
-    return _format(writer, format, args);
-}
+using Fmt = _Fmt<Meta::RemoveConstVolatileRef<Ts>...>;
 
-inline Res<String> format(Str format) {
-    return Ok(format);
+template <typename... Ts>
+inline Res<usize> format(Io::TextWriter& writer, Fmt<Ts...> format, Ts&&... ts) {
+    return format.format(writer, ts...);
 }
 
 template <typename... Ts>
-inline Res<String> format(Str format, Ts&&... ts) {
+inline Res<String> format(Fmt<Ts...> format, Ts&&... ts) {
     Io::StringWriter writer{};
-    Args<Ts...> args{std::forward<Ts>(ts)...};
-    try$(_format(writer, format, args));
+    try$(format.format(writer, ts...));
     return Ok(writer.take());
 }
 
@@ -286,13 +425,7 @@ struct Formatter<Cased<T>> {
 
 // MARK: Number Formatting -----------------------------------------------------
 
-struct NumberFormatter {
-    bool prefix = false;
-    bool isChar = false;
-    usize base = 10;
-    usize width = 0;
-    char fillChar = ' ';
-
+struct NumberFormatter : public NumberSpec {
     Str formatPrefix() {
         if (base == 16)
             return "0x";
@@ -306,92 +439,79 @@ struct NumberFormatter {
         return "";
     }
 
-    void parse(Str str) {
-        Io::SScan scan{str};
-        parse(scan);
-    }
+    using NumberSpec::parse;
 
     void parse(Io::SScan& scan) {
-        if (scan.skip('#'))
-            prefix = true;
-
-        if (scan.skip('0'))
-            fillChar = '0';
-
-        width = atoi(scan).unwrapOr(0);
-
-        if (scan.ended())
-            return;
-
-        Rune c = scan.next();
-        switch (c) {
-        case 'b':
-            base = 2;
-            break;
+        scan.next(NumberSpec::parse(scan.remStr()));
+    }
 
-        case 'o':
-            base = 8;
-            break;
+    static constexpr Array<char, 200> _DIGIT_PAIRS = [] {
+        Array<char, 200> pairs{};
+        for (usize i = 0; i < 100; i++) {
+            pairs[i * 2] = '0' + i / 10;
+            pairs[i * 2 + 1] = '0' + i % 10;
+        }
+        return pairs;
+    }();
+
+    // Digits are produced from the end of the buffer, so the whole number
+    // goes out in a single write.
+    Res<usize> _formatInteger(Io::TextWriter& writer, usize val, bool negative) {
+        Array<char, 128> buf;
+        usize i = buf.len();
+
+        if (base == 10) {
+            while (val >= 100) {
+                usize pair = (val % 100) * 2;
+                val /= 100;
+                buf[--i] = _DIGIT_PAIRS[pair + 1];
+                buf[--i] = _DIGIT_PAIRS[pair];
+            }
 
-        case 'd':
-            base = 10;
-            break;
+            if (val >= 10) {
+                buf[--i] = _DIGIT_PAIRS[val * 2 + 1];
+                buf[--i] = _DIGIT_PAIRS[val * 2];
+            } else {
+                buf[--i] = '0' + val;
+            }
+        } else if (base == 2 or base == 8 or base == 16) {
+            usize shift = base == 16 ? 4 : (base == 8 ? 3 : 1);
+            do {
+                buf[--i] = "0123456789abcdef"[val & (base - 1)];
+                val >>= shift;
+            } while (val != 0);
+        } else {
+            do {
+                usize digit = val % base;
+                buf[--i] = digit < 10 ? '0' + digit : 'a' + (digit - 10);
+                val /= base;
+            } while (val != 0);
+        }
 
-        case 'x':
-            base = 16;
-            break;
+        // NOTE: Leave room for the sign and the prefix
+        while (buf.len() - i < width and i > 3)
+            buf[--i] = fillChar;
 
-        case 'p':
-            prefix = true;
-            base = 16;
-            fillChar = '0';
-            width = sizeof(usize) * 2;
-            break;
+        if (prefix) {
+            Str p = formatPrefix();
+            for (usize j = p.len(); j > 0; j--)
+                buf[--i] = p[j - 1];
+        }
 
-        case 'c':
-            isChar = true;
-            break;
+        if (negative)
+            buf[--i] = '-';
 
-        default:
-            break;
-        }
+        return writer.writeStr(Str{buf.buf() + i, buf.len() - i});
     }
 
     Res<usize> formatUnsigned(Io::TextWriter& writer, usize val) {
-        auto digit = [](usize v) {
-            if (v < 10)
-                return '0' + v;
-            return 'a' + (v - 10);
-        };
-
-        InlineVec<char, 128> buf;
-
-        do {
-            buf.pushBack(digit(val % base));
-            val /= base;
-        } while (val != 0 and buf.len() < buf.cap());
-
-        while (width > buf.len())
-            buf.pushBack(fillChar);
-
-        reverse(mutSub(buf));
-
-        usize written = 0;
-        if (prefix)
-            written += try$(writer.writeStr(formatPrefix()));
-        written += try$(writer.writeStr(Str{buf}));
-
-        return Ok(written);
+        return _formatInteger(writer, val, false);
     }
 
     Res<usize> formatSigned(Io::TextWriter& writer, isize val) {
-        usize written = 0;
-        if (val < 0) {
-            written += try$(writer.writeRune('-'));
-            val = -val;
-        }
-        written += try$(formatUnsigned(writer, val));
-        return Ok(written);
+        if (val < 0)
+            return _formatInteger(writer, 0uz - (usize)val, true);
+        return _formatInteger(writer, val, false);
     }
 
     Res<usize> formatRune(Io::TextWriter& writer, Rune val) {
@@ -462,22 +582,19 @@ struct Formatter<T> : public UnsignedFormatter<T> {};
 template <Meta::SignedIntegral T>
 struct Formatter<T> : public SignedFormatter<T> {};
 
+// Writes the shortest digits that read back as the same value, always in
+// positional notation: PDF, CSS and SVG numbers can't have an exponent.
+Res<usize> formatFloat(Io::TextWriter& writer, f64 val);
+
+Res<usize> formatFloat(Io::TextWriter& writer, f32 val);
+
 template <Meta::Float T>
 struct Formatter<T> {
-    Res<usize> format(Io::TextWriter& writer, f64 const& val) {
-        NumberFormatter formatter;
-        usize written = 0;
-        isize ipart = (isize)val;
-        written += try$(formatter.formatSigned(writer, ipart));
-        f64 fpart = val - (f64)ipart;
-        if (fpart != 0.0) {
-            written += try$(writer.writeRune('.'));
-            formatter.width = 6;
-            formatter.fillChar = '0';
-            fpart *= 1000000;
-            written += try$(formatter.formatUnsigned(writer, (u64)fpart));
-        }
-        return Ok(written);
+    Res<usize> format(Io::TextWriter& writer, T const& val) {
+        if constexpr (Meta::Same<T, f32>)
+            return formatFloat(writer, val);
+        else
+            return formatFloat(writer, (f64)val);
     }
 };
 
@@ -22,6 +22,19 @@ inline Res<Byte> getByte(Readable auto& reader) {
     return Ok(byte);
 }
 
+/// Reads until `bytes` is full or the reader runs out, returns how many
+/// bytes were read.
+inline Res<usize> readFull(Readable auto& reader, MutBytes bytes) {
+    usize n = 0;
+    while (n < bytes.len()) {
+        auto read = try$(reader.read(mutNext(bytes, n)));
+        if (read == 0)
+            break;
+        n += read;
+    }
+    return Ok(n);
+}
+
 inline Res<String> readAllUtf8(Readable auto& reader) {
     StringWriter writer;
     Array<Utf8::Unit, 512> buf;
@@ -219,6 +219,15 @@ struct _StringWriter :
         return Ok(E::runeLen(rune));
     }
 
+    Res<usize> writeUtf8(Str str) override {
+        if constexpr (Meta::Same<E, Utf8>) {
+            _StringBuilder<E>::append(str);
+            return Ok(str.len());
+        } else {
+            return TextWriter::writeUtf8(str);
+        }
+    }
+
     Res<usize> writeUnit(Slice<typename E::Unit> unit) {
         _StringBuilder<E>::append(unit);
         return Ok(unit.len());
@@ -69,6 +69,81 @@ test$("fmt-signed-number") {
     return Ok();
 }
 
+test$("fmt-number-limits") {
+    try$(testCase("-9223372036854775808", (isize)(-9223372036854775807 - 1)));
+    try$(testCase("18446744073709551615", (usize)-1));
+    try$(testCase("ffffffffffffffff", (usize)-1, "x"));
+    try$(testCase("0b101", 5u, "#b"));
+    try$(testCase("0o17", 15u, "#o"));
+    return Ok();
+}
+
+// MARK: Float Formatting ------------------------------------------------------
+
+static String _zeros(Str before, usize n, Str after) {
+    StringBuilder sb;
+    sb.append(before);
+    for (usize i = 0; i < n; i++)
+        sb.append('0');
+    sb.append(after);
+    return sb.take();
+}
+
+test$("fmt-float") {
+    try$(testCase("0", 0.0));
+    try$(testCase("1", 1.0));
+    try$(testCase("-3", -3.0));
+    try$(testCase("0.1", 0.1));
+    try$(testCase("-0.25", -0.25));
+    try$(testCase("123.456", 123.456));
+    try$(testCase("100000000000000000000", 1e20));
+    try$(testCase("0.000001", 1e-6));
+    return Ok();
+}
+
+// NOTE: Numbers are never written with an exponent, PDF, CSS and SVG
+//       can't read them back.
+test$("fmt-float-no-exponent") {
+    try$(testCase("1000000000000000000000", 1e21));
+    try$(testCase("0.0000001", 1e-7));
+    try$(testCase("-0.00000000015", -1.5e-10));
+    try$(testCase(_zeros("0.", 323, "5"), 5e-324));
+    try$(testCase(_zeros("17976931348623157", 292, ""), 1.7976931348623157e308));
+    try$(testCase(_zeros("-0.", 44, "1"), -1e-45f));
+    try$(testCase("340282350000000000000000000000000000000", 3.4028235e38f));
+    return Ok();
+}
+
+test$("fmt-float-single") {
+    try$(testCase("0.1", 0.1f));
+    try$(testCase("3.14159", 3.14159f));
+    return Ok();
+}
+
+// MARK: Format Strings --------------------------------------------------------
+
+test$("fmt-format-string") {
+    expectEq$(try$(Io::format("a{}b{x}c", 1, 255u)), "a1bffc"s);
+    expectEq$(try$(Io::format("{#x} {04}", 255u, 7)), "0xff 0007"s);
+    expectEq$(try$(Io::format("{:x}", 255u)), "ff"s);
+    expectEq$(try$(Io::format("{}}", 1)), "1}"s);
+    expectEq$(try$(Io::format("{}", "test"s)), "test"s);
+    expectEq$(try$(Io::format("no placeholders")), "no placeholders"s);
+    return Ok();
+}
+
+test$("fmt-format-string-specs") {
+    // NOTE: Integer specs are parsed along with the format string, the
+    //       others when formatting, both have to agree.
+    expectEq$(try$(Io::format("{x} {x}", 123uz, Opt<usize>{123})), "7b 7b"s);
+    expectEq$(try$(Io::format("{#b} {c} {08}", 5u, (Rune)'a', -42)), "0b101 a -00000042"s);
+    expectEq$(try$(Io::format("{p}", 255uz)), "0x00000000000000ff"s);
+    expectEq$(try$(Io::format("{} {}", true, 1.5)), "True 1.5"s);
+    return Ok();
+}
+
+// MARK: Enum Formatting -------------------------------------------------------
+
 enum struct MyEnum {
     BAR,
     BAZ,
@@ -79,6 +79,22 @@ struct TextWriter :
 
     template <StaticEncoding E>
     Res<usize> writeStr(_Str<E> str) {
+        if constexpr (Meta::Same<E, Utf8>) {
+            return writeUtf8(str);
+        } else {
+            usize written = 0;
+            for (auto rune : iterRunes(str)) {
+                written += try$(writeRune(rune));
+            }
+            return Ok(written);
+        }
+    }
+
+    virtual Res<usize> writeRune(Rune rune) = 0;
+
+    // Writers that can take UTF-8 text in one go override this instead of
+    // receiving it rune by rune.
+    virtual Res<usize> writeUtf8(Str str) {
         usize written = 0;
         for (auto rune : iterRunes(str)) {
             written += try$(writeRune(rune));
@@ -86,8 +102,6 @@ struct TextWriter :
         return Ok(written);
     }
 
-    virtual Res<usize> writeRune(Rune rune) = 0;
-
     Res<usize> flush() override {
         return Ok(0uz);
     }
@@ -106,6 +120,13 @@ struct TextWriterBase :
         }
         return write(bytes(one));
     }
+
+    Res<usize> writeUtf8(Str str) override {
+        if constexpr (Meta::Same<E, Utf8>)
+            return write(bytes(str));
+        else
+            return TextWriter::writeUtf8(str);
+    }
 };
 
 template <StaticEncoding E = typename Sys::Encoding>
@@ -22,7 +22,7 @@ struct Resizable : public Ui::ProxyNode<Resizable> {
         if (auto de = e.is<Ui::DragEvent>()) {
             if (de->type == Ui::DragEvent::DRAG) {
                 _size = _size + de->delta;
-                auto minSize = child().size({}, Ui::Hint::MIN);
+                auto minSize = child().measure({}, Ui::Hint::MIN);
                 _size = _size.max(minSize);
                 if (_onChange) {
                     _onChange(*this, _size);
@@ -38,7 +38,7 @@ struct Resizable : public Ui::ProxyNode<Resizable> {
 
     Math::Vec2i size(Math::Vec2i s, Ui::Hint hint) override {
         return child()
-            .size(s, hint)
+            .measure(s, hint)
             .max(_size);
     }
 };
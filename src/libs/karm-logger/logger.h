@@ -14,19 +14,23 @@ struct Level {
     Cli::Style style;
 };
 
-struct Format {
-    Str str;
+template <typename... Ts>
+struct _Format {
+    Io::_Fmt<Ts...> fmt;
     Loc loc;
 
-    Format(char const* str, Loc loc = Loc::current())
-        : str(str), loc(loc) {
+    consteval _Format(char const* str, Loc loc = Loc::current())
+        : fmt(str), loc(loc) {
     }
 
-    Format(Str str, Loc loc = Loc::current())
-        : str(str), loc(loc) {
+    consteval _Format(Str str, Loc loc = Loc::current())
+        : fmt(str), loc(loc) {
     }
 };
 
+template <typename... Ts>
+using Format = _Format<Meta::RemoveConstVolatileRef<Ts>...>;
+
 static constexpr Level PRINT = {-2, "print", Cli::BLUE};
 static constexpr Level YAP = {-1, "yappin'", Cli::GREEN};
 static constexpr Level DEBUG = {0, "debug", Cli::BLUE};
@@ -42,16 +46,18 @@ inline void _catch(Res<usize> res) {
     panic(res.none().msg());
 }
 
-inline void _log(Level level, Format fmt, Io::_Args& args) {
+inline void _logBegin(Level level, Loc loc) {
     Logger::_Embed::loggerLock();
 
     if (level.value != -2) {
         _catch(Io::format(Logger::_Embed::loggerOut(), "{} ", Cli::styled(level.name, level.style)));
-        _catch(Io::format(Logger::_Embed::loggerOut(), "{}{}:{}: ", Cli::reset().fg(Cli::GRAY_DARK), fmt.loc.file, fmt.loc.line));
+        _catch(Io::format(Logger::_Embed::loggerOut(), "{}{}:{}: ", Cli::reset().fg(Cli::GRAY_DARK), loc.file, loc.line));
     }
 
     _catch(Io::format(Logger::_Embed::loggerOut(), "{}", Cli::reset()));
-    _catch(Io::_format(Logger::_Embed::loggerOut(), fmt.str, args));
+}
+
+inline void _logEnd() {
     _catch(Io::format(Logger::_Embed::loggerOut(), "{}\n", Cli::reset()));
     _catch(Logger::_Embed::loggerOut().flush());
 
@@ -59,75 +65,75 @@ inline void _log(Level level, Format fmt, Io::_Args& args) {
 }
 
 template <typename... Args>
-inline void logPrint(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(PRINT, format, args);
+inline void _log(Level level, Loc loc, Io::Fmt<Args...> fmt, Args&&... va) {
+    _logBegin(level, loc);
+    _catch(Io::format(Logger::_Embed::loggerOut(), fmt, std::forward<Args>(va)...));
+    _logEnd();
+}
+
+template <typename... Args>
+inline void logPrint(Format<Args...> format, Args&&... va) {
+    _log(PRINT, format.loc, format.fmt, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logPrintIf(bool condition, Format format, Args&&... va) {
+inline void logPrintIf(bool condition, Format<Args...> format, Args&&... va) {
     if (condition)
         logPrint(format, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logDebug(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(DEBUG, format, args);
+inline void logDebug(Format<Args...> format, Args&&... va) {
+    _log(DEBUG, format.loc, format.fmt, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logDebugIf(bool condition, Format format, Args&&... va) {
+inline void logDebugIf(bool condition, Format<Args...> format, Args&&... va) {
     if (condition)
         logDebug(format, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logInfo(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(INFO, format, args);
+inline void logInfo(Format<Args...> format, Args&&... va) {
+    _log(INFO, format.loc, format.fmt, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logInfoIf(bool condition, Format format, Args&&... va) {
+inline void logInfoIf(bool condition, Format<Args...> format, Args&&... va) {
     if (condition)
         logInfo(format, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void yap(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(YAP, format, args);
+inline void yap(Format<Args...> format, Args&&... va) {
+    _log(YAP, format.loc, format.fmt, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logWarn(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(WARNING, format, args);
+inline void logWarn(Format<Args...> format, Args&&... va) {
+    _log(WARNING, format.loc, format.fmt, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logWarnIf(bool condition, Format format, Args&&... va) {
+inline void logWarnIf(bool condition, Format<Args...> format, Args&&... va) {
     if (condition)
         logWarn(format, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logError(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(ERROR, format, args);
+inline void logError(Format<Args...> format, Args&&... va) {
+    _log(ERROR, format.loc, format.fmt, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-inline void logErrorIf(bool condition, Format format, Args&&... va) {
+inline void logErrorIf(bool condition, Format<Args...> format, Args&&... va) {
     if (condition)
         logError(format, std::forward<Args>(va)...);
 }
 
 template <typename... Args>
-[[noreturn]] inline void logFatal(Format format, Args&&... va) {
-    Io::Args<Args...> args{std::forward<Args>(va)...};
-    _log(FATAL, format, args);
+[[noreturn]] inline void logFatal(Format<Args...> format, Args&&... va) {
+    _log(FATAL, format.loc, format.fmt, std::forward<Args>(va)...);
     panic("fatal error occured, see logs");
 }
 
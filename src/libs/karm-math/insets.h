@@ -26,6 +26,8 @@ struct Insets {
     constexpr Insets(T top, T end, T bottom, T start)
         : start(start), top(top), end(end), bottom(bottom) {}
 
+    constexpr bool operator==(Insets const&) const = default;
+
     constexpr bool zero() const {
         return start == T{} and top == T{} and end == T{} and bottom == T{};
     }
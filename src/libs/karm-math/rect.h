@@ -234,6 +234,13 @@ union Rect {
         return _els[i];
     }
 
+    always_inline constexpr bool operator==(Rect const& other) const {
+        return x == other.x and
+               y == other.y and
+               width == other.width and
+               height == other.height;
+    }
+
     template <typename U>
     always_inline constexpr Rect<U> cast() const {
         return {
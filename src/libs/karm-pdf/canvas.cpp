@@ -1,4 +1,5 @@
 #include <karm-logger/logger.h>
+#include <karm-text/prose.h>
 
 #include "canvas.h"
 
@@ -148,6 +149,89 @@ void Canvas::apply(Gfx::Filter) {
     logDebugIf(DEBUG_CANVAS, "pdf: apply() operation not implemented");
 };
 
+// MARK: Text Operations ---------------------------------------------------
+
+void Canvas::fill(Text::Font& font, Text::Glyph glyph, Math::Vec2f baseline) {
+    auto res = _resources ? _resources->font(font.fontface) : nullptr;
+    if (not res) {
+        Gfx::Canvas::fill(font, glyph, baseline);
+        return;
+    }
+
+    res->use(glyph, {});
+
+    // NOTE: The text matrix flips the glyphs back up, the page is upside
+    //       down, see PdfPrinter::beginPage().
+    _e.ln("BT /{} {} Tf 1 0 0 -1 {} {} Tm <{:04x}> Tj ET", res->name.str(), font.fontsize, baseline.x, baseline.y, glyph.index);
+}
+
+void Canvas::fill(Text::Prose& prose) {
+    auto& font = prose._style.font;
+    auto res = _resources ? _resources->font(font.fontface) : nullptr;
+    if (not res) {
+        Gfx::Canvas::fill(prose);
+        return;
+    }
+
+    push();
+
+    if (prose._style.color)
+        fillStyle(*prose._style.color);
+
+    // NOTE: Every line is shown as a single TJ array, split only where spans
+    //       change the color. Glyphs are moved to where the prose placed
+    //       them by adjusting the position the viewer would have put them.
+    for (auto const& line : prose._lines) {
+        bool inRun = false;
+        Opt<Gfx::Color> runColor = NONE;
+        f64 expected = 0;
+
+        auto endRun = [&] {
+            _e.ln(">] TJ ET");
+            if (runColor)
+                pop();
+            inRun = false;
+        };
+
+        for (auto const& block : line.blocks()) {
+            for (auto const& cell : block.cells()) {
+                Opt<Gfx::Color> color = cell.span ? cell.span->color : NONE;
+                f64 x = block.pos + cell.pos;
+
+                if (inRun and color != runColor)
+                    endRun();
+
+                if (not inRun) {
+                    runColor = color;
+                    if (runColor) {
+                        push();
+                        fillStyle(*runColor);
+                    }
+                    _e("BT /{} {} Tf 1 0 0 -1 {} {} Tm [<", res->name.str(), font.fontsize, x, line.baseline);
+                    expected = x;
+                    inRun = true;
+                } else {
+                    f64 delta = (expected - x) * 1000 / font.fontsize;
+                    isize adjust = delta < 0 ? delta - 0.5 : delta + 0.5;
+                    if (adjust != 0) {
+                        _e("> {} <", adjust);
+                        expected -= adjust * font.fontsize / 1000;
+                    }
+                }
+
+                _e("{:04x}", cell.glyph.index);
+                res->use(cell.glyph, cell.runes());
+                expected += res->width(cell.glyph) * font.fontsize / 1000;
+            }
+        }
+
+        if (inRun)
+            endRun();
+    }
+
+    pop();
+}
+
 // MARK: Clear Operations --------------------------------------------------
 
 void Canvas::clear(Gfx::Color) {
@@ -174,8 +258,20 @@ void Canvas::plot(Math::Recti, Gfx::Color) {
 
 // MARK: Blit Operations ---------------------------------------------------
 
-void Canvas::blit(Math::Recti, Math::Recti, Gfx::Pixels) {
-    logDebugIf(DEBUG_CANVAS, "pdf: blit() operation not implemented");
+void Canvas::blit(Math::Recti src, Math::Recti dest, Gfx::Pixels pixels) {
+    if (not _resources) {
+        logDebugIf(DEBUG_CANVAS, "pdf: blit() without resources not implemented");
+        return;
+    }
+
+    auto& name = _resources->image(pixels.clip(src));
+
+    // NOTE: Images are drawn in the unit square, with their first row at
+    //       the top, which is y = 1 since the page is upside down.
+    push();
+    transform({(f64)dest.width, 0, 0, (f64)-dest.height, (f64)dest.x, (f64)(dest.y + dest.height)});
+    _e.ln("/{} Do", name.str());
+    pop();
 }
 
 } // namespace Karm::Pdf
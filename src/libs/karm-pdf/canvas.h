@@ -4,15 +4,18 @@
 #include <karm-io/emit.h>
 #include <karm-io/impls.h>
 
+#include "resources.h"
+
 namespace Karm::Pdf {
 
 struct Canvas : public Gfx::Canvas {
     Io::Emit _e;
     Math::Vec2f _mediaBox{};
     Math::Vec2f _p{};
+    MutCursor<Resources> _resources = nullptr;
 
-    Canvas(Io::Emit e, Math::Vec2f mediaBox)
-        : _e{e}, _mediaBox{mediaBox} {}
+    Canvas(Io::Emit e, Math::Vec2f mediaBox, MutCursor<Resources> resources = nullptr)
+        : _e{e}, _mediaBox{mediaBox}, _resources{resources} {}
 
     Math::Vec2f _mapPoint(Math::Vec2f p, Math::Path::Flags flags) {
         if (flags & Math::Path::RELATIVE)
@@ -81,6 +84,12 @@ struct Canvas : public Gfx::Canvas {
 
     void apply(Gfx::Filter filter) override;
 
+    // MARK: Text Operations ---------------------------------------------------
+
+    void fill(Text::Font& font, Text::Glyph glyph, Math::Vec2f baseline) override;
+
+    void fill(Text::Prose& prose) override;
+
     // MARK: Clear Operations --------------------------------------------------
 
     void clear(Gfx::Color color) override;
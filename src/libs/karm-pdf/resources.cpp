@@ -0,0 +1,328 @@
+#include <karm-crypto/crc32.h>
+#include <karm-io/impls.h>
+#include <karm-logger/logger.h>
+#include <karm-text/ttf/subset.h>
+
+#include "resources.h"
+
+namespace Karm::Pdf {
+
+// MARK: Font ------------------------------------------------------------------
+
+void FontResource::use(Text::Glyph glyph, Slice<Rune> runes) {
+    if (glyph.index >= used.len()) {
+        used.resize(glyph.index + 1, false);
+        unicodes.resize(glyph.index + 1);
+    }
+
+    if (used[glyph.index])
+        return;
+
+    used[glyph.index] = true;
+    unicodes[glyph.index] = runes;
+}
+
+isize FontResource::width(Text::Glyph glyph) const {
+    return face->_parser.glyphMetrics(glyph).advance * 1000 / face->_parser.unitPerEm();
+}
+
+static String _fontName(FontResource const& font) {
+    StringBuilder sb;
+    auto family = font.face->attrs().family;
+    for (auto r : iterRunes(family.str()))
+        if (isAsciiAlphaNum(r))
+            sb.append(r);
+    return sb.take();
+}
+
+// NOTE: Subset fonts are named after the font they come from, prefixed by a
+//       tag made of six uppercase letters.
+//       See ISO 32000-2:2020, 9.9.2 "Font subsets"
+static String _subsetName(FontResource const& font, Slice<u16> glyphs) {
+    u32 hash = Crypto::crc32(bytes(glyphs));
+
+    StringBuilder sb;
+    for (usize i = 0; i < 6; i++) {
+        sb.append((Rune)('A' + hash % 26));
+        hash /= 26;
+    }
+    sb.append('+');
+    sb.append(_fontName(font));
+
+    return sb.take();
+}
+
+// https://adobe-type-tools.github.io/font-tech-notes/pdfs/5411.ToUnicode.pdf
+static Buf<Byte> _toUnicode(FontResource const& font) {
+    Io::StringWriter sw;
+    Io::Emit e{sw};
+
+    e.ln("/CIDInit /ProcSet findresource begin");
+    e.ln("12 dict begin");
+    e.ln("begincmap");
+    e.ln("/CIDSystemInfo << /Registry (Adobe) /Ordering (UCS) /Supplement 0 >> def");
+    e.ln("/CMapName /Adobe-Identity-UCS def");
+    e.ln("/CMapType 2 def");
+    e.ln("1 begincodespacerange");
+    e.ln("<0000> <FFFF>");
+    e.ln("endcodespacerange");
+
+    Vec<usize> mapped;
+    for (usize i = 0; i < font.used.len(); i++)
+        if (font.used[i] and font.unicodes[i].len())
+            mapped.pushBack(i);
+
+    // NOTE: A bfchar section can't have more than 100 entries.
+    for (usize i = 0; i < mapped.len(); i += 100) {
+        auto chunk = sub(mapped, i, min(i + 100, mapped.len()));
+        e.ln("{} beginbfchar", chunk.len());
+        for (auto glyph : chunk) {
+            e("<{:04x}> <", glyph);
+            for (auto r : font.unicodes[glyph]) {
+                Utf16::One one;
+                if (not Utf16::encodeUnit(r, one))
+                    continue;
+                for (auto unit : iter(one))
+                    e("{:04x}", unit);
+            }
+            e.ln(">");
+        }
+        e.ln("endbfchar");
+    }
+
+    e.ln("endcmap");
+    e.ln("CMapName currentdict /CMap defineresource pop");
+    e.ln("end");
+    e.ln("end");
+    (void)e.flush();
+
+    return sw.bytes();
+}
+
+Ref FontResource::write(File& file, Ref& alloc) const {
+    Vec<u16> glyphs;
+    for (usize i = 0; i < used.len(); i++)
+        if (used[i])
+            glyphs.pushBack(i);
+
+    auto& parser = face->_parser;
+    auto unitPerEm = parser.unitPerEm();
+    auto scale = [&](isize v) -> isize {
+        return v * 1000 / (isize)unitPerEm;
+    };
+
+    Ref fontRef = alloc.alloc();
+    Ref cidFontRef = alloc.alloc();
+    Ref descriptorRef = alloc.alloc();
+    Ref fontFileRef = alloc.alloc();
+    Ref toUnicodeRef = alloc.alloc();
+
+    // NOTE: A font that can't be subset is embedded whole, under its own
+    //       name, rather than failing the whole document.
+    Buf<Byte> fontFile;
+    Name baseFont;
+    if (auto res = Ttf::subset(parser, glyphs)) {
+        fontFile = res.take();
+        baseFont = Name{_subsetName(*this, glyphs)};
+    } else {
+        logWarn("pdf: could not subset font '{}', embedding it whole: {}", face->attrs().family, res.none().msg());
+        fontFile = Buf<Byte>{parser._slice};
+        baseFont = Name{_fontName(*this)};
+    }
+
+    auto fontFileLen = fontFile.len();
+    file.add(
+        fontFileRef,
+        Stream::deflate(
+            Dict{
+                {"Length1"s, fontFileLen},
+            },
+            fontFile
+        )
+    );
+
+    auto bbox = parser._head.begin().skip(36);
+    auto xMin = bbox.nextI16be();
+    auto yMin = bbox.nextI16be();
+    auto xMax = bbox.nextI16be();
+    auto yMax = bbox.nextI16be();
+    auto metrics = face->metrics();
+
+    file.add(
+        descriptorRef,
+        Dict{
+            {"Type"s, Name{"FontDescriptor"s}},
+            {"FontName"s, baseFont},
+            {"Flags"s, usize{4}}, // Symbolic
+            {"FontBBox"s,
+             Array{
+                 scale(xMin),
+                 scale(yMin),
+                 scale(xMax),
+                 scale(yMax),
+             }},
+            {"ItalicAngle"s, isize{0}},
+            {"Ascent"s, (isize)(metrics.ascend * 1000)},
+            {"Descent"s, (isize)(-metrics.descend * 1000)},
+            {"CapHeight"s, (isize)(metrics.captop * 1000)},
+            {"StemV"s, isize{80}},
+            {"FontFile2"s, fontFileRef},
+        }
+    );
+
+    Array widths;
+    for (auto glyph : glyphs) {
+        widths.pushBack(usize{glyph});
+        widths.pushBack(Array{
+            width({glyph, 0}),
+        });
+    }
+
+    file.add(
+        cidFontRef,
+        Dict{
+            {"Type"s, Name{"Font"s}},
+            {"Subtype"s, Name{"CIDFontType2"s}},
+            {"BaseFont"s, baseFont},
+            {"CIDSystemInfo"s,
+             Dict{
+                 {"Registry"s, String{"Adobe"s}},
+                 {"Ordering"s, String{"Identity"s}},
+                 {"Supplement"s, isize{0}},
+             }},
+            {"FontDescriptor"s, descriptorRef},
+            {"W"s, std::move(widths)},
+            {"CIDToGIDMap"s, Name{"Identity"s}},
+        }
+    );
+
+    file.add(
+        toUnicodeRef,
+        Stream::deflate({}, _toUnicode(*this))
+    );
+
+    file.add(
+        fontRef,
+        Dict{
+            {"Type"s, Name{"Font"s}},
+            {"Subtype"s, Name{"Type0"s}},
+            {"BaseFont"s, baseFont},
+            {"Encoding"s, Name{"Identity-H"s}},
+            {"DescendantFonts"s, Array{cidFontRef}},
+            {"ToUnicode"s, toUnicodeRef},
+        }
+    );
+
+    return fontRef;
+}
+
+// MARK: Image -----------------------------------------------------------------
+
+Ref ImageResource::write(File& file, Ref& alloc) const {
+    Ref imageRef = alloc.alloc();
+
+    Dict dict = {
+        {"Type"s, Name{"XObject"s}},
+        {"Subtype"s, Name{"Image"s}},
+        {"Width"s, (usize)size.x},
+        {"Height"s, (usize)size.y},
+        {"ColorSpace"s, Name{"DeviceRGB"s}},
+        {"BitsPerComponent"s, usize{8}},
+    };
+
+    if (alpha) {
+        Ref maskRef = alloc.alloc();
+        file.add(
+            maskRef,
+            Stream::deflate(
+                Dict{
+                    {"Type"s, Name{"XObject"s}},
+                    {"Subtype"s, Name{"Image"s}},
+                    {"Width"s, (usize)size.x},
+                    {"Height"s, (usize)size.y},
+                    {"ColorSpace"s, Name{"DeviceGray"s}},
+                    {"BitsPerComponent"s, usize{8}},
+                },
+                *alpha
+            )
+        );
+        dict.put("SMask"s, maskRef);
+    }
+
+    file.add(imageRef, Stream::deflate(std::move(dict), rgb));
+    return imageRef;
+}
+
+// MARK: Resources -------------------------------------------------------------
+
+MutCursor<FontResource> Resources::font(Rc<Text::Fontface> fontface) {
+    for (auto& font : fonts) {
+        if (&*font.face == &*fontface)
+            return &font;
+    }
+
+    auto ttf = fontface.cast<Text::TtfFontface>();
+    if (not ttf)
+        return nullptr;
+
+    return &fonts.emplaceBack(
+        Name{Io::format("F{}", fonts.len()).unwrap()},
+        ttf.take()
+    );
+}
+
+Name const& Resources::image(Gfx::Pixels pixels) {
+    Io::BufferWriter rgb{(usize)(pixels.width() * pixels.height() * 3)};
+    Io::BufferWriter alpha{(usize)(pixels.width() * pixels.height())};
+    bool opaque = true;
+
+    for (isize y = 0; y < pixels.height(); y++) {
+        for (isize x = 0; x < pixels.width(); x++) {
+            auto c = pixels.load({x, y});
+            Karm::Array<u8, 3> px = {c.red, c.green, c.blue};
+            (void)rgb.write(px);
+            (void)alpha.write(Bytes{&c.alpha, 1});
+            opaque = opaque and c.alpha == 0xff;
+        }
+    }
+
+    u32 hash = Crypto::crc32(rgb.bytes());
+    if (not opaque)
+        hash = Crypto::crc32(alpha.bytes(), hash);
+
+    for (auto& image : images) {
+        if (image.hash == hash and
+            image.size == pixels.size() and
+            image.alpha.has() == not opaque and
+            image.rgb == rgb.bytes() and
+            (opaque or *image.alpha == alpha.bytes()))
+            return image.name;
+    }
+
+    auto& image = images.emplaceBack(
+        Name{Io::format("I{}", images.len()).unwrap()},
+        pixels.size(),
+        hash,
+        rgb.take()
+    );
+    if (not opaque)
+        image.alpha = alpha.take();
+    return image.name;
+}
+
+Dict Resources::write(File& file, Ref& alloc) const {
+    Dict fontDict;
+    for (auto& font : fonts)
+        fontDict.put(font.name, font.write(file, alloc));
+
+    Dict xObjectDict;
+    for (auto& image : images)
+        xObjectDict.put(image.name, image.write(file, alloc));
+
+    return {
+        {"Font"s, std::move(fontDict)},
+        {"XObject"s, std::move(xObjectDict)},
+    };
+}
+
+} // namespace Karm::Pdf
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <karm-gfx/buffer.h>
+#include <karm-text/ttf.h>
+
+#include "values.h"
+
+namespace Karm::Pdf {
+
+// MARK: Font ------------------------------------------------------------------
+
+// A TrueType font embedded as a CID font, with only the glyphs that were
+// used. Glyph ids are used as character codes (Identity-H).
+struct FontResource {
+    Name name;
+    Rc<Text::TtfFontface> face;
+    Vec<bool> used;
+    Vec<Vec<Rune>> unicodes; // Text of each glyph, for the ToUnicode map
+
+    void use(Text::Glyph glyph, Slice<Rune> runes);
+
+    // Advance of the glyph in thousandths of an em, as the viewer sees it.
+    isize width(Text::Glyph glyph) const;
+
+    Ref write(File& file, Ref& alloc) const;
+};
+
+// MARK: Image -----------------------------------------------------------------
+
+// Pixels drawn with Canvas::blit(), shared by every page drawing the same
+// pixels again.
+struct ImageResource {
+    Name name;
+    Math::Vec2i size;
+    u32 hash;
+    Buf<Byte> rgb;
+    Opt<Buf<Byte>> alpha;
+
+    Ref write(File& file, Ref& alloc) const;
+};
+
+// MARK: Resources -------------------------------------------------------------
+
+// Fonts and images of a document, shared by all its pages.
+struct Resources {
+    Vec<FontResource> fonts;
+    Vec<ImageResource> images;
+
+    // Returns the font to draw text with, or nullptr if the fontface can't
+    // be embedded and its glyphs have to be drawn as paths.
+    MutCursor<FontResource> font(Rc<Text::Fontface> fontface);
+
+    // Returns the name of the image with these pixels, adding it if it's
+    // not there yet.
+    Name const& image(Gfx::Pixels pixels);
+
+    // Adds all the resources to the file and returns the resource
+    // dictionary referring to them.
+    Dict write(File& file, Ref& alloc) const;
+};
+
+} // namespace Karm::Pdf
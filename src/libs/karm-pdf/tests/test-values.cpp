@@ -0,0 +1,63 @@
+#include <karm-archive/zlib/decoder.h>
+#include <karm-io/emit.h>
+#include <karm-io/fmt.h>
+#include <karm-pdf/values.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Pdf::Tests {
+
+// A content stream as the canvas emits them, repetitive enough to shrink.
+static String _content() {
+    Io::StringWriter sw;
+    for (usize i = 0; i < 64; i++)
+        (void)Io::format(sw, "BT /F1 12 Tf 72 {} Td (Line {}) Tj ET\n", 72 + i * 10, i);
+    return sw.take();
+}
+
+test$("pdf-stream-deflate") {
+    auto content = _content();
+
+    Dict dict;
+    dict.put("Subtype"s, Name{"Form"s});
+
+    auto stream = Stream::deflate(std::move(dict), bytes(content));
+
+    expectEq$(stream.dict.get("Filter"s).unwrap<Name>(), "FlateDecode"s);
+    expectEq$(stream.dict.get("Length"s).unwrap<usize>(), stream.data.len());
+    expectEq$(stream.dict.get("Subtype"s).unwrap<Name>(), "Form"s);
+    expectLt$(stream.data.len(), content.len());
+
+    auto decoded = try$(Zlib::decode(stream.data));
+    expect$(Bytes{decoded} == bytes(content));
+
+    return Ok();
+}
+
+test$("pdf-stream-deflate-empty") {
+    auto stream = Stream::deflate({}, Bytes{});
+
+    expectEq$(stream.dict.get("Length"s).unwrap<usize>(), stream.data.len());
+
+    auto decoded = try$(Zlib::decode(stream.data));
+    expectEq$(decoded.len(), 0uz);
+
+    return Ok();
+}
+
+static String _write(Value const& value) {
+    Io::StringWriter sw;
+    Io::Emit e{sw};
+    value.write(e);
+    return sw.take();
+}
+
+test$("pdf-value-real") {
+    // NOTE: PDF numbers can't have an exponent.
+    expectEq$(_write(0.5), "0.5"s);
+    expectEq$(_write(1e-7), "0.0000001"s);
+    expectEq$(_write(-2.5e-9), "-0.0000000025"s);
+    expectEq$(_write(1e21), "1000000000000000000000"s);
+    return Ok();
+}
+
+} // namespace Karm::Pdf::Tests
@@ -1,7 +1,22 @@
+#include <karm-archive/zlib/encoder.h>
+#include <karm-io/impls.h>
+
 #include "values.h"
 
 namespace Karm::Pdf {
 
+Stream Stream::deflate(Dict dict, Bytes data) {
+    Io::BufferWriter buf;
+    if (not Zlib::encode(data, buf)) {
+        dict.put("Length"s, data.len());
+        return {std::move(dict), data};
+    }
+
+    dict.put("Filter"s, Name{"FlateDecode"s});
+    dict.put("Length"s, buf.bytes().len());
+    return {std::move(dict), buf.take()};
+}
+
 void Value::write(Io::Emit& e) const {
     visit(Visitor{
         [&](None) {
@@ -61,7 +76,7 @@ void Value::write(Io::Emit& e) const {
 
 void File::write(Io::Emit& e) const {
     e("%{}\n", header);
-    e("%Powered By Karm PDF 🐢🏳️‍⚧️🦔\n", header);
+    e("%Powered By Karm PDF 🐢🏳️‍⚧️🦔\n");
 
     XRef xref;
 
@@ -30,6 +30,10 @@ using Dict = Map<Name, Value>;
 struct Stream {
     Dict dict;
     Buf<Byte> data;
+
+    // Compresses the data with FlateDecode, the Filter and Length entries
+    // are added to the dictionary.
+    static Stream deflate(Dict dict, Bytes data);
 };
 
 using _Value = Union<
@@ -15,10 +15,11 @@ struct PdfPage {
 struct PdfPrinter : public FilePrinter {
     Vec<PdfPage> _pages;
     Opt<Pdf::Canvas> _canvas;
+    Pdf::Resources _resources;
 
     Gfx::Canvas& beginPage(PaperStock paper) override {
         auto& page = _pages.emplaceBack(paper);
-        _canvas = Pdf::Canvas{page.data, paper.size()};
+        _canvas = Pdf::Canvas{page.data, paper.size(), &_resources};
 
         // NOTE: PDF has the coordinate system origin at the bottom left corner.
         //       But we want to have it at the top left corner.
@@ -38,6 +39,11 @@ struct PdfPrinter : public FilePrinter {
         Pdf::Array pagesKids;
         Pdf::Ref pagesRef = alloc.alloc();
 
+        // NOTE: Fonts and images are shared by all the pages, so are the
+        //       resources referring to them.
+        Pdf::Ref resourcesRef = alloc.alloc();
+        file.add(resourcesRef, _resources.write(file, alloc));
+
         // Page
         for (auto& p : _pages) {
             Pdf::Ref pageRef = alloc.alloc();
@@ -59,17 +65,13 @@ struct PdfPrinter : public FilePrinter {
                         "Contents"s,
                         contentsRef,
                     },
+                    {"Resources"s, resourcesRef},
                 }
             );
 
             file.add(
                 contentsRef,
-                Pdf::Stream{
-                    .dict = Pdf::Dict{
-                        {"Length"s, p.data.bytes().len()},
-                    },
-                    .data = p.data.bytes(),
-                }
+                Pdf::Stream::deflate({}, p.data.bytes())
             );
 
             pagesKids.pushBack(pageRef);
@@ -22,7 +22,11 @@ struct Image : public Node {
         if (not r.colide(bound()))
             return;
 
-        ctx.blit(_bound.cast<isize>(), _picture.pixels());
+        auto bound = _bound.cast<isize>();
+        if (auto size = ctx.deviceSize(bound))
+            ctx.blit(bound, _picture.scaled(*size)->pixels());
+        else
+            ctx.blit(bound, _picture.pixels());
     }
 
     void repr(Io::Emit& e) const override {
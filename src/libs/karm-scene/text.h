@@ -7,28 +7,51 @@
 namespace Karm::Scene {
 
 struct Text : public Node {
-    Math::Vec2f _origin;
-    Rc<Karm::Text::Prose> _prose;
+    struct Run {
+        Math::Vec2f origin;
+        Rc<Karm::Text::Prose> prose;
+
+        Math::Rectf bound() const {
+            return {origin, prose->size()};
+        }
+    };
+
+    Vec<Run> _runs;
+    Math::Rectf _bound;
 
     Text(Math::Vec2f origin, Rc<Karm::Text::Prose> prose)
-        : _origin(origin), _prose(prose) {}
+        : _bound({origin, prose->size()}) {
+        _runs.pushBack({origin, prose});
+    }
+
+    /// Add another run of text, painted after the previous ones
+    void add(Math::Vec2f origin, Rc<Karm::Text::Prose> prose) {
+        Run run = {origin, prose};
+        _bound = _bound.mergeWith(run.bound());
+        _runs.pushBack(std::move(run));
+    }
 
     Math::Rectf bound() override {
-        return {_origin, _prose->size()};
+        return _bound;
     }
 
     void paint(Gfx::Canvas& g, Math::Rectf r, PaintOptions) override {
         if (not bound().colide(r))
             return;
 
-        g.push();
-        g.origin(_origin);
-        g.fill(*_prose);
-        g.pop();
+        for (auto& run : _runs) {
+            if (_runs.len() > 1 and not run.bound().colide(r))
+                continue;
+
+            g.push();
+            g.origin(run.origin);
+            g.fill(*run.prose);
+            g.pop();
+        }
     }
 
     void repr(Io::Emit& e) const override {
-        e("(text z:{} {})", zIndex, _origin);
+        e("(text z:{} {} runs:{})", zIndex, _bound, _runs.len());
     }
 };
 
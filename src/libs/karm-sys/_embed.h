@@ -1,5 +1,6 @@
 #pragma once
 
+#include <karm-base/func.h>
 #include <karm-base/range.h>
 #include <karm-base/time.h>
 #include <karm-base/tuple.h>
@@ -8,6 +9,7 @@
 #include "async.h"
 #include "dir.h"
 #include "fd.h"
+#include "watch.h"
 #include "info.h"
 #include "types.h"
 
@@ -15,6 +17,8 @@ namespace Karm::Sys {
 
 struct Intent;
 
+struct Thread;
+
 } // namespace Karm::Sys
 
 namespace Karm::Sys::_Embed {
@@ -39,7 +43,11 @@ Res<Rc<Sys::Fd>> createOut();
 
 Res<Rc<Sys::Fd>> createErr();
 
-Res<Vec<Sys::DirEntry>> readDir(Mime::Url const& url);
+Res<Vec<Sys::DirEntry>> readDir(Mime::Url const& url, bool withStat = false);
+
+Res<Rc<Sys::Fd>> watchDir(Mime::Url const& url);
+
+Res<Vec<Sys::DirChange>> decodeDirChanges(Bytes bytes);
 
 Res<Stat> stat(Mime::Url const& url);
 
@@ -97,6 +105,20 @@ Res<> sleepUntil(Instant);
 
 Res<> exit(i32);
 
+// MARK: Threads ---------------------------------------------------------------
+
+Res<Rc<Sys::Thread>> spawnThread(Func<void()> fn);
+
+usize concurrency();
+
+void parkLock();
+
+void parkUnlock();
+
+void park();
+
+void unparkAll();
+
 // MARK: Sandboxing ------------------------------------------------------------
 
 void hardenSandbox();
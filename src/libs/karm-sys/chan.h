@@ -67,22 +67,46 @@ Out& out();
 
 Err& err();
 
-inline void print(Str str = "", auto&&... args) {
-    (void)Io::format(out(), str, std::forward<decltype(args)>(args)...);
+inline void print(Str str = "") {
+    (void)out().writeStr(str);
 }
 
-inline void err(Str str = "", auto&&... args) {
-    (void)Io::format(err(), str, std::forward<decltype(args)>(args)...);
+template <typename... Args>
+inline void print(Io::Fmt<Args...> fmt, Args&&... args) {
+    (void)Io::format(out(), fmt, std::forward<Args>(args)...);
 }
 
-inline void println(Str str = "", auto&&... args) {
-    (void)Io::format(out(), str, std::forward<decltype(args)>(args)...);
+inline void err(Str str) {
+    (void)err().writeStr(str);
+}
+
+template <typename... Args>
+inline void err(Io::Fmt<Args...> fmt, Args&&... args) {
+    (void)Io::format(err(), fmt, std::forward<Args>(args)...);
+}
+
+inline void println(Str str = "") {
+    (void)out().writeStr(str);
+    (void)out().writeStr(Str{Sys::LINE_ENDING});
+    (void)out().flush();
+}
+
+template <typename... Args>
+inline void println(Io::Fmt<Args...> fmt, Args&&... args) {
+    (void)Io::format(out(), fmt, std::forward<Args>(args)...);
     (void)out().writeStr(Str{Sys::LINE_ENDING});
     (void)out().flush();
 }
 
-inline void errln(Str str = "", auto&&... args) {
-    (void)Io::format(err(), str, std::forward<decltype(args)>(args)...);
+inline void errln(Str str = "") {
+    (void)err().writeStr(str);
+    (void)err().writeStr(Str{Sys::LINE_ENDING});
+    (void)err().flush();
+}
+
+template <typename... Args>
+inline void errln(Io::Fmt<Args...> fmt, Args&&... args) {
+    (void)Io::format(err(), fmt, std::forward<Args>(args)...);
     (void)err().writeStr(Str{Sys::LINE_ENDING});
     (void)err().flush();
 }
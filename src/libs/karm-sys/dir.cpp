@@ -2,17 +2,102 @@
 
 #include "_embed.h"
 #include "proc.h"
+#include "thread.h"
 
 namespace Karm::Sys {
 
-Res<Dir> Dir::open(Mime::Url url) {
+static Res<Dir> _open(Mime::Url url, bool withStat) {
     try$(ensureUnrestricted());
 
-    auto entries = try$(_Embed::readDir(url));
+    auto entries = try$(_Embed::readDir(url, withStat));
     sort(entries, [](auto const& lhs, auto const& rhs) {
         return lhs.name <=> rhs.name;
     });
     return Ok(Dir{entries, url});
 }
 
+Res<Dir> Dir::open(Mime::Url url) {
+    return _open(url, false);
+}
+
+Res<Dir> Dir::openWithStat(Mime::Url url) {
+    return _open(url, true);
+}
+
+// MARK: Walk ------------------------------------------------------------------
+
+static void _walkLevel(Slice<Mime::Url> dirs, bool withStat, Vec<WalkEntry>& out) {
+    for (auto const& dir : dirs) {
+        auto entries = _Embed::readDir(dir, withStat);
+        if (not entries)
+            continue;
+        for (auto& entry : entries.unwrap())
+            out.pushBack({dir / entry.name, std::move(entry)});
+    }
+}
+
+Res<Vec<WalkEntry>> walk(Mime::Url url, bool withStat) {
+    try$(ensureUnrestricted());
+
+    Vec<WalkEntry> result;
+    for (auto& entry : try$(_Embed::readDir(url, withStat)))
+        result.pushBack({url / entry.name, std::move(entry)});
+
+    // NOTE: Each level is split between the workers, which only touch
+    //       their own slice and output, so they share nothing but the
+    //       list of directories to read.
+    usize levelStart = 0;
+    while (true) {
+        Vec<Mime::Url> dirs;
+        for (usize i = levelStart; i < result.len(); i++)
+            if (result[i].entry.type == Type::DIR)
+                dirs.pushBack(result[i].url);
+        levelStart = result.len();
+
+        if (not dirs.len())
+            break;
+
+        usize workers = clamp(dirs.len() / 8, 1uz, concurrency());
+        usize chunk = (dirs.len() + workers - 1) / workers;
+
+        Vec<Vec<WalkEntry>> outs;
+        outs.resize(workers);
+
+        Vec<Rc<Thread>> threads;
+        for (usize i = 1; i < workers; i++) {
+            auto start = min(i * chunk, dirs.len());
+            auto end = min(start + chunk, dirs.len());
+            auto slice = sub(dirs, start, end);
+            auto& out = outs[i];
+            auto thread = spawn([slice, withStat, &out] {
+                _walkLevel(slice, withStat, out);
+            });
+
+            // NOTE: If no thread can be spawned, the work is done here.
+            if (thread)
+                threads.pushBack(thread.take());
+            else
+                _walkLevel(slice, withStat, out);
+        }
+
+        _walkLevel(sub(dirs, 0, min(chunk, dirs.len())), withStat, outs[0]);
+
+        // NOTE: The workers write to outs, all of them have to be done
+        //       before it goes out of scope, even if one can't be joined.
+        Res<> joined = Ok();
+        for (auto& thread : threads) {
+            auto res = thread->join();
+            if (not res and joined)
+                joined = res;
+        }
+        try$(joined);
+
+        for (auto& out : outs)
+            for (auto& entry : out)
+                result.pushBack(std::move(entry));
+    }
+
+    return Ok(result);
+}
+
 } // namespace Karm::Sys
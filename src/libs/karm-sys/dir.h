@@ -12,6 +12,10 @@ struct DirEntry {
     String name;
     Type type;
 
+    // Metadata of the entry, only read when the directory was opened
+    // with Dir::openWithStat().
+    Opt<Stat> stat = NONE;
+
     bool hidden() const {
         return name[0] == '.';
     }
@@ -23,6 +27,10 @@ struct Dir {
 
     static Res<Dir> open(Mime::Url url);
 
+    /// Same as open(), but also reads the metadata of every entry while
+    /// the directory is open, rather than one stat() per entry afterward.
+    static Res<Dir> openWithStat(Mime::Url url);
+
     static Res<Dir> create(Mime::Url url);
 
     static Res<Dir> openOrCreate(Mime::Url url);
@@ -32,4 +40,14 @@ struct Dir {
     auto const& path() const { return _url; }
 };
 
+struct WalkEntry {
+    Mime::Url url;
+    DirEntry entry;
+};
+
+/// Lists everything below `url`, recursively, in breadth first order.
+/// The directories at the same depth are read in parallel. Directories
+/// that can't be read below `url` are skipped, and symlinks aren't followed.
+Res<Vec<WalkEntry>> walk(Mime::Url url, bool withStat = false);
+
 } // namespace Karm::Sys
@@ -0,0 +1,203 @@
+#include <karm-sys/dir.h>
+#include <karm-sys/pipe.h>
+#include <karm-sys/watch.h>
+#include <karm-test/macros.h>
+
+#ifdef __ck_sys_linux__
+#    include <sys/inotify.h>
+#endif
+
+namespace Karm::Sys::Tests {
+
+// NOTE: The tree has 16 directories side by side under wide/, enough for
+//       walk() to split that level between several workers.
+static Mime::Url _tree() {
+    return "bundle://karm-sys.tests/tree"_url;
+}
+
+test$("dir-open") {
+    auto dir = try$(Dir::open(_tree()));
+    auto const& entries = dir.entries();
+
+    expectEq$(entries.len(), 3uz);
+    expectEq$(entries[0].name, "hello.txt"s);
+    expect$(entries[0].type == Type::FILE);
+    expectEq$(entries[1].name, "sub"s);
+    expect$(entries[1].type == Type::DIR);
+    expectEq$(entries[2].name, "wide"s);
+    expect$(entries[2].type == Type::DIR);
+
+    for (auto const& entry : entries)
+        expect$(not entry.stat.has());
+
+    return Ok();
+}
+
+test$("dir-open-with-stat") {
+    auto dir = try$(Dir::openWithStat(_tree()));
+    auto const& entries = dir.entries();
+
+    expectEq$(entries.len(), 3uz);
+    for (auto const& entry : entries) {
+        expect$(entry.stat.has());
+        expect$(entry.stat->type == entry.type);
+    }
+    expectEq$(entries[0].stat->size, 5uz);
+
+    return Ok();
+}
+
+test$("dir-open-no-follow") {
+#ifdef __ck_sys_linux__
+    // NOTE: /proc/self/root is a symlink to /, it's listed as itself
+    //       rather than as the directory it points to.
+    auto dir = try$(Dir::openWithStat("file:/proc/self"_url));
+    bool found = false;
+    for (auto const& entry : dir.entries()) {
+        if (entry.name == "root") {
+            expect$(entry.type != Type::DIR);
+
+            // NOTE: Its stat is the one of what it points to.
+            expect$(entry.stat->type == Type::DIR);
+            found = true;
+        }
+    }
+    expect$(found);
+    return Ok();
+#else
+    return Error::skipped();
+#endif
+}
+
+test$("dir-walk") {
+    auto entries = try$(walk(_tree()));
+
+    // NOTE: hello.txt, sub and wide, then sub/deep and the 16 directories
+    //       of wide, then the files below them.
+    expectEq$(entries.len(), 3uz + 17uz + 17uz);
+
+    usize depth = 0;
+    for (auto const& e : entries) {
+        expect$(e.url.len() >= depth);
+        depth = e.url.len();
+    }
+
+    Vec<Mime::Url> expected = {
+        _tree() / "hello.txt",
+        _tree() / "sub",
+        _tree() / "sub/deep",
+        _tree() / "sub/deep/leaf.txt",
+        _tree() / "wide",
+    };
+    for (usize i = 0; i < 16; i++) {
+        auto name = try$(Io::format("{02}", i));
+        expected.pushBack(_tree() / "wide" / name);
+        expected.pushBack(_tree() / "wide" / name / "item.txt");
+    }
+
+    // NOTE: Every entry is listed exactly once.
+    for (auto const& url : expected) {
+        usize found = 0;
+        for (auto const& e : entries)
+            if (e.url.str() == url.str())
+                found++;
+        expectEq$(found, 1uz);
+    }
+
+    return Ok();
+}
+
+test$("dir-walk-with-stat") {
+    auto entries = try$(walk(_tree(), true));
+
+    for (auto const& e : entries) {
+        expect$(e.entry.stat.has());
+        if (e.entry.name == "leaf.txt")
+            expectEq$(e.entry.stat->size, 4uz);
+    }
+
+    return Ok();
+}
+
+test$("dir-walk-missing") {
+    auto res = walk(_tree() / "missing");
+    expect$(not res);
+    return Ok();
+}
+
+#ifdef __ck_sys_linux__
+
+static void _pushEvent(Vec<u8>& buf, u32 mask, Str name, Opt<u32> len = NONE) {
+    struct inotify_event event = {};
+    event.mask = mask;
+    event.len = len ? *len : (name.len() ? alignUp(name.len() + 1, 4) : 0);
+
+    auto const* bytes = reinterpret_cast<u8 const*>(&event);
+    for (usize i = 0; i < sizeof(event); i++)
+        buf.pushBack(bytes[i]);
+
+    for (usize i = 0; i < event.len; i++)
+        buf.pushBack(i < name.len() ? (u8)name[i] : 0);
+}
+
+#endif
+
+testAsync$("dir-watch-changes") {
+#ifdef __ck_sys_linux__
+    // NOTE: A pipe stands in for the inotify descriptor, so the changes
+    //       don't depend on what else happens on the filesystem.
+    auto pipe = co_try$(Pipe::create());
+    Watch watch{pipe.out.fd(), _tree()};
+
+    Vec<u8> events;
+    _pushEvent(events, IN_CREATE, "a");
+    _pushEvent(events, IN_MOVED_FROM, "bb");
+    _pushEvent(events, IN_MODIFY, "ccccc");
+    _pushEvent(events, IN_Q_OVERFLOW, "");
+    co_try$(pipe.in.write(events));
+
+    auto changes = co_trya$(watch.changesAsync());
+    co_expectEq$(changes.len(), 4uz);
+    co_expect$(changes[0].type == DirChange::CREATED);
+    co_expectEq$(changes[0].name, "a"s);
+    co_expect$(changes[1].type == DirChange::DELETED);
+    co_expectEq$(changes[1].name, "bb"s);
+    co_expect$(changes[2].type == DirChange::MODIFIED);
+    co_expectEq$(changes[2].name, "ccccc"s);
+
+    // NOTE: Dropped events aren't silently lost.
+    co_expect$(changes[3].type == DirChange::RESCAN);
+
+    co_return Ok();
+#else
+    co_return Error::skipped();
+#endif
+}
+
+testAsync$("dir-watch-changes-truncated") {
+#ifdef __ck_sys_linux__
+    auto pipe = co_try$(Pipe::create());
+    Watch watch{pipe.out.fd(), _tree()};
+
+    // NOTE: A name that fills its record has no terminator, and the last
+    //       record claims more bytes than there are.
+    Vec<u8> events;
+    _pushEvent(events, IN_CREATE, "dddd", 4);
+    _pushEvent(events, IN_DELETE, "e");
+    _pushEvent(events, IN_CREATE, "ffff", 16);
+    events.trunc(events.len() - 8);
+    co_try$(pipe.in.write(events));
+
+    auto changes = co_trya$(watch.changesAsync());
+    co_expectEq$(changes.len(), 2uz);
+    co_expectEq$(changes[0].name, "dddd"s);
+    co_expect$(changes[1].type == DirChange::DELETED);
+    co_expectEq$(changes[1].name, "e"s);
+
+    co_return Ok();
+#else
+    co_return Error::skipped();
+#endif
+}
+
+} // namespace Karm::Sys::Tests
@@ -0,0 +1,24 @@
+#include <karm-base/atomic.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Sys::Tests {
+
+test$("thread-join") {
+    Atomic<usize> count = 0;
+
+    Vec<Rc<Thread>> threads;
+    for (usize i = 0; i < 4; i++) {
+        threads.pushBack(try$(Sys::spawn([&] {
+            count.inc();
+        })));
+    }
+
+    for (auto& thread : threads)
+        try$(thread->join());
+
+    expectEq$(count.load(), 4uz);
+    return Ok();
+}
+
+} // namespace Karm::Sys::Tests
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <karm-base/func.h>
+
+#include "_embed.h"
+
+namespace Karm::Sys {
+
+// A thread of the current process, running a function to completion. The
+// thread keeps running on its own if the handle is dropped before join().
+struct Thread {
+    virtual ~Thread() = default;
+
+    // Waits for the function to return.
+    virtual Res<> join() = 0;
+};
+
+inline Res<Rc<Thread>> spawn(Func<void()> fn) {
+    return _Embed::spawnThread(std::move(fn));
+}
+
+// How many threads can run at the same time on this machine.
+inline usize concurrency() {
+    return _Embed::concurrency();
+}
+
+// Blocks the calling thread while cond() returns true. It's checked again
+// every time another thread calls unparkAll(), which must be done after
+// changing anything cond() depends on.
+template <typename F>
+void parkWhile(F cond) {
+    _Embed::parkLock();
+    while (cond())
+        _Embed::park();
+    _Embed::parkUnlock();
+}
+
+// Wakes up every parked thread so they check their condition again.
+inline void unparkAll() {
+    _Embed::unparkAll();
+}
+
+} // namespace Karm::Sys
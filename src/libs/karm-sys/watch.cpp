@@ -0,0 +1,20 @@
+#include "watch.h"
+
+#include "_embed.h"
+#include "proc.h"
+
+namespace Karm::Sys {
+
+Res<Watch> Watch::open(Mime::Url url) {
+    try$(ensureUnrestricted());
+    auto fd = try$(_Embed::watchDir(url));
+    return Ok(Watch{fd, url});
+}
+
+Async::Task<Vec<DirChange>> Watch::changesAsync(Sched& sched) {
+    Array<u8, 4096> buf;
+    auto len = co_trya$(sched.readAsync(_fd, buf));
+    co_return _Embed::decodeDirChanges(sub(buf, 0, len));
+}
+
+} // namespace Karm::Sys
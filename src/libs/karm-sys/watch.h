@@ -0,0 +1,43 @@
+#pragma once
+
+#include <karm-mime/url.h>
+
+#include "async.h"
+#include "fd.h"
+
+namespace Karm::Sys {
+
+struct DirChange {
+    enum struct Type {
+        CREATED,
+        DELETED,
+        MODIFIED,
+
+        // Changes were lost, the whole directory has to be read again.
+        RESCAN,
+
+        _LEN,
+    };
+
+    using enum Type;
+
+    Type type;
+    String name;
+};
+
+// Reports the entries created, deleted or modified in a directory, so a
+// listing can be kept up to date without reading the directory again.
+struct Watch {
+    Rc<Fd> _fd;
+    Mime::Url _url;
+
+    static Res<Watch> open(Mime::Url url);
+
+    auto const& path() const { return _url; }
+
+    // Waits for changes in the directory, a single call can report
+    // several of them.
+    Async::Task<Vec<DirChange>> changesAsync(Sched& sched = globalSched());
+};
+
+} // namespace Karm::Sys
@@ -17,7 +17,7 @@ struct Driver {
     Async::Task<> runAllAsync();
 
     Res<> unexpect(auto const& lhs, auto const& rhs, Str op, Loc loc = Loc::current()) {
-        logError({"unexpected: {#} {} {#}", loc}, lhs, op, rhs);
+        _log(ERROR, loc, "unexpected: {#} {} {#}", lhs, op, rhs);
         return Error::other("unexpected");
     }
 };
@@ -0,0 +1,60 @@
+#include <karm-sys/entry.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-sys/time.h>
+#include <karm-text/prose.h>
+#include <karm-text/ttf.h>
+
+static constexpr Str LOREM =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+    "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+    "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+    "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+    "velit esse cillum dolore eu fugiat nulla pariatur. AVAWAY Tojo Wave. ";
+
+static constexpr isize REPEAT = 200;
+static constexpr isize ROUNDS = 20;
+
+static Res<Rc<Text::Fontface>> _load(Mime::Url url, bool accelerate) {
+    auto file = try$(Sys::File::open(url));
+    auto map = try$(Sys::mmap().map(file));
+    return Ok(try$(Text::TtfFontface::load(std::move(map), accelerate)));
+}
+
+static Duration _shape(Rc<Text::Fontface> fontface) {
+    Text::ProseStyle style{
+        .font = {fontface, 16},
+        .multiline = true,
+    };
+
+    auto start = Sys::now();
+    for (isize i = 0; i < ROUNDS; i++) {
+        Text::Prose prose{style};
+        for (isize j = 0; j < REPEAT; j++)
+            prose.append(LOREM);
+        prose.layout(800);
+    }
+    return Sys::now() - start;
+}
+
+Async::Task<> entryPointAsync(Sys::Context&) {
+    auto url = "bundle://fonts-inter/fonts/Inter-Regular.ttf"_url;
+
+    auto cached = co_try$(_load(url, false));
+    auto accelerated = co_try$(_load(url, true));
+
+    // Warm up, this also compiles the lookup tables of the accelerated face
+    // and fills the caches of the other one.
+    _shape(cached);
+    _shape(accelerated);
+
+    auto runes = LOREM.len() * REPEAT;
+    auto cachedTime = _shape(cached);
+    auto acceleratedTime = _shape(accelerated);
+
+    Sys::println("shaping {} runes, {} rounds", runes, ROUNDS);
+    Sys::println("cached: {} ({}us/round)", cachedTime, cachedTime.toUSecs() / ROUNDS);
+    Sys::println("accelerated: {} ({}us/round)", acceleratedTime, acceleratedTime.toUSecs() / ROUNDS);
+
+    co_return Ok();
+}
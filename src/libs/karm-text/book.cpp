@@ -1,47 +1,198 @@
+#include <karm-io/pack.h>
 #include <karm-logger/logger.h>
 #include <karm-pkg/bundle.h>
+#include <karm-sys/dir.h>
+#include <karm-sys/file.h>
 #include <karm-sys/time.h>
 
 #include "book.h"
 #include "loader.h"
+#include "ttf.h"
 
 namespace Karm::Text {
 
+// MARK: Font index ------------------------------------------------------------
+
+struct _FontIndexHeader {
+    u32 magic;
+    u32 version;
+};
+
+Res<FontIndex> FontIndex::unpack(Bytes bytes) {
+    Io::PackScan s{bytes, {}};
+    auto header = try$(Io::unpack<_FontIndexHeader>(s));
+    if (header.magic != MAGIC or header.version != VERSION)
+        return Error::invalidData("font index version mismatch");
+
+    return Ok(FontIndex{try$(Io::unpack<Vec<FontIndexEntry>>(s))});
+}
+
+Res<FontIndex> FontIndex::load(Mime::Url url) {
+    auto file = try$(Sys::File::open(url));
+    auto map = try$(Sys::mmap().map(file));
+    return unpack(map.bytes());
+}
+
+Res<> FontIndex::pack(Io::Writer& writer) const {
+    Io::PackEmit e{writer};
+    try$(Io::pack(e, _FontIndexHeader{MAGIC, VERSION}));
+    try$(Io::pack(e, entries));
+    return Ok();
+}
+
+Res<> FontIndex::save(Mime::Url url) const {
+    Io::BufferWriter buf;
+    try$(pack(buf));
+
+    auto file = try$(Sys::File::create(url));
+    try$(file.write(buf.bytes()));
+    return Ok();
+}
+
+Cursor<FontIndexEntry> FontIndex::lookup(Str url) const {
+    auto index = search(entries, [&](FontIndexEntry const& entry) {
+        return entry.url <=> url;
+    });
+    if (not index)
+        return nullptr;
+    return &entries[*index];
+}
+
+static Res<FontIndexEntry> _indexFontface(Mime::Url url, Sys::Stat stat) {
+    auto file = try$(Sys::File::open(url));
+    auto map = try$(Sys::mmap().map(file));
+    auto face = try$(TtfFontface::load(std::move(map)));
+
+    FontCoverage coverage;
+    face->_parser._cmapTable.iterMappings([&](Rune rune, Glyph) {
+        coverage.add(rune);
+    });
+
+    return Ok(FontIndexEntry{
+        .url = url.str(),
+        .mtime = stat.modifyTime.val(),
+        .size = stat.size,
+        .attrs = face->attrs(),
+        .coverage = coverage,
+    });
+}
+
+// A face known from the index, the font file is only mapped and parsed
+// when something other than its attributes is needed.
+struct _LazyFontface : public Fontface {
+    Mime::Url _url;
+    FontAttrs _attrs;
+    mutable FontCoverage _coverage;
+    mutable Opt<Rc<Fontface>> _face;
+
+    _LazyFontface(Mime::Url url, FontAttrs attrs, FontCoverage coverage)
+        : _url(url), _attrs(attrs), _coverage(coverage) {}
+
+    Fontface& _load() const {
+        if (not _face) {
+            auto face = loadFontface(_url);
+            if (face) {
+                _face = face.take();
+            } else {
+                // NOTE: The failure is remembered, the file isn't opened
+                //       again and the face stops claiming any rune, so
+                //       font fallback moves on to the next one.
+                logWarn("failed to load font {}: {}", _url, face.none());
+                _face = Fontface::fallback();
+                _coverage = {};
+            }
+        }
+        return **_face;
+    }
+
+    FontMetrics metrics() const override {
+        return _load().metrics();
+    }
+
+    FontAttrs attrs() const override {
+        return _attrs;
+    }
+
+    Glyph glyph(Rune rune) override {
+        // NOTE: Lets font fallback skip over faces that can't have the
+        //       rune without loading them.
+        if (not _coverage.covers(rune))
+            return Glyph::TOFU;
+        auto& face = _load();
+        // NOTE: Loading cleared the coverage if it failed.
+        if (not _coverage.covers(rune))
+            return Glyph::TOFU;
+        return face.glyph(rune);
+    }
+
+    f64 advance(Glyph glyph) override {
+        return _load().advance(glyph);
+    }
+
+    f64 kern(Glyph prev, Glyph curr) override {
+        return _load().kern(prev, curr);
+    }
+
+    void contour(Gfx::Canvas& g, Glyph glyph) const override {
+        _load().contour(g, glyph);
+    }
+};
+
 // MARK: Font loading ----------------------------------------------------------
 
-Res<> FontBook::loadAll() {
+Res<> FontBook::loadAll(Mime::Url indexUrl) {
     auto start = Sys::now();
 
+    FontIndex cached;
+    if (auto res = FontIndex::load(indexUrl))
+        cached = res.take();
+    FontIndex index;
+    usize indexed = 0;
+
     auto bundles = try$(Pkg::installedBundles());
-    usize count = 0;
     for (auto& bundle : bundles) {
-        auto maybeDir = Sys::Dir::open(bundle.url() / "fonts");
+        auto maybeDir = Sys::Dir::openWithStat(bundle.url() / "fonts");
         if (not maybeDir)
             continue;
 
         auto dir = maybeDir.take();
 
         for (auto& diren : dir.entries()) {
-            if (diren.type != Sys::Type::FILE)
+            if (diren.type != Sys::Type::FILE or not diren.stat)
                 continue;
 
             auto fontUrl = dir.path() / diren.name;
+            auto const& stat = *diren.stat;
+
+            auto entry = cached.lookup(fontUrl.str());
+            if (not entry or entry->stale(stat)) {
+                auto maybeEntry = _indexFontface(fontUrl, stat);
+                if (not maybeEntry)
+                    continue;
+                index.entries.pushBack(maybeEntry.take());
+                indexed++;
+            } else {
+                index.entries.pushBack(*entry);
+            }
 
-            auto maybeFace = loadFontface(fontUrl);
-            if (not maybeFace)
-                continue;
-
-            auto face = maybeFace.take();
-
+            auto& info = last(index.entries);
             add({
                 .url = fontUrl,
-                .attrs = face->attrs(),
-                .face = face,
+                .attrs = info.attrs,
+                .face = makeRc<_LazyFontface>(fontUrl, info.attrs, info.coverage),
             });
-            count++;
         }
     }
 
+    if (indexed or index.entries.len() != cached.entries.len()) {
+        sort(index.entries, [](auto const& lhs, auto const& rhs) {
+            return lhs.url <=> rhs.url;
+        });
+
+        if (auto res = index.save(indexUrl); not res)
+            logWarn("failed to save font index to {}: {}", indexUrl, res.none());
+    }
+
     auto ibmVga = Fontface::fallback();
 
     add({
@@ -51,7 +202,7 @@ Res<> FontBook::loadAll() {
     });
 
     auto elapsed = Sys::now() - start;
-    logDebug("Loaded {} fonts in {}", count, elapsed);
+    logDebug("Found {} fonts in {}, {} indexed", index.entries.len(), elapsed, indexed);
 
     return Ok();
 }
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <karm-base/array.h>
 #include <karm-base/set.h>
 #include <karm-mime/url.h>
 #include <karm-sys/mmap.h>
+#include <karm-sys/stat.h>
 
 #include "base.h"
 #include "font.h"
@@ -23,6 +25,62 @@ struct FontQuery {
     }
 };
 
+// One bit per block of 256 runes, set when the face maps at least one rune
+// of the block.
+struct FontCoverage {
+    static constexpr usize BLOCK_BITS = 8;
+    static constexpr usize BLOCK_COUNT = 0x110000 >> BLOCK_BITS;
+
+    Array<u64, BLOCK_COUNT / 64> _bits{};
+
+    void add(Rune rune) {
+        if (rune >= 0x110000)
+            return;
+        usize block = rune >> BLOCK_BITS;
+        _bits[block / 64] |= 1ull << (block % 64);
+    }
+
+    bool covers(Rune rune) const {
+        if (rune >= 0x110000)
+            return false;
+        usize block = rune >> BLOCK_BITS;
+        return _bits[block / 64] & (1ull << (block % 64));
+    }
+};
+
+// What the font book remembers about a font file between runs, enough to
+// match a face without opening it.
+struct FontIndexEntry {
+    String url;
+    u64 mtime;
+    u64 size;
+    FontAttrs attrs;
+    FontCoverage coverage;
+
+    // Whether the file changed since it was indexed.
+    bool stale(Sys::Stat const& stat) const {
+        return mtime != stat.modifyTime.val() or size != stat.size;
+    }
+};
+
+struct FontIndex {
+    static constexpr u32 MAGIC = 0x78646966; // "fidx"
+    static constexpr u32 VERSION = 1;
+
+    // Sorted by url
+    Vec<FontIndexEntry> entries;
+
+    static Res<FontIndex> unpack(Bytes bytes);
+
+    static Res<FontIndex> load(Mime::Url url);
+
+    Res<> pack(Io::Writer& writer) const;
+
+    Res<> save(Mime::Url url) const;
+
+    Cursor<FontIndexEntry> lookup(Str url) const;
+};
+
 struct FontInfo {
     Mime::Url url;
     FontAttrs attrs;
@@ -41,7 +99,9 @@ struct FontBook {
 
     Rc<Fontface> load(Mime::Url url, Opt<FontAttrs> attrs = NONE);
 
-    Res<> loadAll();
+    // Faces found by loadAll() are only mapped and parsed on first use,
+    // their attributes come from an index cached between runs.
+    Res<> loadAll(Mime::Url indexUrl = "location://home/.cache/karm-fonts.idx"_url);
 
     Vec<String> families() const;
 
@@ -8,7 +8,7 @@
 namespace Karm::Text {
 
 Res<Rc<Fontface>> loadFontface(Sys::Mmap&& map) {
-    return Ok(try$(TtfFontface::load(std::move(map))));
+    return Ok(try$(TtfFontface::load(std::move(map), true)));
 }
 
 Res<Rc<Fontface>> loadFontface(Mime::Url url) {
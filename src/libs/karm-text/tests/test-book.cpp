@@ -1,3 +1,4 @@
+#include <karm-io/impls.h>
 #include <karm-test/macros.h>
 #include <karm-text/book.h>
 
@@ -14,4 +15,112 @@ test$("karm-text-common-family") {
     return Ok();
 }
 
+test$("karm-text-font-coverage") {
+    FontCoverage coverage;
+    coverage.add('A');
+    coverage.add(0x1F600);
+
+    expect$(coverage.covers('z'));
+    expect$(coverage.covers(0x1F64F));
+    expect$(not coverage.covers(0x0400));
+    expect$(not coverage.covers(0x110000));
+
+    return Ok();
+}
+
+static FontIndexEntry _entry(Str url, u64 mtime, u64 size) {
+    FontCoverage coverage;
+    coverage.add('A');
+    return {
+        .url = url,
+        .mtime = mtime,
+        .size = size,
+        .attrs = {.family = "Noto Sans"s, .weight = FontWeight::BOLD},
+        .coverage = coverage,
+    };
+}
+
+static Sys::Stat _stat(u64 mtime, u64 size) {
+    return {
+        .type = Sys::Type::FILE,
+        .size = size,
+        .modifyTime = SystemTime{mtime},
+    };
+}
+
+test$("karm-text-font-index-roundtrip") {
+    FontIndex index;
+    index.entries.pushBack(_entry("bundle://fonts-a/fonts/A.ttf", 10, 100));
+    index.entries.pushBack(_entry("bundle://fonts-b/fonts/B.ttf", 20, 200));
+
+    Io::BufferWriter buf;
+    try$(index.pack(buf));
+    auto loaded = try$(FontIndex::unpack(buf.bytes()));
+
+    expectEq$(loaded.entries.len(), 2uz);
+    for (usize i = 0; i < 2; i++) {
+        auto& expected = index.entries[i];
+        auto& actual = loaded.entries[i];
+        expectEq$(actual.url, expected.url);
+        expectEq$(actual.mtime, expected.mtime);
+        expectEq$(actual.size, expected.size);
+        expectEq$(actual.attrs.family, expected.attrs.family);
+        expectEq$(actual.attrs.weight, expected.attrs.weight);
+        expect$(actual.coverage.covers('A'));
+        expect$(not actual.coverage.covers(0x0400));
+    }
+
+    return Ok();
+}
+
+test$("karm-text-font-index-version") {
+    FontIndex index;
+    index.entries.pushBack(_entry("bundle://fonts-a/fonts/A.ttf", 10, 100));
+
+    Io::BufferWriter buf;
+    try$(index.pack(buf));
+    auto bytes = buf.take();
+
+    // NOTE: The version follows the 4 bytes of the magic.
+    bytes[4] ^= 0xFF;
+    expect$(not FontIndex::unpack(bytes));
+
+    bytes[4] ^= 0xFF;
+    bytes[0] ^= 0xFF;
+    expect$(not FontIndex::unpack(bytes));
+
+    expect$(not FontIndex::unpack(Bytes{}));
+
+    return Ok();
+}
+
+test$("karm-text-font-index-stale") {
+    auto entry = _entry("bundle://fonts-a/fonts/A.ttf", 10, 100);
+
+    expect$(not entry.stale(_stat(10, 100)));
+    expect$(entry.stale(_stat(11, 100)));
+    expect$(entry.stale(_stat(10, 101)));
+
+    return Ok();
+}
+
+test$("karm-text-font-index-lookup") {
+    FontIndex index;
+    index.entries.pushBack(_entry("bundle://fonts-a/fonts/A.ttf", 1, 1));
+    index.entries.pushBack(_entry("bundle://fonts-b/fonts/B.ttf", 2, 2));
+    index.entries.pushBack(_entry("bundle://fonts-c/fonts/C.ttf", 3, 3));
+
+    for (auto& entry : index.entries) {
+        auto found = index.lookup(entry.url);
+        expect$(found != nullptr);
+        expectEq$(found->mtime, entry.mtime);
+    }
+
+    expect$(not index.lookup("bundle://fonts-a/fonts/0.ttf"));
+    expect$(not index.lookup("bundle://fonts-b/fonts/BB.ttf"));
+    expect$(not index.lookup("bundle://fonts-d/fonts/D.ttf"));
+
+    return Ok();
+}
+
 } // namespace Karm::Text::Tests
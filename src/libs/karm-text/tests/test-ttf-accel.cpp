@@ -0,0 +1,85 @@
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-test/macros.h>
+#include <karm-text/ttf/accel.h>
+
+namespace Ttf::Tests {
+
+// NOTE: Droid Sans and Noto Sans kern with GPOS, Space Mono doesn't.
+static Array _FONTS = {
+    "bundle://fonts-droid-sans/fonts/DroidSans.ttf"_url,
+    "bundle://fonts-noto-sans/fonts/NotoSans-Regular.ttf"_url,
+    "bundle://fonts-space-mono/fonts/SpaceMono-Regular.ttf"_url,
+};
+
+static Res<Sys::Mmap> _map(Mime::Url const& url) {
+    auto file = try$(Sys::File::open(url));
+    return Sys::mmap().map(file);
+}
+
+test$("ttf-accel-glyph") {
+    for (auto& url : _FONTS) {
+        auto map = try$(_map(url));
+        auto parser = try$(Parser::init(map.bytes()));
+        auto accel = Accel::build(parser);
+
+        usize mapped = 0;
+        Res<> result = Ok();
+        parser._cmapTable.iterMappings([&](Rune rune, Text::Glyph) {
+            if (result and accel.glyph(rune) != parser.glyph(rune))
+                result = Error::invalidData("glyph mismatch");
+            mapped++;
+        });
+        try$(result);
+        expectGt$(mapped, 0uz);
+
+        // NOTE: Unmapped runes, in mapped pages and out of range.
+        for (Rune rune : {0x0378u, 0xFFFFu, 0x10FFFFu, 0x110000u})
+            expectEq$(accel.glyph(rune).index, parser.glyph(rune).index);
+    }
+
+    return Ok();
+}
+
+test$("ttf-accel-advance") {
+    for (auto& url : _FONTS) {
+        auto map = try$(_map(url));
+        auto parser = try$(Parser::init(map.bytes()));
+        auto accel = Accel::build(parser);
+
+        for (usize i = 0; i < accel._advances.len(); i++) {
+            Text::Glyph glyph(i);
+            expectEq$(accel.advance(glyph), parser.glyphMetrics(glyph).advance);
+        }
+    }
+
+    return Ok();
+}
+
+test$("ttf-accel-kern") {
+    for (auto& url : _FONTS) {
+        auto map = try$(_map(url));
+        auto parser = try$(Parser::init(map.bytes()));
+        auto accel = Accel::build(parser);
+
+        usize kerned = 0;
+        for (Rune prev = 0x20; prev < 0x7F; prev++) {
+            for (Rune curr = 0x20; curr < 0x7F; curr++) {
+                auto a = parser.glyph(prev);
+                auto b = parser.glyph(curr);
+                auto expected = parser.glyphKern(a, b);
+                expectEq$(accel.kern(a, b), expected);
+                if (expected != 0)
+                    kerned++;
+            }
+        }
+
+        // NOTE: Makes sure the comparison isn't between two zeros.
+        if (parser._gpos.present())
+            expectGt$(kerned, 0uz);
+    }
+
+    return Ok();
+}
+
+} // namespace Ttf::Tests
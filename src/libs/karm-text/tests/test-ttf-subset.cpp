@@ -0,0 +1,134 @@
+#include <karm-base/align.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-test/macros.h>
+#include <karm-text/ttf/subset.h>
+#include <karm-text/ttf/table-maxp.h>
+
+namespace Ttf::Tests {
+
+// NOTE: In Droid Sans, 'é' is a composite glyph made of 'e' and of a
+//       combining acute accent that isn't mapped to any rune.
+static constexpr u16 GLYPH_E_ACUTE = 171;
+static constexpr u16 GLYPH_ACUTE = 118;
+
+static Res<Sys::Mmap> _map() {
+    auto file = try$(Sys::File::open("bundle://fonts-droid-sans/fonts/DroidSans.ttf"_url));
+    return Sys::mmap().map(file);
+}
+
+static Bytes _glyph(Parser const& parser, usize id) {
+    auto start = parser._loca.glyfOffset(id, parser._head);
+    auto end = parser._loca.glyfOffset(id + 1, parser._head);
+    return sub(parser._glyf.bytes(), start, end);
+}
+
+// The subset has no cmap, so Parser::init() can't be used on it.
+static Res<Parser> _parseSubset(Bytes bytes) {
+    Parser parser{bytes};
+    parser._head = try$(parser.requireTable<Head>());
+    parser._glyf = try$(parser.requireTable<Glyf>());
+    parser._loca = try$(parser.requireTable<Loca>());
+    parser._hhea = try$(parser.requireTable<Hhea>());
+    parser._hmtx = try$(parser.requireTable<Hmtx>());
+    return Ok(parser);
+}
+
+static u32 _checksum(Bytes bytes) {
+    u32 sum = 0;
+    for (usize i = 0; i < bytes.len(); i += 4) {
+        u32 word = 0;
+        for (usize j = 0; j < 4; j++)
+            word = (word << 8) | (i + j < bytes.len() ? bytes[i + j] : 0);
+        sum += word;
+    }
+    return sum;
+}
+
+test$("ttf-subset-glyf-loca") {
+    auto map = try$(_map());
+    auto font = try$(Parser::init(map.bytes()));
+
+    u16 a = font.glyph('A').index;
+    Array<u16, 2> glyphs = {a, a};
+    auto bytes = try$(subset(font, glyphs));
+    auto result = try$(_parseSubset(bytes));
+
+    // NOTE: The original uses short offsets, the subset always long ones.
+    expectEq$(font._head.locaFormat(), 0);
+    expectEq$(result._head.locaFormat(), 1);
+
+    auto maxp = result.lookupTable<Maxp>();
+    expectEq$(maxp.numGlyphs(), a + 1uz);
+    expectEq$(result._loca.bytes().len(), (a + 2uz) * 4);
+
+    usize prev = 0;
+    for (usize i = 0; i <= maxp.numGlyphs(); i++) {
+        auto offset = result._loca.glyfOffset(i, result._head);
+        expectGteq$(offset, prev);
+        expectEq$(offset % 4, 0uz);
+        prev = offset;
+    }
+    expectEq$(prev, result._glyf.bytes().len());
+
+    // NOTE: .notdef and the requested glyph are kept as they are, padded
+    //       to 4 bytes, the others before them are emptied.
+    for (u16 id : {u16(0), a}) {
+        auto original = _glyph(font, id);
+        auto copy = _glyph(result, id);
+        expectEq$(copy.len(), alignUp(original.len(), 4));
+        expect$(sub(copy, 0, original.len()) == original);
+    }
+    expectEq$(_glyph(result, 1).len(), 0uz);
+
+    expectEq$(result._hmtx.metrics(a, result._hhea).advanceWidth, font._hmtx.metrics(a, font._hhea).advanceWidth);
+    expectEq$(result._hmtx.metrics(a, result._hhea).lsb, font._hmtx.metrics(a, font._hhea).lsb);
+
+    expectEq$(_checksum(bytes), 0xB1B0AFBAu);
+
+    return Ok();
+}
+
+test$("ttf-subset-composite") {
+    auto map = try$(_map());
+    auto font = try$(Parser::init(map.bytes()));
+
+    u16 e = font.glyph('e').index;
+    expectEq$(font.glyph(U'é').index, GLYPH_E_ACUTE);
+    expect$(e < GLYPH_ACUTE);
+
+    Array<u16, 1> glyphs = {GLYPH_E_ACUTE};
+    auto bytes = try$(subset(font, glyphs));
+    auto result = try$(_parseSubset(bytes));
+
+    // NOTE: The components are pulled in even though they weren't asked
+    //       for, and the composite still refers to them by the same ids.
+    for (u16 id : {e, GLYPH_ACUTE, GLYPH_E_ACUTE}) {
+        auto original = _glyph(font, id);
+        auto copy = _glyph(result, id);
+        expect$(original.len() > 0);
+        expect$(sub(copy, 0, original.len()) == original);
+    }
+
+    expectEq$(_glyph(result, e - 1).len(), 0uz);
+    expectEq$(_glyph(result, GLYPH_ACUTE + 1).len(), 0uz);
+
+    return Ok();
+}
+
+test$("ttf-subset-out-of-range") {
+    auto map = try$(_map());
+    auto font = try$(Parser::init(map.bytes()));
+
+    Array<u16, 1> glyphs = {0xFFFF};
+    auto bytes = try$(subset(font, glyphs));
+    auto result = try$(_parseSubset(bytes));
+
+    // NOTE: Only .notdef is left.
+    expectEq$(result.lookupTable<Maxp>().numGlyphs(), 1uz);
+    expectEq$(_glyph(result, 0).len(), alignUp(_glyph(font, 0).len(), 4));
+
+    return Ok();
+}
+
+} // namespace Ttf::Tests
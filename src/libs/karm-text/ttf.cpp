@@ -2,17 +2,26 @@
 
 namespace Karm::Text {
 
-Res<Rc<TtfFontface>> TtfFontface::load(Sys::Mmap&& mmap) {
+Res<Rc<TtfFontface>> TtfFontface::load(Sys::Mmap&& mmap, bool accelerate) {
     auto ttf = try$(Ttf::Parser::init(mmap.bytes()));
-    return Ok(makeRc<TtfFontface>(std::move(mmap), ttf));
+    return Ok(makeRc<TtfFontface>(std::move(mmap), ttf, accelerate));
 }
 
-TtfFontface::TtfFontface(Sys::Mmap&& mmap, Ttf::Parser parser)
+TtfFontface::TtfFontface(Sys::Mmap&& mmap, Ttf::Parser parser, bool accelerate)
     : _mmap(std::move(mmap)),
-      _parser(std::move(parser)) {
+      _parser(std::move(parser)),
+      _accelerate(accelerate) {
     _unitPerEm = _parser.unitPerEm();
 }
 
+Ttf::Accel const* TtfFontface::_ensureAccel() {
+    if (not _accelerate)
+        return nullptr;
+    if (not _accel)
+        _accel = Ttf::Accel::build(_parser);
+    return &*_accel;
+}
+
 FontMetrics TtfFontface::metrics() const {
     auto m = _parser.metrics();
     return {
@@ -49,6 +58,9 @@ FontAttrs TtfFontface::attrs() const {
 }
 
 Glyph TtfFontface::glyph(Rune rune) {
+    if (auto accel = _ensureAccel())
+        return accel->glyph(rune);
+
     auto glyph = _cachedEntries.tryGet(rune);
     if (glyph.has())
         return glyph.unwrap();
@@ -58,6 +70,9 @@ Glyph TtfFontface::glyph(Rune rune) {
 }
 
 f64 TtfFontface::advance(Glyph glyph) {
+    if (auto accel = _ensureAccel())
+        return accel->advance(glyph) / _unitPerEm;
+
     auto advance = _cachedAdvances.tryGet(glyph);
     if (advance.has())
         return advance.unwrap();
@@ -67,6 +82,9 @@ f64 TtfFontface::advance(Glyph glyph) {
 }
 
 f64 TtfFontface::kern(Glyph prev, Glyph curr) {
+    if (auto accel = _ensureAccel())
+        return accel->kern(prev, curr) / _unitPerEm;
+
     auto kern = _cachedKerns.tryGet({prev, curr});
     if (kern.has())
         return kern.unwrap();
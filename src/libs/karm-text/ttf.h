@@ -4,6 +4,7 @@
 #include <karm-sys/mmap.h>
 
 #include "font.h"
+#include "ttf/accel.h"
 #include "ttf/parser.h"
 
 namespace Karm::Text {
@@ -16,9 +17,16 @@ struct TtfFontface : public Fontface {
     Map<Pair<Glyph>, f64> _cachedKerns;
     f64 _unitPerEm = 0;
 
-    static Res<Rc<TtfFontface>> load(Sys::Mmap&& mmap);
+    // When accelerated, the lookup tables are compiled on the first query
+    // and replace the caches above.
+    bool _accelerate = false;
+    Opt<Ttf::Accel> _accel;
 
-    TtfFontface(Sys::Mmap&& mmap, Ttf::Parser parser);
+    static Res<Rc<TtfFontface>> load(Sys::Mmap&& mmap, bool accelerate = false);
+
+    TtfFontface(Sys::Mmap&& mmap, Ttf::Parser parser, bool accelerate = false);
+
+    Ttf::Accel const* _ensureAccel();
 
     FontMetrics metrics() const override;
 
@@ -0,0 +1,139 @@
+#include "accel.h"
+
+namespace Ttf {
+
+static usize _numGlyphs(Parser const& parser) {
+    for (auto table : parser.iterTables()) {
+        if (table.tag == Maxp::SIG)
+            return Maxp{sub(parser._slice, table.offset, table.offset + table.length)}.numGlyphs();
+    }
+
+    // NOTE: No maxp table, loca has one more entry than there are glyphs.
+    usize entrySize = parser._head.locaFormat() == 0 ? 2 : 4;
+    usize len = parser._loca.bytes().len() / entrySize;
+    return len ? len - 1 : 0;
+}
+
+static void _buildCmap(Parser const& parser, Accel& accel) {
+    accel._pageIndex.resize(Accel::PAGE_COUNT, 0);
+    accel._pages.pushBack(Accel::Page{});
+
+    parser._cmapTable.iterMappings([&](Rune rune, Text::Glyph glyph) {
+        if (rune >= 0x110000 or glyph.index == 0)
+            return;
+
+        auto& index = accel._pageIndex[rune >> Accel::PAGE_BITS];
+        if (index == 0) {
+            index = accel._pages.len();
+            accel._pages.pushBack(Accel::Page{});
+        }
+
+        auto& slot = accel._pages[index][rune & (Accel::PAGE_SIZE - 1)];
+        // NOTE: Overlapping mappings resolve to the first one, the same
+        //       way the linear lookup does.
+        if (slot == 0)
+            slot = glyph.index;
+    });
+}
+
+static void _buildAdvances(Parser const& parser, Accel& accel, usize numGlyphs) {
+    accel._advances.ensure(numGlyphs);
+    for (usize i = 0; i < numGlyphs; i++)
+        accel._advances.pushBack(parser._hmtx.metrics(i, parser._hhea).advanceWidth);
+}
+
+static Accel::PairKerns _buildPairKerns(GlyphPairAdjustment const& subtable) {
+    Vec<Tuple<u32, i16>> pairs;
+    subtable.iterPairs([&](usize prev, usize curr, ValueRecord value) {
+        pairs.pushBack({(u32)(prev << 16) | (u32)curr, value.xAdvance});
+    });
+
+    usize cap = 16;
+    while (cap < pairs.len() * 2)
+        cap *= 2;
+
+    Accel::PairKerns kerns;
+    kerns.keys.resize(cap, Accel::NO_PAIR);
+    kerns.values.resize(cap, 0);
+
+    usize mask = cap - 1;
+    for (auto& [key, value] : pairs) {
+        usize i = Accel::PairKerns::_hash(key, mask);
+        while (kerns.keys[i] != Accel::NO_PAIR and kerns.keys[i] != key)
+            i = (i + 1) & mask;
+
+        // NOTE: The first occurrence of a pair wins.
+        if (kerns.keys[i] == key)
+            continue;
+
+        kerns.keys[i] = key;
+        kerns.values[i] = value;
+    }
+
+    return kerns;
+}
+
+static void _resolveClasses(ClassDef const& classDef, Vec<u16>& classes, usize classCount) {
+    classDef.iterClasses([&](usize glyph, usize class_) {
+        if (glyph >= classes.len() or class_ >= classCount)
+            return;
+        // NOTE: The first range listing a glyph wins, like in ClassDef::classOf()
+        if (classes[glyph] == Accel::NO_CLASS)
+            classes[glyph] = class_;
+    });
+}
+
+static Accel::ClassKerns _buildClassKerns(ClassPairAdjustment const& subtable, usize numGlyphs) {
+    Accel::ClassKerns kerns;
+    kerns.class1.resize(numGlyphs, Accel::NO_CLASS);
+    kerns.class2.resize(numGlyphs, Accel::NO_CLASS);
+    kerns.class2Count = subtable.class2Count();
+    kerns.values.resize(subtable.class1Count() * kerns.class2Count, 0);
+
+    _resolveClasses(subtable.classDef1(), kerns.class1, subtable.class1Count());
+    _resolveClasses(subtable.classDef2(), kerns.class2, subtable.class2Count());
+
+    subtable.iterMatrix([&](usize c1, usize c2, ValueRecord value) {
+        kerns.values[c1 * kerns.class2Count + c2] = value.xAdvance;
+    });
+
+    return kerns;
+}
+
+static void _buildKerns(Parser const& parser, Accel& accel, usize numGlyphs) {
+    if (not parser._gpos.present())
+        return;
+
+    auto kernFeature = parser._gpos.kernFeature();
+    if (not kernFeature or not kernFeature.unwrap())
+        return;
+
+    for (auto lookupIndex : kernFeature.unwrap()->iterLookups()) {
+        auto lookupTable = parser._gpos.lookupList().at(lookupIndex);
+
+        if (lookupTable.lookupType() != (u16)GposLookupType::PAIR_ADJUSTMENT)
+            continue;
+
+        for (auto lookupSubtable : lookupTable.iter()) {
+            if (auto glyphPair = lookupSubtable.is<GlyphPairAdjustment>()) {
+                if (glyphPair->format() == GlyphPairAdjustment::FORMAT)
+                    accel._kerns.pushBack(_buildPairKerns(*glyphPair));
+            } else if (auto classPair = lookupSubtable.is<ClassPairAdjustment>()) {
+                accel._kerns.pushBack(_buildClassKerns(*classPair, numGlyphs));
+            }
+        }
+    }
+}
+
+Accel Accel::build(Parser const& parser) {
+    Accel accel;
+    auto numGlyphs = _numGlyphs(parser);
+
+    _buildCmap(parser, accel);
+    _buildAdvances(parser, accel, numGlyphs);
+    _buildKerns(parser, accel, numGlyphs);
+
+    return accel;
+}
+
+} // namespace Ttf
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <karm-base/array.h>
+#include <karm-base/vec.h>
+
+#include "parser.h"
+
+namespace Ttf {
+
+// Lookup tables compiled from a font, answering cmap, hmtx and kerning
+// queries with a couple of array accesses instead of walking the tables.
+struct Accel {
+    static constexpr usize PAGE_BITS = 8;
+    static constexpr usize PAGE_SIZE = 1 << PAGE_BITS;
+    static constexpr usize PAGE_COUNT = 0x110000 >> PAGE_BITS;
+
+    static constexpr u16 NO_CLASS = 0xffff;
+    static constexpr u32 NO_PAIR = 0xffffffff;
+
+    using Page = Array<u16, PAGE_SIZE>;
+
+    // Pairs of a glyph pair adjustment subtable (format 1), in an open
+    // addressing hash table keyed by (prev << 16) | curr.
+    struct PairKerns {
+        Vec<u32> keys;
+        Vec<i16> values;
+
+        static usize _hash(u32 key, usize mask) {
+            u32 h = key * 0x9e3779b1u;
+            return (h ^ (h >> 16)) & mask;
+        }
+
+        Opt<i16> lookup(u32 key) const {
+            usize mask = keys.len() - 1;
+            for (usize i = _hash(key, mask);; i = (i + 1) & mask) {
+                if (keys[i] == key)
+                    return values[i];
+                if (keys[i] == NO_PAIR)
+                    return NONE;
+            }
+        }
+    };
+
+    // Class matrix of a class pair adjustment subtable (format 2), with the
+    // classes of every glyph resolved up front.
+    struct ClassKerns {
+        Vec<u16> class1;
+        Vec<u16> class2;
+        usize class2Count = 0;
+        Vec<i16> values;
+
+        Opt<i16> lookup(u16 prev, u16 curr) const {
+            if (prev >= class1.len() or curr >= class2.len())
+                return NONE;
+            auto c1 = class1[prev];
+            auto c2 = class2[curr];
+            if (c1 == NO_CLASS or c2 == NO_CLASS)
+                return NONE;
+            return values[c1 * class2Count + c2];
+        }
+    };
+
+    using Kerns = Union<PairKerns, ClassKerns>;
+
+    // Two level rune to glyph table, page 0 maps everything to .notdef and
+    // is shared by all the unmapped pages.
+    Vec<u16> _pageIndex;
+    Vec<Page> _pages;
+
+    // Advance of each glyph, in font units.
+    Vec<f64> _advances;
+
+    // Kerning subtables, in the order they apply.
+    Vec<Kerns> _kerns;
+
+    static Accel build(Parser const& parser);
+
+    Text::Glyph glyph(Rune rune) const {
+        if (rune >= 0x110000)
+            return Text::Glyph(0);
+        auto const& page = _pages[_pageIndex[rune >> PAGE_BITS]];
+        return Text::Glyph(page[rune & (PAGE_SIZE - 1)]);
+    }
+
+    f64 advance(Text::Glyph glyph) const {
+        if (glyph.index >= _advances.len())
+            return 0;
+        return _advances[glyph.index];
+    }
+
+    f64 kern(Text::Glyph prev, Text::Glyph curr) const {
+        for (auto& kerns : _kerns) {
+            auto value = kerns.visit(Visitor{
+                [&](PairKerns const& k) {
+                    return k.lookup(((u32)prev.index << 16) | curr.index);
+                },
+                [&](ClassKerns const& k) {
+                    return k.lookup(prev.index, curr.index);
+                },
+            });
+
+            if (value)
+                return *value;
+        }
+        return 0;
+    }
+};
+
+} // namespace Ttf
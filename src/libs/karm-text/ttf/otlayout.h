@@ -159,6 +159,27 @@ struct CoverageTable : public Io::BChunk {
 
         return NONE;
     }
+
+    // Calls f(glyphId, coverageIndex) for every glyph covered by the table.
+    void iterGlyphs(auto f) const {
+        auto s = begin().skip(4);
+
+        if (format() == 1) {
+            for (auto i : range(len()))
+                f((usize)s.nextU16be(), i);
+        }
+
+        if (format() == 2) {
+            for (auto i : range(len())) {
+                (void)i;
+                usize start = s.nextU16be();
+                usize end = s.nextU16be();
+                usize index = s.nextU16be();
+                for (usize glyph = start; glyph <= end; glyph++)
+                    f(glyph, index + glyph - start);
+            }
+        }
+    }
 };
 
 struct LookupSubtableBase : public Io::BChunk {
@@ -265,6 +286,37 @@ struct GlyphPairAdjustment : public LookupSubtableBase {
 
         return NONE;
     }
+
+    // Calls f(prev, curr, value1) for every pair of the table, in the
+    // order adjustments() looks them up.
+    void iterPairs(auto f) const {
+        auto s = begin();
+
+        /* format = */ s.nextU16be();
+        auto coverageOffset = s.nextU16be();
+        auto valueFormat1 = s.nextU16be();
+        auto valueFormat2 = s.nextU16be();
+        auto pairSetCount = s.nextU16be();
+
+        auto value2len = ValueRecord::len(valueFormat2);
+
+        CoverageTable coverage{begin().skip(coverageOffset).remBytes()};
+        coverage.iterGlyphs([&](usize prev, usize coverageIndex) {
+            if (coverageIndex >= pairSetCount)
+                return;
+
+            auto pairSetOffset = Io::BScan{s}.skip(coverageIndex * 2).nextU16be();
+            auto pairSetTable = begin().skip(pairSetOffset);
+            auto pairValueCount = pairSetTable.nextU16be();
+
+            for (usize i : range(pairValueCount)) {
+                (void)i;
+                usize curr = pairSetTable.nextU16be();
+                f(prev, curr, ValueRecord::read(pairSetTable, valueFormat1));
+                pairSetTable.skip(value2len);
+            }
+        });
+    }
 };
 
 // https://learn.microsoft.com/en-us/typography/opentype/spec/chapter2#class-definition-table
@@ -296,12 +348,44 @@ struct ClassDef : public Io::BChunk {
 
         return NONE;
     }
+
+    // Calls f(glyphId, class) for every glyph listed in the table.
+    void iterClasses(auto f) const {
+        auto s = begin();
+        auto format = s.nextU16be();
+
+        if (format == 1) {
+            usize startGlyph = s.nextU16be();
+            usize glyphCount = s.nextU16be();
+            for (usize i : range(glyphCount))
+                f(startGlyph + i, (usize)s.nextU16be());
+        }
+
+        if (format == 2) {
+            auto classRangeCount = s.nextU16be();
+            for (usize i : range(classRangeCount)) {
+                (void)i;
+                usize startGlyph = s.nextU16be();
+                usize endGlyph = s.nextU16be();
+                usize glyphClass = s.nextU16be();
+                for (usize glyph = startGlyph; glyph <= endGlyph; glyph++)
+                    f(glyph, glyphClass);
+            }
+        }
+    }
 };
 
 // https://learn.microsoft.com/en-us/typography/opentype/spec/gpos#pair-adjustment-positioning-format-2-class-pair-adjustment
 struct ClassPairAdjustment : public LookupSubtableBase {
     static constexpr int FORMAT = 2;
 
+    using ValueFormat1 = Io::BField<u16be, 4>;
+    using ValueFormat2 = Io::BField<u16be, 6>;
+    using ClassDef1Offset = Io::BField<u16be, 8>;
+    using ClassDef2Offset = Io::BField<u16be, 10>;
+    using Class1Count = Io::BField<u16be, 12>;
+    using Class2Count = Io::BField<u16be, 14>;
+
     Opt<Pair<ValueRecord>> adjustments(usize prev, usize curr) {
         auto s = begin();
 
@@ -333,6 +417,33 @@ struct ClassPairAdjustment : public LookupSubtableBase {
 
         return Pair<ValueRecord>{value1, value2};
     }
+
+    ClassDef classDef1() const {
+        return ClassDef{begin().skip(get<ClassDef1Offset>()).remBytes()};
+    }
+
+    ClassDef classDef2() const {
+        return ClassDef{begin().skip(get<ClassDef2Offset>()).remBytes()};
+    }
+
+    usize class1Count() const { return get<Class1Count>(); }
+
+    usize class2Count() const { return get<Class2Count>(); }
+
+    // Calls f(class1, class2, value1) for every cell of the class matrix.
+    void iterMatrix(auto f) const {
+        u16 valueFormat1 = get<ValueFormat1>();
+        u16 valueFormat2 = get<ValueFormat2>();
+        auto value2len = ValueRecord::len(valueFormat2);
+
+        auto s = begin().skip(16);
+        for (usize c1 : range(class1Count())) {
+            for (usize c2 : range(class2Count())) {
+                f(c1, c2, ValueRecord::read(s, valueFormat1));
+                s.skip(value2len);
+            }
+        }
+    }
 };
 
 using LookupSubtable = Union<
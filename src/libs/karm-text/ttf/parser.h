@@ -143,7 +143,7 @@ struct Parser {
         return begin().nextU32be();
     }
 
-    auto iterTables() {
+    auto iterTables() const {
         auto scan = begin();
         /* auto version = */ scan.nextU32be();
         auto numTables = scan.nextU16be();
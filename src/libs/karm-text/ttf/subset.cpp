@@ -0,0 +1,229 @@
+#include <karm-base/align.h>
+#include <karm-io/impls.h>
+
+#include "subset.h"
+#include "table-maxp.h"
+
+// https://learn.microsoft.com/en-us/typography/opentype/spec/otff
+// https://learn.microsoft.com/en-us/typography/opentype/spec/glyf#composite-glyph-description
+
+namespace Ttf {
+
+static constexpr u16 ARG_1_AND_2_ARE_WORDS = 0x0001;
+static constexpr u16 WE_HAVE_A_SCALE = 0x0008;
+static constexpr u16 MORE_COMPONENTS = 0x0020;
+static constexpr u16 WE_HAVE_AN_X_AND_Y_SCALE = 0x0040;
+static constexpr u16 WE_HAVE_A_TWO_BY_TWO = 0x0080;
+
+static constexpr usize HEAD_CHECKSUM_ADJUSTMENT = 8;
+static constexpr usize HEAD_INDEX_TO_LOC_FORMAT = 50;
+static constexpr usize MAXP_NUM_GLYPHS = 4;
+static constexpr usize HHEA_NUMBER_OF_HMETRICS = 34;
+
+static Bytes _table(Parser const& parser, Str tag) {
+    for (auto table : parser.iterTables()) {
+        if (table.tag == tag and table.offset + table.length <= parser._slice.len())
+            return sub(parser._slice, table.offset, table.offset + table.length);
+    }
+    return {};
+}
+
+static Bytes _glyph(Parser const& parser, usize id) {
+    auto start = parser._loca.glyfOffset(id, parser._head);
+    auto end = parser._loca.glyfOffset(id + 1, parser._head);
+    if (end <= start or end > parser._glyf.bytes().len())
+        return {};
+    return sub(parser._glyf.bytes(), start, end);
+}
+
+static void _useComponents(Parser const& parser, Vec<bool>& used, usize id) {
+    Io::BScan s{_glyph(parser, id)};
+    if (s.rem() < 10 or s.nextI16be() >= 0)
+        return;
+    s.skip(8);
+
+    while (s.rem() >= 4) {
+        u16 flags = s.nextU16be();
+        u16 component = s.nextU16be();
+
+        if (component < used.len() and not used[component]) {
+            used[component] = true;
+            _useComponents(parser, used, component);
+        }
+
+        s.skip(flags & ARG_1_AND_2_ARE_WORDS ? 4 : 2);
+        if (flags & WE_HAVE_A_SCALE)
+            s.skip(2);
+        else if (flags & WE_HAVE_AN_X_AND_Y_SCALE)
+            s.skip(4);
+        else if (flags & WE_HAVE_A_TWO_BY_TWO)
+            s.skip(8);
+
+        if (not(flags & MORE_COMPONENTS))
+            break;
+    }
+}
+
+static void _patchU16be(Buf<Byte>& buf, usize offset, u16 value) {
+    buf[offset] = value >> 8;
+    buf[offset + 1] = value;
+}
+
+static void _patchU32be(Buf<Byte>& buf, usize offset, u32 value) {
+    buf[offset] = value >> 24;
+    buf[offset + 1] = value >> 16;
+    buf[offset + 2] = value >> 8;
+    buf[offset + 3] = value;
+}
+
+static u32 _checksum(Bytes bytes) {
+    u32 sum = 0;
+    for (usize i = 0; i < bytes.len(); i += 4) {
+        u32 word = 0;
+        for (usize j = 0; j < 4; j++)
+            word = (word << 8) | (i + j < bytes.len() ? bytes[i + j] : 0);
+        sum += word;
+    }
+    return sum;
+}
+
+struct _Table {
+    Str tag;
+    Buf<Byte> data;
+};
+
+Res<Buf<Byte>> subset(Parser const& parser, Slice<u16> glyphs) {
+    auto maxp = _table(parser, Maxp::SIG);
+    if (maxp.len() < 6)
+        return Error::invalidData("missing maxp table");
+
+    usize numGlyphs = Maxp{maxp}.numGlyphs();
+
+    // NOTE: .notdef is always kept, renderers fall back to it.
+    Vec<bool> used;
+    used.resize(numGlyphs, false);
+    if (numGlyphs)
+        used[0] = true;
+
+    usize lastGlyph = 0;
+    for (auto glyph : glyphs) {
+        if (glyph >= numGlyphs or used[glyph])
+            continue;
+        used[glyph] = true;
+        _useComponents(parser, used, glyph);
+    }
+
+    for (usize i = 0; i < numGlyphs; i++)
+        if (used[i])
+            lastGlyph = i;
+
+    // NOTE: Glyphs past the last one used are dropped, the ones before it
+    //       are kept but emptied.
+    usize subsetGlyphs = lastGlyph + 1;
+
+    // MARK: glyf & loca -------------------------------------------------------
+
+    Io::BufferWriter glyfBuf;
+    Io::BufferWriter locaBuf;
+    Io::BEmit glyf{glyfBuf};
+    Io::BEmit loca{locaBuf};
+
+    usize offset = 0;
+    for (usize i = 0; i < subsetGlyphs; i++) {
+        loca.writeU32be(offset);
+        if (not used[i])
+            continue;
+
+        auto bytes = _glyph(parser, i);
+        glyf.writeBytes(bytes);
+        offset += bytes.len();
+
+        // NOTE: Keeps every glyph 4-byte aligned, as recommended.
+        while (offset % 4) {
+            glyf.writeU8be(0);
+            offset++;
+        }
+    }
+    loca.writeU32be(offset);
+
+    // MARK: hmtx --------------------------------------------------------------
+
+    Io::BufferWriter hmtxBuf;
+    Io::BEmit hmtx{hmtxBuf};
+    for (usize i = 0; i < subsetGlyphs; i++) {
+        auto metrics = parser._hmtx.metrics(i, parser._hhea);
+        hmtx.writeU16be(metrics.advanceWidth);
+        hmtx.writeU16be(metrics.lsb);
+    }
+
+    // MARK: head, hhea & maxp -------------------------------------------------
+
+    Buf<Byte> head = parser._head.bytes();
+    if (head.len() < 54)
+        return Error::invalidData("invalid head table");
+    _patchU32be(head, HEAD_CHECKSUM_ADJUSTMENT, 0);
+    _patchU16be(head, HEAD_INDEX_TO_LOC_FORMAT, 1);
+
+    Buf<Byte> hhea = parser._hhea.bytes();
+    if (hhea.len() < 36)
+        return Error::invalidData("invalid hhea table");
+    _patchU16be(hhea, HHEA_NUMBER_OF_HMETRICS, subsetGlyphs);
+
+    Buf<Byte> maxpBuf = maxp;
+    _patchU16be(maxpBuf, MAXP_NUM_GLYPHS, subsetGlyphs);
+
+    // MARK: Table Directory ---------------------------------------------------
+
+    // NOTE: Sorted by tag, as the table directory has to be.
+    Vec<_Table> tables;
+    if (auto cvt = _table(parser, "cvt "))
+        tables.pushBack({"cvt ", cvt});
+    if (auto fpgm = _table(parser, "fpgm"))
+        tables.pushBack({"fpgm", fpgm});
+    tables.pushBack({"glyf", glyfBuf.take()});
+    tables.pushBack({"head", std::move(head)});
+    tables.pushBack({"hhea", std::move(hhea)});
+    tables.pushBack({"hmtx", hmtxBuf.take()});
+    tables.pushBack({"loca", locaBuf.take()});
+    tables.pushBack({"maxp", std::move(maxpBuf)});
+    if (auto prep = _table(parser, "prep"))
+        tables.pushBack({"prep", prep});
+
+    usize numTables = tables.len();
+    usize entrySelector = 0;
+    while ((2uz << entrySelector) <= numTables)
+        entrySelector++;
+    usize searchRange = (1uz << entrySelector) * 16;
+
+    Io::BufferWriter out;
+    Io::BEmit e{out};
+    e.writeU32be(0x00010000);
+    e.writeU16be(numTables);
+    e.writeU16be(searchRange);
+    e.writeU16be(entrySelector);
+    e.writeU16be(numTables * 16 - searchRange);
+
+    usize tableOffset = 12 + numTables * 16;
+    usize headOffset = 0;
+    for (auto& table : tables) {
+        if (table.tag == Head::SIG)
+            headOffset = tableOffset;
+        e.writeStr(table.tag);
+        e.writeU32be(_checksum(table.data));
+        e.writeU32be(tableOffset);
+        e.writeU32be(table.data.len());
+        tableOffset += alignUp(table.data.len(), 4);
+    }
+
+    for (auto& table : tables) {
+        e.writeBytes(table.data);
+        for (usize i = table.data.len(); i % 4; i++)
+            e.writeU8be(0);
+    }
+
+    auto font = out.take();
+    _patchU32be(font, headOffset + HEAD_CHECKSUM_ADJUSTMENT, 0xB1B0AFBA - _checksum(font));
+    return Ok(std::move(font));
+}
+
+} // namespace Ttf
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "parser.h"
+
+namespace Ttf {
+
+// Builds a TrueType font with only the outlines of the given glyphs, and of
+// the glyphs they are composed of. Glyph ids are kept as they are, unused
+// ones are left empty, so text can still refer to the original ids.
+//
+// Only the tables needed to render the glyphs are kept, the result is meant
+// to be embedded, not installed.
+Res<Buf<Byte>> subset(Parser const& parser, Slice<u16> glyphs);
+
+} // namespace Ttf
@@ -21,63 +21,122 @@ struct Cmap : public Io::BChunk {
             return slice;
         }
 
-        Text::Glyph _glyphIdForType4(Rune r) const {
-            u16 segCountX2 = begin().skip(6).nextU16be();
-            u16 segCount = segCountX2 / 2;
+        struct Segment4 {
+            u16 startCode;
+            u16 endCode;
+            u16 idDelta;
+            u16 idRangeOffset;
+            Io::BScan idRangeOffsetPos;
+        };
+
+        usize _segCount4() const {
+            return begin().skip(6).nextU16be() / 2;
+        }
 
-            for (usize i = 0; i < segCount; i++) {
-                auto s = begin().skip(14);
+        Segment4 _segment4(usize i) const {
+            u16 segCountX2 = _segCount4() * 2;
+            auto s = begin().skip(14);
 
-                u16 endCode = s.skip(i * 2).peekU16be();
+            u16 endCode = s.skip(i * 2).peekU16be();
+            // + 2 for reserved padding
+            u16 startCode = s.skip(segCountX2 + 2).peekU16be();
+            u16 idDelta = s.skip(segCountX2).peekI16be();
+            u16 idRangeOffset = s.skip(segCountX2).peekU16be();
 
-                if (r > endCode)
-                    continue;
-
-                // + 2 for reserved padding
-                u16 startCode = s.skip(segCountX2 + 2).peekU16be();
+            return {startCode, endCode, idDelta, idRangeOffset, s};
+        }
 
-                if (r < startCode)
-                    break;
+        static Text::Glyph _glyphInSegment4(Segment4 const& seg, Rune r) {
+            if (seg.idRangeOffset == 0)
+                return Text::Glyph((r + seg.idDelta) & 0xFFFF);
 
-                u16 idDelta = s.skip(segCountX2).peekI16be();
-                u16 idRangeOffset = s.skip(segCountX2).peekU16be();
+            auto offset = seg.idRangeOffset + (r - seg.startCode) * 2;
+            auto s = seg.idRangeOffsetPos;
+            return Text::Glyph(s.skip(offset).nextU16be());
+        }
 
-                if (idRangeOffset == 0) {
-                    return Text::Glyph((r + idDelta) & 0xFFFF);
-                }
+        Text::Glyph _glyphIdForType4(Rune r) const {
+            usize segCount = _segCount4();
+            auto endCodes = begin().skip(14);
+
+            // NOTE: Segments are sorted by end code, look for the first one
+            //       ending after the rune.
+            usize lo = 0, hi = segCount;
+            while (lo < hi) {
+                usize mid = lo + (hi - lo) / 2;
+                u16 endCode = Io::BScan{endCodes}.skip(mid * 2).peekU16be();
+                if (r > endCode)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
 
-                auto offset = idRangeOffset + (r - startCode) * 2;
-                return Text::Glyph(s.skip(offset).nextU16be());
+            if (lo < segCount) {
+                auto seg = _segment4(lo);
+                if (r >= seg.startCode)
+                    return _glyphInSegment4(seg, r);
             }
 
             logWarn("ttf: glyph not found for rune {x}", r);
             return Text::Glyph(0);
         }
 
-        Text::Glyph _glyphForType12(Rune r) const {
+        struct Group12 {
+            u32 startCode;
+            u32 endCode;
+            u32 glyphOffset;
+        };
+
+        auto _iterGroups12() const {
             auto s = begin().skip(12);
             u32 nGroups = s.nextU32be();
 
-            for (u32 i = 0; i < nGroups; i++) {
-                u32 startCode = s.nextU32be();
-                u32 endCode = s.nextU32be();
-                u32 glyphOffset = s.nextU32be();
+            return Iter{[s, i = 0uz, nGroups] mutable -> Opt<Group12> {
+                if (i == nGroups)
+                    return NONE;
+                i++;
+
+                Group12 group;
+                group.startCode = s.nextU32be();
+                group.endCode = s.nextU32be();
+                group.glyphOffset = s.nextU32be();
+                return group;
+            }};
+        }
 
-                if (r < startCode)
+        Text::Glyph _glyphForType12(Rune r) const {
+            for (auto group : _iterGroups12()) {
+                if (r < group.startCode)
                     break;
 
-                if (r > endCode)
+                if (r > group.endCode)
                     continue;
 
-                if (r >= startCode and r <= endCode) {
-                    return Text::Glyph((r - startCode) + glyphOffset);
-                }
+                return Text::Glyph((r - group.startCode) + group.glyphOffset);
             }
 
             logWarn("ttf: glyph not found for rune {c}", r);
             return Text::Glyph(0);
         }
 
+        // Calls f(rune, glyph) for every rune mapped by the table, in the
+        // same way glyphIdFor() would map it.
+        void iterMappings(auto f) const {
+            if (type == 4) {
+                usize segCount = _segCount4();
+                for (usize i = 0; i < segCount; i++) {
+                    auto seg = _segment4(i);
+                    for (Rune r = seg.startCode; r <= seg.endCode; r++)
+                        f(r, _glyphInSegment4(seg, r));
+                }
+            } else if (type == 12) {
+                for (auto group : _iterGroups12()) {
+                    for (Rune r = group.startCode; r <= min(group.endCode, 0x10FFFFu); r++)
+                        f(r, Text::Glyph((r - group.startCode) + group.glyphOffset));
+                }
+            }
+        }
+
         Text::Glyph glyphIdFor(Rune r) const {
             if (type == 4) {
                 return _glyphIdForType4(r);
@@ -40,7 +40,8 @@ struct Gpos : public Io::BChunk {
         return LookupList{begin().skip(get<LookupListOffset>()).remBytes()};
     }
 
-    Res<Pair<ValueRecord>> adjustments(usize prev, usize curr) const {
+    // The feature table holding the kerning lookups, if any.
+    Res<Opt<FeatureTable>> kernFeature() const {
         // 1. Locate the current script in the GPOS ScriptList table.
 
         // FIXME: We assume that the script is always "latn".
@@ -66,6 +67,11 @@ struct Gpos : public Io::BChunk {
             }
         }
 
+        return Ok(kernFeatureTable);
+    }
+
+    Res<Pair<ValueRecord>> adjustments(usize prev, usize curr) const {
+        auto kernFeatureTable = try$(kernFeature());
         if (not kernFeatureTable)
             return Ok(Pair<ValueRecord>{});
 
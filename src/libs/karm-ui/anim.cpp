@@ -157,7 +157,7 @@ struct Carousel : public GroupNode<Carousel> {
     void layout(Math::Recti r) override {
         _bound = r;
         for (auto& child : children()) {
-            child->layout(r);
+            child->place(r);
             r = r.offset({r.width, 0});
         }
     }
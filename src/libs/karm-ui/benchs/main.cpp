@@ -0,0 +1,66 @@
+#include <karm-sys/entry.h>
+#include <karm-sys/time.h>
+#include <karm-ui/layout.h>
+
+struct List : public Ui::GroupNode<List> {
+    using GroupNode::GroupNode;
+};
+
+static constexpr usize ITEMS = 10000;
+
+static Ui::Child _list(Vec<usize> const& items) {
+    Ui::Children children;
+    for (auto item : items)
+        children.pushBack(Ui::empty({16, 16}) | Ui::key(item));
+    return makeRc<List>(children);
+}
+
+static void _bench(Str name, Vec<usize> const& before, Vec<usize> const& after) {
+    auto root = _list(before);
+    Vec<Ui::Node*> nodes;
+    for (auto& child : root.unwrap<List>().children())
+        nodes.pushBack(&*child);
+
+    auto next = _list(after);
+    auto start = Sys::now();
+    root->reconcile(next);
+    auto elapsed = Sys::now() - start;
+
+    sort(nodes);
+    usize kept = 0;
+    for (auto& child : root.unwrap<List>().children()) {
+        auto found = search(nodes, [&](Ui::Node* node) {
+            return node <=> &*child;
+        });
+        if (found)
+            kept++;
+    }
+
+    Sys::println("{}: {} ({} of {} nodes kept)", name, elapsed, kept, after.len());
+}
+
+Async::Task<> entryPointAsync(Sys::Context&) {
+    Vec<usize> items;
+    for (usize i = 0; i < ITEMS; i++)
+        items.pushBack(i);
+
+    auto prepended = items;
+    prepended.pushFront(ITEMS);
+
+    auto removed = items;
+    removed.removeAt(ITEMS / 2);
+
+    Vec<usize> reversed;
+    for (usize i = ITEMS; i > 0; i--)
+        reversed.pushBack(i - 1);
+
+    auto swapped = items;
+    std::swap(swapped[1], swapped[ITEMS - 2]);
+
+    _bench("prepend"s, items, prepended);
+    _bench("remove"s, items, removed);
+    _bench("reverse"s, items, reversed);
+    _bench("swap"s, items, swapped);
+
+    co_return Ok();
+}
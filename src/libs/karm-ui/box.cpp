@@ -9,6 +9,11 @@ struct Box : public _Box<Box> {
     Box(BoxStyle style, Child child)
         : _Box(child), _style(style) {}
 
+    bool sameLayout(Box& o) override {
+        return _style.margin == o._style.margin and
+               _style.padding == o._style.padding;
+    }
+
     void reconcile(Box& o) override {
         _style = o._style;
         _Box<Box>::reconcile(o);
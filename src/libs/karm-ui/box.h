@@ -115,14 +115,14 @@ struct _Box : public ProxyNode<Crtp> {
         rect = rect.shrink(boxStyle().margin);
         rect = rect.shrink(boxStyle().padding);
 
-        ProxyNode<Crtp>::child().layout(rect);
+        ProxyNode<Crtp>::child().place(rect);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
         s = s - boxStyle().margin.all();
         s = s - boxStyle().padding.all();
 
-        s = ProxyNode<Crtp>::child().size(s, hint);
+        s = ProxyNode<Crtp>::child().measure(s, hint);
 
         s = s + boxStyle().padding.all();
         s = s + boxStyle().margin.all();
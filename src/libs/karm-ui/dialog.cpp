@@ -132,14 +132,14 @@ struct DialogLayer : public LeafNode<DialogLayer> {
             _shouldShow = NONE;
         }
 
-        _child->layout(r);
+        _child->place(r);
 
         if (_dialog)
-            (*_dialog)->layout(r);
+            (*_dialog)->place(r);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
-        return _child->size(s, hint);
+        return _child->measure(s, hint);
     }
 
     Math::Recti bound() override {
@@ -59,6 +59,7 @@ inline void shouldRepaint(Node& n, Math::Recti bound) {
 }
 
 inline void shouldLayout(Node& n) {
+    n.markDirty();
     bubble<Node::LayoutEvent>(n);
 }
 
@@ -71,7 +71,7 @@ struct Host : public Node {
     }
 
     void layout(Math::Recti r) override {
-        _root->layout(r);
+        _root->place(r);
     }
 
     void event(App::Event& event) override {
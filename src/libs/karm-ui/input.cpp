@@ -399,6 +399,7 @@ struct SimpleInput : public View<SimpleInput> {
             _ensureModel().reduce(*a);
             _text = _ensureModel().string();
             _prose = NONE;
+            markDirty();
             if (_onChange)
                 _onChange(*this, _text);
             else
@@ -443,7 +444,7 @@ struct Slider : public ProxyNode<Slider> {
 
     void layout(Math::Recti r) override {
         _bound = r;
-        child().layout(_bound.hsplit(((r.width - r.height) * _value) + r.height).v0);
+        child().place(_bound.hsplit(((r.width - r.height) * _value) + r.height).v0);
     }
 
     Math::Recti bound() override {
@@ -460,7 +461,7 @@ struct Slider : public ProxyNode<Slider> {
                 if (_onChange) {
                     _onChange(*this, _value);
                 } else {
-                    child().layout(_bound.hsplit(((_bound.width - _bound.height) * _value) + _bound.height).v0);
+                    child().place(_bound.hsplit(((_bound.width - _bound.height) * _value) + _bound.height).v0);
                     shouldRepaint(*this);
                 }
             }
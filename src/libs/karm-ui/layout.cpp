@@ -18,6 +18,10 @@ struct Grow : public ProxyNode<Grow> {
     isize grow() const {
         return _grow;
     }
+
+    bool sameLayout(Grow& o) override {
+        return _grow == o._grow;
+    }
 };
 
 Child grow(Opt<Child> child) {
@@ -45,6 +49,10 @@ struct Empty : public View<Empty> {
     Empty(Math::Vec2i size)
         : _size(size) {}
 
+    bool sameLayout(Empty& o) override {
+        return _size == o._size;
+    }
+
     void reconcile(Empty& o) override {
         _size = o._size;
     }
@@ -78,13 +86,17 @@ struct Bound : public ProxyNode<Bound> {
         return _bound;
     }
 
+    bool sameLayout(Bound&) override {
+        return true;
+    }
+
     void layout(Math::Recti bound) override {
         _bound = bound;
-        child().layout(bound);
+        child().place(bound);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
-        return child().size(s, hint);
+        return child().measure(s, hint);
     }
 };
 
@@ -99,6 +111,10 @@ struct Placed : public ProxyNode<Placed> {
     Placed(Math::Recti place, Child child)
         : ProxyNode(child), _place(place) {}
 
+    bool sameLayout(Placed& o) override {
+        return _place == o._place;
+    }
+
     void reconcile(Placed& o) override {
         _place = o._place;
         ProxyNode<Placed>::reconcile(o);
@@ -112,7 +128,7 @@ struct Placed : public ProxyNode<Placed> {
         _bound = bound;
         auto place = _place;
         place.xy = place.xy + _bound.xy;
-        child().layout(place);
+        child().place(place);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint) override {
@@ -150,15 +166,19 @@ struct Align : public ProxyNode<Align> {
 
     Align(Math::Align align, Child child) : ProxyNode(child), _align(align) {}
 
+    bool sameLayout(Align&) override {
+        return true;
+    }
+
     void layout(Math::Recti bound) override {
-        auto childSize = child().size(
+        auto childSize = child().measure(
             bound.size(), _child.is<Grow>()
                               ? Hint::MAX
                               : Hint::MIN
         );
 
         child()
-            .layout(_align.apply<isize>(
+            .place(_align.apply<isize>(
                 Math::Flow::LEFT_TO_RIGHT,
                 childSize,
                 bound
@@ -167,8 +187,8 @@ struct Align : public ProxyNode<Align> {
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
         if (hint == Hint::MAX)
-            return _align.maxSize(child().size(s, hint), s);
-        return _align.minSize(child().size(s, hint));
+            return _align.maxSize(child().measure(s, hint), s);
+        return _align.minSize(child().measure(s, hint));
     }
 };
 
@@ -226,6 +246,10 @@ struct Sizing : public ProxyNode<Sizing> {
         return _rect;
     }
 
+    bool sameLayout(Sizing& o) override {
+        return _min == o._min and _max == o._max;
+    }
+
     void reconcile(Sizing& o) override {
         _min = o._min;
         _max = o._max;
@@ -234,7 +258,7 @@ struct Sizing : public ProxyNode<Sizing> {
 
     void layout(Math::Recti bound) override {
         _rect = bound;
-        child().layout(bound);
+        child().place(bound);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
@@ -246,7 +270,7 @@ struct Sizing : public ProxyNode<Sizing> {
             s.y = min(s.y, _max.y);
         }
 
-        auto result = child().size(s, hint);
+        auto result = child().measure(s, hint);
 
         if (_min.x != UNCONSTRAINED) {
             result.x = max(result.x, _min.x);
@@ -296,6 +320,10 @@ struct Insets : public ProxyNode<Insets> {
     Insets(Math::Insetsi insets, Child child)
         : ProxyNode(child), _insets(insets) {}
 
+    bool sameLayout(Insets& o) override {
+        return _insets == o._insets;
+    }
+
     void reconcile(Insets& o) override {
         _insets = o._insets;
         ProxyNode<Insets>::reconcile(o);
@@ -306,11 +334,11 @@ struct Insets : public ProxyNode<Insets> {
     }
 
     void layout(Math::Recti rect) override {
-        child().layout(rect.shrink(_insets));
+        child().place(rect.shrink(_insets));
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
-        return child().size(s - _insets.all(), hint) + _insets.all();
+        return child().measure(s - _insets.all(), hint) + _insets.all();
     }
 
     Math::Recti bound() override {
@@ -330,6 +358,10 @@ struct AspectRatio : public ProxyNode<AspectRatio> {
     AspectRatio(f64 ratio, Child child)
         : ProxyNode(child), _ratio(ratio) {}
 
+    bool sameLayout(AspectRatio& o) override {
+        return _ratio == o._ratio;
+    }
+
     void reconcile(AspectRatio& o) override {
         _ratio = o._ratio;
         ProxyNode<AspectRatio>::reconcile(o);
@@ -360,6 +392,10 @@ Child aspectRatio(f64 ratio, Child child) {
 struct StackLayout : public GroupNode<StackLayout> {
     using GroupNode::GroupNode;
 
+    bool sameLayout(StackLayout&) override {
+        return true;
+    }
+
     void event(App::Event& e) override {
         if (e.accepted())
             return;
@@ -376,7 +412,7 @@ struct StackLayout : public GroupNode<StackLayout> {
         isize h{};
 
         for (auto& child : children()) {
-            auto childSize = child->size(s, hint);
+            auto childSize = child->measure(s, hint);
             w = max(w, childSize.x);
             h = max(h, childSize.y);
         }
@@ -399,6 +435,12 @@ struct FlowLayout : public GroupNode<FlowLayout> {
     FlowLayout(FlowStyle style, Children children)
         : GroupNode(children), _style(style) {}
 
+    bool sameLayout(FlowLayout& o) override {
+        return _style.flow._flow == o._style.flow._flow and
+               _style.align._value == o._style.align._value and
+               _style.gaps == o._style.gaps;
+    }
+
     void reconcile(FlowLayout& o) override {
         _style = o._style;
         GroupNode::reconcile(o);
@@ -412,7 +454,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
             if (child.is<Grow>()) {
                 grows += child.unwrap<Grow>().grow();
             } else {
-                total += _style.flow.getX(child->size(r.size(), Hint::MIN));
+                total += _style.flow.getX(child->measure(r.size(), Hint::MIN));
             }
         }
 
@@ -429,7 +471,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
 
         for (auto& child : children()) {
             Math::Recti inner = {};
-            auto childSize = child->size(r.size(), Hint::MIN);
+            auto childSize = child->measure(r.size(), Hint::MIN);
 
             inner = _style.flow.setStart(inner, (isize)start);
             if (child.is<Grow>()) {
@@ -441,7 +483,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
             inner = _style.flow.setTop(inner, _style.flow.getTop(r));
             inner = _style.flow.setBottom(inner, _style.flow.getBottom(r));
 
-            child->layout(_style.align.apply(_style.flow, Math::Recti{childSize}, inner));
+            child->place(_style.align.apply(_style.flow, Math::Recti{childSize}, inner));
             start += _style.flow.getWidth(inner) + _style.gaps;
         }
     }
@@ -455,7 +497,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
             if (child.is<Grow>())
                 grow = true;
 
-            auto childSize = child->size(s, Hint::MIN);
+            auto childSize = child->measure(s, Hint::MIN);
             w += _style.flow.getX(childSize);
             h = max(h, _style.flow.getY(childSize));
         }
@@ -580,7 +622,7 @@ struct GridLayout : public GroupNode<GridLayout> {
             endRow.end() - startRow.start,
         };
 
-        child->layout(childRect);
+        child->place(childRect);
     }
 
     void layout(Math::Recti r) override {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <karm-app/event.h>
+#include <karm-base/array.h>
 #include <karm-base/checked.h>
 #include <karm-base/func.h>
 #include <karm-base/hash.h>
@@ -33,6 +34,13 @@ struct Node : public App::Dispatch {
     Key _key = NONE;
     bool _consumed = false;
 
+    // A node is dirty when something that affects its size or layout
+    // changed since it was last laid out. Clean nodes answer measure()
+    // from their cache and skip place() when given the same bound.
+    bool _dirty = true;
+    Array<Opt<Pair<Math::Vec2i>>, 3> _measures = {};
+    Opt<Math::Recti> _placed = NONE;
+
     struct PaintEvent {
         Math::Recti bound;
     };
@@ -63,6 +71,42 @@ struct Node : public App::Dispatch {
     virtual void attach(Node*) {}
 
     virtual void detach(Node*) {}
+
+    // MARK: Layout cache ------------------------------------------------------
+
+    /// Mark the node, and all its ancestors, as needing to be measured
+    /// and laid out again.
+    void markDirty() {
+        for (Node* n = this; n; n = n->parent()) {
+            n->_dirty = true;
+            n->_measures = {};
+            n->_placed = NONE;
+        }
+    }
+
+    /// Memoized size(), valid until the node is marked dirty.
+    Math::Vec2i measure(Math::Vec2i s, Hint hint) {
+        auto& cached = _measures[toUnderlyingType(hint)];
+        if (cached and cached->v0 == s)
+            return cached->v1;
+
+        // NOTE: size() may leave the node in a state that only fits the
+        //       size it was asked for, so the next place() can't be skipped.
+        auto result = size(s, hint);
+        cached = Pair<Math::Vec2i>{s, result};
+        _placed = NONE;
+        return result;
+    }
+
+    /// Lay the node out, unless it is clean and already laid out in
+    /// this exact bound.
+    void place(Math::Recti r) {
+        if (not _dirty and _placed == r)
+            return;
+        layout(r);
+        _placed = r;
+        _dirty = false;
+    }
 };
 
 inline auto key(Hashable auto const& key) {
@@ -99,6 +143,11 @@ struct LeafNode : public Node {
 
     virtual void reconcile(Crtp&) {}
 
+    /// Whether reconciling with `other` leaves the size and layout of this
+    /// node unchanged. Changes in the children are tracked by the children
+    /// themselves, only the properties of this node matter.
+    virtual bool sameLayout(Crtp&) { return false; }
+
     Opt<Child> reconcile(Child other) override {
         // NOTE: Nodes should never be part of a state, to
         //       ensure this we check that nodes are not
@@ -112,8 +161,11 @@ struct LeafNode : public Node {
         if (not other.is<Crtp>() or _key != other->key())
             return other;
 
+        bool same = sameLayout(other.unwrap<Crtp>());
         reconcile(other.unwrap<Crtp>());
         other->_consumed = true;
+        if (not same)
+            this->markDirty();
 
         return NONE;
     }
@@ -131,7 +183,10 @@ struct LeafNode : public Node {
     }
 
     void attach(Node* parent) override {
+        if (_parent == parent)
+            return;
         _parent = parent;
+        this->markDirty();
     }
 
     void detach(Node* parent) override {
@@ -169,10 +224,95 @@ struct GroupNode : public LeafNode<Crtp> {
         return _children;
     }
 
+    static bool _anyKeyed(Children const& children) {
+        for (auto& c : children)
+            if (c->key())
+                return true;
+        return false;
+    }
+
+    // Pairs old and new children by key, so keyed children keep their
+    // node, and its state, when they are moved around. Unkeyed children
+    // are paired with the unkeyed ones in order.
+    void _reconcileKeyed(Crtp& o) {
+        auto& us = children();
+        auto& them = o.children();
+
+        Vec<Pair<Hash, usize>> keyed;
+        for (usize i = 0; i < us.len(); i++)
+            if (auto k = us[i]->key())
+                keyed.pushBack({*k, i});
+
+        sort(keyed, [](auto const& lhs, auto const& rhs) {
+            return lhs.v0 <=> rhs.v0;
+        });
+
+        Vec<bool> used;
+        used.resize(us.len(), false);
+        usize unkeyed = 0;
+
+        Children next{them.len()};
+        bool changed = us.len() != them.len();
+
+        for (usize j = 0; j < them.len(); j++) {
+            Opt<usize> source = NONE;
+
+            if (auto k = them[j]->key()) {
+                auto found = search(keyed, [&](auto const& e) {
+                    return e.v0 <=> *k;
+                });
+
+                // NOTE: Duplicated keys are paired once, the others
+                //       are treated as new children.
+                if (found and not used[keyed[*found].v1])
+                    source = keyed[*found].v1;
+            } else {
+                while (unkeyed < us.len() and us[unkeyed]->key())
+                    unkeyed++;
+                if (unkeyed < us.len())
+                    source = unkeyed++;
+            }
+
+            Child child = them[j];
+            if (source) {
+                auto& old = us[*source];
+                if (auto replacement = old->reconcile(them[j])) {
+                    child = *replacement;
+                } else {
+                    child = old;
+                    used[*source] = true;
+                }
+            }
+
+            if (j >= us.len() or &*child != &*us[j])
+                changed = true;
+
+            child->attach(this);
+            next.pushBack(child);
+        }
+
+        for (usize i = 0; i < us.len(); i++)
+            if (not used[i])
+                us[i]->detach(this);
+
+        us = std::move(next);
+
+        if (changed)
+            this->markDirty();
+    }
+
     void reconcile(Crtp& o) override {
         auto& us = children();
         auto& them = o.children();
 
+        if (_anyKeyed(us) or _anyKeyed(them)) {
+            _reconcileKeyed(o);
+            return;
+        }
+
+        if (us.len() != them.len())
+            this->markDirty();
+
         for (usize i = 0; i < them.len(); i++) {
             if (i < us.len()) {
                 us.replace(i, us[i]->reconcile(them[i]).unwrapOr(us[i]));
@@ -209,7 +349,7 @@ struct GroupNode : public LeafNode<Crtp> {
         _bound = r;
 
         for (auto& child : children())
-            child->layout(r);
+            child->place(r);
     }
 
     Math::Recti bound() override {
@@ -257,11 +397,11 @@ struct ProxyNode : public LeafNode<Crtp> {
     }
 
     void layout(Math::Recti r) override {
-        child().layout(r);
+        child().place(r);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
-        return child().size(s, hint);
+        return child().measure(s, hint);
     }
 
     Math::Recti bound() override {
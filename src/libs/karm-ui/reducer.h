@@ -144,12 +144,12 @@ struct Reducer :
 
     void layout(Math::Recti r) override {
         ensureBuild();
-        (*_child)->layout(r);
+        (*_child)->place(r);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
         ensureBuild();
-        return (*_child)->size(s, hint);
+        return (*_child)->measure(s, hint);
     }
 
     Math::Recti bound() override {
@@ -141,7 +141,7 @@ struct Scroll : public ProxyNode<Scroll> {
 
     void layout(Math::Recti r) override {
         _bound = r;
-        auto childSize = child().size(_bound.size(), Hint::MAX);
+        auto childSize = child().measure(_bound.size(), Hint::MAX);
         if (_orient == Math::Orien::HORIZONTAL) {
             childSize.height = r.height;
         } else if (_orient == Math::Orien::VERTICAL) {
@@ -153,12 +153,12 @@ struct Scroll : public ProxyNode<Scroll> {
         childSize.height = max(childSize.height, r.height);
 
         r.wh = childSize;
-        child().layout(r);
+        child().place(r);
         scroll(_scroll.cast<isize>());
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
-        auto childSize = child().size(s, hint);
+        auto childSize = child().measure(s, hint);
 
         if (hint == Hint::MIN) {
             if (_orient == Math::Orien::HORIZONTAL) {
@@ -190,6 +190,262 @@ Child vscroll(Child child) {
     return makeRc<Scroll>(child, Math::Orien::VERTICAL);
 }
 
+// MARK: Virtual List --------------------------------------------------------
+
+struct VList : public LeafNode<VList> {
+    static constexpr isize SCROLL_BAR_WIDTH = 4;
+
+    usize _count;
+    Math::Vec2i _itemSize; // A width of zero means the full width of the list
+    ItemBuilder _builder;
+
+    bool _mouseIn = false;
+    bool _animated = false;
+    Math::Recti _bound{};
+    f64 _scroll = 0;
+    f64 _targetScroll = 0;
+    Easedf _scrollOpacity;
+
+    // The items currently built, for the range of indices starting at _first.
+    usize _first = 0;
+    Children _items;
+
+    VList(usize count, Math::Vec2i itemSize, ItemBuilder builder)
+        : _count(count), _itemSize(itemSize), _builder(std::move(builder)) {}
+
+    ~VList() {
+        for (auto& item : _items)
+            item->detach(this);
+    }
+
+    usize _columns() const {
+        if (_itemSize.x <= 0)
+            return 1;
+        return max(1uz, (usize)(_bound.width / _itemSize.x));
+    }
+
+    usize _rows() const {
+        auto columns = _columns();
+        return (_count + columns - 1) / columns;
+    }
+
+    isize _contentHeight() const {
+        return (isize)_rows() * _itemSize.y;
+    }
+
+    Math::Recti _itemBound(usize index) const {
+        auto columns = _columns();
+        isize width = _itemSize.x <= 0 ? _bound.width : _itemSize.x;
+        return {
+            _bound.x + (isize)(index % columns) * width,
+            _bound.y + (isize)(index / columns) * _itemSize.y,
+            width,
+            _itemSize.y,
+        };
+    }
+
+    void scroll(f64 s) {
+        _targetScroll = clamp(s, -(f64)max(_contentHeight() - _bound.height, (isize)0), 0.);
+        if (Math::abs(_scroll - _targetScroll) < 0.5) {
+            _scroll = _targetScroll;
+            _animated = false;
+        } else {
+            _animated = true;
+        }
+    }
+
+    // Build the items in view, plus the overscan, keeping the ones that
+    // were already built, and drop the ones that scrolled out.
+    void _realize() {
+        usize first = 0;
+        usize end = 0;
+
+        if (_count and _itemSize.y > 0) {
+            auto columns = _columns();
+            auto rowHeight = (usize)_itemSize.y;
+            auto top = (usize)(-_scroll) / rowHeight;
+            auto bottom = (usize)(-_scroll + _bound.height) / rowHeight + 1;
+            first = (top > VLIST_OVERSCAN ? top - VLIST_OVERSCAN : 0) * columns;
+            end = min(min(bottom + VLIST_OVERSCAN, _rows()) * columns, _count);
+            first = min(first, end);
+        }
+
+        Children items{end - first};
+        for (usize i = first; i < end; i++) {
+            if (i >= _first and i < _first + _items.len()) {
+                items.pushBack(_items[i - _first]);
+            } else {
+                auto item = _builder(i);
+                item->attach(this);
+                items.pushBack(item);
+            }
+        }
+
+        for (usize i = 0; i < _items.len(); i++) {
+            auto index = _first + i;
+            if (index < first or index >= end)
+                _items[i]->detach(this);
+        }
+
+        _first = first;
+        _items = std::move(items);
+
+        for (usize i = 0; i < _items.len(); i++)
+            _items[i]->place(_itemBound(_first + i));
+    }
+
+    bool sameLayout(VList& o) override {
+        return _count == o._count and
+               _itemSize == o._itemSize;
+    }
+
+    void reconcile(VList& o) override {
+        _count = o._count;
+        _itemSize = o._itemSize;
+        _builder = std::move(o._builder);
+
+        // NOTE: Only the items that are built need to be brought up to
+        //       date, the others will be built from the new builder when
+        //       they come into view.
+        usize keep = _first < _count ? min(_items.len(), _count - _first) : 0;
+        for (usize i = keep; i < _items.len(); i++)
+            _items[i]->detach(this);
+        _items.trunc(keep);
+
+        for (usize i = 0; i < _items.len(); i++) {
+            auto& item = _items[i];
+            if (auto replacement = item->reconcile(_builder(_first + i))) {
+                item->detach(this);
+                item = *replacement;
+                item->attach(this);
+            }
+        }
+    }
+
+    Math::Recti vTrack() {
+        return Math::Recti{_bound.end() - SCROLL_BAR_WIDTH, _bound.top(), SCROLL_BAR_WIDTH, _bound.height};
+    }
+
+    void paint(Gfx::Canvas& g, Math::Recti r) override {
+        g.push();
+        g.clip(_bound);
+        g.origin({0, _scroll});
+        r.y = r.y - (isize)_scroll;
+        for (auto& item : _items) {
+            if (not item->bound().colide(r))
+                continue;
+            item->paint(g, r);
+        }
+        g.pop();
+
+        // draw scroll bar
+        auto contentHeight = _contentHeight();
+        if (contentHeight > _bound.height) {
+            auto scrollBarHeight = max(_bound.height * _bound.height / contentHeight, SCROLL_BAR_WIDTH * 4);
+            auto scrollBarY = _bound.top() + (-_scroll * (_bound.height - scrollBarHeight) / (contentHeight - _bound.height));
+
+            g.push();
+            g.clip(_bound);
+            g.fillStyle(Ui::GRAY500.withOpacity(0.5 * clamp01(_scrollOpacity.value())));
+            g.fill(Math::Recti{_bound.end() - SCROLL_BAR_WIDTH, (isize)scrollBarY, SCROLL_BAR_WIDTH, scrollBarHeight});
+            g.pop();
+        }
+    }
+
+    void _dispatch(App::Event& e) {
+        for (auto& item : _items) {
+            item->event(e);
+            if (e.accepted())
+                return;
+        }
+    }
+
+    void event(App::Event& e) override {
+        if (e.accepted())
+            return;
+
+        if (_scrollOpacity.needRepaint(*this, e))
+            shouldRepaint(*parent(), vTrack());
+
+        if (auto me = e.is<App::MouseEvent>()) {
+            if (_bound.contains(me->pos)) {
+                _mouseIn = true;
+
+                me->pos.y = me->pos.y - (isize)_scroll;
+                _dispatch(e);
+                me->pos.y = me->pos.y + (isize)_scroll;
+
+                if (not e.accepted()) {
+                    if (me->type == App::MouseEvent::SCROLL) {
+                        scroll(_scroll + me->scroll.y * 128);
+                        shouldAnimate(*this);
+                        _scrollOpacity.delay(0).animate(*this, 1, 0.3);
+                    }
+                }
+            } else if (_mouseIn) {
+                _mouseIn = false;
+                mouseLeave(_items);
+            }
+        } else if (e.is<Node::AnimateEvent>() and _animated) {
+            shouldRepaint(*parent(), _bound);
+
+            _scroll = _scroll + (_targetScroll - _scroll) * (e.unwrap<Node::AnimateEvent>().dt * 12);
+
+            if (Math::abs(_scroll - _targetScroll) < 0.5) {
+                _scroll = _targetScroll;
+                _animated = false;
+                _scrollOpacity.delay(1.0).animate(*this, 0, 0.3);
+            } else {
+                shouldAnimate(*this);
+            }
+
+            _realize();
+            _dispatch(e);
+        } else {
+            _dispatch(e);
+        }
+    }
+
+    void bubble(App::Event& e) override {
+        if (auto pe = e.is<Node::PaintEvent>()) {
+            pe->bound.y = pe->bound.y + (isize)_scroll;
+            pe->bound = pe->bound.clipTo(_bound);
+        }
+
+        LeafNode::bubble(e);
+    }
+
+    void layout(Math::Recti r) override {
+        _bound = r;
+        scroll(_scroll);
+        _realize();
+    }
+
+    Math::Vec2i size(Math::Vec2i s, Hint hint) override {
+        if (hint == Hint::MIN)
+            return {max(_itemSize.x, (isize)0), min(_itemSize.y, s.y)};
+
+        usize columns = _itemSize.x > 0 ? max(1uz, (usize)(s.x / _itemSize.x)) : 1;
+        auto contentHeight = (isize)((_count + columns - 1) / columns) * _itemSize.y;
+
+        if (hint == Hint::MAX)
+            return {s.x, max(s.y, contentHeight)};
+        return {s.x, min(s.y, contentHeight)};
+    }
+
+    Math::Recti bound() override {
+        return _bound;
+    }
+};
+
+Child vlist(usize count, isize itemHeight, ItemBuilder builder) {
+    return makeRc<VList>(count, Math::Vec2i{0, itemHeight}, std::move(builder));
+}
+
+Child vgrid(usize count, Math::Vec2i itemSize, ItemBuilder builder) {
+    return makeRc<VList>(count, itemSize, std::move(builder));
+}
+
 // MARK: Clip ------------------------------------------------------------------
 
 struct Clip : public ProxyNode<Clip> {
@@ -210,18 +466,18 @@ struct Clip : public ProxyNode<Clip> {
 
     void layout(Math::Recti r) override {
         _bound = r;
-        auto childSize = child().size(_bound.size(), Hint::MAX);
+        auto childSize = child().measure(_bound.size(), Hint::MAX);
         if (_orient == Math::Orien::HORIZONTAL) {
             childSize.height = r.height;
         } else if (_orient == Math::Orien::VERTICAL) {
             childSize.width = r.width;
         }
         r.wh = childSize;
-        child().layout(r);
+        child().place(r);
     }
 
     Math::Vec2i size(Math::Vec2i s, Hint hint) override {
-        auto childSize = child().size(s, hint);
+        auto childSize = child().measure(s, hint);
 
         if (hint == Hint::MIN) {
             if (_orient == Math::Orien::HORIZONTAL) {
@@ -33,6 +33,22 @@ inline auto vscroll() {
     };
 }
 
+// MARK: Virtual List --------------------------------------------------------
+
+using ItemBuilder = Func<Child(usize)>;
+
+static constexpr usize VLIST_OVERSCAN = 4;
+
+/// A vertically scrolling list of `count` rows of `itemHeight` pixels.
+/// Only the visible rows, plus a few of overscan, are built, laid out
+/// and painted; `builder` is called with the index of each row as it
+/// comes into view.
+Child vlist(usize count, isize itemHeight, ItemBuilder builder);
+
+/// Same as vlist(), but with cells of `itemSize` wrapped in as many
+/// columns as fit the width of the list.
+Child vgrid(usize count, Math::Vec2i itemSize, ItemBuilder builder);
+
 // MARK: Clip ------------------------------------------------------------------
 
 Child vhclip(Child child);
@@ -0,0 +1,142 @@
+#include <karm-gfx/cpu/canvas.h>
+#include <karm-test/macros.h>
+#include <karm-ui/funcs.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+// A leaf that fills its bound and counts how many times it is painted.
+struct Painted : public LeafNode<Painted> {
+    usize* _paints;
+    Gfx::Color _color;
+    Math::Recti _bound{};
+
+    Painted(usize& paints, Gfx::Color color)
+        : _paints(&paints), _color(color) {}
+
+    void reconcile(Painted& o) override {
+        _paints = o._paints;
+        _color = o._color;
+    }
+
+    bool sameLayout(Painted&) override {
+        return true;
+    }
+
+    void paint(Gfx::Canvas& g, Math::Recti) override {
+        (*_paints)++;
+        g.fillStyle(_color);
+        g.fill(_bound);
+    }
+
+    void layout(Math::Recti r) override {
+        _bound = r;
+    }
+
+    Math::Recti bound() override {
+        return _bound;
+    }
+};
+
+static Gfx::Color const _RED = Gfx::Color::fromRgba(255, 0, 0, 255);
+static Gfx::Color const _BLUE = Gfx::Color::fromRgba(0, 0, 255, 255);
+
+static Math::Recti const BOUND = {0, 0, 20, 20};
+
+static Child _layer(usize& paints, Gfx::Color color = _RED) {
+    return layer(makeRc<Painted>(paints, color));
+}
+
+static void _rebuild(Child& root, Child next) {
+    root = root->reconcile(next).unwrapOr(root);
+}
+
+static void _paint(Child& root, Gfx::Surface& surface, f64 scale = 1) {
+    Gfx::CpuCanvas canvas;
+    canvas.begin(surface.mutPixels());
+    Gfx::Canvas& g = canvas;
+    g.scale({scale, scale});
+    root->paint(g, BOUND);
+    canvas.end();
+}
+
+test$("ui-layer-reuse") {
+    usize paints = 0;
+    auto root = _layer(paints);
+    root->place(BOUND);
+
+    auto surface = Gfx::Surface::alloc(BOUND.size());
+    _paint(root, *surface);
+    expectEq$(paints, 1uz);
+
+    // NOTE: Same size and nothing asked to be repainted, the surface is
+    //       blitted as it is.
+    _paint(root, *surface);
+    _paint(root, *surface);
+    expectEq$(paints, 1uz);
+    expectEq$(surface->pixels().loadUnsafe({10, 10}), _RED);
+
+    return Ok();
+}
+
+test$("ui-layer-damage") {
+    usize paints = 0;
+    Child child = makeRc<Painted>(paints, _RED);
+    Child root = layer(child);
+    root->place(BOUND);
+
+    auto surface = Gfx::Surface::alloc(BOUND.size());
+    _paint(root, *surface);
+
+    // NOTE: Only what the child asks for is rasterized again.
+    shouldRepaint(*child, {0, 0, 5, 5});
+    _paint(root, *surface);
+    expectEq$(paints, 2uz);
+
+    _paint(root, *surface);
+    expectEq$(paints, 2uz);
+
+    return Ok();
+}
+
+test$("ui-layer-device-size") {
+    usize paints = 0;
+    auto root = _layer(paints);
+    root->place(BOUND);
+
+    auto surface = Gfx::Surface::alloc(BOUND.size() * 2);
+    _paint(root, *surface);
+    expectEq$(paints, 1uz);
+
+    // NOTE: The layer now covers twice as many device pixels, it's
+    //       rasterized again rather than stretched.
+    _paint(root, *surface, 2);
+    expectEq$(paints, 2uz);
+    expectEq$(surface->pixels().loadUnsafe({39, 39}), _RED);
+
+    _paint(root, *surface, 2);
+    expectEq$(paints, 2uz);
+
+    return Ok();
+}
+
+test$("ui-layer-rebuild") {
+    usize paints = 0;
+    auto root = _layer(paints);
+    root->place(BOUND);
+
+    auto surface = Gfx::Surface::alloc(BOUND.size());
+    _paint(root, *surface);
+    expectEq$(surface->pixels().loadUnsafe({10, 10}), _RED);
+
+    // NOTE: The rebuild changed the color without asking to be
+    //       repainted, the old surface must not be reused.
+    _rebuild(root, _layer(paints, _BLUE));
+    _paint(root, *surface);
+    expectEq$(paints, 2uz);
+    expectEq$(surface->pixels().loadUnsafe({10, 10}), _BLUE);
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
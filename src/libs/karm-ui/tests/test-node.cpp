@@ -0,0 +1,144 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layout.h>
+
+namespace Karm::Ui::Tests {
+
+struct _Calls {
+    usize size = 0;
+    usize layout = 0;
+};
+
+// A fixed size leaf that counts how many times it is measured and laid out.
+struct Counted : public LeafNode<Counted> {
+    _Calls* _calls;
+    isize _width;
+    bool _stable;
+    Math::Recti _bound{};
+
+    Counted(_Calls& calls, isize width, bool stable)
+        : _calls(&calls), _width(width), _stable(stable) {}
+
+    void reconcile(Counted& o) override {
+        _calls = o._calls;
+        _width = o._width;
+    }
+
+    bool sameLayout(Counted& o) override {
+        return _stable and o._stable and _width == o._width;
+    }
+
+    Math::Vec2i size(Math::Vec2i, Hint) override {
+        _calls->size++;
+        return {_width, 10};
+    }
+
+    void layout(Math::Recti r) override {
+        _calls->layout++;
+        _bound = r;
+    }
+
+    Math::Recti bound() override {
+        return _bound;
+    }
+};
+
+static Child _counted(_Calls& calls, isize width, bool stable = true) {
+    return makeRc<Counted>(calls, width, stable);
+}
+
+static Math::Recti const VIEWPORT = {0, 0, 100, 10};
+
+static void _rebuild(Child& root, Child next) {
+    root = root->reconcile(next).unwrapOr(root);
+}
+
+static void _layout(Child root) {
+    root->measure(VIEWPORT.size(), Hint::PREFERRED);
+    root->place(VIEWPORT);
+}
+
+test$("ui-node-layout-once") {
+    _Calls a, b;
+    auto root = hflow(_counted(a, 10), _counted(b, 20));
+
+    _layout(root);
+    expectEq$(a.layout, 1uz);
+    expectEq$(b.layout, 1uz);
+    auto measured = a.size;
+
+    // NOTE: Nothing changed, everything comes from the cache.
+    _layout(root);
+    expectEq$(a.size, measured);
+    expectEq$(a.layout, 1uz);
+    expectEq$(b.layout, 1uz);
+
+    return Ok();
+}
+
+test$("ui-node-clean-sibling") {
+    _Calls a, b;
+    auto second = _counted(b, 20);
+    auto root = hflow(_counted(a, 10), second);
+    _layout(root);
+
+    auto measured = b.size;
+
+    // NOTE: Only the first child changes size, the second one is moved
+    //       over but stays clean, so it's placed again without being
+    //       measured.
+    _rebuild(root, hflow(_counted(a, 30), _counted(b, 20)));
+    expect$(root->_dirty);
+    expect$(not second->_dirty);
+
+    _layout(root);
+    expectEq$(a.layout, 2uz);
+    expectEq$(b.size, measured);
+    expectEq$(b.layout, 2uz);
+
+    // NOTE: Same width again, the second child keeps its bound and isn't
+    //       laid out at all.
+    _rebuild(root, hflow(_counted(a, 40), _counted(b, 20)));
+    _rebuild(root, hflow(_counted(a, 30), _counted(b, 20)));
+    _layout(root);
+    expectEq$(b.size, measured);
+    expectEq$(b.layout, 2uz);
+
+    Child stacked = stack(_counted(a, 10), _counted(b, 20));
+    _layout(stacked);
+    auto before = b.layout;
+    _rebuild(stacked, stack(_counted(a, 50), _counted(b, 20)));
+    _layout(stacked);
+    expectEq$(b.layout, before);
+
+    return Ok();
+}
+
+test$("ui-node-same-layout") {
+    _Calls a, b;
+    auto root = hflow(_counted(a, 10), _counted(b, 20));
+    _layout(root);
+
+    // NOTE: Rebuilding the same tree, sameLayout() holds all the way
+    //       down so nothing is measured or laid out again.
+    auto sized = a.size + b.size;
+    _rebuild(root, hflow(_counted(a, 10), _counted(b, 20)));
+    expect$(not root->_dirty);
+
+    _layout(root);
+    expectEq$(a.size + b.size, sized);
+    expectEq$(a.layout, 1uz);
+    expectEq$(b.layout, 1uz);
+
+    // NOTE: Without the override, the leaf is laid out again even if
+    //       nothing changed.
+    _rebuild(root, hflow(_counted(a, 10, false), _counted(b, 20)));
+    expect$(root->_dirty);
+
+    _layout(root);
+    expectEq$(a.layout, 2uz);
+    expectEq$(b.layout, 1uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
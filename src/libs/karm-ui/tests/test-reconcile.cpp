@@ -0,0 +1,183 @@
+#include <karm-test/macros.h>
+#include <karm-ui/node.h>
+
+namespace Karm::Ui::Tests {
+
+// A leaf with some state that only lives as long as the node itself and a
+// label that is updated on every rebuild.
+struct Item : public LeafNode<Item> {
+    static inline usize _created = 0;
+
+    usize _state = _created++;
+    Str _label;
+
+    Item(Str label)
+        : _label(label) {}
+
+    bool sameLayout(Item&) override {
+        return true;
+    }
+
+    void reconcile(Item& o) override {
+        _label = o._label;
+    }
+
+    Math::Recti bound() override {
+        return {};
+    }
+};
+
+struct List : public GroupNode<List> {
+    using GroupNode::GroupNode;
+
+    bool sameLayout(List&) override {
+        return true;
+    }
+};
+
+static Child _item(Str label) {
+    return makeRc<Item>(label);
+}
+
+static Child _keyed(usize k, Str label) {
+    return _item(label) | key(k);
+}
+
+static Child _list(Children children) {
+    return makeRc<List>(children);
+}
+
+static void _rebuild(Child& root, Child next) {
+    root = root->reconcile(next).unwrapOr(root);
+}
+
+static Children& _children(Child& root) {
+    return root.unwrap<List>().children();
+}
+
+static Item& _at(Child& root, usize i) {
+    return _children(root)[i].unwrap<Item>();
+}
+
+static Vec<Str> _labels(Child& root) {
+    Vec<Str> labels;
+    for (auto& c : _children(root))
+        labels.pushBack(c.unwrap<Item>()._label);
+    return labels;
+}
+
+test$("ui-reconcile-keyed-prepend") {
+    auto root = _list({_keyed(1, "a"), _keyed(2, "b"), _keyed(3, "c")});
+    auto a = _at(root, 0)._state;
+    auto b = _at(root, 1)._state;
+    auto c = _at(root, 2)._state;
+
+    _rebuild(root, _list({_keyed(0, "z"), _keyed(1, "A"), _keyed(2, "B"), _keyed(3, "C")}));
+
+    expectEq$(_labels(root), (Vec<Str>{"z", "A", "B", "C"}));
+    expect$(_at(root, 0)._state > c);
+    expectEq$(_at(root, 1)._state, a);
+    expectEq$(_at(root, 2)._state, b);
+    expectEq$(_at(root, 3)._state, c);
+    expect$(root->_dirty);
+
+    for (auto& child : _children(root))
+        expect$(child->parent() == &*root);
+
+    return Ok();
+}
+
+test$("ui-reconcile-keyed-remove") {
+    auto removed = _keyed(2, "b");
+    auto root = _list({_keyed(1, "a"), removed, _keyed(3, "c")});
+    auto a = _at(root, 0)._state;
+    auto c = _at(root, 2)._state;
+
+    _rebuild(root, _list({_keyed(1, "a"), _keyed(3, "c")}));
+
+    expectEq$(_labels(root), (Vec<Str>{"a", "c"}));
+    expectEq$(_at(root, 0)._state, a);
+    expectEq$(_at(root, 1)._state, c);
+    expect$(removed->parent() == nullptr);
+
+    return Ok();
+}
+
+test$("ui-reconcile-keyed-reorder") {
+    auto root = _list({_keyed(1, "a"), _keyed(2, "b"), _keyed(3, "c")});
+    Vec<Node*> before;
+    for (auto& child : _children(root))
+        before.pushBack(&*child);
+
+    // NOTE: Rebuilding in the same order keeps every node in place, so
+    //       the list doesn't need to be laid out again.
+    root->_dirty = false;
+    _rebuild(root, _list({_keyed(1, "a"), _keyed(2, "b"), _keyed(3, "c")}));
+    expect$(not root->_dirty);
+
+    _rebuild(root, _list({_keyed(3, "c"), _keyed(1, "a"), _keyed(2, "b")}));
+
+    expectEq$(_labels(root), (Vec<Str>{"c", "a", "b"}));
+    expect$(&*_children(root)[0] == before[2]);
+    expect$(&*_children(root)[1] == before[0]);
+    expect$(&*_children(root)[2] == before[1]);
+    expect$(root->_dirty);
+
+    return Ok();
+}
+
+test$("ui-reconcile-keyed-duplicate") {
+    auto root = _list({_keyed(1, "a"), _keyed(1, "b")});
+    Node* first = &*_children(root)[0];
+    Node* second = &*_children(root)[1];
+
+    _rebuild(root, _list({_keyed(1, "A"), _keyed(1, "B")}));
+
+    // NOTE: Duplicated keys are paired once, the other node is a new one,
+    //       and no node ends up in the list twice.
+    expectEq$(_labels(root), (Vec<Str>{"A", "B"}));
+    Node* x = &*_children(root)[0];
+    Node* y = &*_children(root)[1];
+    expect$(x != y);
+
+    usize kept = 0;
+    for (Node* n : {x, y})
+        if (n == first or n == second)
+            kept++;
+    expectEq$(kept, 1uz);
+
+    for (auto& child : _children(root))
+        expect$(child->parent() == &*root);
+
+    return Ok();
+}
+
+test$("ui-reconcile-keyed-mixed") {
+    auto root = _list({_keyed(1, "a"), _item("x"), _keyed(2, "b"), _item("y")});
+    auto a = _at(root, 0)._state;
+    auto x = _at(root, 1)._state;
+    auto b = _at(root, 2)._state;
+    auto y = _at(root, 3)._state;
+
+    // NOTE: Keyed children follow their key, unkeyed ones are paired with
+    //       the unkeyed ones in order, whatever their position.
+    _rebuild(root, _list({_item("X"), _keyed(2, "B"), _item("Y"), _keyed(1, "A"), _item("Z")}));
+
+    expectEq$(_labels(root), (Vec<Str>{"X", "B", "Y", "A", "Z"}));
+    expectEq$(_at(root, 0)._state, x);
+    expectEq$(_at(root, 1)._state, b);
+    expectEq$(_at(root, 2)._state, y);
+    expectEq$(_at(root, 3)._state, a);
+    expect$(_at(root, 4)._state > y);
+
+    // NOTE: A keyed node is never paired with an unkeyed one.
+    _rebuild(root, _list({_item("X"), _item("Y"), _item("Z"), _item("W")}));
+    expectEq$(_at(root, 0)._state, x);
+    expectEq$(_at(root, 1)._state, y);
+    expect$(_at(root, 2)._state != a and _at(root, 2)._state != b);
+    expect$(_at(root, 3)._state != a and _at(root, 3)._state != b);
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,145 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layout.h>
+#include <karm-ui/scroll.h>
+
+namespace Karm::Ui::Tests {
+
+// A row that remembers where it was placed.
+struct Row : public LeafNode<Row> {
+    Math::Recti _bound{};
+
+    bool sameLayout(Row&) override {
+        return true;
+    }
+
+    void layout(Math::Recti r) override {
+        _bound = r;
+    }
+
+    Math::Recti bound() override {
+        return _bound;
+    }
+};
+
+// The rows built so far, by index, in the order they were built.
+struct _Built {
+    Vec<usize> indices;
+    Vec<Child> rows;
+
+    ItemBuilder builder() {
+        return [this](usize index) -> Child {
+            Child row = makeRc<Row>();
+            indices.pushBack(index);
+            rows.pushBack(row);
+            return row;
+        };
+    }
+
+    Math::Recti bound(usize index) {
+        for (usize i = 0; i < indices.len(); i++)
+            if (indices[i] == index)
+                return rows[i]->bound();
+        return {};
+    }
+
+    usize first() const {
+        return indices.len() ? indices[0] : 0;
+    }
+
+    usize last() const {
+        return indices.len() ? indices[indices.len() - 1] : 0;
+    }
+};
+
+static Math::Recti const VIEWPORT = {0, 0, 100, 50};
+
+static Child _frame(Child list) {
+    auto root = stack(list);
+    root->measure(VIEWPORT.size(), Hint::PREFERRED);
+    root->place(VIEWPORT);
+    return root;
+}
+
+// NOTE: Scrolling is animated, an animation step of 1/12s gets there in
+//       one frame.
+static void _scroll(Child& root, isize offset) {
+    event<App::MouseEvent>(
+        *root,
+        App::MouseEvent{
+            .type = App::MouseEvent::SCROLL,
+            .pos = VIEWPORT.center(),
+            .scroll = {0, offset / 128.},
+        }
+    );
+    event<Node::AnimateEvent>(*root, 1. / 12);
+}
+
+test$("ui-vlist-range") {
+    _Built built;
+    auto root = _frame(vlist(100, 10, built.builder()));
+
+    // NOTE: Rows 0 to 4 are in view, the row below them is partly in view,
+    //       then comes the overscan.
+    expectEq$(built.indices.len(), 6uz + VLIST_OVERSCAN);
+    expectEq$(built.first(), 0uz);
+    expectEq$(built.last(), 5uz + VLIST_OVERSCAN);
+    expectEq$(built.bound(3), (Math::Recti{0, 30, 100, 10}));
+
+    return Ok();
+}
+
+test$("ui-vlist-scrolled") {
+    _Built built;
+    auto root = _frame(vlist(100, 10, built.builder()));
+    built.indices.clear();
+    built.rows.clear();
+
+    // NOTE: Rows 20 to 24 are now in view, only those that weren't built
+    //       yet are.
+    _scroll(root, -200);
+    expectEq$(built.first(), 20uz - VLIST_OVERSCAN);
+    expectEq$(built.last(), 25uz + VLIST_OVERSCAN);
+    expectEq$(built.indices.len(), 6uz + 2 * VLIST_OVERSCAN);
+
+    // NOTE: Rows are placed in content coordinates, the scroll is applied
+    //       when painting.
+    expectEq$(built.bound(20), (Math::Recti{0, 200, 100, 10}));
+
+    return Ok();
+}
+
+test$("ui-vlist-end") {
+    _Built built;
+    auto root = _frame(vlist(30, 10, built.builder()));
+
+    // NOTE: The scroll stops at the last row, there is nothing to build
+    //       past it.
+    _scroll(root, -10000);
+    expectEq$(built.last(), 29uz);
+    expectEq$(built.bound(29), (Math::Recti{0, 290, 100, 10}));
+
+    return Ok();
+}
+
+test$("ui-vgrid-columns") {
+    _Built built;
+    auto root = _frame(vgrid(50, {30, 10}, built.builder()));
+
+    // NOTE: Three columns of 30 fit in 100, rows are filled left to right.
+    expectEq$(built.first(), 0uz);
+    expectEq$(built.last(), (6 + VLIST_OVERSCAN) * 3 - 1);
+    expectEq$(built.bound(4), (Math::Recti{30, 10, 30, 10}));
+    expectEq$(built.bound(29), (Math::Recti{60, 90, 30, 10}));
+
+    // NOTE: The last row is only partly filled.
+    built.indices.clear();
+    built.rows.clear();
+    _scroll(root, -100);
+    expectEq$(built.first(), (6 + VLIST_OVERSCAN) * 3);
+    expectEq$(built.last(), 49uz);
+    expectEq$(built.bound(49), (Math::Recti{30, 160, 30, 10}));
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
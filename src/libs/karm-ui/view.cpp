@@ -1,3 +1,4 @@
+#include <karm-gfx/cpu/canvas.h>
 #include <karm-text/loader.h>
 
 #include "box.h"
@@ -229,8 +230,32 @@ struct Text : public View<Text> {
     Text(::Text::ProseStyle style, Str text)
         : _prose(makeRc<Karm::Text::Prose>(style, text)) {}
 
+    static bool _sameProse(Karm::Text::Prose const& lhs, Karm::Text::Prose const& rhs) {
+        auto const& l = lhs._style;
+        auto const& r = rhs._style;
+
+        // NOTE: Spans can carry styling we don't know how to compare.
+        if (lhs._spans.len() or rhs._spans.len())
+            return false;
+
+        return &*l.font.fontface == &*r.font.fontface and
+               l.font.fontsize == r.font.fontsize and
+               l.font.lineheight == r.font.lineheight and
+               l.align == r.align and
+               l.color == r.color and
+               l.wordwrap == r.wordwrap and
+               l.multiline == r.multiline and
+               lhs._runes == rhs._runes;
+    }
+
+    bool sameLayout(Text& o) override {
+        return &*_prose == &*o._prose or _sameProse(*_prose, *o._prose);
+    }
+
     void reconcile(Text& o) override {
-        _prose = std::move(o._prose);
+        // NOTE: Keep our prose, and its measurements, when nothing changed.
+        if (not _sameProse(*_prose, *o._prose))
+            _prose = std::move(o._prose);
     }
 
     void paint(Gfx::Canvas& g, Math::Recti) override {
@@ -307,6 +332,11 @@ struct Image : public View<Image> {
     Image(Karm::Image::Picture image, Opt<Math::Radiif> radii = NONE)
         : _image(image), _radii(radii) {}
 
+    // NOTE: Images keep their first picture across rebuilds.
+    bool sameLayout(Image&) override {
+        return true;
+    }
+
     void paint(Gfx::Canvas& g, Math::Recti) override {
         g.push();
 
@@ -314,7 +344,10 @@ struct Image : public View<Image> {
             g.fillStyle(_image.pixels());
             g.fill(bound(), *_radii);
         } else {
-            g.blit(bound(), _image);
+            if (auto size = g.deviceSize(bound()))
+                g.blit(bound(), _image.scaled(*size)->pixels());
+            else
+                g.blit(bound(), _image.pixels());
         }
 
         g.pop();
@@ -460,4 +493,116 @@ Child foregroundFilter(Gfx::Filter f, Child child) {
     return makeRc<ForegroundFilter>(f, std::move(child));
 }
 
+// MARK: Layer -----------------------------------------------------------------
+
+static usize _layerUsage = 0;
+
+struct Layer : public ProxyNode<Layer> {
+    Math::Recti _bound;
+    Opt<Rc<Gfx::Surface>> _surface;
+    Opt<Math::Recti> _damage;
+
+    using ProxyNode<Layer>::ProxyNode;
+
+    bool sameLayout(Layer&) override {
+        return true;
+    }
+
+    void reconcile(Layer& o) override {
+        ProxyNode<Layer>::reconcile(o);
+
+        // NOTE: The rebuild may have changed how the child looks without
+        //       it asking to be repainted.
+        _damage = _bound;
+    }
+
+    ~Layer() {
+        _release();
+    }
+
+    static usize _bytes(Math::Vec2i size) {
+        return size.x * size.y * Gfx::RGBA8888.bpp();
+    }
+
+    void _release() {
+        if (not _surface)
+            return;
+        _layerUsage -= _bytes((*_surface)->pixels().size());
+        _surface = NONE;
+    }
+
+    // NOTE: The surface is keyed by the size of the layer in device
+    //       pixels, so it's rasterized again when the canvas is scaled.
+    bool _ensureSurface(Math::Vec2i size) {
+        if (_surface and (*_surface)->pixels().size() == size)
+            return true;
+
+        _release();
+        if (size.x <= 0 or size.y <= 0 or _bound.width <= 0 or _bound.height <= 0)
+            return false;
+
+        auto bytes = _bytes(size);
+        if (_layerUsage + bytes > LAYER_BUDGET)
+            return false;
+
+        _surface = Gfx::Surface::alloc(size);
+        _layerUsage += bytes;
+        _damage = _bound;
+        return true;
+    }
+
+    void _rasterize(Math::Recti r) {
+        auto size = (*_surface)->pixels().size();
+
+        Gfx::CpuCanvas g;
+        g.begin((*_surface)->mutPixels());
+        g.scale(size.cast<f64>() / _bound.size().cast<f64>());
+        g.origin(-_bound.xy.cast<f64>());
+        g.clip(r.cast<f64>());
+        g.clear(r, Gfx::ALPHA);
+        child().paint(g, r);
+        g.end();
+    }
+
+    void paint(Gfx::Canvas& g, Math::Recti r) override {
+        // NOTE: Canvases that aren't backed by pixels get the child as is.
+        auto size = g.deviceSize(_bound);
+        if (not size or not _ensureSurface(*size)) {
+            child().paint(g, r);
+            return;
+        }
+
+        if (_damage) {
+            _rasterize(*_damage);
+            _damage = NONE;
+        }
+
+        g.blit(_bound, (*_surface)->pixels());
+    }
+
+    void bubble(App::Event& e) override {
+        if (auto pe = e.is<Node::PaintEvent>()) {
+            auto damage = pe->bound.clipTo(_bound);
+            if (damage.width > 0 and damage.height > 0)
+                _damage = _damage ? _damage->mergeWith(damage) : damage;
+        }
+
+        ProxyNode<Layer>::bubble(e);
+    }
+
+    void layout(Math::Recti r) override {
+        _bound = r;
+        _damage = r;
+        child().place(r);
+    }
+
+    Math::Recti bound() override {
+        return _bound;
+    }
+};
+
+Child layer(Child child) {
+    return makeRc<Layer>(std::move(child));
+}
+
 } // namespace Karm::Ui
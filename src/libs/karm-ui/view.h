@@ -63,12 +63,12 @@ Child text(Str text);
 Child text(Rc<Karm::Text::Prose> prose);
 
 template <typename... Args>
-inline Child text(Text::ProseStyle style, Str format, Args&&... args) {
+inline Child text(Text::ProseStyle style, Io::Fmt<Args...> format, Args&&... args) {
     return text(style, Io::format(format, std::forward<Args>(args)...).unwrap());
 }
 
 template <typename... Args>
-inline Child text(Str format, Args&&... args) {
+inline Child text(Io::Fmt<Args...> format, Args&&... args) {
     return text(Io::format(format, std::forward<Args>(args)...).unwrap());
 }
 
@@ -76,11 +76,11 @@ inline Child text(Str format, Args&&... args) {
     inline Child STYLE(Str text) { return Karm::Ui::text(TextStyles::STYLE(), text); }                                    \
     inline Child STYLE(Gfx::Color color, Str text) { return Karm::Ui::text(TextStyles::STYLE().withColor(color), text); } \
     template <typename... Args>                                                                                           \
-    inline Child STYLE(Str format, Args&&... args) {                                                                      \
+    inline Child STYLE(Io::Fmt<Args...> format, Args&&... args) {                                                         \
         return text(TextStyles::STYLE(), format, std::forward<Args>(args)...);                                            \
     }                                                                                                                     \
     template <typename... Args>                                                                                           \
-    inline Child STYLE(Gfx::Color color, Str format, Args&&... args) {                                                    \
+    inline Child STYLE(Gfx::Color color, Io::Fmt<Args...> format, Args&&... args) {                                       \
         return text(TextStyles::STYLE().withColor(color), format, std::forward<Args>(args)...);                           \
     }
 
@@ -143,4 +143,22 @@ inline auto foregroundFilter(Gfx::Filter f) {
     };
 }
 
+// MARK: Layer -----------------------------------------------------------------
+
+/// Memory all the layers together may use for their surfaces, layers
+/// that would go over it paint their child directly.
+static constexpr usize LAYER_BUDGET = 64 * 1024 * 1024;
+
+/// Rasterize the child into an offscreen surface and blit it on later
+/// frames, only the parts the child asks to repaint are rasterized again.
+/// The child can't use background filters, there is nothing behind it in
+/// the surface.
+Child layer(Child child);
+
+inline auto layer() {
+    return [](Child child) {
+        return layer(child);
+    };
+}
+
 } // namespace Karm::Ui
@@ -6,8 +6,10 @@
 #include <karm-kira/scaffold.h>
 #include <karm-kira/side-panel.h>
 #include <karm-mime/mime.h>
+#include <karm-sys/async.h>
 #include <karm-sys/file.h>
 #include <karm-sys/launch.h>
+#include <karm-sys/time.h>
 #include <karm-ui/dialog.h>
 #include <karm-ui/focus.h>
 #include <karm-ui/input.h>
@@ -55,6 +57,7 @@ struct State {
     usize currentIndex = 0;
     Vec<Navigate> history;
     Res<Rc<Markup::Document>> dom;
+    Opt<Rc<Driver::Loader>> loader;
     SidePanel sidePanel = SidePanel::CLOSE;
     InspectState inspect = {};
     bool wireframe = false;
@@ -83,36 +86,78 @@ struct GoForward {};
 
 struct ToggleWireframe {};
 
+struct LoadMore {
+    Rc<Driver::Loader> loader;
+};
+
 using Action = Union<
     Reload,
     GoBack,
     GoForward,
     ToggleWireframe,
+    LoadMore,
     SidePanel,
     InspectorAction,
     Navigate>;
 
+// Gives the event loop a chance to lay out and paint what was loaded so far
+// before parsing the next chunk of the document.
+static Async::_Task<Opt<Action>> _loadMoreAsync(Rc<Driver::Loader> loader) {
+    (void)co_await Sys::globalSched().sleepAsync(Sys::instant() + 1_ms);
+    co_return Action{LoadMore{loader}};
+}
+
+static Ui::Task<Action> _loadMore(State& s, Rc<Driver::Loader> loader) {
+    loader->step();
+    if (loader->done()) {
+        s.loader = NONE;
+        return NONE;
+    }
+    return _loadMoreAsync(loader);
+}
+
 Ui::Task<Action> reduce(State& s, Action a) {
+    Ui::Task<Action> task = NONE;
+
     a.visit(Visitor{
         [&](Reload) {
             auto const& object = s.currentUrl();
+            s.loader = NONE;
+
             if (object.action == Mime::Uti::PUBLIC_MODIFY) {
                 s.dom = Vaev::Driver::viewSource(object.url);
-            } else {
-                s.dom = Vaev::Driver::fetchDocument(object.url);
+                return;
+            }
+
+            auto loader = Vaev::Driver::Loader::open(object.url);
+            if (not loader) {
+                s.dom = loader.none();
+                return;
+            }
+
+            s.dom = Ok(loader.unwrap()->document());
+            if (not loader.unwrap()->done()) {
+                s.loader = loader.unwrap();
+                task = _loadMoreAsync(loader.unwrap());
             }
         },
         [&](GoBack) {
             s.currentIndex--;
-            reduce(s, Reload{}).unwrap();
+            task = reduce(s, Reload{});
         },
         [&](GoForward) {
             s.currentIndex++;
-            reduce(s, Reload{}).unwrap();
+            task = reduce(s, Reload{});
         },
         [&](ToggleWireframe) {
             s.wireframe = not s.wireframe;
         },
+        [&](LoadMore l) {
+            // NOTE: Chunks of a document that was navigated away from are
+            //       dropped.
+            if (s.loader and &s.loader->unwrap() == &l.loader.unwrap())
+                task = _loadMore(s, l.loader);
+        },
         [&](SidePanel p) {
             s.sidePanel = p;
         },
@@ -122,11 +167,11 @@ Ui::Task<Action> reduce(State& s, Action a) {
         [&](Navigate n) {
             s.history.pushBack(n);
             s.currentIndex++;
-            reduce(s, Reload{}).unwrap();
+            task = reduce(s, Reload{});
         },
     });
 
-    return NONE;
+    return task;
 }
 
 using Model = Ui::Model<State, Action, reduce>;
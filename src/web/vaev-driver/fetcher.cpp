@@ -1,3 +1,4 @@
+#include <karm-image/cache.h>
 #include <karm-mime/mime.h>
 #include <karm-sys/dir.h>
 #include <karm-sys/file.h>
@@ -9,25 +10,53 @@
 
 namespace Vaev::Driver {
 
-Res<Rc<Markup::Document>> loadDocument(Mime::Url const& url, Mime::Mime const& mime, Io::Reader& reader) {
+// Returns the bytes as UTF-8 text, with malformed sequences replaced by
+// U+FFFD.
+static String _decodeUtf8(Bytes bytes) {
+    StringBuilder sb{bytes.len()};
+    while (bytes.len()) {
+        usize valid = Utf8::validLen(bytes);
+        sb.append(Str{(char const*)bytes.buf(), valid});
+        bytes = next(bytes, valid);
+
+        if (bytes.len()) {
+            sb.append(REPLACEMENT);
+            bytes = next(bytes, 1);
+        }
+    }
+    return sb.take();
+}
+
+static Res<> _parseXml(Bytes bytes, Ns ns, Markup::Document& dom) {
+    // NOTE: Well-formed text is scanned in place, anything else has to go
+    //       through a copy with the malformed sequences replaced.
+    Str str{(char const*)bytes.buf(), bytes.len()};
+    String buf;
+    if (Utf8::validLen(bytes) != bytes.len()) {
+        buf = _decodeUtf8(bytes);
+        str = buf;
+    }
+
+    Io::SScan scan{str};
+    Markup::XmlParser parser;
+    return parser.parse(scan, ns, dom);
+}
+
+Res<Rc<Markup::Document>> loadDocument(Mime::Url const& url, Mime::Mime const& mime, Bytes bytes) {
     auto dom = makeRc<Markup::Document>(url);
-    auto buf = try$(Io::readAllUtf8(reader));
 
     if (mime.is("text/html"_mime)) {
         Markup::HtmlParser parser{dom};
-        parser.write(buf);
+        parser.feed(bytes);
+        parser.end();
 
         return Ok(dom);
     } else if (mime.is("application/xhtml+xml"_mime)) {
-        Io::SScan scan{buf};
-        Markup::XmlParser parser;
-        try$(parser.parse(scan, HTML, *dom));
+        try$(_parseXml(bytes, HTML, *dom));
 
         return Ok(dom);
     } else if (mime.is("image/svg+xml"_mime)) {
-        Io::SScan scan{buf};
-        Markup::XmlParser parser;
-        try$(parser.parse(scan, SVG, *dom));
+        try$(_parseXml(bytes, SVG, *dom));
 
         return Ok(dom);
     } else {
@@ -36,9 +65,38 @@ Res<Rc<Markup::Document>> loadDocument(Mime::Url const& url, Mime::Mime const& m
     }
 }
 
+Res<Rc<Markup::Document>> loadDocument(Mime::Url const& url, Mime::Mime const& mime, Io::Reader& reader) {
+    if (mime.is("text/html"_mime)) {
+        // NOTE: HTML is parsed as it comes in, without waiting for the
+        //       whole document.
+        auto dom = makeRc<Markup::Document>(url);
+        Markup::HtmlParser parser{dom};
+
+        Array<u8, 16 * 1024> buf;
+        while (true) {
+            usize read = try$(reader.read(mutBytes(buf)));
+            if (read == 0)
+                break;
+            parser.feed(sub(buf, 0, read));
+        }
+        parser.end();
+
+        return Ok(dom);
+    }
+
+    auto buf = try$(Io::readAllUtf8(reader));
+    return loadDocument(url, mime, bytes(buf));
+}
+
 Res<Rc<Markup::Document>> viewSource(Mime::Url const& url) {
     auto file = try$(Sys::File::open(url));
-    auto buf = try$(Io::readAllUtf8(file));
+
+    String buf;
+    auto map = Sys::mmap().map(file);
+    if (map)
+        buf = _decodeUtf8(map.unwrap().bytes());
+    else
+        buf = try$(Io::readAllUtf8(file));
 
     auto dom = makeRc<Markup::Document>(url);
 
@@ -106,15 +164,60 @@ Res<Rc<Markup::Document>> fetchDocument(Mime::Url const& url) {
             if (not mime.has())
                 return Error::invalidInput("cannot determine MIME type");
 
-            auto dom = makeRc<Markup::Document>(url);
             auto file = try$(Sys::File::open(url));
-            return loadDocument(url, *mime, file);
+
+            // NOTE: Parse straight from the mapped file, the ones that can't
+            //       be mapped (eg. empty files) are read instead.
+            auto map = Sys::mmap().map(file);
+            if (not map)
+                return loadDocument(url, *mime, file);
+            return loadDocument(url, *mime, map.unwrap().bytes());
         }
     } else {
         return Error::invalidInput("unsupported url scheme");
     }
 }
 
+Res<Rc<Loader>> Loader::open(Mime::Url const& url) {
+    if (url.scheme != "file" and url.scheme != "bundle")
+        return Ok(makeRc<Loader>(try$(fetchDocument(url))));
+
+    if (try$(Sys::isDir(url)))
+        return Ok(makeRc<Loader>(try$(fetchDocument(url))));
+
+    auto mime = Mime::sniffSuffix(url.path.suffix());
+    if (not mime.has() or not mime->is("text/html"_mime))
+        return Ok(makeRc<Loader>(try$(fetchDocument(url))));
+
+    auto file = try$(Sys::File::open(url));
+    auto map = Sys::mmap().map(file);
+    if (not map)
+        return Ok(makeRc<Loader>(try$(loadDocument(url, *mime, file))));
+
+    auto loader = makeRc<Loader>(makeRc<Markup::Document>(url));
+    loader->_map = map.take();
+    loader->_parser = makeBox<Markup::HtmlParser>(loader->_dom);
+    loader->step();
+    return Ok(loader);
+}
+
+void Loader::step() {
+    if (not _parser)
+        return;
+
+    auto bytes = _map->bytes();
+    auto chunk = sub(bytes, _pos, min(_pos + _chunk, bytes.len()));
+    (*_parser)->feed(chunk);
+    _pos += chunk.len();
+    _chunk *= 2;
+
+    if (_pos == bytes.len()) {
+        (*_parser)->end();
+        _parser = NONE;
+        _map = NONE;
+    }
+}
+
 Res<Style::StyleSheet> fetchStylesheet(Mime::Url url, Style::Origin origin) {
     auto file = try$(Sys::File::open(url));
     auto buf = try$(Io::readAllUtf8(file));
@@ -158,4 +261,16 @@ void fetchStylesheets(Markup::Node const& node, Style::StyleBook& sb) {
     }
 }
 
+void fetchImages(Markup::Node const& node) {
+    auto el = node.is<Markup::Element>();
+    if (el and el->tagName == Html::IMG) {
+        auto src = el->getAttribute(Html::SRC_ATTR).unwrapOr(""s);
+        Karm::Image::globalCache().load(Mime::Url::parse(src));
+        return;
+    }
+
+    for (auto& child : node.children())
+        fetchImages(*child);
+}
+
 } // namespace Vaev::Driver
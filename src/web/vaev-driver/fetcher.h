@@ -1,7 +1,9 @@
 #pragma once
 
 #include <karm-mime/url.h>
+#include <karm-sys/mmap.h>
 #include <vaev-markup/dom.h>
+#include <vaev-markup/html.h>
 #include <vaev-style/stylesheet.h>
 
 namespace Vaev::Driver {
@@ -10,10 +12,45 @@ Res<Style::StyleSheet> fetchStylesheet(Mime::Url url, Style::Origin origin = Sty
 
 void fetchStylesheets(Markup::Node const& node, Style::StyleBook& sb);
 
+// Starts decoding the images of the document in the background, so they are
+// ready, or close to, by the time they are painted.
+void fetchImages(Markup::Node const& node);
+
 Res<Rc<Markup::Document>> fetchDocument(Mime::Url const& url);
 
 Res<Rc<Markup::Document>> loadDocument(Mime::Url const& url, Mime::Mime const& mime, Io::Reader& reader);
 
+Res<Rc<Markup::Document>> loadDocument(Mime::Url const& url, Mime::Mime const& mime, Bytes bytes);
+
 Res<Rc<Markup::Document>> viewSource(Mime::Url const& url);
 
+// Loads a document a chunk at a time, so what was parsed so far can be laid
+// out and painted before the whole document is available.
+struct Loader {
+    static constexpr usize FIRST_CHUNK = 64 * 1024;
+
+    Rc<Markup::Document> _dom;
+    Opt<Sys::Mmap> _map;
+    Opt<Box<Markup::HtmlParser>> _parser;
+    usize _pos = 0;
+    usize _chunk = FIRST_CHUNK;
+
+    static Res<Rc<Loader>> open(Mime::Url const& url);
+
+    Loader(Rc<Markup::Document> dom)
+        : _dom(dom) {}
+
+    Rc<Markup::Document> document() const {
+        return _dom;
+    }
+
+    bool done() const {
+        return not _parser;
+    }
+
+    // Parses the next chunk of the document, chunks double in size every
+    // time so a document is only laid out a logarithmic number of times.
+    void step();
+};
+
 } // namespace Vaev::Driver
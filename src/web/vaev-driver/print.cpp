@@ -255,50 +255,102 @@ static Style::Media _constructMedia(Print::Settings const& settings) {
     };
 }
 
-Vec<Print::Page> print(Markup::Document const& dom, Print::Settings const& settings) {
-    auto media = _constructMedia(settings);
+// MARK: Pagination ------------------------------------------------------------
+
+// Everything needed to lay out and paint a page on its own, once the
+// breakpoints of the whole document are known.
+struct _PageJob {
+    Rc<Style::PageComputedStyle> style;
+    RectPx rect;
+    RectPx content;
+    Layout::Breakpoint prev;
+    Layout::Breakpoint curr;
+};
+
+// Margin boxes only depend on the @page rules that matched and on the page
+// geometry, pages that share both share their margins.
+struct _MarginCache {
+    struct Entry {
+        Vec<Cursor<Style::PageRule>> rules;
+        RectPx rect;
+        RectPx content;
+        Rc<Scene::Stack> stack;
+    };
 
-    Style::StyleBook stylebook;
-    stylebook.add(
-        fetchStylesheet("bundle://vaev-driver/html.css"_url, Style::Origin::USER_AGENT)
-            .take("user agent stylesheet not available")
-    );
-    stylebook.add(
-        fetchStylesheet("bundle://vaev-driver/print.css"_url, Style::Origin::USER_AGENT)
-            .take("print stylesheet not available")
-    );
+    Vec<Entry> _entries;
 
-    fetchStylesheets(dom, stylebook);
+    static bool _sameRect(RectPx lhs, RectPx rhs) {
+        return lhs.xy == rhs.xy and lhs.wh == rhs.wh;
+    }
 
-    Style::Computer computer{
-        media, stylebook
-    };
+    static bool _sameRules(Vec<Cursor<Style::PageRule>> const& lhs, Vec<Cursor<Style::PageRule>> const& rhs) {
+        if (lhs.len() != rhs.len())
+            return false;
+        for (usize i = 0; i < lhs.len(); i++)
+            if ((Style::PageRule const*)lhs[i] != (Style::PageRule const*)rhs[i])
+                return false;
+        return true;
+    }
 
-    // MARK: Page and Margins --------------------------------------------------
+    Rc<Scene::Stack> paint(_PageJob& job) {
+        for (auto& entry : _entries) {
+            if (_sameRect(entry.rect, job.rect) and
+                _sameRect(entry.content, job.content) and
+                _sameRules(entry.rules, job.style->rules))
+                return entry.stack;
+        }
 
-    Vec<Print::Page> pages;
+        auto stack = makeRc<Scene::Stack>();
+        _paintMargins(*job.style, job.rect, job.content, *stack);
+        _entries.pushBack({job.style->rules, job.rect, job.content, stack});
+        return stack;
+    }
+};
 
-    Style::Computed initialStyle = Style::Computed::initial();
-    initialStyle.color = Gfx::BLACK;
-    initialStyle.setCustomProp("-vaev-url", {Css::Token::string(Io::format("\"{}\"", dom.url()).unwrap())});
-    initialStyle.setCustomProp("-vaev-title", {Css::Token::string(Io::format("\"{}\"", dom.title()).unwrap())});
-    initialStyle.setCustomProp("-vaev-datetime", {Css::Token::string(Io::format("\"{}\"", Sys::now()).unwrap())});
+static InsetsPx _resolvePageMargin(Print::Settings const& settings, Style::PageComputedStyle& pageStyle, RectPx pageRect) {
+    Layout::Resolver resolver{};
 
-    // MARK: Page Content ------------------------------------------------------
+    if (settings.margins == Print::Margins::DEFAULT) {
+        return {
+            resolver.resolve(pageStyle.style->margin->top, pageRect.height),
+            resolver.resolve(pageStyle.style->margin->end, pageRect.width),
+            resolver.resolve(pageStyle.style->margin->bottom, pageRect.height),
+            resolver.resolve(pageStyle.style->margin->start, pageRect.width),
+        };
+    } else if (settings.margins == Print::Margins::CUSTOM) {
+        return settings.margins.custom.cast<Px>();
+    }
 
-    Layout::Tree contentTree = {
-        Layout::build(computer, dom),
+    return {};
+}
+
+static Layout::Input _pageLayoutInput(RectPx pageContent) {
+    return {
+        .knownSize = {pageContent.width, NONE},
+        .position = pageContent.topStart(),
+        .availableSpace = pageContent.size(),
+        .containingBlock = pageContent.size(),
+    };
+}
+
+static void _enterPage(Layout::Tree& contentTree, RectPx pageContent) {
+    contentTree.viewport = Layout::Viewport{
+        .small = pageContent.size(),
     };
+    contentTree.fc = {pageContent.size()};
+}
+
+// Finds where every page breaks, without building any fragments.
+static Vec<_PageJob> _paginate(Style::Computer& computer, Style::Computed const& initialStyle, Style::Media const& media, Print::Settings const& settings, Layout::Tree& contentTree) {
+    Vec<_PageJob> jobs;
 
     Layout::Breakpoint prevBreakpoint{
         .endIdx = 0,
         .advanceCase = Layout::Breakpoint::ADVANCE_CASE::ADVANCE_WITHOUT_CHILDREN
     };
-    Layout::Breakpoint currBreakpoint;
 
     while (true) {
-        Layout::Resolver resolver{};
-        Style::Page page{.name = ""s, .number = pages.len(), .blank = false};
+        Style::Page page{.name = ""s, .number = jobs.len(), .blank = false};
 
         auto pageStyle = computer.computeFor(initialStyle, page);
         RectPx pageRect{
@@ -306,70 +358,131 @@ Vec<Print::Page> print(Markup::Document const& dom, Print::Settings const& setti
             media.height / Px{media.resolution.toDppx()}
         };
 
-        auto pageSize = pageRect.size().cast<f64>();
+        RectPx pageContent = pageRect.shrink(_resolvePageMargin(settings, *pageStyle, pageRect));
+        _enterPage(contentTree, pageContent);
 
-        auto pageStack = makeRc<Scene::Stack>();
+        contentTree.fc.enterDiscovery();
+        auto outDiscovery = Layout::layout(
+            contentTree,
+            _pageLayoutInput(pageContent)
+                .withBreakpointTraverser(Layout::BreakpointTraverser(&prevBreakpoint))
+        );
+        contentTree.fc.leaveDiscovery();
 
-        InsetsPx pageMargin = {};
+        auto currBreakpoint = outDiscovery.completelyLaidOut
+                                  ? Layout::Breakpoint::buildClassB(1, false)
+                                  : outDiscovery.breakpoint.unwrap();
 
-        if (settings.margins == Print::Margins::DEFAULT) {
-            pageMargin = {
-                resolver.resolve(pageStyle->style->margin->top, pageRect.height),
-                resolver.resolve(pageStyle->style->margin->end, pageRect.width),
-                resolver.resolve(pageStyle->style->margin->bottom, pageRect.height),
-                resolver.resolve(pageStyle->style->margin->start, pageRect.width),
-            };
-        } else if (settings.margins == Print::Margins::CUSTOM) {
-            pageMargin = settings.margins.custom.cast<Px>();
-        } else if (settings.margins == Print::Margins::MINIMUM) {
-        }
+        jobs.pushBack({
+            pageStyle,
+            pageRect,
+            pageContent,
+            prevBreakpoint,
+            currBreakpoint,
+        });
 
-        RectPx pageContent = pageRect.shrink(pageMargin);
+        if (outDiscovery.completelyLaidOut)
+            break;
 
-        Layout::Viewport vp{
-            .small = pageContent.size(),
-        };
+        prevBreakpoint = std::move(currBreakpoint);
+    }
 
-        contentTree.viewport = vp;
-        contentTree.fc = {pageContent.size()};
+    return jobs;
+}
 
-        if (settings.headerFooter and settings.margins != Print::Margins::NONE)
-            _paintMargins(*pageStyle, pageRect, pageContent, *pageStack);
+struct _PrintTimes {
+    Duration fragment = Duration::zero();
+    Duration paint = Duration::zero();
+};
+
+// Lays out and paints a single page, the tree is left positioned on it.
+static Print::Page _printPage(_PageJob& job, Layout::Tree& contentTree, _MarginCache& margins, Style::Media const& media, Print::Settings const& settings, _PrintTimes& times) {
+    auto start = Sys::now();
+    _enterPage(contentTree, job.content);
+    auto [_, fragment] = Layout::layoutCreateFragment(
+        contentTree,
+        _pageLayoutInput(job.content)
+            .withBreakpointTraverser(Layout::BreakpointTraverser(&job.prev, &job.curr))
+    );
+    times.fragment += Sys::now() - start;
 
-        Layout::Input pageLayoutInput{
-            .knownSize = {pageContent.width, NONE},
-            .position = pageContent.topStart(),
-            .availableSpace = pageContent.size(),
-            .containingBlock = pageContent.size(),
-        };
+    start = Sys::now();
+    auto pageStack = makeRc<Scene::Stack>();
 
-        contentTree.fc.enterDiscovery();
-        auto outDiscovery = Layout::layout(
-            contentTree,
-            pageLayoutInput.withBreakpointTraverser(Layout::BreakpointTraverser(&prevBreakpoint))
-        );
+    if (settings.headerFooter and settings.margins != Print::Margins::NONE)
+        pageStack->add(margins.paint(job));
 
-        currBreakpoint = outDiscovery.completelyLaidOut
-                             ? Layout::Breakpoint::buildClassB(1, false)
-                             : outDiscovery.breakpoint.unwrap();
+    Layout::paint(fragment, *pageStack);
+    pageStack->prepare();
 
-        contentTree.fc.leaveDiscovery();
-        auto [outReal, fragment] = Layout::layoutCreateFragment(
-            contentTree,
-            pageLayoutInput
-                .withBreakpointTraverser(Layout::BreakpointTraverser(&prevBreakpoint, &currBreakpoint))
-        );
+    Print::Page page{settings.paper, makeRc<Scene::Transform>(pageStack, Math::Trans2f::makeScale(media.resolution.toDppx()))};
+    times.paint += Sys::now() - start;
+    return page;
+}
 
-        Layout::paint(fragment, *pageStack);
-        pageStack->prepare();
+Vec<Print::Page> print(Markup::Document const& dom, Print::Settings const& settings) {
+    auto media = _constructMedia(settings);
 
-        pages.emplaceBack(settings.paper, makeRc<Scene::Transform>(pageStack, Math::Trans2f::makeScale(media.resolution.toDppx())));
+    Style::StyleBook stylebook;
+    stylebook.add(
+        fetchStylesheet("bundle://vaev-driver/html.css"_url, Style::Origin::USER_AGENT)
+            .take("user agent stylesheet not available")
+    );
+    stylebook.add(
+        fetchStylesheet("bundle://vaev-driver/print.css"_url, Style::Origin::USER_AGENT)
+            .take("print stylesheet not available")
+    );
 
-        if (outReal.completelyLaidOut)
-            break;
+    fetchImages(dom);
 
-        std::swap(prevBreakpoint, currBreakpoint);
-    }
+    auto start = Sys::now();
+    fetchStylesheets(dom, stylebook);
+    auto styleTime = Sys::now() - start;
+
+    Style::Computer computer{
+        media, stylebook
+    };
+
+    Style::Computed initialStyle = Style::Computed::initial();
+    initialStyle.color = Gfx::BLACK;
+    initialStyle.setCustomProp("-vaev-url", {Css::Token::string(Io::format("\"{}\"", dom.url()).unwrap())});
+    initialStyle.setCustomProp("-vaev-title", {Css::Token::string(Io::format("\"{}\"", dom.title()).unwrap())});
+    initialStyle.setCustomProp("-vaev-datetime", {Css::Token::string(Io::format("\"{}\"", Sys::now()).unwrap())});
+
+    // MARK: Layout Tree -------------------------------------------------------
+
+    start = Sys::now();
+    Layout::Tree contentTree = {
+        Layout::build(computer, dom),
+    };
+    auto buildTime = Sys::now() - start;
+
+    // MARK: Pagination --------------------------------------------------------
+
+    start = Sys::now();
+    auto jobs = _paginate(computer, initialStyle, media, settings, contentTree);
+    auto paginateTime = Sys::now() - start;
+
+    // MARK: Fragments and Painting --------------------------------------------
+
+    // NOTE: The jobs run one after the other on the calling thread. Each
+    //       one only reads its own breakpoints, but they all go through the
+    //       same layout tree, whose viewport and formatting contexts are
+    //       reset for every page. The boxes also hold Rc handles to their
+    //       styles and fontfaces, which painting copies into the scene, and
+    //       Rc isn't counted atomically. Dispatching the jobs to workers
+    //       needs a tree per worker and Arc handles for the shared state.
+    Vec<Print::Page> pages;
+    _MarginCache margins;
+    _PrintTimes times;
+
+    for (auto& job : jobs)
+        pages.pushBack(_printPage(job, contentTree, margins, media, settings, times));
+
+    logInfo(
+        "printed {} pages, style: {}, build: {}, pagination: {}, fragments: {}, paint: {}",
+        pages.len(), styleTime, buildTime, paginateTime, times.fragment, times.paint
+    );
 
     return pages;
 }
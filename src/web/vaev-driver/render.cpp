@@ -22,6 +22,8 @@ RenderResult render(Markup::Document const& dom, Style::Media const& media, Layo
             .take("user agent stylesheet not available")
     );
 
+    fetchImages(dom);
+
     auto start = Sys::now();
     fetchStylesheets(dom, stylebook);
     auto elapsed = Sys::now() - start;
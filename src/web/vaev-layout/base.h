@@ -1,6 +1,6 @@
 #pragma once
 
-#include <karm-image/picture.h>
+#include <karm-image/cache.h>
 #include <karm-text/prose.h>
 #include <vaev-base/length.h>
 #include <vaev-base/resolution.h>
@@ -239,7 +239,7 @@ using Content = Union<
     None,
     Vec<Box>,
     Rc<Text::Prose>,
-    Karm::Image::Picture>;
+    Karm::Image::Cached>;
 
 struct Attrs {
     usize span = 1;
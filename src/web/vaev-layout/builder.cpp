@@ -1,4 +1,4 @@
-#include <karm-image/loader.h>
+#include <karm-image/cache.h>
 #include <karm-text/loader.h>
 
 #include "builder.h"
@@ -202,7 +202,9 @@ static void _buildImage(Style::Computer& c, Markup::Element const& el, Box& pare
 
     auto src = el.getAttribute(Html::SRC_ATTR).unwrapOr(""s);
     auto url = Mime::Url::parse(src);
-    auto img = Karm::Image::loadOrFallback(url).unwrap();
+    // NOTE: Only the size of the image is needed for layout, the pixels are
+    //       waited on when painting, see Driver::fetchImages().
+    auto img = Karm::Image::globalCache().load(url);
     parent.add({style, font, img});
 }
 
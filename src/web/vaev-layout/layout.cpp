@@ -14,7 +14,7 @@ namespace Vaev::Layout {
 static Opt<Rc<FormatingContext>> _constructFormatingContext(Box& box) {
     auto display = box.style->display;
 
-    if (box.content.is<Karm::Image::Picture>()) {
+    if (box.content.is<Karm::Image::Cached>()) {
         return constructReplacedFormatingContext(box);
     } else if (box.content.is<Rc<Text::Prose>>()) {
         return constructInlineFormatingContext(box);
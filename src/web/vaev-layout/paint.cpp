@@ -32,7 +32,7 @@ static bool _paintBorders(Frag& frag, Gfx::Color currentColor, Gfx::Borders& bor
     return not borders.widths.zero();
 }
 
-static void _paintFrag(Frag& frag, Gfx::Color currentColor, Scene::Stack& stack) {
+static void _paintFrag(Frag& frag, Gfx::Color currentColor, DisplayList& list) {
     auto const& cssBackground = frag.style().backgrounds;
 
     Gfx::Borders borders;
@@ -45,102 +45,231 @@ static void _paintFrag(Frag& frag, Gfx::Color currentColor, Scene::Stack& stack)
     Math::Rectf bound = frag.metrics.borderBox().cast<f64>();
 
     if (any(backgrounds) or hasBorders)
-        stack.add(makeRc<Scene::Box>(bound, std::move(borders), std::move(backgrounds)));
+        list.add(Scene::Box{bound, std::move(borders), std::move(backgrounds)});
 }
 
-static void _establishStackingContext(Frag& frag, Scene::Stack& stack);
-static void _paintStackingContext(Frag& frag, Scene::Stack& stack);
+static bool _sameTextStyle(Text::ProseStyle const& a, Text::ProseStyle const& b) {
+    return &*a.font.fontface == &*b.font.fontface and
+           a.font.fontsize == b.font.fontsize and
+           a.color == b.color;
+}
+
+static void _paintText(Rc<Text::Prose> prose, Math::Vec2f origin, DisplayList& list) {
+    // NOTE: Consecutive runs of text with the same style end up in the
+    //       same node.
+    auto text = list.lastText();
+    if (text and _sameTextStyle(last(text->_runs).prose->_style, prose->_style)) {
+        text->add(origin, prose);
+        list._grow(text->bound());
+        return;
+    }
+
+    list.add(Scene::Text{origin, prose});
+}
 
-static void _paintFrag(Frag& frag, Scene::Stack& stack) {
+static void _paintFrag(Frag& frag, DisplayList& list) {
     Gfx::Color currentColor = Gfx::BLACK;
     currentColor = resolve(frag.style().color, currentColor);
 
-    _paintFrag(frag, currentColor, stack);
+    _paintFrag(frag, currentColor, list);
 
     if (auto prose = frag.box->content.is<Rc<Text::Prose>>()) {
         (*prose)->_style.color = currentColor;
-
-        stack.add(makeRc<Scene::Text>(
-            frag.metrics.borderBox().topStart().cast<f64>(),
-            *prose
-        ));
-    } else if (auto image = frag.box->content.is<Karm::Image::Picture>()) {
-        stack.add(makeRc<Scene::Image>(
+        _paintText(*prose, frag.metrics.borderBox().topStart().cast<f64>(), list);
+    } else if (auto image = frag.box->content.is<Karm::Image::Cached>()) {
+        list.add(Scene::Image{
             frag.metrics.borderBox().cast<f64>(),
-            *image
-        ));
+            image->picture(),
+        });
     }
 }
 
-static void _paintChildren(Frag& frag, Scene::Stack& stack, auto predicate) {
-    for (auto& c : frag.children) {
-        auto& s = c.style();
+// Steps 2 to 7 of the painting order of a stacking context.
+// See https://www.w3.org/TR/CSS22/zindex.html
+enum struct _Phase {
+    NEGATIVE,   //< 2. the child stacking contexts with negative stack levels (most negative first).
+    BLOCK,      //< 3. the in-flow, non-inline-level, non-positioned descendants.
+    FLOAT,      //< 4. the non-positioned floats.
+    INLINE,     //< 5. the in-flow, inline-level, non-positioned descendants, including inline tables and inline blocks.
+    POSITIONED, //< 6. the child stacking contexts with stack level 0 and the positioned descendants with stack level 0.
+    POSITIVE,   //< 7. the child stacking contexts with positive stack levels (least positive first).
+
+    _LEN,
+};
+
+static bool _inPhase(_Phase phase, Style::Computed const& s) {
+    switch (phase) {
+    case _Phase::NEGATIVE:
+        return s.zIndex.value < 0;
 
-        auto zIndex = s.zIndex;
-        if (zIndex != ZIndex::AUTO) {
-            if (predicate(s))
-                _establishStackingContext(c, stack);
-            continue;
-        }
+    case _Phase::BLOCK:
+        return s.zIndex == ZIndex::AUTO and s.display != Display::INLINE and s.position == Position::STATIC;
 
-        // NOTE: Positioned elements act as if they establish a stacking context
-        auto position = s.position;
-        if (position != Position::STATIC) {
-            if (predicate(s))
-                _paintStackingContext(c, stack);
-            continue;
-        }
+    case _Phase::FLOAT:
+        return s.zIndex == ZIndex::AUTO and s.position == Position::STATIC and s.float_ != Float::NONE;
+
+    case _Phase::INLINE:
+        return s.zIndex == ZIndex::AUTO and s.display == Display::INLINE and s.position == Position::STATIC;
 
-        if (predicate(s))
-            _paintFrag(c, stack);
-        _paintChildren(c, stack, predicate);
+    case _Phase::POSITIONED:
+        return s.zIndex == 0 or (s.zIndex == ZIndex::AUTO and s.position != Position::STATIC);
+
+    case _Phase::POSITIVE:
+        return s.zIndex.value > 0;
+
+    default:
+        return false;
     }
 }
 
-static void _paintStackingContext(Frag& frag, Scene::Stack& stack) {
-    // 1. the background and borders of the element forming the stacking context.
-    _paintFrag(frag, stack);
+struct _PaintEntry {
+    enum struct Type {
+        FRAG,                //< Paint the fragment alone, its children have their own entries
+        STACKING_CONTEXT,    //< Establish a new stacking context
+        POSITIONED,          //< Paint as if it established a stacking context, without one
+    };
 
-    // 2. the child stacking contexts with negative stack levels (most negative first).
-    _paintChildren(frag, stack, [](Style::Computed const& s) {
-        return s.zIndex.value < 0;
-    });
+    using enum Type;
 
-    // 3. the in-flow, non-inline-level, non-positioned descendants.
-    _paintChildren(frag, stack, [](Style::Computed const& s) {
-        return s.zIndex == ZIndex::AUTO and s.display != Display::INLINE and s.position == Position::STATIC;
-    });
+    Type type;
+    MutCursor<Frag> frag;
+};
 
-    // 4. the non-positioned floats.
-    _paintChildren(frag, stack, [](Style::Computed const& s) {
-        return s.zIndex == ZIndex::AUTO and s.position == Position::STATIC and s.float_ != Float::NONE;
-    });
+using _PaintBuckets = Array<Vec<_PaintEntry>, toUnderlyingType(_Phase::_LEN)>;
 
-    // 5. the in-flow, inline-level, non-positioned descendants, including inline tables and inline blocks.
-    _paintChildren(frag, stack, [](Style::Computed const& s) {
-        return s.zIndex == ZIndex::AUTO and s.display == Display::INLINE and s.position == Position::STATIC;
-    });
+static _PaintEntry::Type _entryType(Style::Computed const& s) {
+    if (s.zIndex != ZIndex::AUTO)
+        return _PaintEntry::STACKING_CONTEXT;
 
-    // 6. the child stacking contexts with stack level 0 and the positioned descendants with stack level 0.
-    _paintChildren(frag, stack, [](Style::Computed const& s) {
-        return s.zIndex.value == 0 and s.position != Position::STATIC;
-    });
+    // NOTE: Positioned elements act as if they establish a stacking context
+    if (s.position != Position::STATIC)
+        return _PaintEntry::POSITIONED;
 
-    // 7. the child stacking contexts with positive stack levels (least positive first).
-    _paintChildren(frag, stack, [](Style::Computed const& s) {
-        return s.zIndex.value > 0;
-    });
+    return _PaintEntry::FRAG;
 }
 
-static void _establishStackingContext(Frag& frag, Scene::Stack& stack) {
-    auto innerStack = makeRc<Scene::Stack>();
-    innerStack->zIndex = frag.style().zIndex.value;
-    _paintStackingContext(frag, *innerStack);
-    stack.add(std::move(innerStack));
+static void _push(_PaintBuckets& buckets, _PaintEntry::Type type, Frag& frag) {
+    for (usize i = 0; i < buckets.len(); i++)
+        if (_inPhase(static_cast<_Phase>(i), frag.style()))
+            buckets[i].pushBack({type, &frag});
+}
+
+// Collects the positioned descendants of a positioned element, and the
+// stacking contexts it contains, they are painted by the stacking context
+// the element is part of rather than by the element itself.
+static void _collectLayered(Frag& frag, _PaintBuckets& buckets) {
+    for (auto& c : frag.children) {
+        auto type = _entryType(c.style());
+        if (type != _PaintEntry::FRAG)
+            _push(buckets, type, c);
+
+        if (type != _PaintEntry::STACKING_CONTEXT)
+            _collectLayered(c, buckets);
+    }
+}
+
+// Sorts the descendants of a stacking context into the phase they are
+// painted in, visiting each of them once and keeping tree order within
+// each phase.
+//
+// A positioned element is painted as if it established a stacking context
+// (pseudo is set then) but only with its descendants that aren't part of
+// the layered ones, see _collectLayered().
+static void _collect(Frag& frag, _PaintBuckets& buckets, bool pseudo) {
+    for (auto& c : frag.children) {
+        auto type = _entryType(c.style());
+        if (pseudo and type != _PaintEntry::FRAG)
+            continue;
+
+        _push(buckets, type, c);
+
+        if (type == _PaintEntry::FRAG)
+            _collect(c, buckets, pseudo);
+        else if (type == _PaintEntry::POSITIONED)
+            _collectLayered(c, buckets);
+    }
+}
+
+static void _establishStackingContext(Frag& frag, DisplayList& list);
+
+static void _paintStackingContext(Frag& frag, DisplayList& list, bool pseudo = false) {
+    // 1. the background and borders of the element forming the stacking context.
+    _paintFrag(frag, list);
+
+    _PaintBuckets buckets;
+    _collect(frag, buckets, pseudo);
+
+    auto byStackLevel = [](_PaintEntry const& a, _PaintEntry const& b) {
+        return a.frag->style().zIndex.value <=> b.frag->style().zIndex.value;
+    };
+    stableSort(buckets[toUnderlyingType(_Phase::NEGATIVE)], byStackLevel);
+    stableSort(buckets[toUnderlyingType(_Phase::POSITIVE)], byStackLevel);
+
+    for (auto& bucket : buckets) {
+        for (auto& entry : bucket) {
+            switch (entry.type) {
+            case _PaintEntry::FRAG:
+                _paintFrag(*entry.frag, list);
+                break;
+
+            case _PaintEntry::STACKING_CONTEXT:
+                _establishStackingContext(*entry.frag, list);
+                break;
+
+            case _PaintEntry::POSITIONED:
+                _paintStackingContext(*entry.frag, list, true);
+                break;
+            }
+        }
+    }
+}
+
+static void _establishStackingContext(Frag& frag, DisplayList& list) {
+    auto innerList = makeRc<DisplayList>();
+    innerList->zIndex = frag.style().zIndex.value;
+    _paintStackingContext(frag, *innerList);
+    list.add(std::move(innerList));
 }
 
 void paint(Frag& frag, Scene::Stack& stack) {
-    _paintStackingContext(frag, stack);
+    auto list = makeRc<DisplayList>();
+    _paintStackingContext(frag, *list);
+    stack.add(std::move(list));
+}
+
+// MARK: Display List ----------------------------------------------------------
+
+void DisplayList::prepare() {
+    for (auto& item : _items)
+        _node(item).prepare();
+}
+
+void DisplayList::paint(Gfx::Canvas& g, Math::Rectf r, Scene::PaintOptions o) {
+    if (not bound().colide(r))
+        return;
+
+    for (auto& item : _items)
+        _node(item).paint(g, r, o);
+}
+
+void DisplayList::repr(Io::Emit& e) const {
+    e("(display-list z:{}", zIndex);
+    if (_items) {
+        e.indentNewline();
+        for (auto& item : _items) {
+            item.visit(Visitor{
+                [&](Rc<DisplayList> const& list) {
+                    list->repr(e);
+                },
+                [&](auto const& node) {
+                    node.repr(e);
+                },
+            });
+            e.newline();
+        }
+        e.deindent();
+    }
+    e(")");
 }
 
 void wireframe(Frag& frag, Gfx::Canvas& g) {
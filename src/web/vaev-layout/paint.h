@@ -1,11 +1,72 @@
 #pragma once
 
+#include <karm-scene/box.h>
+#include <karm-scene/image.h>
 #include <karm-scene/stack.h>
+#include <karm-scene/text.h>
 
 #include "base.h"
 
 namespace Vaev::Layout {
 
+// The scene of a stacking context, already in painting order.
+// Its nodes are stored inline rather than each in its own heap cell, so a
+// page allocates per stacking context instead of per fragment. The
+// storage lives as long as the scene holding the list.
+struct DisplayList : public Scene::Node {
+    using Item = Union<
+        Scene::Box,
+        Scene::Text,
+        Scene::Image,
+        Rc<DisplayList>>;
+
+    Vec<Item> _items;
+    Math::Rectf _bound;
+
+    static Scene::Node& _node(Item& item) {
+        // NOTE: visit() returns by value, hence the pointer.
+        return *item.visit(Visitor{
+            [](Rc<DisplayList>& list) -> Scene::Node* {
+                return &*list;
+            },
+            [](auto& node) -> Scene::Node* {
+                return &node;
+            },
+        });
+    }
+
+    void _grow(Math::Rectf bound) {
+        _bound = _items.len() ? _bound.mergeWith(bound) : bound;
+    }
+
+    template <typename T>
+    void add(T node) {
+        _grow(node.bound());
+        _items.pushBack(std::move(node));
+    }
+
+    void add(Rc<DisplayList> list) {
+        _grow(list->bound());
+        _items.pushBack(std::move(list));
+    }
+
+    MutCursor<Scene::Text> lastText() {
+        if (not _items.len())
+            return nullptr;
+        return last(_items).is<Scene::Text>();
+    }
+
+    void prepare() override;
+
+    Math::Rectf bound() override {
+        return _bound;
+    }
+
+    void paint(Gfx::Canvas& g, Math::Rectf r, Scene::PaintOptions o) override;
+
+    void repr(Io::Emit& e) const override;
+};
+
 void wireframe(Frag& frag, Gfx::Canvas& g);
 
 void paint(Frag& frag, Scene::Stack& stack);
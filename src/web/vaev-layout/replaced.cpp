@@ -6,8 +6,8 @@ struct ReplacedFormatingContext : public FormatingContext {
     Output run(Tree& tree, Box& box, Input input, [[maybe_unused]] usize startAt, [[maybe_unused]] Opt<usize> stopAt) override {
         Vec2Px size = {};
 
-        if (auto image = box.content.is<Karm::Image::Picture>()) {
-            size = image->bound().size().cast<Px>();
+        if (auto image = box.content.is<Karm::Image::Cached>()) {
+            size = image->size().cast<Px>();
         } else {
             panic("unsupported replaced content");
         }
@@ -0,0 +1,101 @@
+#include <karm-test/macros.h>
+#include <vaev-layout/paint.h>
+
+namespace Vaev::Layout::Tests {
+
+// Every box gets its own background color, so the order they are painted
+// in can be read back from the display list.
+static Box _box(Gfx::Color color, Position position = Position::STATIC, ZIndex zIndex = ZIndex::AUTO) {
+    auto style = makeRc<Style::Computed>(Style::Computed::initial());
+    style->display = Display{Display::FLOW, Display::BLOCK};
+    style->backgrounds.cow().color = color;
+    style->position = position;
+    style->zIndex = zIndex;
+    return {style, Text::Fontface::fallback(), Vec<Box>{}};
+}
+
+static Frag _frag(Box& box) {
+    Frag frag{&box};
+    frag.metrics.borderSize = {Px{10}, Px{10}};
+    for (auto& c : box.children())
+        frag.add(_frag(c));
+    return frag;
+}
+
+static void _flatten(DisplayList& list, Vec<Gfx::Color>& out) {
+    for (auto& item : list._items) {
+        if (auto inner = item.is<Rc<DisplayList>>())
+            _flatten(**inner, out);
+        else if (auto box = item.is<Scene::Box>())
+            out.pushBack(box->_backgrounds[0].unwrap<Gfx::Color>());
+    }
+}
+
+static Vec<Gfx::Color> _paintOrder(Box& root) {
+    auto frag = _frag(root);
+    Scene::Stack stack;
+    paint(frag, stack);
+
+    Vec<Gfx::Color> order;
+    for (auto& child : stack._children)
+        _flatten(child.unwrap<DisplayList>(), order);
+    return order;
+}
+
+static constexpr Gfx::Color ROOT = Gfx::Color::fromHex(0x000001);
+static constexpr Gfx::Color A = Gfx::Color::fromHex(0x00000A);
+static constexpr Gfx::Color B = Gfx::Color::fromHex(0x00000B);
+static constexpr Gfx::Color C = Gfx::Color::fromHex(0x00000C);
+static constexpr Gfx::Color D = Gfx::Color::fromHex(0x00000D);
+static constexpr Gfx::Color E = Gfx::Color::fromHex(0x00000E);
+
+test$("vaev-layout-paint-order-phases") {
+    auto root = _box(ROOT);
+    root.add(_box(A, Position::RELATIVE, 2));
+    root.add(_box(B, Position::RELATIVE));
+    root.add(_box(C, Position::RELATIVE, -1));
+    root.add(_box(D));
+    root.add(_box(E, Position::RELATIVE, 1));
+
+    Vec<Gfx::Color> expected = {ROOT, C, D, B, E, A};
+    expectEq$(_paintOrder(root), expected);
+
+    return Ok();
+}
+
+test$("vaev-layout-paint-order-positioned-descendants") {
+    // NOTE: A is positioned without a z-index, so the stacking contexts and
+    //       the positioned elements in it belong to the root one, they are
+    //       sorted with B and painted after everything else in A.
+    auto root = _box(ROOT);
+    auto a = _box(A, Position::RELATIVE);
+    a.add(_box(C, Position::RELATIVE, 2));
+    a.add(_box(D, Position::RELATIVE));
+    a.add(_box(E));
+    root.add(std::move(a));
+    root.add(_box(B, Position::RELATIVE, 1));
+
+    Vec<Gfx::Color> expected = {ROOT, A, E, D, B, C};
+    expectEq$(_paintOrder(root), expected);
+
+    return Ok();
+}
+
+test$("vaev-layout-paint-order-stacking-context") {
+    // NOTE: A establishes a stacking context, what it contains is painted
+    //       with it, right after its background even with a negative
+    //       z-index, and before B even with a greater one.
+    auto root = _box(ROOT);
+    auto a = _box(A, Position::RELATIVE, 1);
+    a.add(_box(C, Position::RELATIVE, 5));
+    a.add(_box(D, Position::RELATIVE, -1));
+    root.add(std::move(a));
+    root.add(_box(B, Position::RELATIVE, 2));
+
+    Vec<Gfx::Color> expected = {ROOT, A, D, C, B};
+    expectEq$(_paintOrder(root), expected);
+
+    return Ok();
+}
+
+} // namespace Vaev::Layout::Tests
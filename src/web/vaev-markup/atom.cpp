@@ -0,0 +1,62 @@
+#include <karm-base/box.h>
+#include <karm-base/lock.h>
+#include <karm-base/vec.h>
+
+#include "atom.h"
+
+namespace Vaev {
+
+// Open addressing table of every atom ever made, entries are never freed
+// so the pointers handed out stay valid.
+struct _AtomTable {
+    Lock _lock;
+    Vec<Box<Atom::_Data>> _atoms;
+    Vec<Atom::_Data const*> _slots;
+
+    static Hash _hash(Str str) {
+        return Hasher<Bytes>::hash(bytes(str));
+    }
+
+    void _grow() {
+        Vec<Atom::_Data const*> slots;
+        slots.resize(max(_slots.len() * 2, 256uz), nullptr);
+        for (auto& atom : _atoms) {
+            usize i = atom->hash % slots.len();
+            while (slots[i])
+                i = (i + 1) % slots.len();
+            slots[i] = &*atom;
+        }
+        _slots = std::move(slots);
+    }
+
+    Atom::_Data const* intern(Str str) {
+        LockScope scope{_lock};
+
+        // Keep the load factor under 50%
+        if (_atoms.len() * 2 >= _slots.len())
+            _grow();
+
+        auto hash = _hash(str);
+        usize i = hash % _slots.len();
+        while (_slots[i]) {
+            if (_slots[i]->hash == hash and _slots[i]->str == str)
+                return _slots[i];
+            i = (i + 1) % _slots.len();
+        }
+
+        auto& atom = _atoms.emplaceBack(makeBox<Atom::_Data>(String{str}, hash));
+        _slots[i] = &*atom;
+        return &*atom;
+    }
+};
+
+static _AtomTable& _atomTable() {
+    static _AtomTable table;
+    return table;
+}
+
+Atom::_Data const* Atom::_intern(Str str) {
+    return _atomTable().intern(str);
+}
+
+} // namespace Vaev
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <karm-base/hash.h>
+#include <karm-base/string.h>
+#include <karm-io/emit.h>
+
+namespace Vaev {
+
+// An interned string, two atoms made from the same string are the same
+// atom, so comparing them is a pointer comparison. Atoms live for the
+// whole lifetime of the program and are meant for short identifiers
+// (ids, class names) that are compared over and over during styling.
+struct Atom {
+    struct _Data {
+        String str;
+        Hash hash;
+    };
+
+    _Data const* _data;
+
+    static _Data const* _intern(Str str);
+
+    Atom() : Atom(Str{""}) {}
+
+    Atom(Str str) : _data(_intern(str)) {}
+
+    Atom(char const* str) : Atom(Str{str}) {}
+
+    Atom(String const& str) : Atom(str.str()) {}
+
+    Str str() const {
+        return _data->str;
+    }
+
+    Hash hash() const {
+        return _data->hash;
+    }
+
+    bool operator==(Atom const& other) const {
+        return _data == other._data;
+    }
+
+    bool operator==(Str other) const {
+        return _data->str == other;
+    }
+
+    void repr(Io::Emit& e) const {
+        e("{}", str());
+    }
+};
+
+} // namespace Vaev
+
+template <>
+struct Karm::Hasher<Vaev::Atom> {
+    static Hash hash(Vaev::Atom const& v) {
+        return v.hash();
+    }
+};
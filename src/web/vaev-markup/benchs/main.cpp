@@ -0,0 +1,55 @@
+#include <karm-sys/entry.h>
+#include <karm-sys/file.h>
+#include <karm-sys/time.h>
+#include <vaev-markup/html.h>
+
+using namespace Vaev;
+
+static constexpr usize ROUNDS = 8;
+
+// Roughly 4MiB of prose split into paragraphs with some inline markup,
+// character references and a table, close to what a long article looks like.
+static String _generate() {
+    StringBuilder sb;
+    sb.append("<!DOCTYPE html><html><head><title>Benchmark</title></head><body>"s);
+    for (usize i = 0; i < 8192; i++) {
+        sb.append("<h2>Section</h2><p>Lorem ipsum dolor sit amet, consectetur adipiscing elit, "s);
+        sb.append("sed do <b>eiusmod</b> tempor incididunt ut labore et dolore magna aliqua. "s);
+        sb.append("Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "s);
+        sb.append("aliquip ex ea commodo consequat &amp; duis aute irure dolor in <a href=\"#\">reprehenderit</a> "s);
+        sb.append("in voluptate velit esse cillum dolore eu fugiat nulla pariatur.</p>\n"s);
+        sb.append("<table><tr><td>Excepteur sint</td><td>occaecat cupidatat</td></tr></table>\n"s);
+    }
+    sb.append("</body></html>"s);
+    return sb.take();
+}
+
+// Parses a document (a file given on the command line, or a generated one)
+// a few times and reports the throughput of the tokenizer and tree builder.
+Async::Task<> entryPointAsync(Sys::Context& ctx) {
+    auto& args = useArgs(ctx);
+
+    String html;
+    if (args.len() > 0) {
+        auto url = co_try$(Mime::parseUrlOrPath(args[0]));
+        html = co_try$(Sys::readAllUtf8(url));
+    } else {
+        html = _generate();
+    }
+
+    Duration total = Duration::fromUSecs(0);
+    for (usize i = 0; i < ROUNDS; i++) {
+        auto dom = makeRc<Markup::Document>(Mime::Url());
+        Markup::HtmlParser parser{dom};
+
+        auto start = Sys::now();
+        parser.write(html);
+        total += Sys::now() - start;
+    }
+
+    f64 secs = total.toUSecs() / 1e6;
+    Sys::println("{} bytes parsed {} times in {}", html.len(), ROUNDS, total);
+    Sys::println("html-parse: {} MB/s", html.len() * ROUNDS / secs / 1e6);
+
+    co_return Ok();
+}
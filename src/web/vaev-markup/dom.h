@@ -7,6 +7,7 @@
 #include <karm-io/emit.h>
 #include <karm-mime/url.h>
 
+#include "atom.h"
 #include "tags.h"
 
 namespace Vaev::Markup {
@@ -312,32 +313,32 @@ struct Attr : public Node {
 
 // https://dom.spec.whatwg.org/#domtokenlist
 struct TokenList {
-    Vec<String> _tokens;
+    Vec<Atom> _tokens;
 
     usize length() const {
         return _tokens.len();
     }
 
-    Opt<String> item(usize index) const {
+    Opt<Atom> item(usize index) const {
         if (index >= _tokens.len())
             return NONE;
         return _tokens[index];
     }
 
-    bool contains(Str token) const {
+    bool contains(Atom token) const {
         return ::contains(_tokens, token);
     }
 
-    void add(Str token) {
+    void add(Atom token) {
         if (not::contains(_tokens, token))
             _tokens.pushBack(token);
     }
 
-    void remove(Str token) {
+    void remove(Atom token) {
         _tokens.removeAll(token);
     }
 
-    bool toggle(Str token) {
+    bool toggle(Atom token) {
         if (::contains(_tokens, token)) {
             _tokens.removeAll(token);
             return false;
@@ -346,7 +347,7 @@ struct TokenList {
         return true;
     }
 
-    bool replace(Str oldToken, Str newToken) {
+    bool replace(Atom oldToken, Atom newToken) {
         if (not::contains(_tokens, oldToken))
             return false;
         _tokens.removeAll(oldToken);
@@ -361,11 +362,12 @@ struct TokenList {
 struct Element : public Node {
     static constexpr auto TYPE = NodeType::ELEMENT;
 
-    Opt<Str> id() const {
-        return this->getAttribute(Html::ID_ATTR);
+    Opt<Atom> id() const {
+        return this->_id;
     }
 
     TagName tagName;
+    Opt<Atom> _id; //< Interned value of the id attribute, for selector matching
     // NOSPEC: Should be a NamedNodeMap
     Map<AttrName, Rc<Attr>> attributes;
     TokenList classList;
@@ -411,6 +413,8 @@ struct Element : public Node {
             }
             return;
         }
+        if (name == Html::ID_ATTR)
+            this->_id = Atom{value};
         auto attr = makeRc<Attr>(name, value);
         this->attributes.put(name, attr);
     }
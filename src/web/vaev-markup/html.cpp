@@ -3681,6 +3681,27 @@ void HtmlLexer::consume(Rune rune, bool isEof) {
     }
 }
 
+usize HtmlLexer::consumeRun(Str str) {
+    // NOTE: In these states, anything but the characters below is emitted
+    //       as is, so whole runs of them can go out as a single token.
+    if (_state != State::DATA and
+        _state != State::RCDATA and
+        _state != State::RAWTEXT and
+        _state != State::SCRIPT_DATA and
+        _state != State::PLAINTEXT)
+        return 0;
+
+    usize len = 0;
+    while (len < str.len() and str[len] != '&' and str[len] != '<' and str[len] != '\0')
+        len++;
+
+    if (len == 0)
+        return 0;
+
+    _emit(sub(str, 0, len));
+    return len;
+}
+
 // MARK: Parser ----------------------------------------------------------------
 
 // 13.2.2 MARK: Parse errors
@@ -3909,21 +3930,38 @@ static Rc<Element> insertHtmlElement(HtmlParser& b, HtmlToken const& t) {
     return insertAForeignElement(b, t, Vaev::HTML, false);
 }
 
+void HtmlParser::_flushText() {
+    if (not _pendingText)
+        return;
+    (*_pendingText)->data = _pendingData.take();
+    _pendingText = NONE;
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#insert-a-character
-static void insertACharacter(HtmlParser& b, Rune c) {
+// Makes the text node the characters go into pending, their data is then
+// appended to the parser's pending data rather than to the node directly.
+// Returns false if the characters should be ignored.
+static bool _prepareTextInsertion(HtmlParser& b) {
     // 2. Let the adjusted insertion location be the appropriate place for inserting a node.
     auto location = apropriatePlaceForInsertingANode(b);
 
     // 3. If the adjusted insertion location is inside a Document node, then ignore the token.
     if (location.parent->nodeType() == NodeType::DOCUMENT)
-        return;
+        return false;
 
     // 4. If there is a Text node immediately before the adjusted insertion
     //    location, then append data to that Text node's data.
     auto lastChild = location.lastChild();
     if (lastChild and (*lastChild)->nodeType() == NodeType::TEXT) {
         auto text = (*(*lastChild).cast<Text>());
-        text->appendData(c);
+        if (b._pendingText and &(*b._pendingText).unwrap() == &text.unwrap())
+            return true;
+
+        // NOTE: Parsing came back to a text node it already left, pick up
+        //       its data where it was.
+        b._flushText();
+        b._pendingData.append(text->data.str());
+        b._pendingText = text;
     }
 
     // Otherwise, create a new Text node whose data is data and whose node
@@ -3931,11 +3969,23 @@ static void insertACharacter(HtmlParser& b, Rune c) {
     //            adjusted insertion location finds itself, and insert the
     //            newly created node at the adjusted insertion location.
     else {
+        b._flushText();
         auto text = makeRc<Text>(""s);
-        text->appendData(c);
-
         location.insert(text);
+        b._pendingText = text;
     }
+
+    return true;
+}
+
+static void insertACharacter(HtmlParser& b, Rune c) {
+    if (_prepareTextInsertion(b))
+        b._pendingData.append(c);
+}
+
+static void insertCharacters(HtmlParser& b, Str run) {
+    if (_prepareTextInsertion(b))
+        b._pendingData.append(run);
 }
 
 static void insertACharacter(HtmlParser& b, HtmlToken const& t) {
@@ -5730,8 +5780,159 @@ void HtmlParser::_acceptIn(Mode mode, HtmlToken const& t) {
     }
 }
 
+void HtmlParser::_acceptRun(HtmlToken const& t) {
+    // NOTE: Runs never contain NULL, '&' or '<', so in the modes that simply
+    //       insert character tokens the whole run can be inserted at once.
+    //       Other modes see the run one character at a time, as they may
+    //       switch modes halfway through.
+    Cursor<Utf8::Unit> cursor = t.run;
+    HtmlToken c;
+    c.type = HtmlToken::CHARACTER;
+
+    while (not cursor.ended()) {
+        if (_insertionMode == Mode::TEXT) {
+            insertCharacters(*this, {cursor.buf(), cursor.rem()});
+            return;
+        }
+
+        if (_insertionMode == Mode::IN_BODY) {
+            Str rest = {cursor.buf(), cursor.rem()};
+            reconstructActiveFormattingElements(*this);
+            insertCharacters(*this, rest);
+            for (auto r : rest) {
+                if (r != '\t' and r != '\n' and r != '\f' and r != '\r' and r != ' ') {
+                    _framesetOk = false;
+                    break;
+                }
+            }
+            return;
+        }
+
+        if (not Utf8::decodeUnit(c.rune, cursor))
+            return;
+        _acceptIn(_insertionMode, c);
+    }
+}
+
 void HtmlParser::accept(HtmlToken const& t) {
-    _acceptIn(_insertionMode, t);
+    if (t.type == HtmlToken::CHARACTER_RUN)
+        _acceptRun(t);
+    else
+        _acceptIn(_insertionMode, t);
+}
+
+// Consumes text that is known to be well-formed UTF-8.
+void HtmlParser::_consume(Str str) {
+    Cursor<Utf8::Unit> cursor = str;
+
+    while (not cursor.ended()) {
+        usize n = _lexer.consumeRun({cursor.buf(), cursor.rem()});
+        if (n) {
+            cursor.next(n);
+            continue;
+        }
+
+        Rune r;
+        Utf8::decodeUnit(r, cursor);
+        _lexer.consume(r);
+    }
+}
+
+// Length of the UTF-8 sequence started by `lead`, or zero if it can't
+// start one.
+static usize _utf8SequenceLen(u8 lead) {
+    if (lead >= 0xc2 and lead <= 0xdf)
+        return 2;
+    if (lead >= 0xe0 and lead <= 0xef)
+        return 3;
+    if (lead >= 0xf0 and lead <= 0xf4)
+        return 4;
+    return 0;
+}
+
+// Whether `byte` may be the `i`-th byte of the sequence started by `lead`,
+// the bounds of the second byte rule out overlong forms, surrogates and
+// code points above U+10FFFF.
+static bool _utf8Continues(u8 lead, usize i, u8 byte) {
+    u8 lo = 0x80, hi = 0xbf;
+    if (i == 1) {
+        if (lead == 0xe0)
+            lo = 0xa0;
+        else if (lead == 0xed)
+            hi = 0x9f;
+        else if (lead == 0xf0)
+            lo = 0x90;
+        else if (lead == 0xf4)
+            hi = 0x8f;
+    }
+    return byte >= lo and byte <= hi;
+}
+
+// Length of the maximal subpart at the start of `bytes`, the longest run
+// of bytes that starts a valid sequence, or the first byte alone.
+static usize _utf8Subpart(Bytes bytes) {
+    usize len = _utf8SequenceLen(bytes[0]);
+    usize i = 1;
+    while (i < len and i < bytes.len() and _utf8Continues(bytes[0], i, bytes[i]))
+        i++;
+    return i;
+}
+
+// https://encoding.spec.whatwg.org/#utf-8-decoder
+void HtmlParser::_consume(Bytes bytes) {
+    while (bytes.len()) {
+        usize valid = Utf8::validLen(bytes);
+        _consume(Str{(char const*)bytes.buf(), valid});
+        bytes = next(bytes, valid);
+
+        if (not bytes.len())
+            break;
+
+        // NOTE: Keep the start of a sequence continuing in the next chunk,
+        //       only bytes that can still complete it are kept.
+        usize subpart = _utf8Subpart(bytes);
+        if (subpart == bytes.len() and subpart < _utf8SequenceLen(bytes[0])) {
+            _partialLen = bytes.len();
+            copy(bytes, mutBytes(_partial));
+            break;
+        }
+
+        // NOTE: A maximal subpart is replaced as a whole, by a single U+FFFD.
+        _lexer.consume(REPLACEMENT);
+        bytes = next(bytes, subpart);
+    }
+}
+
+void HtmlParser::feed(Bytes bytes) {
+    // NOTE: A byte that can't continue the sequence cut at the end of the
+    //       last chunk ends it, and is decoded again as the start of the next.
+    while (_partialLen and bytes.len()) {
+        if (not _utf8Continues(_partial[0], _partialLen, bytes[0])) {
+            _partialLen = 0;
+            _lexer.consume(REPLACEMENT);
+            break;
+        }
+
+        _partial[_partialLen++] = bytes[0];
+        bytes = next(bytes, 1);
+
+        if (_partialLen == _utf8SequenceLen(_partial[0]))
+            _consume(Str{(char const*)_partial.buf(), std::exchange(_partialLen, 0)});
+    }
+
+    _consume(bytes);
+    _flushText();
+}
+
+void HtmlParser::end() {
+    if (_partialLen) {
+        _partialLen = 0;
+        _lexer.consume(REPLACEMENT);
+    }
+
+    // NOTE: '\3' (End of Text) is used here as a placeholder so we are directed to the EOF case
+    _lexer.consume('\3', true);
+    _flushText();
 }
 
 } // namespace Vaev::Markup
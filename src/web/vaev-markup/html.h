@@ -21,6 +21,7 @@ namespace Vaev::Markup {
     TOKEN(END_TAG)           \
     TOKEN(COMMENT)           \
     TOKEN(CHARACTER)         \
+    TOKEN(CHARACTER_RUN)     \
     TOKEN(END_OF_FILE)
 
 struct HtmlToken {
@@ -41,6 +42,9 @@ struct HtmlToken {
     Type type = NIL;
     String name;
     Rune rune = '\0';
+    // Slice of the input covered by a CHARACTER_RUN token, it's only valid
+    // while the token is being accepted.
+    Str run;
     String data;
     String publicIdent;
     String systemIdent;
@@ -54,6 +58,8 @@ struct HtmlToken {
             e(" name={}", name);
         if (rune)
             e(" rune='{#c}'", rune);
+        if (run.len())
+            e(" run={#}", run);
         if (data)
             e(" data={#}", data);
         if (publicIdent)
@@ -135,6 +141,11 @@ struct HtmlLexer {
         _emit();
     }
 
+    void _emit(Str run) {
+        _begin(HtmlToken::CHARACTER_RUN).run = run;
+        _emit();
+    }
+
     void _beginAttribute() {
         _ensure().attrs.emplaceBack();
     }
@@ -186,6 +197,11 @@ struct HtmlLexer {
     }
 
     void consume(Rune rune, bool isEof = false);
+
+    // Emits the plain character data at the start of str as a single
+    // token, returns the number of bytes consumed, which is zero when the
+    // input doesn't start with plain character data in the current state.
+    usize consumeRun(Str str);
 };
 
 #undef FOREACH_TOKEN
@@ -241,6 +257,17 @@ struct HtmlParser : public HtmlSink {
 
     Vec<HtmlToken> _pendingTableCharacterTokens;
 
+    // The text node characters are currently inserted into, its data is
+    // accumulated in a builder and only set once parsing moves on.
+    Opt<Rc<Text>> _pendingText;
+    StringBuilder _pendingData;
+
+    // Start of a UTF-8 sequence that was cut at the end of the last chunk,
+    // always a valid prefix, so it ends as a single U+FFFD if it's never
+    // completed.
+    Array<u8, 4> _partial{};
+    usize _partialLen = 0;
+
     HtmlParser(Rc<Document> document)
         : _document(document) {
         _lexer.bind(*this);
@@ -340,13 +367,26 @@ struct HtmlParser : public HtmlSink {
 
     void _acceptIn(Mode mode, HtmlToken const& t);
 
+    void _acceptRun(HtmlToken const& t);
+
+    void _flushText();
+
     void accept(HtmlToken const& t) override;
 
+    void _consume(Str str);
+
+    void _consume(Bytes bytes);
+
+    // Parses the next chunk of the document, it doesn't have to end on a
+    // character boundary. Nodes parsed so far are complete when it returns.
+    void feed(Bytes bytes);
+
+    // Signals that there is no more input and finishes the document.
+    void end();
+
     void write(Str str) {
-        for (auto r : iterRunes(str))
-            _lexer.consume(r);
-        // NOTE: '\3' (End of Text) is used here as a placeholder so we are directed to the EOF case
-        _lexer.consume('\3', true);
+        feed(bytes(str));
+        end();
     }
 };
 
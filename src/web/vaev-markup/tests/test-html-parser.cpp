@@ -86,6 +86,90 @@ test$("parse-text") {
     return Ok();
 }
 
+test$("parse-text-in-chunks") {
+    auto dom = makeRc<Markup::Document>(Mime::Url());
+    Markup::HtmlParser parser{dom};
+
+    // NOTE: The chunks split both a tag and a multi-byte sequence
+    parser.feed(bytes("<html><bo"s));
+    parser.feed(bytes("dy>caf\xc3"s));
+    parser.feed(bytes("\xa9 \xff"s));
+
+    auto html = try$(dom->firstChild().cast<Element>());
+    auto body = try$(html->firstChild()->nextSibling().cast<Element>());
+    expect$(body->tagName == Html::BODY);
+
+    // NOTE: What was parsed so far is visible before the end of the document
+    auto text = try$(body->firstChild().cast<Text>());
+    expect$(text->data == "caf\xc3\xa9 \xef\xbf\xbd");
+
+    parser.feed(bytes("more</body></html>"s));
+    parser.end();
+
+    expect$(body->children().len() == 1);
+    expect$(text->data == "caf\xc3\xa9 \xef\xbf\xbdmore");
+
+    return Ok();
+}
+
+static Res<String> _parseChunks(Slice<Str> chunks) {
+    auto dom = makeRc<Markup::Document>(Mime::Url());
+    Markup::HtmlParser parser{dom};
+
+    parser.feed(bytes("<html><body>"s));
+    for (auto chunk : chunks)
+        parser.feed(bytes(chunk));
+    parser.end();
+
+    auto html = try$(dom->firstChild().cast<Element>());
+    auto body = try$(html->firstChild()->nextSibling().cast<Element>());
+    auto text = try$(body->firstChild().cast<Text>());
+    return Ok(text->data);
+}
+
+test$("parse-text-invalid-across-chunks") {
+    auto parse = [](Array<Str, 3> chunks) {
+        return _parseChunks(chunks);
+    };
+
+    // NOTE: A byte that can't continue the cut sequence starts the next one
+    expect$(try$(parse({"a\xe0"s, "\xf0\x9f\x98\x80" "b"s, ""s})) == "a\xef\xbf\xbd\xf0\x9f\x98\x80" "b");
+
+    // NOTE: A sequence can be cut more than once
+    expect$(try$(parse({"a\xf0\x9f"s, "\x98"s, "\x80" "b"s})) == "a\xf0\x9f\x98\x80" "b");
+
+    // NOTE: An invalid lead byte isn't kept for the next chunk
+    expect$(try$(parse({"a\xc0"s, "\x80" "b"s, ""s})) == "a\xef\xbf\xbd\xef\xbf\xbd" "b");
+
+    // NOTE: The second byte bounds are checked as soon as it arrives
+    expect$(try$(parse({"a\xed"s, "\xa0\x80" "b"s, ""s})) == "a\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd" "b");
+
+    // NOTE: A valid prefix that never completes is a single replacement
+    expect$(try$(parse({"a\xf0\x9f"s, "\x98"s, ""s})) == "a\xef\xbf\xbd");
+
+    return Ok();
+}
+
+test$("parse-text-invalid-maximal-subpart") {
+    auto parse = [](Str text) {
+        return _parseChunks(Array<Str, 1>{text});
+    };
+
+    // NOTE: A valid prefix cut short by an unexpected byte is a single
+    //       replacement, the byte is decoded again.
+    expect$(try$(parse("a\xe2\x82" "b"s)) == "a\xef\xbf\xbd" "b");
+    expect$(try$(parse("a\xf0\x9f\x98" "b"s)) == "a\xef\xbf\xbd" "b");
+    expect$(try$(parse("a\xf0\x9f\xe2\x82\xac" "b"s)) == "a\xef\xbf\xbd\xe2\x82\xac" "b");
+
+    // NOTE: Bytes that can't start or continue a sequence are replaced
+    //       one by one.
+    expect$(try$(parse("a\xc0\xaf" "b"s)) == "a\xef\xbf\xbd\xef\xbf\xbd" "b");
+    expect$(try$(parse("a\xed\xa0\x80" "b"s)) == "a\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd" "b");
+    expect$(try$(parse("a\x80\x80" "b"s)) == "a\xef\xbf\xbd\xef\xbf\xbd" "b");
+
+    return Ok();
+}
+
 test$("parse-title") {
     auto dom = makeRc<Markup::Document>(Mime::Url());
     Markup::HtmlParser parser{dom};
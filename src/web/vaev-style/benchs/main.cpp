@@ -0,0 +1,99 @@
+#include <karm-sys/entry.h>
+#include <karm-sys/time.h>
+#include <vaev-style/select.h>
+
+using namespace Vaev;
+
+static constexpr usize ROUNDS = 8;
+static constexpr usize DEPTH = 128;
+static constexpr usize LEAVES = 8;
+
+// A deep chain of nested <div>s, each with a few <span> leaves, the worst
+// case for descendant selectors since each of them has to look at every
+// ancestor before failing.
+static Rc<Markup::Document> _generate() {
+    auto dom = makeRc<Markup::Document>(Mime::Url());
+    Markup::Node* parent = &*dom;
+
+    for (usize i = 0; i < DEPTH; i++) {
+        auto div = makeRc<Markup::Element>(Html::DIV);
+        div->setAttribute(Html::CLASS_ATTR, Io::format("level level-{}", i % 16).unwrap());
+        if (i % 32 == 0)
+            div->setAttribute(Html::ID_ATTR, Io::format("section-{}", i / 32).unwrap());
+
+        for (usize j = 0; j < LEAVES; j++) {
+            auto span = makeRc<Markup::Element>(Html::SPAN);
+            span->setAttribute(Html::CLASS_ATTR, j % 2 ? "item odd"s : "item even"s);
+            div->appendChild(span);
+        }
+
+        parent->appendChild(div);
+        parent = &*div;
+    }
+
+    return dom;
+}
+
+static Vec<Style::Selector> _selectors() {
+    Vec<Style::Selector> selectors;
+    for (usize i = 0; i < 16; i++) {
+        // Never matching, the ancestor isn't in the document
+        selectors.pushBack(Style::Selector::parse(Io::format(".missing-{} div span.item", i).unwrap()).unwrap());
+        selectors.pushBack(Style::Selector::parse(Io::format("#nowhere-{} .level span", i).unwrap()).unwrap());
+        selectors.pushBack(Style::Selector::parse(Io::format("article .level-{} > span", i).unwrap()).unwrap());
+
+        // Matching somewhere down the tree
+        selectors.pushBack(Style::Selector::parse(Io::format(".level-{} .level span.odd", i).unwrap()).unwrap());
+    }
+    selectors.pushBack(Style::Selector::parse("#section-3 span.even").unwrap());
+    return selectors;
+}
+
+static void _walk(Markup::Node const& node, Slice<Style::Selector> selectors, MutCursor<Style::AncestorFilter> filter, usize& matches) {
+    auto el = node.is<Markup::Element>();
+    if (el)
+        for (auto& s : selectors)
+            if (s.match(*el, filter))
+                matches++;
+
+    if (el and filter)
+        filter->push(*el);
+
+    for (auto& child : node.children())
+        _walk(*child, selectors, filter, matches);
+
+    if (el and filter)
+        filter->pop(*el);
+}
+
+static Duration _bench(Markup::Document const& dom, Slice<Style::Selector> selectors, bool useFilter, usize& matches) {
+    auto start = Sys::now();
+    for (usize i = 0; i < ROUNDS; i++) {
+        Style::AncestorFilter filter;
+        matches = 0;
+        _walk(dom, selectors, useFilter ? &filter : nullptr, matches);
+    }
+    return Sys::now() - start;
+}
+
+// Matches a set of deep descendant selectors against every element of a
+// deep document, with and without the ancestor Bloom filter.
+Async::Task<> entryPointAsync(Sys::Context&) {
+    auto dom = _generate();
+    auto selectors = _selectors();
+
+    usize walkMatches = 0;
+    auto walk = _bench(*dom, selectors, false, walkMatches);
+
+    usize filterMatches = 0;
+    auto filter = _bench(*dom, selectors, true, filterMatches);
+
+    if (walkMatches != filterMatches)
+        co_return Error::other("filter changed the result of matching");
+
+    Sys::println("{} elements, {} selectors, {} matches", DEPTH * (LEAVES + 1), selectors.len(), filterMatches);
+    Sys::println("select-walk: {}us per round", walk.toUSecs() / ROUNDS);
+    Sys::println("select-filter: {}us per round", filter.toUSecs() / ROUNDS);
+
+    co_return Ok();
+}
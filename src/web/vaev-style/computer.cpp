@@ -18,7 +18,7 @@ Computed const& Computed::initial() {
 void Computer::_evalRule(Rule const& rule, Markup::Element const& el, MatchingRules& matches) {
     rule.visit(Visitor{
         [&](StyleRule const& r) {
-            if (auto specificity = r.matchWithSpecificity(el))
+            if (auto specificity = r.matchWithSpecificity(el, &_filter))
                 matches.pushBack({&r, specificity.unwrap()});
         },
         [&](MediaRule const& r) {
@@ -35,8 +35,10 @@ void Computer::_evalRule(Rule const& rule, Markup::Element const& el, MatchingRu
 void Computer::_evalRule(Rule const& rule, Page const& page, PageComputedStyle& c) {
     rule.visit(Visitor{
         [&](PageRule const& r) {
-            if (r.match(page))
+            if (r.match(page)) {
                 r.apply(c);
+                c.rules.pushBack(&r);
+            }
         },
         [&](MediaRule const& r) {
             if (r.match(_media))
@@ -90,10 +92,38 @@ Rc<Computed> Computer::_evalCascade(Computed const& parent, MatchingRules& match
     return computed;
 }
 
+// Brings the ancestor filter to the ancestors of the element.
+void Computer::_enterElement(Markup::Element const& el) {
+    Markup::Element const* parent = nullptr;
+    if (el.hasParent())
+        parent = el.parentNode().is<Markup::Element>();
+
+    while (_ancestors.len() and static_cast<Markup::Element const*>(last(_ancestors)) != parent)
+        _filter.pop(*_ancestors.popBack());
+
+    if (_ancestors.len() or not parent)
+        return;
+
+    // NOTE: The element is not next to the last one styled, rebuild
+    //       the filter from scratch.
+    Vec<Cursor<Markup::Element>> ancestors;
+    for (Markup::Element const* curr = parent; curr;) {
+        ancestors.pushBack(curr);
+        curr = curr->hasParent() ? curr->parentNode().is<Markup::Element>() : nullptr;
+    }
+
+    for (auto ancestor : iterRev(ancestors)) {
+        _filter.push(*ancestor);
+        _ancestors.pushBack(ancestor);
+    }
+}
+
 // https://drafts.csswg.org/css-cascade/#cascade-origin
 Rc<Computed> Computer::computeFor(Computed const& parent, Markup::Element const& el) {
     MatchingRules matchingRules;
 
+    _enterElement(el);
+
     // Collect matching styles rules
     for (auto const& sheet : _styleBook.styleSheets)
         for (auto const& rule : sheet.rules)
@@ -108,6 +138,9 @@ Rc<Computed> Computer::computeFor(Computed const& parent, Markup::Element const&
     };
     matchingRules.pushBack({&styleRule, INLINE_SPEC});
 
+    _filter.push(el);
+    _ancestors.pushBack(&el);
+
     return _evalCascade(parent, matchingRules);
 }
 
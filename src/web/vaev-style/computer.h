@@ -11,12 +11,20 @@ struct Computer {
     Media _media;
     StyleBook const& _styleBook;
 
+    // Ancestors of the last element styled, and the last element itself,
+    // in document order, so styling a tree top-down only pushes and pops
+    // one element at a time.
+    Vec<Cursor<Markup::Element>> _ancestors = {};
+    AncestorFilter _filter = {};
+
     using MatchingRules = Vec<Tuple<Cursor<StyleRule>, Spec>>;
 
     void _evalRule(Rule const& rule, Markup::Element const& el, MatchingRules& matches);
 
     void _evalRule(Rule const& rule, Page const& page, PageComputedStyle& c);
 
+    void _enterElement(Markup::Element const& el);
+
     Rc<Computed> _evalCascade(Computed const& parent, MatchingRules& matches);
 
     Rc<Computed> computeFor(Computed const& parent, Markup::Element const& el);
@@ -42,11 +42,14 @@ struct Page {
     bool blank;
 };
 
+struct PageRule;
+
 struct PageComputedStyle {
     using Areas = Array<Rc<Computed>, toUnderlyingType(PageArea::_LEN)>;
 
     Rc<Computed> style;
     Areas _areas;
+    Vec<Cursor<PageRule>> rules; //< The @page rules that matched, in cascade order
 
     PageComputedStyle(Computed const& initial)
         : style(makeRc<Computed>(initial)),
@@ -8,8 +8,8 @@ static bool DEBUG_RULE = false;
 
 // MARK: StyleRule -------------------------------------------------------------
 
-Opt<Spec> StyleRule::matchWithSpecificity(Markup::Element const& el) const {
-    return selector.matchWithSpecificity(el);
+Opt<Spec> StyleRule::matchWithSpecificity(Markup::Element const& el, Cursor<AncestorFilter> filter) const {
+    return selector.matchWithSpecificity(el, filter);
 }
 
 void StyleRule::repr(Io::Emit& e) const {
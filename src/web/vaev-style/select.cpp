@@ -51,15 +51,80 @@ Spec spec(Selector const& s) {
     });
 }
 
+// MARK: Ancestor Filter -------------------------------------------------------
+
+void AncestorFilter::push(Markup::Element const& el) {
+    _add(hashOf(el.tagName));
+    if (auto id = el.id())
+        _add(hashOfId(*id));
+    for (auto& class_ : el.classList._tokens)
+        _add(hashOfClass(class_));
+}
+
+void AncestorFilter::pop(Markup::Element const& el) {
+    _remove(hashOf(el.tagName));
+    if (auto id = el.id())
+        _remove(hashOfId(*id));
+    for (auto& class_ : el.classList._tokens)
+        _remove(hashOfClass(class_));
+}
+
+// Returns false if no ancestor in the filter can match the selector,
+// true if one might.
+static bool _mayMatchAncestor(Selector const& s, AncestorFilter const& filter) {
+    return s.visit(Visitor{
+        [&](Nfix const& n) {
+            if (n.type == Nfix::AND) {
+                for (auto& inner : n.inners)
+                    if (not _mayMatchAncestor(inner, filter))
+                        return false;
+                return true;
+            }
+
+            if (n.type == Nfix::OR) {
+                for (auto& inner : n.inners)
+                    if (_mayMatchAncestor(inner, filter))
+                        return true;
+                return false;
+            }
+
+            return true;
+        },
+        [&](Infix const& i) {
+            // NOTE: The right hand side is the ancestor itself, the left hand
+            //       side is one of its ancestors only for these combinators.
+            if (i.type == Infix::DESCENDANT or i.type == Infix::CHILD)
+                return _mayMatchAncestor(*i.lhs, filter) and
+                       _mayMatchAncestor(*i.rhs, filter);
+            return _mayMatchAncestor(*i.rhs, filter);
+        },
+        [&](TypeSelector const& t) {
+            return filter.mayContain(AncestorFilter::hashOf(t.type));
+        },
+        [&](IdSelector const& i) {
+            return filter.mayContain(AncestorFilter::hashOfId(i.id));
+        },
+        [&](ClassSelector const& c) {
+            return filter.mayContain(AncestorFilter::hashOfClass(c.class_));
+        },
+        [&](auto const&) {
+            return true;
+        }
+    });
+}
+
 // MARK: Selector Matching -----------------------------------------------------
 
 // https://www.w3.org/TR/selectors-4/#descendant-combinators
-static bool _matchDescendant(Selector const& s, Markup::Element const& e) {
+static bool _matchDescendant(Selector const& s, Markup::Element const& e, Cursor<AncestorFilter> filter) {
+    if (filter and not _mayMatchAncestor(s, *filter))
+        return false;
+
     Cursor<Markup::Node> curr = &e;
     while (curr->hasParent()) {
         auto& parent = curr->parentNode();
         if (auto el = parent.is<Markup::Element>())
-            if (s.match(*el))
+            if (s.match(*el, filter))
                 return true;
         curr = &parent;
     }
@@ -67,56 +132,59 @@ static bool _matchDescendant(Selector const& s, Markup::Element const& e) {
 }
 
 // https://www.w3.org/TR/selectors-4/#child-combinators
-static bool _matchChild(Selector const& s, Markup::Element const& e) {
+static bool _matchChild(Selector const& s, Markup::Element const& e, Cursor<AncestorFilter> filter) {
     if (not e.hasParent())
         return false;
 
+    if (filter and not _mayMatchAncestor(s, *filter))
+        return false;
+
     auto& parent = e.parentNode();
     if (auto el = parent.is<Markup::Element>())
-        return s.match(*el);
+        return s.match(*el, filter);
     return false;
 }
 
 // https://www.w3.org/TR/selectors-4/#adjacent-sibling-combinators
-static bool _matchAdjacent(Selector const& s, Markup::Element const& e) {
+static bool _matchAdjacent(Selector const& s, Markup::Element const& e, Cursor<AncestorFilter> filter) {
     if (not e.hasPreviousSibling())
         return false;
 
     auto prev = e.previousSibling();
     if (auto el = prev.is<Markup::Element>())
-        return s.match(*el);
+        return s.match(*el, filter);
     return false;
 }
 
 // https://www.w3.org/TR/selectors-4/#general-sibling-combinators
-static bool _matchSubsequent(Selector const& s, Markup::Element const& e) {
+static bool _matchSubsequent(Selector const& s, Markup::Element const& e, Cursor<AncestorFilter> filter) {
     Cursor<Markup::Node> curr = &e;
     while (curr->hasPreviousSibling()) {
         auto prev = curr->previousSibling();
         if (auto el = prev.is<Markup::Element>())
-            if (s.match(*el))
+            if (s.match(*el, filter))
                 return true;
         curr = &prev.unwrap();
     }
     return false;
 }
 
-static bool _match(Infix const& s, Markup::Element const& e) {
-    if (not s.rhs->match(e))
+static bool _match(Infix const& s, Markup::Element const& e, Cursor<AncestorFilter> filter) {
+    if (not s.rhs->match(e, filter))
         return false;
 
     switch (s.type) {
     case Infix::DESCENDANT: // ' '
-        return _matchDescendant(*s.lhs, e);
+        return _matchDescendant(*s.lhs, e, filter);
 
     case Infix::CHILD: // >
-        return _matchChild(*s.lhs, e);
+        return _matchChild(*s.lhs, e, filter);
 
     case Infix::ADJACENT: // +
-        return _matchAdjacent(*s.lhs, e);
+        return _matchAdjacent(*s.lhs, e, filter);
 
     case Infix::SUBSEQUENT: // ~
-        return _matchSubsequent(*s.lhs, e);
+        return _matchSubsequent(*s.lhs, e, filter);
 
     default:
         logWarnIf(DEBUG_SELECTORS, "unimplemented selector: {}", s);
@@ -124,11 +192,11 @@ static bool _match(Infix const& s, Markup::Element const& e) {
     }
 }
 
-static bool _match(Nfix const& s, Markup::Element const& el) {
+static bool _match(Nfix const& s, Markup::Element const& el, Cursor<AncestorFilter> filter) {
     switch (s.type) {
     case Nfix::AND:
         for (auto& inner : s.inners)
-            if (not inner.match(el))
+            if (not inner.match(el, filter))
                 return false;
         return true;
 
@@ -139,15 +207,15 @@ static bool _match(Nfix const& s, Markup::Element const& el) {
     // https://www.w3.org/TR/selectors-4/#matchess
     case Nfix::OR:
         for (auto& inner : s.inners)
-            if (inner.match(el))
+            if (inner.match(el, filter))
                 return true;
         return false;
 
     case Nfix::NOT:
-        return not s.inners[0].match(el);
+        return not s.inners[0].match(el, filter);
 
     case Nfix::WHERE:
-        return not s.inners[0].match(el);
+        return not s.inners[0].match(el, filter);
 
     default:
         logWarnIf(DEBUG_SELECTORS, "unimplemented selector: {}", s);
@@ -272,10 +340,12 @@ static bool _match(UniversalSelector const&, Markup::Element const&) {
 
 // MARK: Selector --------------------------------------------------------------
 
-bool Selector::match(Markup::Element const& el) const {
+bool Selector::match(Markup::Element const& el, Cursor<AncestorFilter> filter) const {
     return visit(
         [&](auto const& s) {
-            if constexpr (requires { _match(s, el); })
+            if constexpr (requires { _match(s, el, filter); })
+                return _match(s, el, filter);
+            else if constexpr (requires { _match(s, el); })
                 return _match(s, el);
 
             logWarnIf(DEBUG_SELECTORS, "unimplemented selector: {}", s);
@@ -284,21 +354,21 @@ bool Selector::match(Markup::Element const& el) const {
     );
 }
 
-Opt<Spec> Selector::matchWithSpecificity(Markup::Element const& el) const {
+Opt<Spec> Selector::matchWithSpecificity(Markup::Element const& el, Cursor<AncestorFilter> filter) const {
     return visit(Visitor{
         [&](Nfix const& n) -> Opt<Spec> {
             if (n.type == Nfix::OR) {
                 Opt<Spec> specificity;
                 for (auto& inner : n.inners) {
-                    if (inner.match(el))
+                    if (inner.match(el, filter))
                         specificity = max(specificity, spec(inner));
                 }
                 return specificity;
             }
-            return match(el) ? Opt<Spec>{spec(n)} : NONE;
+            return match(el, filter) ? Opt<Spec>{spec(n)} : NONE;
         },
         [&](auto const& s) -> Opt<Spec> {
-            return match(el) ? Opt<Spec>{spec(s)} : NONE;
+            return match(el, filter) ? Opt<Spec>{spec(s)} : NONE;
         }
     });
 }
@@ -475,7 +545,7 @@ static Res<Selector> _parseSelectorElement(Cursor<Css::Sst>& cur, OpCode current
             cur.next();
             return _parseSelectorElement(cur, currentOp);
         case Css::Token::HASH:
-            val = IdSelector{next(cur->token.data, 1)};
+            val = IdSelector{Str{next(cur->token.data, 1)}};
             break;
         case Css::Token::IDENT:
             val = TypeSelector{TagName::make(cur->token.data, Vaev::HTML)};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <karm-base/array.h>
 #include <karm-base/box.h>
 #include <karm-base/vec.h>
 #include <vaev-css/parser.h>
@@ -144,7 +145,7 @@ struct TypeSelector {
 };
 
 struct IdSelector {
-    String id;
+    Atom id;
 
     void repr(Io::Emit& e) const {
         e("#{}", id);
@@ -154,7 +155,7 @@ struct IdSelector {
 };
 
 struct ClassSelector {
-    String class_;
+    Atom class_;
 
     void repr(Io::Emit& e) const {
         e(".{}", class_);
@@ -259,6 +260,68 @@ struct AttributeSelector {
     bool operator==(AttributeSelector const&) const = default;
 };
 
+// A counting Bloom filter of the tags, ids and classes of the ancestors of
+// the element being matched. Selectors requiring an ancestor that is not in
+// the filter can be rejected without walking up the tree.
+struct AncestorFilter {
+    static constexpr usize BITS = 12;
+    static constexpr usize SIZE = 1 << BITS;
+    static constexpr usize MASK = SIZE - 1;
+
+    Array<u8, SIZE> _counters{};
+
+    static u32 _mix(Hash hash, u64 salt) {
+        u64 x = (u64)hash ^ salt;
+        x *= 0x9e3779b97f4a7c15ull;
+        return (u32)(x ^ (x >> 32));
+    }
+
+    static u32 hashOf(TagName tag) {
+        return _mix(tag.id | ((usize)tag.ns._id << 16), 0x74616721);
+    }
+
+    static u32 hashOfId(Atom id) {
+        return _mix(id.hash(), 0x69642121);
+    }
+
+    static u32 hashOfClass(Atom class_) {
+        return _mix(class_.hash(), 0x636c6173);
+    }
+
+    // NOTE: Each hash sets two counters, one from its low bits and one
+    //       from its high bits.
+    void _inc(usize i) {
+        if (_counters[i] != 0xff)
+            _counters[i]++;
+    }
+
+    // NOTE: Saturated counters are never decremented, they just stay as
+    //       false positives.
+    void _dec(usize i) {
+        if (_counters[i] != 0xff and _counters[i] != 0)
+            _counters[i]--;
+    }
+
+    void _add(u32 hash) {
+        _inc(hash & MASK);
+        _inc((hash >> 16) & MASK);
+    }
+
+    void _remove(u32 hash) {
+        _dec(hash & MASK);
+        _dec((hash >> 16) & MASK);
+    }
+
+    bool mayContain(u32 hash) const {
+        return _counters[hash & MASK] and
+               _counters[(hash >> 16) & MASK];
+    }
+
+    void push(Markup::Element const& el);
+
+    void pop(Markup::Element const& el);
+};
+
 using _Selector = Union<
     Nfix,
     Infix,
@@ -357,9 +420,11 @@ struct Selector : public _Selector {
         });
     }
 
-    bool match(Markup::Element const& el) const;
+    // NOTE: The filter, if any, must contain at least all the ancestors
+    //       of the element.
+    bool match(Markup::Element const& el, Cursor<AncestorFilter> filter = nullptr) const;
 
-    Opt<Spec> matchWithSpecificity(Markup::Element const& el) const;
+    Opt<Spec> matchWithSpecificity(Markup::Element const& el, Cursor<AncestorFilter> filter = nullptr) const;
 
     bool operator==(Selector const&) const = default;
 
@@ -11,4 +11,38 @@ test$("select-class-spec") {
     return Ok();
 }
 
+test$("select-id-spec") {
+    Selector sel = IdSelector{"foo"s};
+    auto el = makeRc<Markup::Element>(Html::DIV);
+    el->setAttribute(Html::ID_ATTR, "foo"s);
+    expect$(sel.match(*el));
+    return Ok();
+}
+
+test$("select-descendant-ancestor-filter") {
+    auto outer = makeRc<Markup::Element>(Html::SECTION);
+    outer->setAttribute(Html::CLASS_ATTR, "outer"s);
+    auto inner = makeRc<Markup::Element>(Html::DIV);
+    outer->appendChild(inner);
+    auto leaf = makeRc<Markup::Element>(Html::SPAN);
+    inner->appendChild(leaf);
+
+    AncestorFilter filter;
+    filter.push(*outer);
+    filter.push(*inner);
+
+    auto matching = try$(Selector::parse(".outer div span"));
+    expect$(matching.match(*leaf, &filter));
+    expect$(matching.match(*leaf));
+
+    auto missing = try$(Selector::parse(".missing div span"));
+    expect$(not missing.match(*leaf, &filter));
+
+    filter.pop(*inner);
+    filter.pop(*outer);
+    expect$(not filter.mayContain(AncestorFilter::hashOfClass("outer")));
+
+    return Ok();
+}
+
 } // namespace Vaev::Style::Tests